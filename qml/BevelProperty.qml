@@ -15,14 +15,9 @@ Item {
     ParamDropDown {
         id: control
         y: 15
-        model: ["8 bits", "16 bits"]
+        model: ["8 bits", "16 bits", "16 bits float", "8 bits gray", "16 bits gray", "16 bits float gray", "16 bits float vector"]
         onCurrentIndexChanged: {
-            if(currentIndex == 0) {
-                bitsChanged(0)
-            }
-            else if(currentIndex == 1) {
-                bitsChanged(1)
-            }
+            bitsChanged(currentIndex)
             focus = false
         }
         onActivated: {
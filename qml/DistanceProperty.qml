@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.12
+
+Item {
+    height: childrenRect.height + 30
+    width: parent.width
+    property alias startMode: modeParam.currentIndex
+    property alias startMaxDistance: maxDistanceParam.propertyValue
+    property alias startBits: control.currentIndex
+    signal modeChanged(int mode)
+    signal maxDistanceChanged(real dist)
+    signal bitsChanged(int bitsType)
+    signal propertyChangingFinished(string name, var newValue, var oldValue)
+    ParamDropDown {
+        id: control
+        y: 15
+        model: ["8 bits", "16 bits", "16 bits float", "8 bits gray", "16 bits gray", "16 bits float gray", "16 bits float vector"]
+        onCurrentIndexChanged: {
+            bitsChanged(currentIndex)
+            focus = false
+        }
+        onActivated: {
+            propertyChangingFinished("startBits", currentIndex, oldIndex)
+        }
+    }
+    ParamDropDown {
+        id: modeParam
+        y: 53
+        model: ["Unsigned", "Signed", "Seed color"]
+        onCurrentIndexChanged: {
+            modeChanged(currentIndex)
+            focus = false
+        }
+        onActivated: {
+            propertyChangingFinished("startMode", currentIndex, oldIndex)
+        }
+    }
+    Item {
+        width: parent.width - 40
+        height: childrenRect.height
+        x: 10
+        y: 91
+        clip: true
+        ParamSlider {
+            id: maxDistanceParam
+            propertyName: "Max distance"
+            onPropertyValueChanged: {
+                maxDistanceChanged(propertyValue)
+            }
+            onChangingFinished: {
+                propertyChangingFinished("startMaxDistance", propertyValue, oldValue)
+            }
+        }
+    }
+}
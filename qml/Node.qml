@@ -26,7 +26,7 @@ DragRect {
     ColorSettings {
         id:colors
     }
-    property real scaleView: 1.0
+    property real scaleView: parent && parent.parent ? parent.parent.scale : 1.0
     property string title: "Title"
     id: node
     width: parent.width - 16//*scaleView
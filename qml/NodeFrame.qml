@@ -23,7 +23,7 @@ import QtQuick 2.12
 import QtQuick.Controls 2.5
 
 Rectangle {
-    property real scaleView: 1.0
+    property real scaleView: parent && parent.parent ? parent.parent.scale : 1.0
     property bool selected: false
     property bool hovered: false
     property bool bubbleVisible: false
@@ -34,6 +34,7 @@ Item {
     property alias startSeed: seedParam.propertyValue
     property alias type: control.currentIndex
     property alias startBits: bitsParam.currentIndex
+    property alias startChannels: channelsParam.checked
     signal noiseTypeChanged(string type)
     signal noiseScaleChanged(real scale)
     signal scaleXChanged(real scale)
@@ -43,19 +44,15 @@ Item {
     signal amplitudeChanged(real aplitude)
     signal seedChanged(int seed)
     signal bitsChanged(int bitsType)
+    signal channelsChanged(bool channels)
     signal propertyChangingFinished(string name, var newValue, var oldValue)
 
     ParamDropDown {
         id: bitsParam
         y: 15
-        model: ["8 bits", "16 bits"]
+        model: ["8 bits", "16 bits", "16 bits float", "8 bits gray", "16 bits gray", "16 bits float gray", "16 bits float vector"]
         onCurrentIndexChanged: {
-            if(currentIndex == 0) {
-                bitsChanged(0)
-            }
-            else if(currentIndex == 1) {
-                bitsChanged(1)
-            }
+            bitsChanged(currentIndex)
             focus = false
         }
         onActivated: {
@@ -176,4 +173,18 @@ Item {
             }
         }
     }
+
+    ParamCheckbox {
+        id: channelsParam
+        y: 310
+        width: 140
+        text: qsTr("Separate channels")
+        onCheckedChanged: {
+            channelsChanged(channelsParam.checked)
+        }
+        onToggled: {
+            propertyChangingFinished("startChannels", checked, !checked)
+            focus = false
+        }
+    }
 }
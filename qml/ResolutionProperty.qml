@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.12
+import QtQuick.Controls 2.5
+
+Item {
+    id: resolutionProp
+    height: childrenRect.height
+    width: parent.width
+    property var node: null
+    Connections {
+        target: resolutionProp.node
+        ignoreUnknownSignals: true
+        onChangeResolutionOverride: resolutionParam.currentIndex = index
+    }
+    onNodeChanged: {
+        if(node) resolutionParam.currentIndex = node.resolutionOverride
+    }
+    Text {
+        x: 15
+        y: 21
+        text: qsTr("Resolution")
+        color: "#A2A2A2"
+    }
+    ParamDropDown {
+        id: resolutionParam
+        x: 90
+        y: 15
+        width: parent.width - 100
+        model: ["Graph", "Graph ×¼", "Graph ×½", "Graph ×2", "256", "512", "1024", "2048", "4096"]
+        onActivated: {
+            focus = false
+            if(!resolutionProp.node || currentIndex == oldIndex) return
+            resolutionProp.node.resolutionOverride = currentIndex
+            resolutionProp.node.propertyChanged("resolutionOverride", currentIndex, oldIndex)
+        }
+    }
+}
@@ -6,23 +6,20 @@ Item {
     property alias mode: control.currentIndex
     property alias startIntensity: intensityParam.propertyValue
     property alias startSamples: samplesParam.propertyValue
+    property alias startIterations: iterationsParam.propertyValue
     property alias startBits: bitsParam.currentIndex
     signal blendModeChanged(int mode)
     signal intensityChanged(real intensity)
     signal samplesChanged(int samples)
+    signal iterationsChanged(int iterations)
     signal bitsChanged(int bitsType)
     signal propertyChangingFinished(string name, var newValue, var oldValue)
     ParamDropDown {
         id: bitsParam
         y: 15
-        model: ["8 bits", "16 bits"]
+        model: ["8 bits", "16 bits", "16 bits float", "8 bits gray", "16 bits gray", "16 bits float gray", "16 bits float vector"]
         onCurrentIndexChanged: {
-            if(currentIndex == 0) {
-                bitsChanged(0)
-            }
-            else if(currentIndex == 1) {
-                bitsChanged(1)
-            }
+            bitsChanged(currentIndex)
             focus = false
         }
         onActivated: {
@@ -62,8 +59,8 @@ Item {
         ParamSlider {
             id: samplesParam
             y: 18
-            propertyName: "Samples"
-            maximum: 16
+            propertyName: "Max samples"
+            maximum: 64
             minimum: 1
             step: 1
             onPropertyValueChanged: {
@@ -73,5 +70,19 @@ Item {
                 propertyChangingFinished("startSamples", propertyValue, oldValue)
             }
         }
+        ParamSlider {
+            id: iterationsParam
+            y: 36
+            propertyName: "Iterations"
+            maximum: 10
+            minimum: 1
+            step: 1
+            onPropertyValueChanged: {
+                iterationsChanged(propertyValue)
+            }
+            onChangingFinished: {
+                propertyChangingFinished("startIterations", propertyValue, oldValue)
+            }
+        }
     }
 }
@@ -1,6 +1,6 @@
 #version 440 core
 
-uniform sampler2D dfTexture;
+uniform usampler2D dfTexture;
 uniform sampler2D maskTexture;
 uniform float dist = 0.05;
 uniform bool useAlpha = false;
@@ -16,9 +16,11 @@ void main()
 
     vec2 uv = gl_FragCoord.xy/texSize;
 
-    float div = texSize.x*abs(dist);
-    div = clamp(div, 1.0, texSize.x);
-    float d = (length(texture(dfTexture, uv).xy*texSize - gl_FragCoord.xy))/div;
+    float side = max(texSize.x, texSize.y);
+    float div = side*abs(dist);
+    div = clamp(div, 1.0, side);
+    uvec2 seed = texelFetch(dfTexture, ivec2(gl_FragCoord.xy), 0).xy;
+    float d = seed.x == 0xFFFFu ? 1.0 : length(vec2(seed) + 0.5 - gl_FragCoord.xy)/div;
     d = max(0.0, min(1.0, d));
     d = (d - 0.5)*2.0 + 0.5;
     d += 0.5;
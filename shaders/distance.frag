@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#version 440 core
+
+uniform usampler2D seedTexture;
+uniform usampler2D innerSeedTexture;
+uniform sampler2D colorTexture;
+uniform int mode = 0;
+uniform float maxDistance = 0.25;
+
+out vec4 FragColor;
+
+const uint EMPTY = 0xFFFFu;
+
+float seedDistance(usampler2D seeds)
+{
+    uvec2 seed = texelFetch(seeds, ivec2(gl_FragCoord.xy), 0).xy;
+    if(seed.x == EMPTY) return 1.0e20;
+    return length(vec2(seed) + 0.5 - gl_FragCoord.xy);
+}
+
+void main()
+{
+    vec2 texSize = textureSize(seedTexture, 0);
+    if(mode == 2) {
+        //color of the nearest seed
+        uvec2 seed = texelFetch(seedTexture, ivec2(gl_FragCoord.xy), 0).xy;
+        if(seed.x == EMPTY) FragColor = vec4(0.0);
+        else FragColor = texture(colorTexture, (vec2(seed) + 0.5)/texSize);
+        return;
+    }
+    float range = max(1.0, maxDistance*max(texSize.x, texSize.y));
+    float d = min(seedDistance(seedTexture)/range, 1.0);
+    if(mode == 1) {
+        float inner = min(seedDistance(innerSeedTexture)/range, 1.0);
+        d = 0.5 + 0.5*(d - inner);
+    }
+    FragColor = vec4(vec3(d), 1.0);
+}
@@ -21,40 +21,27 @@
 
 #version 440 core
 
-#define PI 3.14159265359
-
 uniform sampler2D sourceTexture;
 uniform sampler2D maskTexture;
-uniform float intensity = 0.5;
-uniform vec2 resolution;
 uniform vec2 direction;
+uniform float sigma = 1.0;
+uniform int radius = 0;
 uniform bool useMask = false;
-vec2 size = 0.001*resolution*intensity;
-
-uniform float offset[3] = float[](0.0, 1.3846153846, 3.2307692308);
-uniform float weight[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
 
 in vec2 texCoords;
 
 out vec4 FragColor;
 
-float gauss (float x, float sigma)
-{
-    return 0.39894*exp(-0.5*x*x/(sigma*sigma))/sigma;
-}
-
 void main()
 {
-    vec4 color = vec4(0.0);
-    color = texture(sourceTexture, vec2(gl_FragCoord) / resolution) * weight[0];
-    for (int i=1; i<3; i++) {
-        color +=
-            texture(sourceTexture, (vec2(gl_FragCoord) + direction*offset[i]*size) / resolution)
-                * weight[i];
-        color +=
-            texture(sourceTexture, (vec2(gl_FragCoord) - direction*offset[i]*size) / resolution)
-                * weight[i];
+    vec4 color = texture(sourceTexture, texCoords);
+    float total = 1.0;
+    for(int i = 1; i <= radius; ++i) {
+        float weight = exp(-0.5*i*i/(sigma*sigma));
+        color += (texture(sourceTexture, texCoords + i*direction) + texture(sourceTexture, texCoords - i*direction))*weight;
+        total += 2.0*weight;
     }
+    color /= total;
 
     if(useMask) {
         vec4 maskColor = texture(maskTexture, texCoords);
@@ -62,5 +49,5 @@ void main()
         color *= mask;
     }
 
-    FragColor  = color;
+    FragColor = color;
 }
@@ -4,26 +4,19 @@
 #define TWO_PI 6.28318530718
 
 uniform sampler2D maskTexture;
+uniform sampler2D cellsTexture;
 uniform vec2 res;
 uniform int columns = 5;
 uniform int rows = 6;
 uniform float hexSmooth = 0.0;
 uniform float size = 0.9;
 uniform float maskStrength = 0.0;
-uniform int seed = 1;
 uniform bool useMask = false;
 
 in vec2 texCoords;
 
 out vec4 FragColor;
 
-const float PHI = 1.61803398874989484820459;
-
-float gold_noise(vec2 xy, int seed)
-{
-    return fract(tan(distance(xy*PHI, xy)*1367.454541*seed)*xy.x);
-}
-
 void main()
 {
     vec2 st = gl_FragCoord.xy/res;
@@ -49,7 +42,7 @@ void main()
             float a = atan(coords.x,coords.y)+PI*0.5;
             float r = TWO_PI/float(N);
 
-            float mask = 1.0 - gold_noise(cell_t + 1.0, seed)*maskStrength;
+            float mask = 1.0 - texelFetch(cellsTexture, ivec2(cell_t), 0).r*maskStrength;
 
             float d = (cos(floor(.5+a/r)*r-a))*length(coords);
 
@@ -33,18 +33,31 @@ uniform float scaleX = 1.0;
 uniform float scaleY = 1.0;
 uniform int seed = 1;
 uniform bool useMask = false;
+uniform bool channels = false;
 out vec4 FragColor;
 
+//pcg2d integer hash, corners are integral so no precision is lost on large coordinates
+uvec2 pcg2d(uvec2 v) {
+    v = v*1664525u + 1013904223u;
+    v.x += v.y*1664525u;
+    v.y += v.x*1664525u;
+    v = v ^ (v >> 16u);
+    v.x += v.y*1664525u;
+    v.y += v.x*1664525u;
+    v = v ^ (v >> 16u);
+    return v;
+}
+
+uvec2 hash(vec2 st) {
+    return pcg2d(uvec2(ivec2(st)) ^ uvec2(uint(seed)*0x9E3779B9u, uint(seed)*0x85EBCA6Bu));
+}
+
 float random (in vec2 st) {
-    return - 1.0 + 2.0*fract(sin(dot(st.xy,
-                         vec2(12.9898,78.233)))
-                 * 1367.454541*seed);
+    return -1.0 + 2.0*float(hash(st).x >> 8u)/16777216.0;
 }
 
 vec2 random2(vec2 st){
-    st = vec2( dot(st,vec2(127.1,311.7)),
-              dot(st,vec2(269.5,183.3)) );
-    return (-1.0 + 2.0*fract(sin(st)*1367.454541*seed));
+    return -1.0 + 2.0*vec2(hash(st) >> 8u)/16777216.0;
 }
 vec3 mod289(vec3 x) { return x - floor(x * (1.0 / 289.0)) * 289.0; }
 vec2 mod289(vec2 x) { return x - floor(x * (1.0 / 289.0)) * 289.0; }
@@ -82,8 +95,7 @@ vec2 getWrappedPerlinGradient(vec2 corner, vec2 height) {
     return gradient;
 }
 
-subroutine(noiseType)
-float noiseSimple (vec2 st, vec2 s) {
+float valueNoise(vec2 st, vec2 s) {
     vec2 i = floor(st);
     vec2 f = fract(st);
 
@@ -99,8 +111,7 @@ float noiseSimple (vec2 st, vec2 s) {
             (d - b) * u.x * u.y;
 }
 
-subroutine(noiseType)
-float noisePerlin(vec2 st, vec2 s) {
+float perlinNoise(vec2 st, vec2 s) {
     vec2 i = floor(st);
     vec2 f = fract(st);
 
@@ -112,6 +123,16 @@ float noisePerlin(vec2 st, vec2 s) {
                      dot( getWrappedPerlinGradient(i + vec2(1.0,1.0), s), f - vec2(1.0,1.0) ), u.x), u.y);
 }
 
+subroutine(noiseType)
+float noiseSimple(vec2 st, vec2 s) {
+    return valueNoise(st, s);
+}
+
+subroutine(noiseType)
+float noisePerlin(vec2 st, vec2 s) {
+    return perlinNoise(st, s);
+}
+
 float noiseSimplex(vec2 v) {
     const vec4 C = vec4(0.211324865405187,
                         0.366025403784439,
@@ -153,22 +174,34 @@ float noiseSimplex(vec2 v) {
     return 130.0 * dot(m, g);
 }
 
+float fbm(int type, vec2 st, vec2 s) {
+    float frequency = floor(scale);
+    float lacunarity = 2.0;
+    float ampl = amplitude;
+    float value = 0.0;
+    for(int i = 0; i <= octaves; ++i) {
+        if(type == 1) value += ampl*perlinNoise(st*frequency*s, frequency*s);
+        else if(type == 2) value += ampl*valueNoise(st*frequency*s, frequency*s);
+        else value += ampl*noise(st*frequency*s, frequency*s);
+        frequency *= lacunarity;
+        ampl *= persistence;
+    }
+    return value;
+}
+
 void main() {
-   float frequency = floor(scale);
-   float lacunarity = 2.0;
-   float ampl = amplitude;
    vec2 st = gl_FragCoord.xy/res;
    st.x *= res.x/res.y;
    vec2 s = vec2(scaleX, scaleY);
    vec3 color = vec3(0.0);
 
-   for(int i = 0; i <= octaves; ++i) {
-      color += ampl*noise(st*frequency*s, frequency*s);
-      frequency *= lacunarity;
-      ampl *= persistence;
+   if(channels) {
+      color.r = 0.5 + fbm(1, st, s)*0.5;
+      color.g = 0.5 + fbm(2, st, s)*0.5;
+   }
+   else {
+      color = vec3(0.5 + fbm(0, st, s)*0.5);
    }
-
-   color =  0.5 + color*0.5;
 
    vec4 result = vec4(color, 1.0);
    if(useMask) {
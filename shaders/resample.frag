@@ -0,0 +1,44 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#version 440 core
+
+uniform sampler2D sourceTexture;
+uniform vec2 ratio = vec2(1.0);
+
+in vec2 texCoords;
+
+out vec4 FragColor;
+
+void main()
+{
+    //bilinear taps spread over the footprint of the target texel when shrinking
+    ivec2 taps = clamp(ivec2(ceil(ratio*0.5)), ivec2(1), ivec2(4));
+    vec2 footprint = ratio/vec2(textureSize(sourceTexture, 0));
+    vec4 result = vec4(0.0);
+    for(int y = 0; y < taps.y; ++y) {
+        for(int x = 0; x < taps.x; ++x) {
+            vec2 offset = ((vec2(x, y) + 0.5)/vec2(taps) - 0.5)*footprint;
+            result += texture(sourceTexture, texCoords + offset);
+        }
+    }
+    FragColor = result/float(taps.x*taps.y);
+}
@@ -1,7 +1,7 @@
 #version 440 core
 
 uniform sampler2D sourceTexture;
-uniform sampler2D slopeTexture;
+uniform sampler2D gradientTexture;
 uniform sampler2D maskTexture;
 uniform float intensity = 0.1f;
 uniform int samples = 1;
@@ -14,52 +14,26 @@ out vec4 FragColor;
 
 void main()
 {
-    vec2 step = vec2(0.3);
     vec2 uv = texCoords;
+    vec2 n = texture(gradientTexture, uv).xy;
 
-    float tl = texture(slopeTexture, uv + vec2(-step.x, step.y)).x;
-    float t = texture(slopeTexture, uv + vec2(0.0, step.y)).x;
-    float tr = texture(slopeTexture, uv + vec2(step.x, step.y)).x;
-    float bl = texture(slopeTexture, uv + vec2(-step.x, -step.y)).x;
-    float b = texture(slopeTexture, uv + vec2(0.0, -step.y)).x;
-    float br = texture(slopeTexture, uv + vec2(step.x, -step.y)).x;
-    float l = texture(slopeTexture, uv + vec2(-step.x, 0.0)).x;
-    float r = texture(slopeTexture, uv + vec2(step.x, 0.0)).x;
+    //no more than one sample per pixel of displacement
+    vec2 displacement = intensity*0.1*n*textureSize(sourceTexture, 0);
+    int count = clamp(int(ceil(length(displacement))), 1, samples);
 
-    float top_side = tl + 2.0*t + tr;
-    float bottom_side = bl + 2.0*b + br;
-    float right_side = tr + 2.0*r + br;
-    float left_side = tl + 2.0*l + bl;
-    vec2 n = vec2(right_side - left_side, top_side - bottom_side);
-
-    float offset = (intensity*0.1)/samples;
+    float offset = (intensity*0.1)/count;
     float f = offset;
     vec4 result = texture(sourceTexture, uv + f*n);
     vec4 color = texture(sourceTexture, uv);
-    vec4 s = vec4(0.0);
-    if(mode == 0) { //average
-        for(int i = 1; i < samples; ++i) {
-            f += offset;
-            s = texture(sourceTexture, uv + f*n);
-            if(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722)) > 0.0) result += s;
-            else result += max(s, color);
-        }
-    }
-    else if(mode == 1) { //min
-        for(int i = 1; i < samples; ++i) {
-            f += offset;
-            s = texture(sourceTexture, uv + f*n);
-            if(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722)) > 0.0) result += s;
-        }
-    }
-    else if(mode == 2) { //max
-        for(int i = 1; i < samples; ++i) {
-            f += offset;
-            s = texture(sourceTexture, uv + f*n);
-            result += max(s, color);
-        }
+    bool lit = dot(color.rgb, vec3(0.2126, 0.7152, 0.0722)) > 0.0;
+    //average keeps lit samples and lifts dark ones, min drops dark ones, max lifts all
+    float weight = (mode != 1 || lit) ? 1.0 : 0.0;
+    vec4 low = (mode == 2 || (mode == 0 && !lit)) ? color : vec4(0.0);
+    for(int i = 1; i < count; ++i) {
+        f += offset;
+        result += weight*max(texture(sourceTexture, uv + f*n), low);
     }
-    result.rgb /= samples;
+    result.rgb /= count;
     if(useMask) {
         vec4 maskColor = texture(maskTexture, uv);
         float mask = 0.33333*(maskColor.r + maskColor.g + maskColor.b);
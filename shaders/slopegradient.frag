@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#version 440 core
+
+uniform sampler2D slopeTexture;
+
+in vec2 texCoords;
+
+out vec2 FragColor;
+
+void main()
+{
+    vec2 step = vec2(0.3);
+    vec2 uv = texCoords;
+
+    float tl = texture(slopeTexture, uv + vec2(-step.x, step.y)).x;
+    float t = texture(slopeTexture, uv + vec2(0.0, step.y)).x;
+    float tr = texture(slopeTexture, uv + vec2(step.x, step.y)).x;
+    float bl = texture(slopeTexture, uv + vec2(-step.x, -step.y)).x;
+    float b = texture(slopeTexture, uv + vec2(0.0, -step.y)).x;
+    float br = texture(slopeTexture, uv + vec2(step.x, -step.y)).x;
+    float l = texture(slopeTexture, uv + vec2(-step.x, 0.0)).x;
+    float r = texture(slopeTexture, uv + vec2(step.x, 0.0)).x;
+
+    float top_side = tl + 2.0*t + tr;
+    float bottom_side = bl + 2.0*b + br;
+    float right_side = tr + 2.0*r + br;
+    float left_side = tl + 2.0*l + bl;
+    FragColor = vec2(right_side - left_side, top_side - bottom_side);
+}
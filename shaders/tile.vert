@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#version 440 core
+
+struct Instance {
+    vec4 placement;
+    vec4 appearance;
+};
+
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+uniform int columns = 5;
+uniform int rows = 5;
+uniform bool keepProportion = false;
+uniform int copies = 1;
+
+out vec2 tileCoords;
+flat out float layer;
+flat out float shade;
+
+const vec2 corners[4] = vec2[](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(1.0, 1.0));
+
+mat2 rotate2d(float _angle){
+    return mat2(cos(_angle),-sin(_angle),
+                sin(_angle),cos(_angle));
+}
+
+void main()
+{
+    int side = 2*copies + 1;
+    Instance instance = instances[gl_InstanceID/(side*side)];
+    int copy = gl_InstanceID % (side*side);
+    vec2 wrap = vec2(copy % side, copy/side) - vec2(copies);
+
+    vec2 offsetForProportion = vec2(0, 0);
+    vec2 scaleForProportion = vec2(1.0, 1.0);
+    if(keepProportion) {
+        if(columns < rows) {
+            offsetForProportion = vec2(1.0 - columns/rows, 0.0)*0.5;
+            scaleForProportion = vec2(float(rows)/float(columns), 1.0);
+        }
+        else {
+            offsetForProportion = vec2(0.0, 1.0 - rows/columns)*0.5;
+            scaleForProportion = vec2(1.0, float(columns)/float(rows));
+        }
+    }
+
+    //inverse of the cell to tile mapping of the former gather shader
+    vec2 corner = corners[gl_VertexID];
+    vec2 coords = (corner - 0.5)*instance.appearance.xy;
+    coords = rotate2d(instance.placement.z)*coords;
+    coords += 0.5;
+    if(keepProportion) {
+        coords -= offsetForProportion;
+        coords /= scaleForProportion;
+        coords += offsetForProportion;
+    }
+    vec2 uv = (instance.placement.xy + coords)/vec2(columns, rows) + wrap;
+
+    tileCoords = corner;
+    layer = instance.appearance.z;
+    shade = instance.appearance.w;
+    gl_Position = vec4(uv*2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#version 440 core
+uniform bool useAlpha = true;
+uniform bool useMask = false;
+uniform sampler2D accumulatedTexture;
+uniform sampler2D maskTexture;
+
+in vec2 texCoords;
+
+out vec4 FragColor;
+
+void main()
+{
+    vec4 color = texture(accumulatedTexture, texCoords);
+    if(color.a > 0.0) color.rgb /= color.a;
+
+    if(!useAlpha) color.a = 1.0;
+
+    if(useMask) {
+        vec4 maskColor = texture(maskTexture, texCoords);
+        float mask = 0.33333*(maskColor.r + maskColor.g + maskColor.b);
+        color *= mask;
+    }
+    FragColor = color;
+}
@@ -23,6 +23,7 @@
 subroutine float voronoiType(vec2 st);
 subroutine uniform voronoiType voronoiFunction;
 uniform sampler2D maskTexture;
+uniform sampler2D pointsTexture;
 uniform vec2 res;
 uniform int scale = 5;
 uniform int scaleX = 1;
@@ -31,14 +32,13 @@ uniform float jitter = 1.0;
 uniform bool inverse = false;
 uniform float intensity = 2.0;
 uniform float bordersSize = 0.0;
-uniform int seed = 1;
 uniform bool useMask = false;
 
 out vec4 FragColor;
 
 vec2 random2( vec2 p ) {
     p = mod(p, scale*vec2(scaleX, scaleY));
-    return fract(sin(vec2(dot(p,vec2(127.1,311.7)),dot(p,vec2(269.5,183.3))))*1367.454541*seed);
+    return texelFetch(pointsTexture, ivec2(p), 0).xy;
 }
 
 vec2 f2Voronoi(vec2 st) {
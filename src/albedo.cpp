@@ -20,8 +20,12 @@
  */
 
 #include "albedo.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 AlbedoObject::AlbedoObject(QQuickItem *parent, QVector2D resolution, GLint bpc):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc)
@@ -90,10 +94,7 @@ void AlbedoObject::setBPC(GLint bpc) {
 
 AlbedoRenderer::AlbedoRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    renderAlbedo = new QOpenGLShaderProgram();
-    renderAlbedo->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderAlbedo->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/albedo.frag");
-    renderAlbedo->link();
+    renderAlbedo = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/albedo.frag");
 
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -120,12 +121,7 @@ AlbedoRenderer::AlbedoRenderer(QVector2D resolution, GLint bpc): m_resolution(re
     glBindFramebuffer(GL_FRAMEBUFFER, albedoFBO);
     glGenTextures(1, &albedoTexture);
     glBindTexture(GL_TEXTURE_2D, albedoTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -153,7 +149,8 @@ AlbedoRenderer::AlbedoRenderer(QVector2D resolution, GLint bpc): m_resolution(re
 }
 
 AlbedoRenderer::~AlbedoRenderer() {
-    delete renderAlbedo;
+    Resampler::release(this);
+    ShaderCache::release(renderAlbedo);
     glDeleteTextures(1, &albedoTexture);
     glDeleteTextures(1, &colorTexture);
     glDeleteFramebuffers(1, &albedoFBO);
@@ -169,9 +166,7 @@ QOpenGLFramebufferObject *AlbedoRenderer::createFramebufferObject(const QSize &s
 
 void AlbedoRenderer::synchronize(QQuickFramebufferObject *item) {
     AlbedoObject *albedoItem = static_cast<AlbedoObject*>(item);
-    renderAlbedo->bind();
-    renderAlbedo->setUniformValue(renderAlbedo->uniformLocation("useAlbedoTex"), albedoItem->useAlbedoTex);
-    renderAlbedo->release();
+    m_useAlbedoTex = albedoItem->useAlbedoTex;
     m_resolution = albedoItem->resolution();
     if(albedoItem->resUpdated) {
         updateTextureRes();
@@ -184,7 +179,7 @@ void AlbedoRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(albedoItem->albedoUpdated) {
             albedoItem->albedoUpdated = false;
-            m_sourceTexture = albedoItem->albedoTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, albedoItem->albedoTexture(), albedoItem->resolution());
             albedoVal = albedoItem->albedoValue();
         }
         if(albedoItem->useAlbedoTex) {
@@ -213,6 +208,7 @@ void AlbedoRenderer::render() {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderAlbedo->bind();
+    renderAlbedo->setUniformValue(renderAlbedo->uniformLocation("useAlbedoTex"), m_useAlbedoTex);
     renderAlbedo->setUniformValue(renderAlbedo->uniformLocation("albedoVal"), albedoVal);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, albedoTexture);
@@ -232,12 +228,7 @@ void AlbedoRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::rgbFormat(TextureFormat::exportFormat(m_bpc)), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -251,6 +242,7 @@ void AlbedoRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderAlbedo->bind();
+    renderAlbedo->setUniformValue(renderAlbedo->uniformLocation("useAlbedoTex"), m_useAlbedoTex);
     renderAlbedo->setUniformValue(renderAlbedo->uniformLocation("albedoVal"), albedoVal);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, albedoTexture);
@@ -261,40 +253,7 @@ void AlbedoRenderer::saveTexture(QString fileName) {
     renderAlbedo->release();
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGB16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGB16 *bits = (FIRGB16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*3 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*3 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 3 * m_resolution.x(), 24, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc, 3);
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
@@ -325,6 +284,7 @@ void AlbedoRenderer::createAlbedoTexture() {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderAlbedo->bind();
+    renderAlbedo->setUniformValue(renderAlbedo->uniformLocation("useAlbedoTex"), m_useAlbedoTex);
     renderAlbedo->setUniformValue(renderAlbedo->uniformLocation("albedoVal"), albedoVal);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
@@ -342,11 +302,6 @@ void AlbedoRenderer::createAlbedoTexture() {
 
 void AlbedoRenderer::updateTextureRes() {
     glBindTexture(GL_TEXTURE_2D, albedoTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -82,6 +82,7 @@ private:
     unsigned int colorTexture = 0;
     unsigned int m_sourceTexture = 0;
     QVector3D albedoVal = QVector3D(1.0f, 1.0f, 1.0f);
+    bool m_useAlbedoTex = false;
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
 };
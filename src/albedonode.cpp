@@ -21,17 +21,16 @@
 
 #include "albedonode.h"
 #include <iostream>
+#include "textureformat.h"
 
 AlbedoNode::AlbedoNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Node(parent, resolution, bpc)
 {
     preview = new AlbedoObject(grNode, m_resolution, m_bpc);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &AlbedoObject::updatePreview, this, &AlbedoNode::updatePreview);
     connect(preview, &AlbedoObject::updateAlbedo, this, &AlbedoNode::albedoChanged);
     connect(this, &Node::changeResolution, preview, &AlbedoObject::setResolution);
@@ -39,25 +38,23 @@ AlbedoNode::AlbedoNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Nod
     createSockets(1, 0);
     setTitle("Albedo");
     m_socketsInput[0]->setTip("Albedo");
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/AlbedoProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(albedoChanged(QVector3D)), this, SLOT(updateAlbedo(QVector3D)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
 AlbedoNode::~AlbedoNode() {
     delete preview;
 }
 
+void AlbedoNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/AlbedoProperty.qml"));
+    propertiesPanel->setProperty("startColor", m_albedo);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(albedoChanged(QVector3D)), this, SLOT(updateAlbedo(QVector3D)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void AlbedoNode::operation() {
     if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
         preview->useAlbedoTex = true;
         preview->setAlbedoTexture(m_socketsInput[0]->value().toUInt());
     }
@@ -67,7 +64,6 @@ void AlbedoNode::operation() {
     preview->setAlbedoValue(m_albedo);
     preview->albedoUpdated = true;
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &AlbedoNode::getPreviewTexture() {
@@ -94,11 +90,11 @@ void AlbedoNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &ha
         QJsonArray albedo = json["albedo"].toArray();
         QVector3D color = QVector3D(albedo[0].toVariant().toFloat(), albedo[1].toVariant().toFloat(),
                              albedo[2].toVariant().toFloat());
-        propertiesPanel->setProperty("startColor", color);
+        updateAlbedo(color);
+        setPropertyOnPanel("startColor", color);
     }
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 void AlbedoNode::updateAlbedo(QVector3D color) {
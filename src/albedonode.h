@@ -40,6 +40,8 @@ signals:
 public slots:
     void updateAlbedo(QVector3D color);
     void saveAlbedo(QString dir);
+protected:
+    void createPropertiesPanel();
 private:
     AlbedoObject *preview;
     QVector3D m_albedo = QVector3D(1.0f, 1.0f, 1.0f);
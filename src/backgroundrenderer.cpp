@@ -20,6 +20,7 @@
  */
 
 #include "backgroundrenderer.h"
+#include "shadercache.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "backgroundobject.h"
 #include <iostream>
@@ -27,10 +28,7 @@
 BackgroundRenderer::BackgroundRenderer()
 {
     initializeOpenGLFunctions();
-    backgroundGrid = new QOpenGLShaderProgram();
-    backgroundGrid->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/grid.vert");
-    backgroundGrid->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/grid.frag");
-    backgroundGrid->link();
+    backgroundGrid = ShaderCache::acquire(":/shaders/grid.vert", ":/shaders/grid.frag");
 
     float vert[] = {-1.0f, -1.0f,
                     -1.0f, 1.0f,
@@ -49,7 +47,7 @@ BackgroundRenderer::BackgroundRenderer()
 }
 
 BackgroundRenderer::~BackgroundRenderer(){
-    delete backgroundGrid;
+    ShaderCache::release(backgroundGrid);
     glDeleteVertexArrays(1, &VAO);
 }
 
@@ -1,7 +1,13 @@
 #include "bevel.h"
+#include "shadercache.h"
+#include "textureexporter.h"
+#include "texturepool.h"
+#include "glworker.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 BevelObject::BevelObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float distance, float smooth,
                          bool useAlpha): QQuickFramebufferObject (parent), m_resolution(resolution),
@@ -100,47 +106,11 @@ void BevelObject::setBPC(GLint bpc) {
 BevelRenderer::BevelRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc)
 {
     initializeOpenGLFunctions();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
-    bevelShader = new QOpenGLShaderProgram();
-    bevelShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    bevelShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/beveldisplay.frag");
-    bevelShader->link();
-    preparationShader = new QOpenGLShaderProgram();
-    preparationShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    preparationShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/fillforjfa.frag");
-    preparationShader->link();
-    jfaShader = new QOpenGLShaderProgram();
-    jfaShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    jfaShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/jumpflooding.frag");
-    jfaShader->link();
-    blurShader = new QOpenGLShaderProgram();
-    blurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    blurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/blur.frag");
-    blurShader->link();
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
-    bevelShader->bind();
-    bevelShader->setUniformValue(bevelShader->uniformLocation("dfTexture"), 0);
-    bevelShader->setUniformValue(bevelShader->uniformLocation("maskTexture"), 1);
-    bevelShader->release();
-    preparationShader->bind();
-    preparationShader->setUniformValue(preparationShader->uniformLocation("sourceTexture"), 0);
-    preparationShader->release();
-    jfaShader->bind();
-    jfaShader->setUniformValue(jfaShader->uniformLocation("sourceTexture"), 0);
-    jfaShader->release();
-    blurShader->bind();
-    blurShader->setUniformValue(blurShader->uniformLocation("sourceTexture"), 0);
-    blurShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
                     1.0f, -1.0f, 1.0f, 0.0f,
@@ -157,110 +127,18 @@ BevelRenderer::BevelRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-
-    glGenFramebuffers(1, &FBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
-    glGenTextures(1, &m_initTexture);
-    glBindTexture(GL_TEXTURE_2D, m_initTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 , GL_TEXTURE_2D, m_initTexture, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glGenFramebuffers(1, &bevelFBO);
-    glGenTextures(1, &m_bevelTexture);
-    glBindFramebuffer(GL_FRAMEBUFFER, bevelFBO);    
-    glBindTexture(GL_TEXTURE_2D, m_bevelTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, 2);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_bevelTexture, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glGenFramebuffers(2, jfaFBO);
-    glGenTextures(2, m_jfaTexture);
-    for (unsigned int i = 0; i < 2; i++)
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, jfaFBO[i]);
-        glBindTexture(GL_TEXTURE_2D, m_jfaTexture[i]);
-        if(m_bpc == GL_RGBA16) {
-            glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        }
-        else if(m_bpc == GL_RGBA8) {
-            glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glFramebufferTexture2D(
-            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_jfaTexture[i], 0
-        );
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glGenFramebuffers(2, blurFBO);
-    glGenTextures(2, m_blurTexture);
-    for (unsigned int i = 0; i < 2; i++)
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, blurFBO[i]);
-        glBindTexture(GL_TEXTURE_2D, m_blurTexture[i]);
-        if(m_bpc == GL_RGBA16) {
-            glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        }
-        else if(m_bpc == GL_RGBA8) {
-            glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glFramebufferTexture2D(
-            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_blurTexture[i], 0
-        );
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_kernel = new BevelKernel();
 }
 
 BevelRenderer::~BevelRenderer()
 {
-    delete checkerShader;
-    delete textureShader;
-    delete blurShader;
-    delete bevelShader;
-    delete preparationShader;
-    delete jfaShader;
-    glDeleteTextures(1, &m_bevelTexture);
-    glDeleteTextures(1, &m_initTexture);
-    glDeleteTextures(2, &m_jfaTexture[0]);
-    glDeleteTextures(2, &m_blurTexture[0]);
-    glDeleteFramebuffers(1, &bevelFBO);
-    glDeleteFramebuffers(1, &FBO);
-    glDeleteFramebuffers(2, &jfaFBO[0]);
-    glDeleteFramebuffers(2, &blurFBO[0]);
+    Resampler::release(this);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteVertexArrays(1, &textureVAO);
+    BevelKernel *kernel = m_kernel;
+    kernel->nextGeneration();
+    GLWorker::instance()->post(kernel, [kernel]() { delete kernel; });
 }
 
 QOpenGLFramebufferObject *BevelRenderer::createFramebufferObject(const QSize &size) {
@@ -271,41 +149,45 @@ QOpenGLFramebufferObject *BevelRenderer::createFramebufferObject(const QSize &si
 
 void BevelRenderer::synchronize(QQuickFramebufferObject *item) {
     BevelObject *bevelItem = static_cast<BevelObject*>(item);
+    m_kernel->setItem(item);
     if(bevelItem->resUpdated) {
         bevelItem->resUpdated = false;
         m_resolution = bevelItem->resolution();
-        updateTexResolution();
     }
     if(bevelItem->beveledTex || bevelItem->bpcUpdated) {
         if(bevelItem->bpcUpdated) {
             bevelItem->bpcUpdated = false;
             m_bpc = bevelItem->bpc();
-            updateTexResolution();
         }
         if(bevelItem->beveledTex) {
             bevelItem->beveledTex = false;
-            m_sourceTexture = bevelItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, bevelItem->sourceTexture(), bevelItem->resolution());
             if(m_sourceTexture) {
-                maskTexture = bevelItem->maskTexture();
-                float dist = bevelItem->distance();
-                preparationShader->bind();
-                preparationShader->setUniformValue(preparationShader->uniformLocation("outer"), dist > 0.0f);
-                preparationShader->release();
-                bevelShader->bind();
-                bevelShader->setUniformValue(bevelShader->uniformLocation("dist"), dist);
-                bevelShader->setUniformValue(bevelShader->uniformLocation("useAlpha"), bevelItem->useAlpha());
-                bevelShader->release();
-                blurShader->bind();
-                blurShader->setUniformValue(blurShader->uniformLocation("intensity"), bevelItem->smooth());
-                blurShader->release();
+                maskTexture = Resampler::instance()->resample(this, 1, bevelItem->maskTexture(), bevelItem->resolution());
+                m_distance = bevelItem->distance();
+                m_useAlpha = bevelItem->useAlpha();
+                m_smooth = bevelItem->smooth();
             }
         }
         if(m_sourceTexture) {
-            jumpFlooding();
-            bevelItem->setTexture(m_bevelTexture);
-            bevelItem->updatePreview(m_bevelTexture);
+            BevelKernel *kernel = m_kernel;
+            unsigned int source = m_sourceTexture;
+            unsigned int mask = maskTexture;
+            QVector2D resolution = m_resolution;
+            GLint bpc = m_bpc;
+            float distance = m_distance;
+            float smooth = m_smooth;
+            bool useAlpha = m_useAlpha;
+            int generation = kernel->nextGeneration();
+            GLWorker::instance()->post(kernel, [=]() {
+                kernel->jumpFlooding(source, mask, resolution, bpc, distance, smooth, useAlpha, generation);
+            });
         }
     }
+    if(m_kernel->publish(this)) {
+        bevelItem->setTexture(m_kernel->texture());
+        bevelItem->updatePreview(m_kernel->texture());
+    }
 
     if(bevelItem->texSaving) {
         bevelItem->texSaving = false;
@@ -326,12 +208,12 @@ void BevelRenderer::render() {
     glBindVertexArray(0);
     checkerShader->release();
 
-    if(m_sourceTexture) {
+    if(m_sourceTexture && m_kernel->texture()) {
         textureShader->bind();
         textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glBindVertexArray(textureVAO);
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_bevelTexture);
+        glBindTexture(GL_TEXTURE_2D, m_kernel->texture());
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         glBindVertexArray(0);
         glActiveTexture(GL_TEXTURE0);
@@ -341,150 +223,6 @@ void BevelRenderer::render() {
     glFlush();
 }
 
-void BevelRenderer::jumpFlooding() {
-    //preparation of jfa
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
-    glViewport(0, 0, m_resolution.x(), m_resolution.y());
-    glDisable(GL_DEPTH_TEST);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    preparationShader->bind();
-    glBindVertexArray(textureVAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    preparationShader->release();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    //jfa
-    bool first_iteration = true;
-    int step = m_resolution.x();
-    //int stepsCount = ceil(log2(step));
-    for(int i = 0; i < 10; ++i) {
-        glBindFramebuffer(GL_FRAMEBUFFER, jfaFBO[i%2]);
-        glViewport(0, 0, m_resolution.x(), m_resolution.y());
-        glDisable(GL_DEPTH_TEST);
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        jfaShader->bind();
-        step /= 2;
-        jfaShader->setUniformValue(jfaShader->uniformLocation("step"), step);
-        glBindVertexArray(textureVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, first_iteration ? m_initTexture : m_jfaTexture[1 - i%2]);
-        if(first_iteration) first_iteration = false;
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindVertexArray(0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        jfaShader->release();
-    }
-
-    //dt
-    glBindFramebuffer(GL_FRAMEBUFFER, bevelFBO);
-    glViewport(0, 0, m_resolution.x(), m_resolution.y());
-    glDisable(GL_DEPTH_TEST);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    bevelShader->bind();
-    bevelShader->setUniformValue(bevelShader->uniformLocation("useMask"), maskTexture);
-    glBindVertexArray(textureVAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_jfaTexture[1]);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, maskTexture);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    bevelShader->release();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_bevelTexture);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    //blur
-    first_iteration = true;
-    QVector2D dir = QVector2D(1, 0);
-    for(int i = 0; i < 10; ++i) {
-        glBindFramebuffer(GL_FRAMEBUFFER, blurFBO[i%2]);
-        glViewport(0, 0, m_resolution.x(), m_resolution.y());
-        glDisable(GL_DEPTH_TEST);
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        blurShader->bind();
-        glBindVertexArray(textureVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, first_iteration ? m_bevelTexture : m_blurTexture[1 - i%2]);
-        blurShader->setUniformValue(blurShader->uniformLocation("direction"), dir);
-        dir = QVector2D(1, 1) - dir;
-        blurShader->setUniformValue(blurShader->uniformLocation("resolution"), m_resolution);
-        if(first_iteration) first_iteration = false;
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindVertexArray(0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        blurShader->release();
-    }
-
-    glBindFramebuffer(GL_FRAMEBUFFER, bevelFBO);
-    glViewport(0, 0, m_resolution.x(), m_resolution.y());
-    glDisable(GL_DEPTH_TEST);
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    textureShader->bind();
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 0.0f);
-    glBindVertexArray(textureVAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_blurTexture[1]);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);      
-    textureShader->release();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_bevelTexture);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glFlush();
-    glFinish();
-}
-
-void BevelRenderer::updateTexResolution() {
-    if(m_bpc == GL_RGBA16) {
-        glBindTexture(GL_TEXTURE_2D, m_bevelTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_initTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_jfaTexture[0]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_jfaTexture[1]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_blurTexture[0]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_blurTexture[1]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glBindTexture(GL_TEXTURE_2D, m_bevelTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_initTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_jfaTexture[0]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_jfaTexture[1]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_blurTexture[0]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, m_blurTexture[1]);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-}
-
 void BevelRenderer::saveTexture(QString fileName) {
     unsigned int fbo;
     unsigned int texture;
@@ -492,12 +230,7 @@ void BevelRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -511,51 +244,84 @@ void BevelRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_bevelTexture);
+    glBindTexture(GL_TEXTURE_2D, m_kernel->texture());
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
     textureShader->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        std::cout << "bevel save" << std::endl;
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);    
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
 }
+
+BevelKernel::~BevelKernel() {
+    if(!isInitialized()) return;
+    ShaderCache::release(bevelShader);
+    delete jumpFlood;
+    delete blurEngine;
+}
+
+void BevelKernel::jumpFlooding(unsigned int sourceTexture, unsigned int maskTexture, QVector2D resolution, GLint bpc, float distance, float smooth, bool useAlpha, int generation) {
+    if(initialize()) {
+        bevelShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/beveldisplay.frag");
+        bevelShader->bind();
+        bevelShader->setUniformValue(bevelShader->uniformLocation("dfTexture"), 0);
+        bevelShader->setUniformValue(bevelShader->uniformLocation("maskTexture"), 1);
+        bevelShader->release();
+        jumpFlood = new JumpFlood();
+        blurEngine = new BlurEngine();
+    }
+    if(isCancelled(generation)) return;
+    unsigned int bevelTexture = beginOutput(resolution, bpc);
+    auto cancelled = [this, generation]() { return isCancelled(generation); };
+    TexturePool *pool = TexturePool::instance();
+    TexturePool::Target seeds;
+    if(!jumpFlood->seeds(sourceTexture, resolution, distance > 0.0f, seeds, cancelled)) {
+        abandonOutput();
+        return;
+    }
+
+    //dt
+    TexturePool::Target bevel;
+    if(smooth > 0.0f) bevel = pool->acquire(resolution.x(), resolution.y(), bpc, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, smooth > 0.0f ? bevel.fbo : outputFBO);
+    glViewport(0, 0, resolution.x(), resolution.y());
+    glDisable(GL_DEPTH_TEST);
+    bevelShader->bind();
+    bevelShader->setUniformValue(bevelShader->uniformLocation("dist"), distance);
+    bevelShader->setUniformValue(bevelShader->uniformLocation("useAlpha"), useAlpha);
+    bevelShader->setUniformValue(bevelShader->uniformLocation("useMask"), maskTexture);
+    glBindVertexArray(textureVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, seeds.texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, maskTexture);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    bevelShader->release();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    pool->release(seeds);
+
+    //blur, the former five horizontal and five vertical 5-tap passes add up to a sigma of 3.78 taps
+    if(smooth > 0.0f) {
+        bool blurred = blurEngine->gaussian(bevel.texture, outputFBO, resolution, bpc, 0.00378f*smooth*resolution, 0, GL_REPEAT, cancelled);
+        pool->release(bevel);
+        if(!blurred) {
+            abandonOutput();
+            return;
+        }
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, bevelTexture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    finishOutput();
+}
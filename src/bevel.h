@@ -4,6 +4,9 @@
 #include <QQuickFramebufferObject>
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
+#include "blurengine.h"
+#include "jumpflood.h"
+#include "workerkernel.h"
 
 class BevelObject: public QQuickFramebufferObject
 {
@@ -47,6 +50,17 @@ private:
     bool m_alpha = false;
 };
 
+class BevelKernel: public WorkerKernel
+{
+public:
+    ~BevelKernel();
+    void jumpFlooding(unsigned int sourceTexture, unsigned int maskTexture, QVector2D resolution, GLint bpc, float distance, float smooth, bool useAlpha, int generation);
+private:
+    QOpenGLShaderProgram *bevelShader;
+    JumpFlood *jumpFlood = nullptr;
+    BlurEngine *blurEngine = nullptr;
+};
+
 class BevelRenderer: public QQuickFramebufferObject::Renderer, public QOpenGLFunctions_4_4_Core
 {
 public:
@@ -56,28 +70,18 @@ public:
     void synchronize(QQuickFramebufferObject *item);
     void render();
 private:
-    void jumpFlooding();
-    void updateTexResolution();
     void saveTexture(QString fileName);
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA16;
     unsigned int m_sourceTexture = 0;
-    unsigned int m_initTexture;
-    unsigned int m_jfaTexture[2];
-    unsigned int m_blurTexture[2];
-    unsigned int m_bevelTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
-    unsigned int FBO = 0;
-    unsigned int jfaFBO[2];
-    unsigned int blurFBO[2];
-    unsigned int bevelFBO = 0;
+    float m_distance = 0.0f;
+    float m_smooth = 0.0f;
+    bool m_useAlpha = false;
+    BevelKernel *m_kernel;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
-    QOpenGLShaderProgram *bevelShader;
-    QOpenGLShaderProgram *preparationShader;
-    QOpenGLShaderProgram *jfaShader;
-    QOpenGLShaderProgram *blurShader;
 };
 
 #endif // BEVEL_H
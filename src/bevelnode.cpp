@@ -1,4 +1,5 @@
 #include "bevelnode.h"
+#include "textureformat.h"
 
 BevelNode::BevelNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float distance, float smooth,
                      bool useAlpha): Node(parent, resolution, bpc), m_dist(distance), m_smooth(smooth),
@@ -9,25 +10,27 @@ BevelNode::BevelNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float
     m_socketsInput[0]->setTip("Height");
     m_socketsInput[1]->setTip("Mask");
     preview = new BevelObject(grNode, m_resolution, m_bpc, m_dist, m_smooth, m_alpha);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &BevelObject::textureChanged, this, &BevelNode::setOutput);
     connect(preview, &BevelObject::updatePreview, this, &BevelNode::updatePreview);
     connect(this, &Node::changeResolution, preview, &BevelObject::setResolution);
     connect(this, &Node::changeBPC, preview, &BevelObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/BevelProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+BevelNode::~BevelNode() {
+    delete preview;
+}
+
+void BevelNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/BevelProperty.qml"));
     propertiesPanel->setProperty("startDistance", m_dist);
     propertiesPanel->setProperty("startSmooth", m_smooth);
     propertiesPanel->setProperty("startUseAlpha", m_alpha);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(distanceChanged(qreal)), this, SLOT(updateDistance(qreal)));
     connect(propertiesPanel, SIGNAL(bevelSmoothChanged(qreal)), this, SLOT(updateSmooth(qreal)));
     connect(propertiesPanel, SIGNAL(useAlphaChanged(bool)), this, SLOT(updateUseAlpha(bool)));
@@ -35,26 +38,11 @@ BevelNode::BevelNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-BevelNode::~BevelNode() {
-    delete preview;
-}
-
 void BevelNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &BevelNode::getPreviewTexture() {
@@ -66,7 +54,7 @@ void BevelNode::saveTexture(QString fileName) {
 }
 
 BevelNode *BevelNode::clone() {
-    return new BevelNode(parentItem(), m_resolution, m_bpc, m_dist, m_smooth, m_alpha);
+    return new BevelNode(parentItem(), m_graphResolution, m_bpc, m_dist, m_smooth, m_alpha);
 }
 
 void BevelNode::serialize(QJsonObject &json) const {
@@ -88,16 +76,15 @@ void BevelNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &has
     if(json.contains("useAlpha")) {
         m_alpha = json["useAlpha"].toBool();
     }
-    propertiesPanel->setProperty("startDistance", m_dist);
-    propertiesPanel->setProperty("startSmooth", m_smooth);
-    propertiesPanel->setProperty("startUseAlpha", m_alpha);
+    setPropertyOnPanel("startDistance", m_dist);
+    setPropertyOnPanel("startSmooth", m_smooth);
+    setPropertyOnPanel("startUseAlpha", m_alpha);
 
     preview->setDistance(m_dist);
     preview->setSmooth(m_smooth);
     preview->setUseAlpha(m_alpha);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
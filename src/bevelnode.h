@@ -31,6 +31,8 @@ public slots:
     void updateDistance(qreal dist);
     void updateSmooth(qreal smooth);
     void updateUseAlpha(bool use);
+protected:
+    void createPropertiesPanel() override;
 private:
     BevelObject *preview;
     float m_dist = -0.5f;
@@ -20,8 +20,13 @@
  */
 
 #include "blur.h"
+#include "shadercache.h"
+#include "textureexporter.h"
+#include "glworker.h"
 #include <iostream>
 #include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
 
 BlurObject::BlurObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float intensity):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc), m_intensity(intensity)
@@ -97,25 +102,10 @@ void BlurObject::setBPC(GLint bpc) {
 
 BlurRenderer::BlurRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    blurShader = new QOpenGLShaderProgram();
-    blurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    blurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/blur.frag");
-    blurShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
-    blurShader->bind();
-    blurShader->setUniformValue(blurShader->uniformLocation("sourceTexture"), 0);
-    blurShader->setUniformValue(blurShader->uniformLocation("maskTexture"), 1);
-    blurShader->release();
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -133,44 +123,17 @@ BlurRenderer::BlurRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(b
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-    glGenFramebuffers(2, pingpongFBO);
-    glGenTextures(2, pingpongBuffer);
-    for (unsigned int i = 0; i < 2; i++)
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[i]);
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[i]);
-        if(m_bpc == GL_RGBA8) {
-            glTexImage2D(
-                GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-            );
-        }
-        else if(m_bpc == GL_RGBA16) {
-            glTexImage2D(
-                GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-            );
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, 2);
-        glFramebufferTexture2D(
-            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pingpongBuffer[i], 0
-        );
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_kernel = new BlurKernel();
 }
 
 BlurRenderer::~BlurRenderer() {
-    delete blurShader;
-    delete checkerShader;
-    delete textureShader;
-    glDeleteTextures(2, &pingpongBuffer[0]);
-    glDeleteFramebuffers(2, &pingpongFBO[0]);
+    Resampler::release(this);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteVertexArrays(1, &textureVAO);
+    BlurKernel *kernel = m_kernel;
+    kernel->nextGeneration();
+    GLWorker::instance()->post(kernel, [kernel]() { delete kernel; });
 }
 
 QOpenGLFramebufferObject *BlurRenderer::createFramebufferObject(const QSize &size) {
@@ -181,33 +144,41 @@ QOpenGLFramebufferObject *BlurRenderer::createFramebufferObject(const QSize &siz
 
 void BlurRenderer::synchronize(QQuickFramebufferObject *item) {
     BlurObject *blurItem = static_cast<BlurObject*>(item);
+    m_kernel->setItem(item);
     if(blurItem->resUpdated) {
         blurItem->resUpdated = false;
         m_resolution = blurItem->resolution();
-        updateTexResolution();
     }
     if(blurItem->bluredTex || blurItem->bpcUpdated) {
         if(blurItem->bpcUpdated) {
             blurItem->bpcUpdated = false;
             m_bpc = blurItem->bpc();
-            updateTexResolution();
         }
         if(blurItem->bluredTex) {
             blurItem->bluredTex = false;
-            m_sourceTexture = blurItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, blurItem->sourceTexture(), blurItem->resolution());
             if(m_sourceTexture) {
-                maskTexture = blurItem->maskTexture();
-                blurShader->bind();
-                blurShader->setUniformValue(blurShader->uniformLocation("intensity"), blurItem->intensity());
-                blurShader->release();
+                maskTexture = Resampler::instance()->resample(this, 1, blurItem->maskTexture(), blurItem->resolution());
+                m_intensity = blurItem->intensity();
             }
         }
         if(m_sourceTexture) {
-            createBlur();
-            blurItem->setTexture(pingpongBuffer[1]);
-            blurItem->updatePreview(pingpongBuffer[1]);
+            BlurKernel *kernel = m_kernel;
+            unsigned int source = m_sourceTexture;
+            unsigned int mask = maskTexture;
+            QVector2D resolution = m_resolution;
+            GLint bpc = m_bpc;
+            float intensity = m_intensity;
+            int generation = kernel->nextGeneration();
+            GLWorker::instance()->post(kernel, [=]() {
+                kernel->createBlur(source, mask, resolution, bpc, intensity, generation);
+            });
         }
     }
+    if(m_kernel->publish(this)) {
+        blurItem->setTexture(m_kernel->texture());
+        blurItem->updatePreview(m_kernel->texture());
+    }
     if(blurItem->texSaving) {
         blurItem->texSaving = false;
         saveTexture(blurItem->saveName);
@@ -227,11 +198,12 @@ void BlurRenderer::render() {
     glBindVertexArray(0);
     checkerShader->release();
 
-    if(m_sourceTexture) {
+    if(m_sourceTexture && m_kernel->texture()) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[1]);
+        glBindTexture(GL_TEXTURE_2D, m_kernel->texture());
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         glBindTexture(GL_TEXTURE_2D, 0);
         textureShader->release();
@@ -241,73 +213,6 @@ void BlurRenderer::render() {
 
 }
 
-void BlurRenderer::createBlur() {
-    bool first_iteration = true;
-    QVector2D dir = QVector2D(1, 0);
-    int amount = 50;
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, maskTexture);
-    for (unsigned int i = 0; i < amount; i++)
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[i%2]);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(
-            GL_TEXTURE_2D, first_iteration ? m_sourceTexture : pingpongBuffer[1 - (i%2)]
-        );
-
-        glViewport(0, 0, m_resolution.x(), m_resolution.y());
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glBindVertexArray(textureVAO);
-        blurShader->bind();
-        blurShader->setUniformValue(blurShader->uniformLocation("useMask"), false);
-        blurShader->setUniformValue(blurShader->uniformLocation("direction"), dir);
-        dir = QVector2D(1, 1) - dir;
-        blurShader->setUniformValue(blurShader->uniformLocation("resolution"), m_resolution);
-        if(i == amount - 1) blurShader->setUniformValue(blurShader->uniformLocation("useMask"), maskTexture);
-
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        blurShader->release();
-        glBindVertexArray(0);
-        if (first_iteration)
-            first_iteration = false;
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[i%2]);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-
-    glFlush();
-    glFinish();
-}
-
-void BlurRenderer::updateTexResolution() {
-    if(m_bpc == GL_RGBA8) {
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[0]);
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[1]);
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[0]);
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[1]);
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-}
-
 void BlurRenderer::saveTexture(QString fileName) {
     qDebug("texture save");
     unsigned int fbo;
@@ -316,12 +221,7 @@ void BlurRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -336,49 +236,36 @@ void BlurRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, pingpongBuffer[1]);
+    glBindTexture(GL_TEXTURE_2D, m_kernel->texture());
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindTexture(GL_TEXTURE_2D, 0);
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
 }
+
+BlurKernel::~BlurKernel() {
+    delete blurEngine;
+}
+
+void BlurKernel::createBlur(unsigned int sourceTexture, unsigned int maskTexture, QVector2D resolution, GLint bpc, float intensity, int generation) {
+    if(initialize()) blurEngine = new BlurEngine();
+    if(isCancelled(generation)) return;
+    unsigned int texture = beginOutput(resolution, bpc);
+    //same spread as the former 50 separable passes of the 5-tap kernel
+    if(!blurEngine->gaussian(sourceTexture, outputFBO, resolution, bpc, 0.00818f*intensity*resolution, maskTexture, GL_REPEAT,
+                             [this, generation]() { return isCancelled(generation); })) {
+        abandonOutput();
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    finishOutput();
+}
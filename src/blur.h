@@ -26,6 +26,8 @@
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
 #include "FreeImage.h"
+#include "blurengine.h"
+#include "workerkernel.h"
 
 class BlurObject: public QQuickFramebufferObject
 {
@@ -64,6 +66,15 @@ private:
     float m_intensity = 0.5f;
 };
 
+class BlurKernel: public WorkerKernel
+{
+public:
+    ~BlurKernel();
+    void createBlur(unsigned int sourceTexture, unsigned int maskTexture, QVector2D resolution, GLint bpc, float intensity, int generation);
+private:
+    BlurEngine *blurEngine = nullptr;
+};
+
 class BlurRenderer: public QQuickFramebufferObject::Renderer, public QOpenGLFunctions_4_4_Core {
 public:
     BlurRenderer(QVector2D res, GLint bpc);
@@ -72,17 +83,14 @@ public:
     void synchronize(QQuickFramebufferObject *item);
     void render();
 private:
-    void createBlur();
-    void updateTexResolution();
     void saveTexture(QString fileName);
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
-    unsigned int pingpongFBO[2];
-    unsigned int pingpongBuffer[2];
     unsigned int m_sourceTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
-    QOpenGLShaderProgram *blurShader;
+    float m_intensity = 1.0f;
+    BlurKernel *m_kernel;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
 };
@@ -0,0 +1,192 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "blurengine.h"
+#include "shadercache.h"
+#include "texturepool.h"
+#include <QtMath>
+
+BlurEngine::BlurEngine() {
+    initializeOpenGLFunctions();
+    blurShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/gaussianblur.frag");
+    blurShader->bind();
+    blurShader->setUniformValue(blurShader->uniformLocation("sourceTexture"), 0);
+    blurShader->setUniformValue(blurShader->uniformLocation("maskTexture"), 1);
+    blurShader->release();
+    float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
+                    -1.0f, 1.0f, 0.0f, 1.0f,
+                    1.0f, -1.0f, 1.0f, 0.0f,
+                    1.0f, 1.0f, 1.0f, 1.0f};
+    unsigned int VBO;
+    glGenVertexArrays(1, &textureVAO);
+    glBindVertexArray(textureVAO);
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertQuadTex), vertQuadTex, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), nullptr);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glGenSamplers(1, &sampler);
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+BlurEngine::~BlurEngine() {
+    ShaderCache::release(blurShader);
+    glDeleteVertexArrays(1, &textureVAO);
+    glDeleteSamplers(1, &sampler);
+}
+
+bool BlurEngine::gaussian(unsigned int source, unsigned int targetFBO, QVector2D resolution, GLenum format, QVector2D sigma, unsigned int mask, GLint wrap, std::function<bool()> cancelled) {
+    //box downsampling and bilinear upsampling through n levels add (4^n - 1)/3 px^2 of variance,
+    //the rest is a separable gaussian of 1.5-3 texels at the smallest level
+    int width = resolution.x();
+    int height = resolution.y();
+    float minSigma = qMin(sigma.x(), sigma.y());
+    int levels = 0;
+    while(levels < 8 && (width >> (levels + 1)) >= 8 && (height >> (levels + 1)) >= 8) {
+        float scale = 1 << 2*(levels + 1);
+        if(minSigma*minSigma < 2.25f*scale + (scale - 1.0f)/3.0f) break;
+        ++levels;
+    }
+    float scale = 1 << 2*levels;
+    float pyramidVariance = (scale - 1.0f)/3.0f;
+    float sigmaX = qSqrt(qMax(0.0f, sigma.x()*sigma.x() - pyramidVariance)/scale);
+    float sigmaY = qSqrt(qMax(0.0f, sigma.y()*sigma.y() - pyramidVariance)/scale);
+
+    m_cancelled = cancelled;
+    m_abandoned = false;
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_BLEND);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrap);
+    glBindSampler(0, sampler);
+
+    TexturePool *pool = TexturePool::instance();
+    QList<TexturePool::Target> pyramid;
+    unsigned int current = source;
+    int w = width;
+    int h = height;
+    for(int i = 0; i < levels; ++i) {
+        w = qMax(1, w/2);
+        h = qMax(1, h/2);
+        TexturePool::Target level = pool->acquire(w, h, format, GL_LINEAR);
+        pass(current, level.fbo, w, h, QVector2D(), 0.0f);
+        current = level.texture;
+        pyramid.append(level);
+    }
+    TexturePool::Target temp = pool->acquire(w, h, format, GL_LINEAR);
+    pass(current, temp.fbo, w, h, QVector2D(1.0f/w, 0.0f), sigmaX);
+    if(levels == 0) {
+        pass(temp.texture, targetFBO, w, h, QVector2D(0.0f, 1.0f/h), sigmaY, mask);
+    }
+    else {
+        pass(temp.texture, pyramid.last().fbo, w, h, QVector2D(0.0f, 1.0f/h), sigmaY);
+        for(int i = levels - 1; i > 0; --i) {
+            pass(pyramid[i].texture, pyramid[i - 1].fbo, pyramid[i - 1].width, pyramid[i - 1].height, QVector2D(), 0.0f);
+        }
+        pass(pyramid.first().texture, targetFBO, width, height, QVector2D(), 0.0f, mask);
+    }
+    pool->release(temp);
+    for(auto &level: pyramid) {
+        pool->release(level);
+    }
+
+    glBindSampler(0, 0);
+    if(blend) glEnable(GL_BLEND);
+    m_cancelled = nullptr;
+    return !m_abandoned;
+}
+
+bool BlurEngine::directional(unsigned int source, unsigned int targetFBO, QVector2D resolution, GLenum format, QVector2D offset, unsigned int mask, GLint wrap, std::function<bool()> cancelled) {
+    //each pass doubles the tap spacing, so the tap count stays bounded at any length
+    float sigma = offset.length();
+    QVector2D step = sigma > 0.0f ? offset/sigma/resolution : QVector2D();
+    QList<QPair<float, float>> passes;
+    float variance = sigma*sigma;
+    float spacing = 1.0f;
+    while(variance > 16.0f*spacing*spacing) {
+        passes.append(qMakePair(spacing, 2.0f));
+        variance -= 4.0f*spacing*spacing;
+        spacing *= 2.0f;
+    }
+    passes.append(qMakePair(spacing, qSqrt(variance)/spacing));
+
+    m_cancelled = cancelled;
+    m_abandoned = false;
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_BLEND);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrap);
+    glBindSampler(0, sampler);
+
+    TexturePool *pool = TexturePool::instance();
+    TexturePool::Target pingpong[2];
+    for(int i = 0; i < qMin(passes.size() - 1, 2); ++i) {
+        pingpong[i] = pool->acquire(resolution.x(), resolution.y(), format, GL_LINEAR);
+    }
+    unsigned int current = source;
+    for(int i = 0; i < passes.size(); ++i) {
+        QVector2D direction = step*passes[i].first;
+        if(i == passes.size() - 1) {
+            pass(current, targetFBO, resolution.x(), resolution.y(), direction, passes[i].second, mask);
+        }
+        else {
+            pass(current, pingpong[i%2].fbo, resolution.x(), resolution.y(), direction, passes[i].second);
+            current = pingpong[i%2].texture;
+        }
+    }
+    pool->release(pingpong[0]);
+    pool->release(pingpong[1]);
+
+    glBindSampler(0, 0);
+    if(blend) glEnable(GL_BLEND);
+    m_cancelled = nullptr;
+    return !m_abandoned;
+}
+
+void BlurEngine::pass(unsigned int source, unsigned int targetFBO, int width, int height, QVector2D direction, float sigma, unsigned int mask) {
+    //once superseded the remaining passes are skipped, the callers still return their targets
+    if(m_abandoned || (m_cancelled && m_cancelled())) {
+        m_abandoned = true;
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glViewport(0, 0, width, height);
+    blurShader->bind();
+    blurShader->setUniformValue(blurShader->uniformLocation("direction"), direction);
+    blurShader->setUniformValue(blurShader->uniformLocation("sigma"), sigma);
+    blurShader->setUniformValue(blurShader->uniformLocation("radius"), sigma > 0.0f ? qMin(qCeil(3.0f*sigma), 32) : 0);
+    blurShader->setUniformValue(blurShader->uniformLocation("useMask"), mask != 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mask);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glBindVertexArray(textureVAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    blurShader->release();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
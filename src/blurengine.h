@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLURENGINE_H
+#define BLURENGINE_H
+
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLShaderProgram>
+#include <QVector2D>
+#include <functional>
+
+class BlurEngine: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    BlurEngine();
+    ~BlurEngine();
+    bool gaussian(unsigned int source, unsigned int targetFBO, QVector2D resolution, GLenum format, QVector2D sigma, unsigned int mask = 0, GLint wrap = GL_REPEAT, std::function<bool()> cancelled = nullptr);
+    bool directional(unsigned int source, unsigned int targetFBO, QVector2D resolution, GLenum format, QVector2D offset, unsigned int mask = 0, GLint wrap = GL_REPEAT, std::function<bool()> cancelled = nullptr);
+private:
+    void pass(unsigned int source, unsigned int targetFBO, int width, int height, QVector2D direction, float sigma, unsigned int mask = 0);
+    QOpenGLShaderProgram *blurShader;
+    unsigned int textureVAO = 0;
+    unsigned int sampler = 0;
+    std::function<bool()> m_cancelled;
+    bool m_abandoned = false;
+};
+
+#endif // BLURENGINE_H
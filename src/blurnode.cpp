@@ -21,32 +21,22 @@
 
 #include "blurnode.h"
 #include <iostream>
+#include "textureformat.h"
 
 BlurNode::BlurNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float intensity):
     Node(parent, resolution, bpc), m_intensity(intensity)
 {
     preview = new BlurObject(grNode, m_resolution, m_bpc, m_intensity);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &BlurNode::previewGenerated);
     connect(preview, &BlurObject::textureChanged, this, &BlurNode::setOutput);
     connect(this, &Node::changeResolution, preview, &BlurObject::setResolution);
     connect(this, &Node::changeBPC, preview, &BlurObject::setBPC);
     connect(preview, &BlurObject::updatePreview, this, &BlurNode::updatePreview);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/BlurProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    propertiesPanel->setProperty("startIntensity", m_intensity);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(intensityChanged(qreal)), this, SLOT(updateIntensity(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(2, 1);
     setTitle("Blur");
     m_socketsInput[0]->setTip("Texture");
@@ -57,24 +47,24 @@ BlurNode::~BlurNode() {
     delete preview;
 }
 
+void BlurNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/BlurProperty.qml"));
+    propertiesPanel->setProperty("startIntensity", m_intensity);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(intensityChanged(qreal)), this, SLOT(updateIntensity(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void BlurNode::operation() {
     preview->selectedItem = selected();
     if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
         std::cout << "blur socket 0 " << m_socketsInput[0]->value().toUInt() << std::endl;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
     }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &BlurNode::getPreviewTexture() {
@@ -86,7 +76,7 @@ void BlurNode::saveTexture(QString fileName) {
 }
 
 BlurNode *BlurNode::clone() {
-    return new BlurNode(parentItem(), m_resolution, m_bpc, m_intensity);
+    return new BlurNode(parentItem(), m_graphResolution, m_bpc, m_intensity);
 }
 
 void BlurNode::serialize(QJsonObject &json) const {
@@ -99,13 +89,12 @@ void BlurNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash
     Node::deserialize(json, hash);
     if(json.contains("intensity")) {
         m_intensity = json["intensity"].toVariant().toFloat();
-        propertiesPanel->setProperty("startIntensity", m_intensity);
+        setPropertyOnPanel("startIntensity", m_intensity);
     }
 
     preview->setIntensity(m_intensity);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -45,6 +45,8 @@ public slots:
     void previewGenerated();
     void setOutput();
     void updateIntensity(qreal intensity);
+protected:
+    void createPropertiesPanel() override;
 private:
     BlurObject *preview;
     float m_intensity = 0.5f;
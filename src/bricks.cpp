@@ -1,7 +1,11 @@
 #include "bricks.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 BricksObject::BricksObject(QQuickItem *parent, QVector2D resolution, GLint bpc, int columns, int rows,
                            float offset, float width, float height, float smoothX, float smoothY,
@@ -151,25 +155,15 @@ void BricksObject::setBPC(GLint bpc) {
 
 BricksRenderer::BricksRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    bricksShader = new QOpenGLShaderProgram();
-    bricksShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    bricksShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/bricks.frag");
-    bricksShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    bricksShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/bricks.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     bricksShader->bind();
     bricksShader->setUniformValue(bricksShader->uniformLocation("maskTexture"), 0);
     bricksShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -191,16 +185,7 @@ BricksRenderer::BricksRenderer(QVector2D res, GLint bpc): m_resolution(res), m_b
     glGenTextures(1, &m_bricksTexture);
     glBindFramebuffer(GL_FRAMEBUFFER, bricksFBO);
     glBindTexture(GL_TEXTURE_2D, m_bricksTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -216,9 +201,10 @@ BricksRenderer::BricksRenderer(QVector2D res, GLint bpc): m_resolution(res), m_b
 }
 
 BricksRenderer::~BricksRenderer() {
-    delete bricksShader;
-    delete textureShader;
-    delete checkerShader;
+    Resampler::release(this);
+    ShaderCache::release(bricksShader);
+    ShaderCache::release(textureShader);
+    ShaderCache::release(checkerShader);
     glDeleteTextures(1, &m_bricksTexture);
     glDeleteFramebuffers(1, &bricksFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -240,18 +226,16 @@ void BricksRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(bricksItem->generatedTex) {
             bricksItem->generatedTex = false;
-            m_maskTexture = bricksItem->maskTexture();
-            bricksShader->bind();
-            bricksShader->setUniformValue(bricksShader->uniformLocation("columns"), bricksItem->columns());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("rows"), bricksItem->rows());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("offset"), bricksItem->offset());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("width"), bricksItem->bricksWidth());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("height"), bricksItem->bricksHeight());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("maskStrength"), bricksItem->mask());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("smoothX"), bricksItem->smoothX());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("smoothY"), bricksItem->smoothY());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("seed"), bricksItem->seed());
-            bricksShader->setUniformValue(bricksShader->uniformLocation("useMask"), m_maskTexture);
+            m_maskTexture = Resampler::instance()->resample(this, 0, bricksItem->maskTexture(), bricksItem->resolution());
+            m_columns = bricksItem->columns();
+            m_rows = bricksItem->rows();
+            m_offset = bricksItem->offset();
+            m_width = bricksItem->bricksWidth();
+            m_height = bricksItem->bricksHeight();
+            m_maskStrength = bricksItem->mask();
+            m_smoothX = bricksItem->smoothX();
+            m_smoothY = bricksItem->smoothY();
+            m_seed = bricksItem->seed();
         }
         createBricks();
         bricksItem->setTexture(m_bricksTexture);
@@ -287,6 +271,7 @@ void BricksRenderer::render() {
 
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_bricksTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -307,6 +292,16 @@ void BricksRenderer::createBricks() {
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_maskTexture);
     bricksShader->bind();
+    bricksShader->setUniformValue(bricksShader->uniformLocation("columns"), m_columns);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("rows"), m_rows);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("offset"), m_offset);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("width"), m_width);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("height"), m_height);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("maskStrength"), m_maskStrength);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("smoothX"), m_smoothX);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("smoothY"), m_smoothY);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("seed"), m_seed);
+    bricksShader->setUniformValue(bricksShader->uniformLocation("useMask"), m_maskTexture);
     bricksShader->setUniformValue(bricksShader->uniformLocation("res"), m_resolution);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     bricksShader->release();
@@ -321,16 +316,7 @@ void BricksRenderer::createBricks() {
 
 void BricksRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_bricksTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -341,12 +327,7 @@ void BricksRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -361,6 +342,7 @@ void BricksRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_bricksTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -368,41 +350,7 @@ void BricksRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
@@ -79,6 +79,15 @@ private:
     unsigned int m_bricksTexture = 0;
     unsigned int m_maskTexture = 0;
     unsigned int textureVAO = 0;
+    int m_columns = 0;
+    int m_rows = 0;
+    float m_offset = 0.0f;
+    float m_width = 0.0f;
+    float m_height = 0.0f;
+    float m_maskStrength = 0.0f;
+    float m_smoothX = 0.0f;
+    float m_smoothY = 0.0f;
+    int m_seed = 0;
     QOpenGLShaderProgram *bricksShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
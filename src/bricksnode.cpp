@@ -1,4 +1,5 @@
 #include "bricksnode.h"
+#include "textureformat.h"
 
 BricksNode::BricksNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int columns, int rows,
                        float offset, float width, float height, float smoothX, float smoothY, float mask,
@@ -11,21 +12,24 @@ BricksNode::BricksNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int
     setTitle("Bricks");
     preview = new BricksObject(grNode, m_resolution, m_bpc, m_columns, m_rows, m_offset, m_width, m_height,
                                m_smoothX, m_smoothY, m_mask, m_seed);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &BricksObject::changedTexture, this, &BricksNode::setOutput);
     connect(preview, &BricksObject::updatePreview, this, &Node::updatePreview);
     connect(this, &Node::changeResolution, preview, &BricksObject::setResolution);
     connect(this, &Node::changeBPC, preview, &BricksObject::setBPC);
     connect(this, &Node::generatePreview, this, &BricksNode::previewGenerated);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/BricksProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+BricksNode::~BricksNode() {
+    delete preview;
+}
+
+void BricksNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/BricksProperty.qml"));
     propertiesPanel->setProperty("startColumns", m_columns);
     propertiesPanel->setProperty("startRows", m_rows);
     propertiesPanel->setProperty("startOffset", m_offset);
@@ -35,8 +39,7 @@ BricksNode::BricksNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int
     propertiesPanel->setProperty("startSmothY", m_smoothY);
     propertiesPanel->setProperty("startMask", m_mask);
     propertiesPanel->setProperty("startSeed", m_seed);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(columnsChanged(int)), this, SLOT(updateColumns(int)));
     connect(propertiesPanel, SIGNAL(rowsChanged(int)), this, SLOT(updateRows(int)));
     connect(propertiesPanel, SIGNAL(offsetChanged(qreal)), this, SLOT(updateOffset(qreal)));
@@ -50,10 +53,6 @@ BricksNode::BricksNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-BricksNode::~BricksNode() {
-    delete preview;
-}
-
 unsigned int &BricksNode::getPreviewTexture() {
     return preview->texture();
 }
@@ -63,18 +62,12 @@ void BricksNode::saveTexture(QString fileName) {
 }
 
 void BricksNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
     preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 BricksNode *BricksNode::clone() {
-    return new BricksNode(parentItem(), m_resolution, m_bpc, m_columns, m_rows, m_offset, m_width, m_height,
+    return new BricksNode(parentItem(), m_graphResolution, m_bpc, m_columns, m_rows, m_offset, m_width, m_height,
                           m_smoothX, m_smoothY, m_mask, m_seed);
 }
 
@@ -121,15 +114,15 @@ void BricksNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &ha
     if(json.contains("seed")) {
         m_seed = json["seed"].toInt();
     }
-    propertiesPanel->setProperty("startColumns", m_columns);
-    propertiesPanel->setProperty("startRows", m_rows);
-    propertiesPanel->setProperty("startOffset", m_offset);
-    propertiesPanel->setProperty("startWidth", m_width);
-    propertiesPanel->setProperty("startHeight", m_height);
-    propertiesPanel->setProperty("startSmoothX", m_smoothX);
-    propertiesPanel->setProperty("startSmothY", m_smoothY);
-    propertiesPanel->setProperty("startMask", m_mask);
-    propertiesPanel->setProperty("startSeed", m_seed);
+    setPropertyOnPanel("startColumns", m_columns);
+    setPropertyOnPanel("startRows", m_rows);
+    setPropertyOnPanel("startOffset", m_offset);
+    setPropertyOnPanel("startWidth", m_width);
+    setPropertyOnPanel("startHeight", m_height);
+    setPropertyOnPanel("startSmoothX", m_smoothX);
+    setPropertyOnPanel("startSmothY", m_smoothY);
+    setPropertyOnPanel("startMask", m_mask);
+    setPropertyOnPanel("startSeed", m_seed);
 
     preview->setColumns(m_columns);
     preview->setRows(m_rows);
@@ -141,8 +134,7 @@ void BricksNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &ha
     preview->setMask(m_mask);
     preview->setSeed(m_seed);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -56,6 +56,8 @@ public slots:
     void updateSmoothY(qreal smooth);
     void updateSeed(int seed);
     void previewGenerated();
+protected:
+    void createPropertiesPanel() override;
 private:
     BricksObject *preview;
     int m_columns = 5;
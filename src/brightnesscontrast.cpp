@@ -20,8 +20,12 @@
  */
 
 #include "brightnesscontrast.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <iostream>
 #include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
 
 BrightnessContrastObject::BrightnessContrastObject(QQuickItem *parent, QVector2D resolution, GLint bpc,
                                                    float brightness, float contrast):
@@ -53,6 +57,14 @@ void BrightnessContrastObject::setSourceTexture(unsigned int texture) {
     update();
 }
 
+QList<PointStage> BrightnessContrastObject::stages() {
+    return m_stages;
+}
+
+void BrightnessContrastObject::setStages(const QList<PointStage> &stages) {
+    m_stages = stages;
+}
+
 void BrightnessContrastObject::saveTexture(QString fileName) {
     texSaving = true;
     saveName = fileName;
@@ -102,24 +114,14 @@ void BrightnessContrastObject::setBPC(GLint bpc) {
 BrightnessContrastRenderer::BrightnessContrastRenderer(QVector2D res, GLint bpc): m_resolution(res),
     m_bpc(bpc) {
     initializeOpenGLFunctions();
-    brightnessContrastShader = new QOpenGLShaderProgram();
-    brightnessContrastShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    brightnessContrastShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/brightnesscontrast.frag");
-    brightnessContrastShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    brightnessContrastShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/brightnesscontrast.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     brightnessContrastShader->bind();
     brightnessContrastShader->setUniformValue(brightnessContrastShader->uniformLocation("sourceTexture"), 0);
     brightnessContrastShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                            -1.0f, 1.0f, 0.0f, 1.0f,
@@ -142,16 +144,7 @@ BrightnessContrastRenderer::BrightnessContrastRenderer(QVector2D res, GLint bpc)
     glBindFramebuffer(GL_FRAMEBUFFER, brightnessContrastFBO);
     glGenTextures(1, &m_brightnessContrastTexture);
     glBindTexture(GL_TEXTURE_2D, m_brightnessContrastTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -165,9 +158,10 @@ BrightnessContrastRenderer::BrightnessContrastRenderer(QVector2D res, GLint bpc)
 }
 
 BrightnessContrastRenderer::~BrightnessContrastRenderer() {
-    delete brightnessContrastShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(brightnessContrastShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_brightnessContrastTexture);
     glDeleteFramebuffers(1, &brightnessContrastFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -194,15 +188,14 @@ void BrightnessContrastRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(brightnessContrastItem->created) {
             brightnessContrastItem->created = false;
-            m_sourceTexture = brightnessContrastItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, brightnessContrastItem->sourceTexture(), brightnessContrastItem->resolution());
+            m_stages = brightnessContrastItem->stages();
             if(m_sourceTexture) {
-                brightnessContrastShader->bind();
-                brightnessContrastShader->setUniformValue(brightnessContrastShader->uniformLocation("brightness"), brightnessContrastItem->brightness());
-                brightnessContrastShader->setUniformValue(brightnessContrastShader->uniformLocation("contrast"), brightnessContrastItem->contrast());
-                brightnessContrastShader->release();
+                m_brightness = brightnessContrastItem->brightness();
+                m_contrast = brightnessContrastItem->contrast();
             }
         }
-        if(m_sourceTexture) {
+        if(m_sourceTexture && !brightnessContrastItem->fused) {
             create();
             brightnessContrastItem->setTexture(m_brightnessContrastTexture);
             brightnessContrastItem->updatePreview(m_brightnessContrastTexture);
@@ -230,6 +223,7 @@ void BrightnessContrastRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_brightnessContrastTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -241,12 +235,24 @@ void BrightnessContrastRenderer::render() {
 }
 
 void BrightnessContrastRenderer::create() {
+    if(!m_stages.isEmpty()) {
+        QList<PointStage> stages = m_stages;
+        stages.append(PointStage::brightnessContrast(m_brightness, m_contrast));
+        pointChain.render(stages, m_sourceTexture, brightnessContrastFBO, m_resolution);
+        glBindTexture(GL_TEXTURE_2D, m_brightnessContrastTexture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFlush();
+        return;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, brightnessContrastFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     brightnessContrastShader->bind();
+    brightnessContrastShader->setUniformValue(brightnessContrastShader->uniformLocation("brightness"), m_brightness);
+    brightnessContrastShader->setUniformValue(brightnessContrastShader->uniformLocation("contrast"), m_contrast);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);    
@@ -257,21 +263,11 @@ void BrightnessContrastRenderer::create() {
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     glFlush();
-    glFinish();
 }
 
 void BrightnessContrastRenderer::updateTexResolution(){
     glBindTexture(GL_TEXTURE_2D, m_brightnessContrastTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -283,12 +279,7 @@ void BrightnessContrastRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -303,6 +294,7 @@ void BrightnessContrastRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_brightnessContrastTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -310,41 +302,7 @@ void BrightnessContrastRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
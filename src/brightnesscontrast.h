@@ -26,6 +26,7 @@
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
 #include "FreeImage.h"
+#include "pointchain.h"
 
 class BrightnessContrastObject: public QQuickFramebufferObject
 {
@@ -37,6 +38,8 @@ public:
     void setTexture(unsigned int texture);
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
+    QList<PointStage> stages();
+    void setStages(const QList<PointStage> &stages);
     void saveTexture(QString fileName);
     float brightness();
     void setBrightness(float value);
@@ -50,6 +53,7 @@ public:
     bool selectedItem = false;
     bool resUpdated = false;
     bool bpcUpdated = false;
+    bool fused = false;
     bool texSaving = false;
     QString saveName = "";
 signals:
@@ -58,6 +62,7 @@ signals:
 private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
+    QList<PointStage> m_stages;
     unsigned int m_sourceTexture = 0;
     unsigned int m_texture = 0;
     float m_brightness = 0.0f;
@@ -79,8 +84,12 @@ private:
     GLint m_bpc = GL_RGBA8;
     unsigned int brightnessContrastFBO;
     unsigned int m_brightnessContrastTexture = 0;
+    QList<PointStage> m_stages;
+    PointChain pointChain;
     unsigned int m_sourceTexture = 0;
     unsigned int textureVAO = 0;
+    float m_brightness = 0.0f;
+    float m_contrast = 0.0f;
     QOpenGLShaderProgram *brightnessContrastShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
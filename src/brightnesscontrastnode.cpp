@@ -20,35 +20,23 @@
  */
 
 #include "brightnesscontrastnode.h"
+#include "textureformat.h"
 
 BrightnessContrastNode::BrightnessContrastNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
                                                float brightness, float contrast):
     Node(parent, resolution, bpc), m_brightness(brightness), m_contrast(contrast)
 {
     preview = new BrightnessContrastObject(grNode, m_resolution, m_bpc, m_brightness, m_contrast);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &BrightnessContrastNode::previewGenerated);
     connect(preview, &BrightnessContrastObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &BrightnessContrastObject::textureChanged, this, &BrightnessContrastNode::setOutput);
     connect(this, &Node::changeResolution, preview, &BrightnessContrastObject::setResolution);
     connect(this, &Node::changeBPC, preview, &BrightnessContrastObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/BrightnessContrastProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    propertiesPanel->setProperty("startBrightness", m_brightness);
-    propertiesPanel->setProperty("startContrast", m_contrast);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(brightnessChanged(qreal)), this, SLOT(updateBrightness(qreal)));
-    connect(propertiesPanel, SIGNAL(contrastChanged(qreal)), this, SLOT(updateContrast(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(1, 1);
     setTitle("Brightness-Contrast");
     m_socketsInput[0]->setTip("Texture");
@@ -58,15 +46,23 @@ BrightnessContrastNode::~BrightnessContrastNode() {
     delete preview;
 }
 
+void BrightnessContrastNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/BrightnessContrastProperty.qml"));
+    propertiesPanel->setProperty("startBrightness", m_brightness);
+    propertiesPanel->setProperty("startContrast", m_contrast);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(brightnessChanged(qreal)), this, SLOT(updateBrightness(qreal)));
+    connect(propertiesPanel, SIGNAL(contrastChanged(qreal)), this, SLOT(updateContrast(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void BrightnessContrastNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    QList<PointStage> stages;
+    unsigned int source = fusedSource(stages);
+    preview->setStages(stages);
+    preview->setSourceTexture(source);
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
-    deserializing = false;
 }
 
 unsigned int &BrightnessContrastNode::getPreviewTexture() {
@@ -77,8 +73,18 @@ void BrightnessContrastNode::saveTexture(QString fileName) {
     preview->saveTexture(fileName);
 }
 
+bool BrightnessContrastNode::pointStage(PointStage &stage) {
+    stage = PointStage::brightnessContrast(m_brightness, m_contrast);
+    return true;
+}
+
+void BrightnessContrastNode::setFused(bool fused) {
+    Node::setFused(fused);
+    preview->fused = fused;
+}
+
 BrightnessContrastNode *BrightnessContrastNode::clone() {
-    return new BrightnessContrastNode(parentItem(), m_resolution, m_bpc, m_brightness, m_contrast);
+    return new BrightnessContrastNode(parentItem(), m_graphResolution, m_bpc, m_brightness, m_contrast);
 }
 
 void BrightnessContrastNode::serialize(QJsonObject &json) const {
@@ -92,18 +98,17 @@ void BrightnessContrastNode::deserialize(const QJsonObject &json, QHash<QUuid, S
     Node::deserialize(json, hash);
     if(json.contains("brightness")) {
         updateBrightness(json["brightness"].toVariant().toReal());
-        propertiesPanel->setProperty("startBrightness", m_brightness);
+        setPropertyOnPanel("startBrightness", m_brightness);
     }
     if(json.contains("contrast")) {
         updateContrast(json["contrast"].toVariant().toReal());
-        propertiesPanel->setProperty("startContrast", m_contrast);
+        setPropertyOnPanel("startContrast", m_contrast);
     }
 
     preview->setBrightness(m_brightness);
     preview->setContrast(m_contrast);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
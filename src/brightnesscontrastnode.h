@@ -34,6 +34,8 @@ public:
     void operation() override;
     unsigned int &getPreviewTexture() override;
     void saveTexture(QString fileName) override;
+    bool pointStage(PointStage &stage) override;
+    void setFused(bool fused) override;
     BrightnessContrastNode *clone() override;
     void serialize(QJsonObject &json) const override;
     void deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) override;
@@ -49,6 +51,8 @@ public slots:
     void setOutput();
     void updateBrightness(qreal value);
     void updateContrast(qreal value);
+protected:
+    void createPropertiesPanel() override;
 private:
     BrightnessContrastObject *preview;
     float m_brightness = 0.0f;
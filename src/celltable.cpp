@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "celltable.h"
+#include "shadercache.h"
+
+CellTable::CellTable(const QString &compute, GLenum format): m_format(format) {
+    initializeOpenGLFunctions();
+    tableShader = ShaderCache::acquireCompute(compute);
+}
+
+CellTable::~CellTable() {
+    ShaderCache::release(tableShader);
+    TexturePool *pool = TexturePool::instance();
+    if(pool) pool->release(m_table);
+}
+
+unsigned int CellTable::update(QSize cells, int seed) {
+    cells = cells.expandedTo(QSize(1, 1));
+    if(m_table.texture && m_table.width == cells.width() && m_table.height == cells.height() && m_seed == seed) {
+        return m_table.texture;
+    }
+    TexturePool *pool = TexturePool::instance();
+    if(m_table.width != cells.width() || m_table.height != cells.height()) {
+        pool->release(m_table);
+        m_table = pool->acquire(cells.width(), cells.height(), m_format);
+    }
+    m_seed = seed;
+    tableShader->bind();
+    tableShader->setUniformValue(tableShader->uniformLocation("seed"), seed);
+    glBindImageTexture(0, m_table.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_format);
+    glDispatchCompute((cells.width() + 7)/8, (cells.height() + 7)/8, 1);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_format);
+    tableShader->release();
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    return m_table.texture;
+}
+
+unsigned int CellTable::texture() {
+    return m_table.texture;
+}
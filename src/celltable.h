@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CELLTABLE_H
+#define CELLTABLE_H
+
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLShaderProgram>
+#include <QSize>
+#include "texturepool.h"
+
+class CellTable: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    CellTable(const QString &compute, GLenum format);
+    ~CellTable();
+    //per-cell random values of a cell grid, regenerated only when the grid or the seed changes
+    unsigned int update(QSize cells, int seed);
+    unsigned int texture();
+private:
+    QOpenGLShaderProgram *tableShader;
+    TexturePool::Target m_table;
+    GLenum m_format;
+    int m_seed = 0;
+};
+
+#endif // CELLTABLE_H
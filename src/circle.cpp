@@ -20,8 +20,12 @@
  */
 
 #include "circle.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include "QOpenGLFramebufferObjectFormat"
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 CircleObject::CircleObject(QQuickItem *parent, QVector2D resolution, GLint bpc, int interpolation,
                            float radius, float smooth, bool useAlpha): QQuickFramebufferObject (parent),
@@ -121,24 +125,14 @@ void CircleObject::setBPC(GLint bpc) {
 
 CircleRenderer::CircleRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    generateCircle = new QOpenGLShaderProgram();
-    generateCircle->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    generateCircle->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/circle.frag");
-    generateCircle->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    renderTexture = new QOpenGLShaderProgram();
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
+    generateCircle = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/circle.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    renderTexture = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     generateCircle->bind();
     generateCircle->setUniformValue(generateCircle->uniformLocation("maskTexture"), 0);
     generateCircle->release();
-    renderTexture->link();
     renderTexture->bind();
     renderTexture->setUniformValue(renderTexture->uniformLocation("texture"), 0);
-    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     renderTexture->release();
     float vertQuad[] = {-1.0f, -1.0f,
                     -1.0f, 1.0f,
@@ -183,12 +177,7 @@ CircleRenderer::CircleRenderer(QVector2D resolution, GLint bpc): m_resolution(re
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, 2);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, circleTexture, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -196,9 +185,10 @@ CircleRenderer::CircleRenderer(QVector2D resolution, GLint bpc): m_resolution(re
 }
 
 CircleRenderer::~CircleRenderer() {
-    delete generateCircle;
-    delete checkerShader;
-    delete renderTexture;
+    Resampler::release(this);
+    ShaderCache::release(generateCircle);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(renderTexture);
     glDeleteTextures(1, &circleTexture);
     glDeleteFramebuffers(1, &circleFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -230,14 +220,11 @@ void CircleRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(circleItem->generatedCircle) {
             circleItem->generatedCircle = false;
-            maskTexture = circleItem->maskTexture();
-            generateCircle->bind();
-            generateCircle->setUniformValue(generateCircle->uniformLocation("interpolation"), circleItem->interpolation());
-            generateCircle->setUniformValue(generateCircle->uniformLocation("radius"), circleItem->radius());
-            generateCircle->setUniformValue(generateCircle->uniformLocation("smoothValue"), circleItem->smooth());
-            generateCircle->setUniformValue(generateCircle->uniformLocation("useAlpha"), circleItem->useAlpha());
-            generateCircle->setUniformValue(generateCircle->uniformLocation("useMask"), maskTexture);
-            generateCircle->release();
+            maskTexture = Resampler::instance()->resample(this, 0, circleItem->maskTexture(), circleItem->resolution());
+            m_interpolation = circleItem->interpolation();
+            m_radius = circleItem->radius();
+            m_smoothValue = circleItem->smooth();
+            m_useAlpha = circleItem->useAlpha();
         }
         createCircle();
         circleItem->setTexture(circleTexture);
@@ -263,6 +250,7 @@ void CircleRenderer::render() {
     checkerShader->release();
 
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, circleTexture);
@@ -280,6 +268,11 @@ void CircleRenderer::createCircle() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(circleVAO);
     generateCircle->bind();
+    generateCircle->setUniformValue(generateCircle->uniformLocation("interpolation"), m_interpolation);
+    generateCircle->setUniformValue(generateCircle->uniformLocation("radius"), m_radius);
+    generateCircle->setUniformValue(generateCircle->uniformLocation("smoothValue"), m_smoothValue);
+    generateCircle->setUniformValue(generateCircle->uniformLocation("useAlpha"), m_useAlpha);
+    generateCircle->setUniformValue(generateCircle->uniformLocation("useMask"), maskTexture);
     generateCircle->setUniformValue(generateCircle->uniformLocation("res"), m_resolution);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, maskTexture);
@@ -296,12 +289,7 @@ void CircleRenderer::createCircle() {
 
 void CircleRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, circleTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -313,12 +301,7 @@ void CircleRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -332,6 +315,7 @@ void CircleRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, circleTexture);
@@ -340,41 +324,7 @@ void CircleRenderer::saveTexture(QString fileName) {
     glBindTexture(GL_TEXTURE_2D, 0);
     renderTexture->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
@@ -81,6 +81,10 @@ private:
     void createCircle();
     void updateTexResolution();
     void saveTexture(QString fileName);
+    int m_interpolation = 0;
+    float m_radius = 0.0f;
+    float m_smoothValue = 0.0f;
+    bool m_useAlpha = false;
     QOpenGLShaderProgram *generateCircle;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *renderTexture;
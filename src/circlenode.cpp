@@ -20,19 +20,18 @@
  */
 
 #include "circlenode.h"
+#include "textureformat.h"
 
 CircleNode::CircleNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int interpolation, float radius,
                        float smooth, bool useAlpha): Node(parent, resolution, bpc),
     m_interpolation(interpolation), m_radius(radius), m_smooth(smooth), m_useAlpha(useAlpha)
 {
     preview = new CircleObject(grNode, m_resolution, m_bpc, m_interpolation, m_radius, m_smooth, m_useAlpha);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &CircleNode::generatePreview, this, &CircleNode::previewGenerated);
     connect(preview, &CircleObject::changedTexture, this, &CircleNode::setOutput);
     connect(preview, &CircleObject::updatePreview, this, &CircleNode::updatePreview);
@@ -41,15 +40,19 @@ CircleNode::CircleNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int
     createSockets(1, 1);
     m_socketsInput[0]->setTip("Mask");
     setTitle("Circle");
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/CircleProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+CircleNode::~CircleNode() {
+    delete preview;
+}
+
+void CircleNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/CircleProperty.qml"));
     propertiesPanel->setProperty("startInterpolation", m_interpolation);
     propertiesPanel->setProperty("startRadius", m_radius);
     propertiesPanel->setProperty("startSmooth", m_smooth);
     propertiesPanel->setProperty("startUseAlpha", m_useAlpha);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(interpolationChanged(int)), this, SLOT(updateInterpolation(int)));
     connect(propertiesPanel, SIGNAL(radiusChanged(qreal)), this, SLOT(updateRadius(qreal)));
     connect(propertiesPanel, SIGNAL(smoothValueChanged(qreal)), this, SLOT(updateSmooth(qreal)));
@@ -58,20 +61,10 @@ CircleNode::CircleNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-CircleNode::~CircleNode() {
-    delete preview;
-}
-
 void CircleNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
     preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &CircleNode::getPreviewTexture() {
@@ -83,7 +76,7 @@ void CircleNode::saveTexture(QString fileName) {
 }
 
 CircleNode *CircleNode::clone() {
-    return new CircleNode(parentItem(), m_resolution, m_bpc, m_interpolation, m_radius, m_smooth,
+    return new CircleNode(parentItem(), m_graphResolution, m_bpc, m_interpolation, m_radius, m_smooth,
                           m_useAlpha);
 }
 
@@ -111,18 +104,17 @@ void CircleNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &ha
     if(json.contains("useAlpha")) {
         m_useAlpha = json["useAlpha"].toBool();
     }
-    propertiesPanel->setProperty("startInterpolation", m_interpolation);
-    propertiesPanel->setProperty("startRadius", m_radius);
-    propertiesPanel->setProperty("startSmooth", m_smooth);
-    propertiesPanel->setProperty("startUseAlpha", m_useAlpha);
+    setPropertyOnPanel("startInterpolation", m_interpolation);
+    setPropertyOnPanel("startRadius", m_radius);
+    setPropertyOnPanel("startSmooth", m_smooth);
+    setPropertyOnPanel("startUseAlpha", m_useAlpha);
 
     preview->setInterpolation(m_interpolation);
     preview->setRadius(m_radius);
     preview->setSmooth(m_smooth);
     preview->setUseAlpha(m_useAlpha);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -57,6 +57,8 @@ public slots:
     void updateRadius(qreal radius);
     void updateSmooth(qreal smooth);
     void updateUseAlpha(bool use);
+protected:
+    void createPropertiesPanel() override;
 private:
     CircleObject *preview;
     int m_interpolation = 1;
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QDir>
+#include "headlessrenderer.h"
+#include "qmlloader.h"
+#include "texturepool.h"
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("symbinode-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders the outputs of a Symbinode scene without the editor.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scene", "Scene file (*.sne) to render.");
+    QCommandLineOption outputOption({"o", "output"}, "Directory for the exported textures, the scene directory by default.", "dir");
+    QCommandLineOption resolutionOption({"r", "resolution"}, "Texture resolution as WIDTHxHEIGHT or SIZE.", "res");
+    QCommandLineOption bpcOption({"b", "bpc"}, "Bits per channel of every node, 8, 16 or 16f.", "bits");
+    QCommandLineOption setOption({"s", "set"}, "Override a node parameter, node index from --list. Can be repeated.", "node:key=value");
+    QCommandLineOption listOption({"l", "list"}, "List scene nodes with their indices and exit.");
+    QCommandLineOption budgetOption("texture-budget", "Memory limit of pooled intermediate textures in MB, 512 by default.", "mb");
+    parser.addOptions({outputOption, resolutionOption, bpcOption, setOption, listOption, budgetOption});
+    parser.process(app);
+
+    if(parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+    QString sceneFile = parser.positionalArguments().at(0);
+
+    QVector2D resolution(0, 0);
+    if(parser.isSet(resolutionOption)) {
+        QStringList size = parser.value(resolutionOption).toLower().split('x');
+        int width = size[0].toInt();
+        int height = size.size() > 1 ? size[1].toInt() : width;
+        if(width <= 0 || height <= 0 || size.size() > 2) {
+            std::cerr << "Wrong resolution " << parser.value(resolutionOption).toStdString() << std::endl;
+            return 1;
+        }
+        resolution = QVector2D(width, height);
+    }
+
+    GLint bpc = 0;
+    if(parser.isSet(bpcOption)) {
+        QString bits = parser.value(bpcOption);
+        if(bits == "8") bpc = GL_RGBA8;
+        else if(bits == "16") bpc = GL_RGBA16;
+        else if(bits == "16f") bpc = GL_RGBA16F;
+        else {
+            std::cerr << "Wrong bpc " << bits.toStdString() << ", expected 8, 16 or 16f" << std::endl;
+            return 1;
+        }
+    }
+
+    if(parser.isSet(budgetOption)) {
+        int budget = parser.value(budgetOption).toInt();
+        if(budget <= 0) {
+            std::cerr << "Wrong texture budget " << parser.value(budgetOption).toStdString() << std::endl;
+            return 1;
+        }
+        TexturePool::setBudget(qint64(budget)*1024*1024);
+    }
+
+    QStringList overrides = parser.values(setOption);
+    for(auto o: overrides) {
+        if(!HeadlessRenderer::isValidOverride(o)) {
+            std::cerr << "Wrong override " << o.toStdString() << ", expected node:key=value" << std::endl;
+            return 1;
+        }
+    }
+
+    QString outputDir = parser.isSet(outputOption) ? parser.value(outputOption) : QFileInfo(sceneFile).absolutePath();
+    if(!QDir().mkpath(outputDir)) {
+        std::cerr << "Couldn`t create output directory " << outputDir.toStdString() << std::endl;
+        return 1;
+    }
+
+    QmlLoader::setHeadless(true);
+    HeadlessRenderer renderer;
+    if(!renderer.initialize()) return 1;
+    if(!renderer.loadScene(sceneFile, resolution, bpc, overrides)) return 1;
+    if(parser.isSet(listOption)) {
+        renderer.listNodes();
+        return 0;
+    }
+    if(!renderer.render()) return 1;
+    std::cout << "Pooled texture peak " << renderer.texturePoolPeak()/(1024*1024) << " MB" << std::endl;
+    if(!renderer.saveOutputs(outputDir)) return 1;
+    return 0;
+}
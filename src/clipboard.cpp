@@ -54,6 +54,7 @@
 #include "polartransformnode.h"
 #include "bricksnode.h"
 #include "hexagonsnode.h"
+#include "distancenode.h"
 #include <iostream>
 
 Clipboard::Clipboard()
@@ -97,8 +98,8 @@ void Clipboard::copy(Scene *scene) {
             if(qobject_cast<Node*>(item)) {
                 Node *node = qobject_cast<Node*>(item);
                 if(!node->attachedFrame() || !node->attachedFrame()->selected()) sel_nodes.append(node);
-                maxX = std::max(maxX, (float)(node->x() + node->width()*node->scale()));
-                maxY = std::max(maxY, (float)(node->y() + node->height()*node->scale()));
+                maxX = std::max(maxX, (float)(node->x() + node->width()));
+                maxY = std::max(maxY, (float)(node->y() + node->height()));
                 minX = std::min(minX, (float)node->x());
                 minY = std::min(minY, (float)node->y());
                 QList<Edge*> edges = node->getEdges();
@@ -114,16 +115,16 @@ void Clipboard::copy(Scene *scene) {
             else if(qobject_cast<Frame*>(item)) {
                 Frame *frame = qobject_cast<Frame*>(item);
                 sel_frames.append(frame);
-                maxX = std::max(maxX, (float)(frame->x() + frame->width()*frame->scale()));
-                maxY = std::max(maxY, (float)(frame->y() + frame->height()*frame->scale()));
+                maxX = std::max(maxX, (float)(frame->x() + frame->width()));
+                maxY = std::max(maxY, (float)(frame->y() + frame->height()));
                 minX = std::min(minX, (float)frame->x());
                 minY = std::min(minY, (float)frame->y());
             }
         }
     }
 
-    center.setX(((maxX - minX)*0.5 + minX + scene->background()->viewPan().x())/scene->background()->viewScale());
-    center.setY(((maxY - minY)*0.5 + minY + scene->background()->viewPan().y())/scene->background()->viewScale());
+    center.setX((maxX - minX)*0.5 + minX);
+    center.setY((maxY - minY)*0.5 + minY);
 
     for(auto frame: sel_frames) {
         Frame *f = new Frame();
@@ -139,6 +140,7 @@ void Clipboard::copy(Scene *scene) {
             Node *baseNode = qobject_cast<Node*>(item);
             if(baseNode && !(qobject_cast<AlbedoNode*>(item) || qobject_cast<MetalNode*>(item) || qobject_cast<RoughNode*>(item) || qobject_cast<NormalNode*>(item) || qobject_cast<HeightNode*>(item) || qobject_cast<EmissionNode*>(item)) && baseNode->selected()) {
                 Node *copiedContentNode = baseNode->clone();
+                copiedContentNode->setResolutionOverride(baseNode->resolutionOverride());
                 copiedContentNode->setParent(nullptr);
                 copiedContentNode->setParentItem(nullptr);
                 copiedContentNode->setBaseX(baseNode->baseX());
@@ -150,6 +152,7 @@ void Clipboard::copy(Scene *scene) {
     }
     for(auto node: sel_nodes) {
         Node *copiedNode = node->clone();
+        copiedNode->setResolutionOverride(node->resolutionOverride());
         copiedNode->setParent(nullptr);
         copiedNode->setParentItem(nullptr);
         copiedNode->setBaseX(node->baseX());
@@ -158,8 +161,8 @@ void Clipboard::copy(Scene *scene) {
     }
     for(auto edge: sel_edges) {
         Edge *e = new Edge();
-        e->setStartPosition((edge->startPosition() + scene->background()->viewPan())/scene->background()->viewScale());
-        e->setEndPosition((edge->endPosition() + scene->background()->viewPan())/scene->background()->viewScale());
+        e->setStartPosition(edge->startPosition());
+        e->setEndPosition(edge->endPosition());
         clipboard_edges.append(e);
     }
 }
@@ -168,19 +171,14 @@ void Clipboard::paste(float posX, float posY, Scene *scene) {
     QList<QQuickItem*> pastedItem;
     if(clipboard_nodes.empty() && clipboard_frames.empty()) return;
     std::cout << posX << " " << posY << std::endl;
-    float viewScale = scene->background()->viewScale();
-    QVector2D viewPan = scene->background()->viewPan();
-    QVector2D currentCenter = center*viewScale - viewPan;
+    QPointF pos = scene->canvas()->mapFromItem(scene, QPointF(posX, posY));
+    QVector2D offset = QVector2D(pos.x(), pos.y()) - center;
 
     scene->clearSelected();
     for(auto f: clipboard_frames) {
         Frame *frame = new Frame(scene);
-        float x = posX - (currentCenter.x() - (f->baseX()*viewScale - viewPan.x()));
-        float y = posY - (currentCenter.y() - (f->baseY()*viewScale - viewPan.y()));
-        frame->setPan(viewPan);
-        frame->setScaleView(viewScale);
-        frame->setBaseX((viewPan.x() + x)/viewScale);
-        frame->setBaseY((viewPan.y() + y)/viewScale);
+        frame->setBaseX(f->baseX() + offset.x());
+        frame->setBaseY(f->baseY() + offset.y());
         frame->setWidth(f->width());
         frame->setHeight(f->height());
         frame->setTitle(f->title());
@@ -194,12 +192,11 @@ void Clipboard::paste(float posX, float posY, Scene *scene) {
             if(qobject_cast<Node*>(item)) {
                 Node *baseNode = qobject_cast<Node*>(item);
                 Node *pastedNode = baseNode->clone();
+                pastedNode->setResolutionOverride(baseNode->resolutionOverride());
                 pastedNode->setParent(scene);
-                pastedNode->setParentItem(scene);
-                float x = posX - (currentCenter.x() - (baseNode->baseX()*viewScale - viewPan.x()));
-                float y = posY - (currentCenter.y() - (baseNode->baseY()*viewScale - viewPan.y()));
-                pastedNode->setBaseX((viewPan.x() + x)/viewScale);
-                pastedNode->setBaseY((viewPan.y() + y)/viewScale);
+                pastedNode->setParentItem(scene->canvas());
+                pastedNode->setBaseX(baseNode->baseX() + offset.x());
+                pastedNode->setBaseY(baseNode->baseY() + offset.y());
                 pastedNode->setSelected(true);
                 scene->addNode(pastedNode);
                 scene->addSelected(pastedNode);
@@ -211,25 +208,20 @@ void Clipboard::paste(float posX, float posY, Scene *scene) {
     }
     for(auto n: clipboard_nodes) {
         Node *pastedNode = n->clone();
+        pastedNode->setResolutionOverride(n->resolutionOverride());
         pastedNode->setParent(scene);
-        pastedNode->setParentItem(scene);
-        float x = posX - (currentCenter.x() - (n->baseX()*viewScale - viewPan.x()));
-        float y = posY - (currentCenter.y() - (n->baseY()*viewScale - viewPan.y()));
-        pastedNode->setBaseX((viewPan.x() + x)/viewScale);
-        pastedNode->setBaseY((viewPan.y() + y)/viewScale);
+        pastedNode->setParentItem(scene->canvas());
+        pastedNode->setBaseX(n->baseX() + offset.x());
+        pastedNode->setBaseY(n->baseY() + offset.y());
         pastedNode->setSelected(true);
         scene->addNode(pastedNode);
         scene->addSelected(pastedNode);
         pastedItem.append(pastedNode);
     }
     for(auto e: clipboard_edges) {
-        Edge *edge = new Edge(scene);
-        float startX = e->startPosition().x()*viewScale - viewPan.x();
-        float startY = e->startPosition().y()*viewScale - viewPan.y();
-        float endX = e->endPosition().x()*viewScale - viewPan.x();
-        float endY = e->endPosition().y()*viewScale - viewPan.y();
-        edge->setStartPosition(QVector2D(posX - (currentCenter.x() - startX), posY - (currentCenter.y() - startY)));
-        edge->setEndPosition(QVector2D(posX - (currentCenter.x() - endX), posY - (currentCenter.y() - endY)));
+        Edge *edge = new Edge(scene->canvas());
+        edge->setStartPosition(e->startPosition() + offset);
+        edge->setEndPosition(e->endPosition() + offset);
         Socket *startSock = edge->findSockets(scene, edge->startPosition().x(), edge->startPosition().y());
         if(startSock) {
             edge->setStartSocket(startSock);
@@ -249,7 +241,6 @@ void Clipboard::paste(float posX, float posY, Scene *scene) {
             edge->deleteLater();
             continue;
         }
-        edge->updateScale(scene->background()->viewScale());
         scene->addEdge(edge);
         pastedItem.append(edge);
     }
@@ -258,7 +249,6 @@ void Clipboard::paste(float posX, float posY, Scene *scene) {
 
 void Clipboard::duplicate(Scene *scene) {
     QList<QQuickItem*> selected = scene->selectedList();
-    float viewScale = scene->background()->viewScale();
     QList<Frame*> sel_frames;
     QList<Node*> sel_nodes;
     QList<Edge*> sel_edges;
@@ -301,6 +291,7 @@ void Clipboard::duplicate(Scene *scene) {
             Node *baseNode = qobject_cast<Node*>(item);
             if(baseNode && !(qobject_cast<AlbedoNode*>(item) || qobject_cast<MetalNode*>(item) || qobject_cast<RoughNode*>(item) || qobject_cast<NormalNode*>(item) || qobject_cast<HeightNode*>(item) || qobject_cast<EmissionNode*>(item)) && baseNode->selected()) {
                 Node *copiedContentNode = baseNode->clone();
+                copiedContentNode->setResolutionOverride(baseNode->resolutionOverride());
                 copiedContentNode->setBaseX(baseNode->baseX() + 50);
                 copiedContentNode->setBaseY(baseNode->baseY() + 50);
                 copiedContent.append(copiedContentNode);
@@ -313,6 +304,7 @@ void Clipboard::duplicate(Scene *scene) {
     }
     for(auto node: sel_nodes) {
         Node *duplicatedNode = node->clone();
+        duplicatedNode->setResolutionOverride(node->resolutionOverride());
         duplicatedNode->setBaseX(node->baseX() + 50);
         duplicatedNode->setBaseY(node->baseY() + 50);
         scene->addNode(duplicatedNode);
@@ -320,9 +312,9 @@ void Clipboard::duplicate(Scene *scene) {
         pastedItem.append(duplicatedNode);
     }
     for(auto edge: sel_edges) {
-        Edge *e = new Edge(scene);
-        e->setStartPosition(edge->startPosition() + QVector2D(50, 50)*viewScale);
-        e->setEndPosition(edge->endPosition() + QVector2D(50, 50)*viewScale);
+        Edge *e = new Edge(scene->canvas());
+        e->setStartPosition(edge->startPosition() + QVector2D(50, 50));
+        e->setEndPosition(edge->endPosition() + QVector2D(50, 50));
         Socket *startSock = e->findSockets(scene, e->startPosition().x(), e->startPosition().y());
         if(startSock) {
             e->setStartSocket(startSock);
@@ -334,7 +326,6 @@ void Clipboard::duplicate(Scene *scene) {
             e->setEndSocket(endSock);
             endSock->addEdge(e);
         }
-        e->updateScale(scene->background()->viewScale());
         scene->addEdge(e);
         pastedItem.append(e);
     }
@@ -20,6 +20,8 @@
  */
 
 #include "color.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include<QOpenGLFramebufferObjectFormat>
 #include <iostream>
 
@@ -70,14 +72,8 @@ void ColorObject::setResolution(QVector2D res) {
 
 ColorRenderer::ColorRenderer(QVector2D res): m_resolution(res){
     initializeOpenGLFunctions();
-    colorShader = new QOpenGLShaderProgram();
-    colorShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    colorShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/color.frag");
-    colorShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    colorShader = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/color.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
     textureShader->release();
@@ -129,8 +125,8 @@ ColorRenderer::ColorRenderer(QVector2D res): m_resolution(res){
 }
 
 ColorRenderer::~ColorRenderer() {
-    delete colorShader;
-    delete textureShader;
+    ShaderCache::release(colorShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_colorTexture);
     glDeleteFramebuffers(1, &colorFBO);
     glDeleteVertexArrays(1, &colorVAO);
@@ -154,9 +150,7 @@ void ColorRenderer::synchronize(QQuickFramebufferObject *item) {
     }
     if(colorItem->createdTexture) {
         colorItem->createdTexture = false;
-        colorShader->bind();
-        colorShader->setUniformValue(colorShader->uniformLocation("color"), colorItem->color());
-        colorShader->release();
+        m_color = colorItem->color();
         createColor();
         colorItem->setTexture(m_colorTexture);
         colorItem->updatePreview(m_colorTexture);
@@ -174,6 +168,7 @@ void ColorRenderer::render() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 0.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -189,6 +184,7 @@ void ColorRenderer::createColor() {
     glClearColor(0.6f, 0.6f, 0.6f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     colorShader->bind();
+    colorShader->setUniformValue(colorShader->uniformLocation("color"), m_color);
     glBindVertexArray(colorVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
@@ -228,6 +224,7 @@ void ColorRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 0.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -235,16 +232,7 @@ void ColorRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    BYTE *pixels = (BYTE*)malloc(3*m_resolution.x()*m_resolution.y());
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_BYTE, pixels);
-    FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 3 * m_resolution.x(), 24, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-    if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-        printf("Successfully saved!\n");
-    else
-        printf("Failed saving!\n");
-    FreeImage_Unload(image);
-    delete [] pixels;
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), GL_RGBA8, 3);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
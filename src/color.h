@@ -69,6 +69,7 @@ private:
     unsigned int m_colorTexture = 0;
     unsigned int colorVAO = 0;
     unsigned int textureVAO = 0;
+    QVector3D m_color;
     QOpenGLShaderProgram *colorShader;
     QOpenGLShaderProgram *textureShader;
 };
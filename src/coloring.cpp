@@ -20,7 +20,11 @@
  */
 
 #include "coloring.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
 
 ColoringObject::ColoringObject(QQuickItem *parent, QVector2D resolution, GLint bpc, QVector3D color):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc), m_color(color)
@@ -45,6 +49,14 @@ void ColoringObject::setSourceTexture(unsigned int texture) {
     colorizedTex = true;
 }
 
+QList<PointStage> ColoringObject::stages() {
+    return m_stages;
+}
+
+void ColoringObject::setStages(const QList<PointStage> &stages) {
+    m_stages = stages;
+}
+
 void ColoringObject::saveTexture(QString fileName) {
     texSaving = true;
     saveName = fileName;
@@ -87,24 +99,14 @@ QQuickFramebufferObject::Renderer *ColoringObject::createRenderer() const {
 
 ColoringRenderer::ColoringRenderer(QVector2D res, GLint bpc):m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    coloringShader = new QOpenGLShaderProgram();
-    coloringShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    coloringShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/coloring.frag");
-    coloringShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    coloringShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/coloring.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     coloringShader->bind();
     coloringShader->setUniformValue(coloringShader->uniformLocation("sourceTexture"), 0);
     coloringShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                            -1.0f, 1.0f, 0.0f, 1.0f,
@@ -127,16 +129,7 @@ ColoringRenderer::ColoringRenderer(QVector2D res, GLint bpc):m_resolution(res),
     glBindFramebuffer(GL_FRAMEBUFFER, colorFBO);
     glGenTextures(1, &m_colorTexture);
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -150,9 +143,10 @@ ColoringRenderer::ColoringRenderer(QVector2D res, GLint bpc):m_resolution(res),
 }
 
 ColoringRenderer::~ColoringRenderer() {
-    delete coloringShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(coloringShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_colorTexture);
     glDeleteFramebuffers(1, &colorFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -179,14 +173,13 @@ void ColoringRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(coloringItem->colorizedTex) {
             coloringItem->colorizedTex = false;
-            m_sourceTexture = coloringItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, coloringItem->sourceTexture(), coloringItem->resolution());
+            m_stages = coloringItem->stages();
             if(m_sourceTexture) {
-                coloringShader->bind();
-                coloringShader->setUniformValue(coloringShader->uniformLocation("color"), coloringItem->color());
-                coloringShader->release();
+                m_color = coloringItem->color();
             }
         }
-        if(m_sourceTexture) {
+        if(m_sourceTexture && !coloringItem->fused) {
             colorize();
             coloringItem->setTexture(m_colorTexture);
             coloringItem->updatePreview(m_colorTexture);
@@ -213,6 +206,7 @@ void ColoringRenderer::render() {
 
     if(m_sourceTexture) {
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glBindVertexArray(textureVAO);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_colorTexture);
@@ -225,11 +219,22 @@ void ColoringRenderer::render() {
 }
 
 void ColoringRenderer::colorize() {
+    if(!m_stages.isEmpty()) {
+        QList<PointStage> stages = m_stages;
+        stages.append(PointStage::coloring(m_color));
+        pointChain.render(stages, m_sourceTexture, colorFBO, m_resolution);
+        glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFlush();
+        return;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, colorFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     coloringShader->bind();
+    coloringShader->setUniformValue(coloringShader->uniformLocation("color"), m_color);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
@@ -241,21 +246,11 @@ void ColoringRenderer::colorize() {
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     glFlush();
-    glFinish();
 }
 
 void ColoringRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -267,12 +262,7 @@ void ColoringRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -286,6 +276,7 @@ void ColoringRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
@@ -294,41 +285,7 @@ void ColoringRenderer::saveTexture(QString fileName) {
     glBindVertexArray(0);
     textureShader->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
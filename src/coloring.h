@@ -26,6 +26,7 @@
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
 #include "FreeImage.h"
+#include "pointchain.h"
 
 class ColoringObject: public QQuickFramebufferObject
 {
@@ -37,6 +38,8 @@ public:
     void setTexture(unsigned int texture);
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
+    QList<PointStage> stages();
+    void setStages(const QList<PointStage> &stages);
     void saveTexture(QString fileName);
     QVector3D color();
     void setColor(QVector3D color);
@@ -48,6 +51,7 @@ public:
     bool selectedItem = false;
     bool resUpdated = false;
     bool bpcUpdated = false;
+    bool fused = false;
     bool texSaving = false;
     QString saveName = "";
 signals:
@@ -56,6 +60,7 @@ signals:
 private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
+    QList<PointStage> m_stages;
     unsigned int m_sourceTexture = 0;
     unsigned int m_texture = 0;
     QVector3D m_color = QVector3D(1, 1, 1);
@@ -76,8 +81,11 @@ private:
     GLint m_bpc = GL_RGBA8;
     unsigned int colorFBO;
     unsigned int m_colorTexture = 0;
+    QList<PointStage> m_stages;
+    PointChain pointChain;
     unsigned int m_sourceTexture = 0;
     unsigned int textureVAO = 0;
+    QVector3D m_color;
     QOpenGLShaderProgram *coloringShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
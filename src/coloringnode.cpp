@@ -20,32 +20,22 @@
  */
 
 #include "coloringnode.h"
+#include "textureformat.h"
 
 ColoringNode::ColoringNode(QQuickItem *parent, QVector2D resolution, GLint bpc, QVector3D color):
     Node(parent, resolution, bpc), m_color(color)
 {
     preview = new ColoringObject(grNode, m_resolution, m_bpc, m_color);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &ColoringNode::previewGenerated);
     connect(preview, &ColoringObject::updatePreview, this, &Node::updatePreview);
     connect(this, &Node::changeResolution, preview, &ColoringObject::setResolution);
     connect(this, &Node::changeBPC, preview, &ColoringObject::setBPC);
     connect(preview, &ColoringObject::textureChanged, this, &ColoringNode::setOutput);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/AlbedoProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    propertiesPanel->setProperty("startColor", m_color);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(albedoChanged(QVector3D)), this, SLOT(updateColor(QVector3D)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(1, 1);
     setTitle("Coloring");
     m_socketsInput[0]->setTip("Texture");
@@ -55,17 +45,23 @@ ColoringNode::~ColoringNode() {
     delete preview;
 }
 
+void ColoringNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/AlbedoProperty.qml"));
+    propertiesPanel->setProperty("startColor", m_color);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(albedoChanged(QVector3D)), this, SLOT(updateColor(QVector3D)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void ColoringNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    QList<PointStage> stages;
+    unsigned int source = fusedSource(stages);
+    preview->setStages(stages);
+    preview->setSourceTexture(source);
     preview->update();
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &ColoringNode::getPreviewTexture() {
@@ -76,8 +72,18 @@ void ColoringNode::saveTexture(QString fileName) {
     preview->saveTexture(fileName);
 }
 
+bool ColoringNode::pointStage(PointStage &stage) {
+    stage = PointStage::coloring(m_color);
+    return true;
+}
+
+void ColoringNode::setFused(bool fused) {
+    Node::setFused(fused);
+    preview->fused = fused;
+}
+
 ColoringNode *ColoringNode::clone() {
-    return new ColoringNode(parentItem(), m_resolution, m_bpc, m_color);
+    return new ColoringNode(parentItem(), m_graphResolution, m_bpc, m_color);
 }
 
 void ColoringNode::serialize(QJsonObject &json) const {
@@ -95,10 +101,10 @@ void ColoringNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &
     if(json.contains("color")) {
         QJsonArray color = json["color"].toArray();
         QVector3D c = QVector3D(color[0].toVariant().toFloat(), color[1].toVariant().toFloat(), color[2].toVariant().toFloat());
-        propertiesPanel->setProperty("startColor", c);
+        updateColor(c);
+        setPropertyOnPanel("startColor", c);
     }
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 QVector3D ColoringNode::color() {
@@ -34,6 +34,8 @@ public:
     void operation() override;
     unsigned int &getPreviewTexture() override;
     void saveTexture(QString fileName) override;
+    bool pointStage(PointStage &stage) override;
+    void setFused(bool fused) override;
     ColoringNode *clone() override;
     void serialize(QJsonObject &json) const override;
     void deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) override;
@@ -45,6 +47,8 @@ public slots:
     void previewGenerated();
     void setOutput();
     void updateColor(QVector3D color);
+protected:
+    void createPropertiesPanel() override;
 private:
     ColoringObject *preview;
     QVector3D m_color = QVector3D(1, 1, 1);
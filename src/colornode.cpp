@@ -25,23 +25,15 @@ ColorNode::ColorNode(QQuickItem *parent, QVector2D resolution, QVector3D color):
     m_color(color)
 {
     preview = new ColorObject(grNode, m_resolution, m_color);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::changeResolution, preview, &ColorObject::setResolution);
     connect(this, &ColorNode::generatePreview, this, &ColorNode::previewGenerated);
     connect(preview, &ColorObject::updatePreview, this, &ColorNode::updatePreview);
     connect(preview, &ColorObject::textureChanged, this, &ColorNode::operation);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/ColorProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    propertiesPanel->setProperty("startColor", m_color);
-    connect(propertiesPanel, SIGNAL(colorChanged(QVector3D)), this, SLOT(updateColor(QVector3D)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(0, 1);
     setTitle("Color");
 }
@@ -50,6 +42,13 @@ ColorNode::~ColorNode() {
     delete preview;
 }
 
+void ColorNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/ColorProperty.qml"));
+    propertiesPanel->setProperty("startColor", m_color);
+    connect(propertiesPanel, SIGNAL(colorChanged(QVector3D)), this, SLOT(updateColor(QVector3D)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void ColorNode::operation() {
     m_socketOutput[0]->setValue(preview->texture());
 }
@@ -63,7 +62,7 @@ void ColorNode::saveTexture(QString fileName) {
 }
 
 ColorNode *ColorNode::clone() {
-    return new ColorNode(parentItem(), m_resolution, m_color);
+    return new ColorNode(parentItem(), m_graphResolution, m_color);
 }
 
 void ColorNode::serialize(QJsonObject &json) const {
@@ -81,7 +80,8 @@ void ColorNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &has
     if(json.contains("color")) {
         QJsonArray color = json["color"].toVariant().toJsonArray();
         QVector3D colorValue = QVector3D(color[0].toVariant().toFloat(), color[1].toVariant().toFloat(), color[2].toVariant().toFloat());
-        propertiesPanel->setProperty("startColor", colorValue);
+        updateColor(colorValue);
+        setPropertyOnPanel("startColor", colorValue);
     }
 }
 
@@ -44,6 +44,8 @@ signals:
 public slots:
     void updateColor(QVector3D color);
     void previewGenerated();
+protected:
+    void createPropertiesPanel() override;
 private:
     ColorObject *preview;
     QVector3D m_color = QVector3D(1, 1, 1);
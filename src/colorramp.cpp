@@ -20,12 +20,13 @@
  */
 
 #include "colorramp.h"
+#include "shadercache.h"
+#include "textureexporter.h"
+#include "ramplut.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include <iostream>
-
-bool gradientSort(QVector4D f, QVector4D s) {
-    return f.w() < s.w();
-}
+#include "textureformat.h"
+#include "resampler.h"
 
 ColorRampObject::ColorRampObject(QQuickItem *parent, QVector2D resolution, GLint bpc, QJsonArray stops):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc)
@@ -79,6 +80,14 @@ void ColorRampObject::setSourceTexture(unsigned int texture) {
     rampedTex = true;
 }
 
+QList<PointStage> ColorRampObject::stages() {
+    return m_stages;
+}
+
+void ColorRampObject::setStages(const QList<PointStage> &stages) {
+    m_stages = stages;
+}
+
 void ColorRampObject::setGradientsStops(QJsonArray stops) {
     m_stops.clear();
     for(auto s: stops) {
@@ -138,25 +147,16 @@ void ColorRampObject::gradientDelete(int index) {
 
 ColorRampRenderer::ColorRampRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    colorRampShader = new QOpenGLShaderProgram();
-    colorRampShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    colorRampShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/colorramp.frag");
-    colorRampShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    colorRampShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/colorramp.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     colorRampShader->bind();
     colorRampShader->setUniformValue(colorRampShader->uniformLocation("sourceTexture"), 0);
     colorRampShader->setUniformValue(colorRampShader->uniformLocation("maskTexture"), 1);
+    colorRampShader->setUniformValue(colorRampShader->uniformLocation("rampTexture"), 2);
     colorRampShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -178,16 +178,7 @@ ColorRampRenderer::ColorRampRenderer(QVector2D res, GLint bpc): m_resolution(res
     glGenTextures(1, &m_colorTexture);
     glBindFramebuffer(GL_FRAMEBUFFER, colorFBO);
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -201,17 +192,17 @@ ColorRampRenderer::ColorRampRenderer(QVector2D res, GLint bpc): m_resolution(res
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    glGenBuffers(1, &gradientsSSBO);
 }
 
 ColorRampRenderer::~ColorRampRenderer() {
-    delete colorRampShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(colorRampShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_colorTexture);
     glDeleteFramebuffers(1, &colorFBO);
     glDeleteVertexArrays(1, &textureVAO);
-    glDeleteBuffers(1, &gradientsSSBO);
+    RampLut::instance()->release(m_rampTexture);
 }
 
 QOpenGLFramebufferObject *ColorRampRenderer::createFramebufferObject(const QSize &size) {
@@ -235,12 +226,13 @@ void ColorRampRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(colorRampItem->rampedTex) {
             colorRampItem->rampedTex = false;
-            m_sourceTexture = colorRampItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, colorRampItem->sourceTexture(), colorRampItem->resolution());
+            m_stages = colorRampItem->stages();
             if(m_sourceTexture) {
-                maskTexture = colorRampItem->maskTexture();
+                maskTexture = Resampler::instance()->resample(this, 1, colorRampItem->maskTexture(), colorRampItem->resolution());
             }
         }
-        if(m_sourceTexture) {
+        if(m_sourceTexture && !colorRampItem->fused) {
             colorRamp(colorRampItem->stops());
             colorRampItem->setTexture(m_colorTexture);
             colorRampItem->updatePreview(m_colorTexture);
@@ -268,6 +260,7 @@ void ColorRampRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_colorTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -279,26 +272,32 @@ void ColorRampRenderer::render() {
 }
 
 void ColorRampRenderer::colorRamp(const std::vector<QVector4D> &stops) {
+    if(!m_stages.isEmpty()) {
+        QList<PointStage> stages = m_stages;
+        stages.append(PointStage::colorRamp(stops, maskTexture));
+        pointChain.render(stages, m_sourceTexture, colorFBO, m_resolution);
+        glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFlush();
+        return;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, colorFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
-    std::vector<QVector4D> gradSort = stops;
-    std::reverse(gradSort.begin(), gradSort.end());
-    std::sort(gradSort.begin(), gradSort.end(), gradientSort);
+    unsigned int ramp = rampTexture(stops);
     colorRampShader->bind();
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, maskTexture);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gradientsSSBO);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, gradSort.size()*sizeof (QVector4D), gradSort.data(), GL_STATIC_DRAW);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, gradientsSSBO);
-    colorRampShader->setUniformValue(colorRampShader->uniformLocation("stopCount"), (int)gradSort.size());
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_1D, ramp);
     colorRampShader->setUniformValue(colorRampShader->uniformLocation("useMask"), maskTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_1D, 0);
     glActiveTexture(GL_TEXTURE0);    
     glBindVertexArray(0);
     colorRampShader->release();
@@ -307,21 +306,19 @@ void ColorRampRenderer::colorRamp(const std::vector<QVector4D> &stops) {
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     glFlush();
-    glFinish();
+}
+
+unsigned int ColorRampRenderer::rampTexture(const std::vector<QVector4D> &stops) {
+    RampLut *lut = RampLut::instance();
+    unsigned int texture = lut->acquire(stops);
+    lut->release(m_rampTexture);
+    m_rampTexture = texture;
+    return m_rampTexture;
 }
 
 void ColorRampRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, GL_RGBA8, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, GL_RGBA16, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -333,12 +330,7 @@ void ColorRampRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -353,6 +345,7 @@ void ColorRampRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -360,41 +353,7 @@ void ColorRampRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
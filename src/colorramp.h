@@ -28,6 +28,7 @@
 #include <vector>
 #include <QJsonArray>
 #include "FreeImage.h"
+#include "pointchain.h"
 
 class ColorRampObject: public QQuickFramebufferObject
 {
@@ -42,6 +43,8 @@ public:
     std::vector<QVector4D> &stops();
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
+    QList<PointStage> stages();
+    void setStages(const QList<PointStage> &stages);
     void saveTexture(QString fileName);
     void setGradientsStops(QJsonArray stops);
     QVector2D resolution();
@@ -52,6 +55,7 @@ public:
     bool selectedItem = false;
     bool resUpdated = false;
     bool bpcUpdated = false;
+    bool fused = false;
     bool texSaving = false;
     QString saveName = "";
 public slots:
@@ -66,6 +70,7 @@ private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
     unsigned int m_texture = 0;
+    QList<PointStage> m_stages;
     unsigned int m_sourceTexture = 0;    
     unsigned int m_maskTexture = 0;
     std::vector<QVector4D> m_stops;
@@ -80,16 +85,19 @@ public:
     void render();
 private:
     void colorRamp(const std::vector<QVector4D> &stops);
+    unsigned int rampTexture(const std::vector<QVector4D> &stops);
     void updateTexResolution();
     void saveTexture(QString fileName);
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
     unsigned int colorFBO;
     unsigned int m_colorTexture = 0;
+    QList<PointStage> m_stages;
+    PointChain pointChain;
     unsigned int m_sourceTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
-    unsigned int gradientsSSBO;
+    unsigned int m_rampTexture = 0;
     QOpenGLShaderProgram *colorRampShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
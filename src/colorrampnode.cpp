@@ -22,63 +22,54 @@
 #include "colorrampnode.h"
 #include <QQmlComponent>
 #include <iostream>
+#include "textureformat.h"
 
 ColorRampNode::ColorRampNode(QQuickItem *parent, QVector2D resolution, GLint bpc, QJsonArray stops):
     Node(parent, resolution, bpc)
 {
     preview = new ColorRampObject(grNode, m_resolution, m_bpc, stops);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &ColorRampNode::previewGenerated);
     connect(this, &Node::changeResolution, preview, &ColorRampObject::setResolution);
     connect(this, &Node::changeBPC, preview, &ColorRampObject::setBPC);
     connect(preview, &ColorRampObject::textureChanged, this, &ColorRampNode::setOutput);
     connect(preview, &ColorRampObject::updatePreview, this, &ColorRampNode::updatePreview);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/ColorRampProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(gradientStopAdded(QVector3D, qreal, int)), preview, SLOT(gradientAdd(QVector3D, qreal, int)));
-    connect(propertiesPanel, SIGNAL(positionChanged(qreal, int)), preview, SLOT(positionUpdate(qreal, int)));
-    connect(propertiesPanel, SIGNAL(colorChanged(QVector3D, int)), preview, SLOT(colorUpdate(QVector3D, int)));
-    connect(propertiesPanel, SIGNAL(gradientStopDeleted(int)), preview, SLOT(gradientDelete(int)));
-    connect(this, SIGNAL(stopsChanged(QVariant)), propertiesPanel, SIGNAL(gradientsStopsChanged(QVariant)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(2, 1);
     setTitle("Color Ramp");
     m_socketsInput[0]->setTip("Texture");
     m_socketsInput[1]->setTip("Mask");
-    stopsChanged(QVariant(stops));
 }
 
 ColorRampNode::~ColorRampNode() {
     delete preview;
 }
 
+void ColorRampNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/ColorRampProperty.qml"));
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(gradientStopAdded(QVector3D, qreal, int)), preview, SLOT(gradientAdd(QVector3D, qreal, int)));
+    connect(propertiesPanel, SIGNAL(positionChanged(qreal, int)), preview, SLOT(positionUpdate(qreal, int)));
+    connect(propertiesPanel, SIGNAL(colorChanged(QVector3D, int)), preview, SLOT(colorUpdate(QVector3D, int)));
+    connect(propertiesPanel, SIGNAL(gradientStopDeleted(int)), preview, SLOT(gradientDelete(int)));
+    connect(this, SIGNAL(stopsChanged(QVariant)), propertiesPanel, SIGNAL(gradientsStopsChanged(QVariant)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+    stopsChanged(QVariant(stops()));
+}
+
 void ColorRampNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
-    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    QList<PointStage> stages;
+    unsigned int source = fusedSource(stages);
+    preview->setStages(stages);
+    preview->setSourceTexture(source);
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &ColorRampNode::getPreviewTexture() {
@@ -89,8 +80,18 @@ void ColorRampNode::saveTexture(QString fileName) {
     preview->saveTexture(fileName);
 }
 
+bool ColorRampNode::pointStage(PointStage &stage) {
+    stage = PointStage::colorRamp(preview->stops(), m_socketsInput[1]->value().toUInt());
+    return true;
+}
+
+void ColorRampNode::setFused(bool fused) {
+    Node::setFused(fused);
+    preview->fused = fused;
+}
+
 ColorRampNode *ColorRampNode::clone() {
-    return new ColorRampNode(parentItem(), m_resolution, m_bpc, stops());
+    return new ColorRampNode(parentItem(), m_graphResolution, m_bpc, stops());
 }
 
 void ColorRampNode::serialize(QJsonObject &json) const {
@@ -106,16 +107,14 @@ void ColorRampNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *>
         stopsChanged(QVariant(gradientStops));
         preview->setGradientsStops(gradientStops);
     }
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 QJsonArray ColorRampNode::stops() const{
-    QList<QVariant> gradientsStops = propertiesPanel->property("gradientStops").toList();
+    //the preview holds the stops, the panel may not exist yet
     QJsonArray stops;
-    for(auto s: gradientsStops) {
-        QJsonArray i = s.toJsonArray();
-        stops.push_back(i);
+    for(auto &s: preview->stops()) {
+        stops.push_back(QJsonArray{s.x(), s.y(), s.z(), s.w()});
     }
     return stops;
 }
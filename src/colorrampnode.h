@@ -34,6 +34,8 @@ public:
     void operation() override;
     unsigned int &getPreviewTexture() override;
     void saveTexture(QString fileName) override;
+    bool pointStage(PointStage &stage) override;
+    void setFused(bool fused) override;
     ColorRampNode *clone() override;
     void serialize(QJsonObject &json) const override;
     void deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) override;
@@ -43,6 +45,8 @@ signals:
 public slots:
     void previewGenerated();
     void setOutput();
+protected:
+    void createPropertiesPanel() override;
 private:
     ColorRampObject *preview;
 };
@@ -78,7 +78,7 @@ void MoveCommand::undo() {
     }
     if(m_intersectingEdge) {
         Node *node = qobject_cast<Node*>(m_nodes[0]);
-        qobject_cast<Scene*>(node->parentItem())->deleteEdge(m_newEdge);
+        Scene::sceneOf(node)->deleteEdge(m_newEdge);
         m_newEdge->endSocket()->deleteEdge(m_newEdge);
         m_newEdge->startSocket()->deleteEdge(m_newEdge);
         m_newEdge->setParentItem(nullptr);
@@ -119,9 +119,9 @@ void MoveCommand::redo() {
             newEndSocket->setValue(m_intersectingEdge->startSocket()->value());
         }
         m_intersectingEdge->setEndPosition(newEndSocket->globalPos());
-        Scene *scene = qobject_cast<Scene*>(node->parentItem());
+        Scene *scene = Scene::sceneOf(node);
         if(!m_newEdge) {
-            m_newEdge = new Edge(scene);
+            m_newEdge = new Edge(scene->canvas());
             Socket *startSocket = node->getOutputSocket(0);
             m_newEdge->setStartSocket(startSocket);
             if(startSocket) startSocket->addEdge(m_newEdge);
@@ -137,7 +137,7 @@ void MoveCommand::redo() {
             m_newEdge->setStartPosition(m_newEdge->startSocket()->globalPos());
             m_newEdge->setEndPosition(m_newEdge->endSocket()->globalPos());
             m_newEdge->endSocket()->setValue(m_newEdge->startSocket()->value());
-            m_newEdge->setParentItem(scene);
+            m_newEdge->setParentItem(scene->canvas());
         }
         scene->addEdge(m_newEdge);
     }
@@ -159,7 +159,7 @@ void AddNode::undo() {
 
 void AddNode::redo() {
     m_scene->addNode(m_node);
-    m_node->setParentItem(m_scene);
+    m_node->setParentItem(m_scene->canvas());
     m_node->generatePreview();
 }
 
@@ -185,7 +185,7 @@ void AddEdge::redo() {
     m_edge->endSocket()->addEdge(m_edge);
     m_edge->setStartPosition(m_edge->startSocket()->globalPos());
     m_edge->setEndPosition(m_edge->endSocket()->globalPos());
-    m_edge->setParentItem(m_scene);
+    m_edge->setParentItem(m_scene->canvas());
     m_edge->endSocket()->setValue(m_edge->startSocket()->value());
 }
 
@@ -215,7 +215,7 @@ void AddFrame::undo() {
 
 void AddFrame::redo() {
     m_scene->addFrame(m_frame);
-    m_frame->setParentItem(m_scene);
+    m_frame->setParentItem(m_scene->canvas());
     QList<QQuickItem*> addedNodes;
     for(auto p: m_nodes) {
         addedNodes.push_back(p.first);
@@ -292,7 +292,7 @@ void DeleteCommand::deleteWithSaveConnection() {
                             if(inputSocket && inputSocket->countEdge() > 0) inNode = qobject_cast<Node*>(inputSocket->getEdges()[0]->startSocket()->parentItem());
                         }
                         if(outNode && inNode) {
-                            Edge *newEdge = new Edge(m_scene);
+                            Edge *newEdge = new Edge(m_scene->canvas());
                             newEdge->setEndSocket(edge->endSocket());
                             newEdge->setStartSocket(inNode->getOutputSocket(0));
                             newEdge->endSocket()->setValue(newEdge->startSocket()->value());
@@ -310,7 +310,7 @@ void DeleteCommand::deleteWithSaveConnection() {
         edge->endSocket()->addEdge(edge);
         edge->startSocket()->addEdge(edge);
         m_scene->addEdge(edge);
-        edge->setParentItem(m_scene);
+        edge->setParentItem(m_scene->canvas());
         edge->endSocket()->setValue(edge->startSocket()->value());
     }
 }
@@ -322,7 +322,7 @@ void DeleteCommand::cancelDelete() {
             Node *node = qobject_cast<Node*>(item);
             m_scene->addNode(node);
             if(node->attachedFrame()) node->attachedFrame()->addNodes(QList<QQuickItem*>({node}));
-            node->setParentItem(m_scene);
+            node->setParentItem(m_scene->canvas());
             m_scene->addSelected(node);
             node->generatePreview();
         }
@@ -341,13 +341,13 @@ void DeleteCommand::cancelDelete() {
             edge->endSocket()->addEdge(edge);
             edge->setStartPosition(edge->startSocket()->globalPos());
             edge->setEndPosition(edge->endSocket()->globalPos());
-            edge->setParentItem(m_scene);
+            edge->setParentItem(m_scene->canvas());
             edge->endSocket()->setValue(edge->startSocket()->value());
         }
         else if(qobject_cast<Frame*>(item)) {
             Frame *frame = qobject_cast<Frame*>(item);
             m_scene->addFrame(frame);
-            frame->setParentItem(m_scene);
+            frame->setParentItem(m_scene->canvas());
             m_scene->addSelected(frame);
             for(auto item: frame->contentList()) {
                 if(qobject_cast<Node*>(item)) {
@@ -480,7 +480,7 @@ void PasteCommand::redo() {
     for(auto item: m_pastedItems) {
         if(qobject_cast<Node*>(item)) {
             Node *node = qobject_cast<Node*>(item);
-            node->setParentItem(m_scene);
+            node->setParentItem(m_scene->canvas());
             node->setSelected(true);
             m_scene->addNode(node);
             m_scene->addSelected(node);
@@ -488,12 +488,12 @@ void PasteCommand::redo() {
         }
         else if(qobject_cast<Edge*>(item)) {
             Edge *edge = qobject_cast<Edge*>(item);
-            edge->setParentItem(m_scene);
+            edge->setParentItem(m_scene->canvas());
             m_scene->addEdge(edge);
         }
         else if(qobject_cast<Frame*>(item)) {
             Frame *frame = qobject_cast<Frame*>(item);
-            frame->setParentItem(m_scene);
+            frame->setParentItem(m_scene->canvas());
             frame->setSelected(true);
             m_scene->addFrame(frame);
             m_scene->addSelected(frame);
@@ -515,7 +515,9 @@ PropertyChangeCommand::~PropertyChangeCommand() {
 void PropertyChangeCommand::undo() {
     if(qobject_cast<Node*>(m_item)) {
         Node *n = qobject_cast<Node*>(m_item);
-        n->getPropertyPanel()->setProperty(m_propName, m_oldValue);
+        //node level properties are not mirrored on the panel
+        if(n->metaObject()->indexOfProperty(m_propName) >= 0) n->setProperty(m_propName, m_oldValue);
+        else n->getPropertyPanel()->setProperty(m_propName, m_oldValue);
     }
     else if(qobject_cast<Frame*>(m_item)) {
         Frame *f = qobject_cast<Frame*>(m_item);
@@ -526,7 +528,9 @@ void PropertyChangeCommand::undo() {
 void PropertyChangeCommand::redo() {
     if(qobject_cast<Node*>(m_item)) {
         Node *n = qobject_cast<Node*>(m_item);
-        n->getPropertyPanel()->setProperty(m_propName, m_newValue);
+        //node level properties are not mirrored on the panel
+        if(n->metaObject()->indexOfProperty(m_propName) >= 0) n->setProperty(m_propName, m_newValue);
+        else n->getPropertyPanel()->setProperty(m_propName, m_newValue);
     }
     else if(qobject_cast<Frame*>(m_item)) {
         Frame *f = qobject_cast<Frame*>(m_item);
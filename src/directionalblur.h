@@ -4,6 +4,8 @@
 #include <QQuickFramebufferObject>
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
+#include "blurengine.h"
+#include "workerkernel.h"
 
 class DirectionalBlurObject: public QQuickFramebufferObject
 {
@@ -44,6 +46,15 @@ private:
     int m_angle = 0;
 };
 
+class DirectionalBlurKernel: public WorkerKernel
+{
+public:
+    ~DirectionalBlurKernel();
+    void createDirectionalBlur(unsigned int sourceTexture, unsigned int maskTexture, QVector2D resolution, GLint bpc, int angle, float intensity, int generation);
+private:
+    BlurEngine *blurEngine = nullptr;
+};
+
 class DirectionalBlurRenderer: public QQuickFramebufferObject::Renderer, public QOpenGLFunctions_4_4_Core
 {
 public:
@@ -53,18 +64,15 @@ public:
     void synchronize(QQuickFramebufferObject *item);
     void render();
 private:
-    void createDirectionalBlur();
-    void updateTexResolution();
     void saveTexture(QString fileName);
     float m_intensity = 3.75f;
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA16;
-    unsigned int pingpongFBO[2];
-    unsigned int pingpongBuffer[2];
     unsigned int m_sourceTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
-    QOpenGLShaderProgram *dirBlurShader;
+    int m_angle = 0;
+    DirectionalBlurKernel *m_kernel;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
 };
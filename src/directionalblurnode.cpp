@@ -1,4 +1,5 @@
 #include "directionalblurnode.h"
+#include "textureformat.h"
 
 DirectionalBlurNode::DirectionalBlurNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
                                          float intensity, int angle): Node(parent, resolution, bpc),
@@ -9,51 +10,38 @@ DirectionalBlurNode::DirectionalBlurNode(QQuickItem *parent, QVector2D resolutio
     m_socketsInput[0]->setTip("Texture");
     m_socketsInput[1]->setTip("Mask");
     preview = new DirectionalBlurObject(grNode, m_resolution, m_bpc, m_intensity, m_angle);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &DirectionalBlurObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &DirectionalBlurObject::textureChanged, this, &DirectionalBlurNode::setOutput);
     connect(this, &DirectionalBlurNode::changeResolution, preview, &DirectionalBlurObject::setResolution);
     connect(this, &Node::changeBPC, preview, &DirectionalBlurObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/DirectionalBlurProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+DirectionalBlurNode::~DirectionalBlurNode() {
+    delete preview;
+}
+
+void DirectionalBlurNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/DirectionalBlurProperty.qml"));
     propertiesPanel->setProperty("startIntensity", m_intensity);
     propertiesPanel->setProperty("startAngle", m_angle);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(intensityChanged(qreal)), this, SLOT(updateIntensity(qreal)));
     connect(propertiesPanel, SIGNAL(angleChanged(int)), this, SLOT(updateAngle(int)));
     connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-DirectionalBlurNode::~DirectionalBlurNode() {
-    delete preview;
-}
-
 void DirectionalBlurNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->bluredTex = true;
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &DirectionalBlurNode::getPreviewTexture() {
@@ -65,7 +53,7 @@ void DirectionalBlurNode::saveTexture(QString fileName) {
 }
 
 DirectionalBlurNode *DirectionalBlurNode::clone() {
-    return new DirectionalBlurNode(parentItem(), m_resolution, m_bpc, m_intensity, m_angle);
+    return new DirectionalBlurNode(parentItem(), m_graphResolution, m_bpc, m_intensity, m_angle);
 }
 
 void DirectionalBlurNode::serialize(QJsonObject &json) const {
@@ -83,14 +71,13 @@ void DirectionalBlurNode::deserialize(const QJsonObject &json, QHash<QUuid, Sock
     if(json.contains("angle")) {
         m_angle = json["angle"].toInt();
     }
-    propertiesPanel->setProperty("startIntensity", m_intensity);
-    propertiesPanel->setProperty("startAngle", m_angle);
+    setPropertyOnPanel("startIntensity", m_intensity);
+    setPropertyOnPanel("startAngle", m_angle);
 
     preview->setIntensity(m_intensity);
     preview->setAngle(m_angle);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
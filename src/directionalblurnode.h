@@ -27,6 +27,8 @@ public slots:
     void updateIntensity(qreal intensity);
     void updateAngle(int angle);
     void setOutput();
+protected:
+    void createPropertiesPanel() override;
 private:
     DirectionalBlurObject *preview;
     float m_intensity = 3.75f;
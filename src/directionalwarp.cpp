@@ -1,6 +1,10 @@
 #include "directionalwarp.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 DirectionalWarpObject::DirectionalWarpObject(QQuickItem *parent, QVector2D resolution, GLint bpc,
                                              float intensity, int angle): QQuickFramebufferObject (parent),
@@ -97,18 +101,9 @@ void DirectionalWarpObject::setBPC(GLint bpc) {
 
 DirectionalWarpRenderer::DirectionalWarpRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    dirWarpShader = new QOpenGLShaderProgram();
-    dirWarpShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    dirWarpShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/directionalwarp.frag");
-    dirWarpShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    dirWarpShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/directionalwarp.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     dirWarpShader->bind();
     dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("sourceTexture"), 0);
     dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("warpTexture"), 1);
@@ -116,7 +111,6 @@ DirectionalWarpRenderer::DirectionalWarpRenderer(QVector2D res, GLint bpc): m_re
     dirWarpShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -138,12 +132,7 @@ DirectionalWarpRenderer::DirectionalWarpRenderer(QVector2D res, GLint bpc): m_re
     glBindFramebuffer(GL_FRAMEBUFFER, warpFBO);
     glGenTextures(1, &m_warpedTexture);
     glBindTexture(GL_TEXTURE_2D, m_warpedTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -157,9 +146,10 @@ DirectionalWarpRenderer::DirectionalWarpRenderer(QVector2D res, GLint bpc): m_re
 }
 
 DirectionalWarpRenderer::~DirectionalWarpRenderer() {
-    delete dirWarpShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(dirWarpShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_warpTexture);
     glDeleteTextures(1, &m_warpedTexture);
     glDeleteFramebuffers(1, &warpFBO);
@@ -187,16 +177,13 @@ void DirectionalWarpRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(dirWarpItem->warpedTex) {
             dirWarpItem->warpedTex = false;
-            m_sourceTexture = dirWarpItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, dirWarpItem->sourceTexture(), dirWarpItem->resolution());
             glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
             if(m_sourceTexture) {
-                m_warpTexture = dirWarpItem->warpTexture();
-                maskTexture = dirWarpItem->maskTexture();
-                dirWarpShader->bind();
-                dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("useMask"), maskTexture);
-                dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("intensity"), dirWarpItem->intensity());
-                dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("angle"), dirWarpItem->angle());
-                dirWarpShader->release();
+                m_warpTexture = Resampler::instance()->resample(this, 1, dirWarpItem->warpTexture(), dirWarpItem->resolution());
+                maskTexture = Resampler::instance()->resample(this, 2, dirWarpItem->maskTexture(), dirWarpItem->resolution());
+                m_intensity = dirWarpItem->intensity();
+                m_angle = dirWarpItem->angle();
             }
         }
         if(m_sourceTexture) {
@@ -227,6 +214,7 @@ void DirectionalWarpRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_warpedTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -244,6 +232,9 @@ void DirectionalWarpRenderer::createDirectionalWarp() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     dirWarpShader->bind();
+    dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("useMask"), maskTexture);
+    dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("intensity"), m_intensity);
+    dirWarpShader->setUniformValue(dirWarpShader->uniformLocation("angle"), m_angle);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glActiveTexture(GL_TEXTURE1);
@@ -264,12 +255,7 @@ void DirectionalWarpRenderer::createDirectionalWarp() {
 
 void DirectionalWarpRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_warpedTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -280,12 +266,7 @@ void DirectionalWarpRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_REPEAT);
@@ -298,6 +279,7 @@ void DirectionalWarpRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_warpedTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -305,41 +287,7 @@ void DirectionalWarpRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
     glDeleteFramebuffers(1, &fbo);
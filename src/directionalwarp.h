@@ -66,6 +66,8 @@ private:
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
     unsigned int warpFBO = 0;
+    float m_intensity = 0.0f;
+    int m_angle = 0;
     QOpenGLShaderProgram *dirWarpShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
@@ -1,4 +1,5 @@
 #include "directionalwarpnode.h"
+#include "textureformat.h"
 
 DirectionalWarpNode::DirectionalWarpNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
                                          float intensity, int angle): Node (parent, resolution, bpc),
@@ -10,56 +11,38 @@ DirectionalWarpNode::DirectionalWarpNode(QQuickItem *parent, QVector2D resolutio
     m_socketsInput[1]->setTip("Factor");
     m_socketsInput[2]->setTip("Mask");
     preview = new DirectionalWarpObject(grNode, m_resolution, m_bpc, m_intensity, m_angle);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &DirectionalWarpObject::changedTexture, this, &DirectionalWarpNode::setOutput);
     connect(preview, &DirectionalWarpObject::updatePreview, this, &Node::updatePreview);
     connect(this, &Node::changeResolution, preview, &DirectionalWarpObject::setResolution);
     connect(this, &Node::changeBPC, preview, &DirectionalWarpObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/DirectionalWarpProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+DirectionalWarpNode::~DirectionalWarpNode() {
+    delete preview;
+}
+
+void DirectionalWarpNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/DirectionalWarpProperty.qml"));
     propertiesPanel->setProperty("startIntensity", m_intensity);
     propertiesPanel->setProperty("startAngle", m_angle);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(intensityChanged(qreal)), this, SLOT(updateIntensity(qreal)));
     connect(propertiesPanel, SIGNAL(angleChanged(int)), this, SLOT(updateAngle(int)));
     connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-DirectionalWarpNode::~DirectionalWarpNode() {
-    delete preview;
-}
-
 void DirectionalWarpNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode2 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode2 && inputNode2->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[2]->getEdges().isEmpty()) {
-        Node *inputNode3 = static_cast<Node*>(m_socketsInput[2]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode3 && inputNode3->resolution() != m_resolution) return;
-        if(m_socketsInput[2]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setWarpTexture(m_socketsInput[1]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[2]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &DirectionalWarpNode::getPreviewTexture() {
@@ -71,7 +54,7 @@ void DirectionalWarpNode::saveTexture(QString fileName) {
 }
 
 DirectionalWarpNode *DirectionalWarpNode::clone() {
-    return new DirectionalWarpNode(parentItem(), m_resolution, m_bpc, m_intensity, m_angle);
+    return new DirectionalWarpNode(parentItem(), m_graphResolution, m_bpc, m_intensity, m_angle);
 }
 
 void DirectionalWarpNode::serialize(QJsonObject &json) const {
@@ -89,14 +72,13 @@ void DirectionalWarpNode::deserialize(const QJsonObject &json, QHash<QUuid, Sock
     if(json.contains("angle")) {
         m_angle = json["angle"].toInt();
     }
-    propertiesPanel->setProperty("startIntensity", m_intensity);
-    propertiesPanel->setProperty("startAngle", m_angle);
+    setPropertyOnPanel("startIntensity", m_intensity);
+    setPropertyOnPanel("startAngle", m_angle);
 
     preview->setIntensity(m_intensity);
     preview->setAngle(m_angle);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
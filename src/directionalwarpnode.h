@@ -27,6 +27,8 @@ public slots:
     void updateIntensity(qreal intensity);
     void updateAngle(int angle);
     void setOutput();
+protected:
+    void createPropertiesPanel() override;
 private:
     DirectionalWarpObject *preview;
     float m_intensity = 0.1f;
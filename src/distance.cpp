@@ -0,0 +1,330 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "distance.h"
+#include "shadercache.h"
+#include "textureexporter.h"
+#include "texturepool.h"
+#include "glworker.h"
+#include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
+
+DistanceObject::DistanceObject(QQuickItem *parent, QVector2D resolution, GLint bpc, int mode, float maxDistance):
+    QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc), m_mode(mode), m_maxDistance(maxDistance)
+{
+
+}
+
+QQuickFramebufferObject::Renderer *DistanceObject::createRenderer() const {
+    return new DistanceRenderer(m_resolution, m_bpc);
+}
+
+unsigned int &DistanceObject::texture() {
+    return m_texture;
+}
+
+void DistanceObject::setTexture(unsigned int texture) {
+    m_texture = texture;
+    textureChanged();
+}
+
+void DistanceObject::saveTexture(QString fileName) {
+    saveName = fileName;
+    texSaving = true;
+    update();
+}
+
+unsigned int DistanceObject::sourceTexture() {
+    return m_sourceTexture;
+}
+
+void DistanceObject::setSourceTexture(unsigned int texture) {
+    m_sourceTexture = texture;
+    distanceTex = true;
+}
+
+unsigned int DistanceObject::colorTexture() {
+    return m_colorTexture;
+}
+
+void DistanceObject::setColorTexture(unsigned int texture) {
+    m_colorTexture = texture;
+    distanceTex = true;
+}
+
+int DistanceObject::mode() {
+    return m_mode;
+}
+
+void DistanceObject::setMode(int mode) {
+    if(m_mode == mode) return;
+    m_mode = mode;
+    distanceTex = true;
+}
+
+float DistanceObject::maxDistance() {
+    return m_maxDistance;
+}
+
+void DistanceObject::setMaxDistance(float dist) {
+    if(m_maxDistance == dist) return;
+    m_maxDistance = dist;
+    distanceTex = true;
+}
+
+QVector2D DistanceObject::resolution() {
+    return m_resolution;
+}
+
+void DistanceObject::setResolution(QVector2D res) {
+    m_resolution = res;
+    resUpdated = true;
+    update();
+}
+
+GLint DistanceObject::bpc() {
+    return m_bpc;
+}
+
+void DistanceObject::setBPC(GLint bpc) {
+    if(m_bpc == bpc) return;
+    m_bpc = bpc;
+    bpcUpdated = true;
+}
+
+DistanceRenderer::DistanceRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc)
+{
+    initializeOpenGLFunctions();
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
+    textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
+    textureShader->release();
+    float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
+                    -1.0f, 1.0f, 0.0f, 1.0f,
+                    1.0f, -1.0f, 1.0f, 0.0f,
+                    1.0f, 1.0f, 1.0f, 1.0f};
+    unsigned int VBO;
+    glGenVertexArrays(1, &textureVAO);
+    glBindVertexArray(textureVAO);
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertQuadTex), vertQuadTex, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), nullptr);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    m_kernel = new DistanceKernel();
+}
+
+DistanceRenderer::~DistanceRenderer()
+{
+    Resampler::release(this);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
+    glDeleteVertexArrays(1, &textureVAO);
+    DistanceKernel *kernel = m_kernel;
+    kernel->nextGeneration();
+    GLWorker::instance()->post(kernel, [kernel]() { delete kernel; });
+}
+
+QOpenGLFramebufferObject *DistanceRenderer::createFramebufferObject(const QSize &size) {
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    return new QOpenGLFramebufferObject(size, format);
+}
+
+void DistanceRenderer::synchronize(QQuickFramebufferObject *item) {
+    DistanceObject *distanceItem = static_cast<DistanceObject*>(item);
+    m_kernel->setItem(item);
+    if(distanceItem->resUpdated) {
+        distanceItem->resUpdated = false;
+        m_resolution = distanceItem->resolution();
+    }
+    if(distanceItem->distanceTex || distanceItem->bpcUpdated) {
+        if(distanceItem->bpcUpdated) {
+            distanceItem->bpcUpdated = false;
+            m_bpc = distanceItem->bpc();
+        }
+        if(distanceItem->distanceTex) {
+            distanceItem->distanceTex = false;
+            m_sourceTexture = Resampler::instance()->resample(this, 0, distanceItem->sourceTexture(), distanceItem->resolution());
+            if(m_sourceTexture) {
+                m_colorTexture = Resampler::instance()->resample(this, 1, distanceItem->colorTexture(), distanceItem->resolution());
+                m_mode = distanceItem->mode();
+                m_maxDistance = distanceItem->maxDistance();
+            }
+        }
+        if(m_sourceTexture) {
+            DistanceKernel *kernel = m_kernel;
+            unsigned int source = m_sourceTexture;
+            unsigned int color = m_colorTexture;
+            QVector2D resolution = m_resolution;
+            GLint bpc = m_bpc;
+            int mode = m_mode;
+            float maxDistance = m_maxDistance;
+            int generation = kernel->nextGeneration();
+            GLWorker::instance()->post(kernel, [=]() {
+                kernel->distanceField(source, color, resolution, bpc, mode, maxDistance, generation);
+            });
+        }
+    }
+    if(m_kernel->publish(this)) {
+        distanceItem->setTexture(m_kernel->texture());
+        distanceItem->updatePreview(m_kernel->texture());
+    }
+
+    if(distanceItem->texSaving) {
+        distanceItem->texSaving = false;
+        saveTexture(distanceItem->saveName);
+    }
+}
+
+void DistanceRenderer::render() {
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    checkerShader->bind();
+    glBindVertexArray(textureVAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    checkerShader->release();
+
+    if(m_sourceTexture && m_kernel->texture()) {
+        textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
+        glBindVertexArray(textureVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_kernel->texture());
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glBindVertexArray(0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        textureShader->release();
+    }
+    glFlush();
+}
+
+void DistanceRenderer::saveTexture(QString fileName) {
+    unsigned int fbo;
+    unsigned int texture;
+    glGenFramebuffers(1, &fbo);
+    glGenTextures(1, &texture);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+    glViewport(0, 0, m_resolution.x(), m_resolution.y());
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
+    glBindVertexArray(textureVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_kernel->texture());
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    textureShader->release();
+
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);    
+    glDeleteTextures(1, &texture);
+    glDeleteFramebuffers(1, &fbo);
+}
+
+DistanceKernel::~DistanceKernel() {
+    if(!isInitialized()) return;
+    ShaderCache::release(distanceShader);
+    delete jumpFlood;
+}
+
+void DistanceKernel::distanceField(unsigned int sourceTexture, unsigned int colorTexture, QVector2D resolution, GLint bpc, int mode, float maxDistance, int generation) {
+    if(initialize()) {
+        distanceShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/distance.frag");
+        distanceShader->bind();
+        distanceShader->setUniformValue(distanceShader->uniformLocation("seedTexture"), 0);
+        distanceShader->setUniformValue(distanceShader->uniformLocation("innerSeedTexture"), 1);
+        distanceShader->setUniformValue(distanceShader->uniformLocation("colorTexture"), 2);
+        distanceShader->release();
+        jumpFlood = new JumpFlood();
+    }
+    if(isCancelled(generation)) return;
+    unsigned int distanceTexture = beginOutput(resolution, bpc);
+    auto cancelled = [this, generation]() { return isCancelled(generation); };
+    TexturePool *pool = TexturePool::instance();
+    //seeds are the bright pixels, the signed field also floods from the dark ones
+    TexturePool::Target seeds;
+    TexturePool::Target innerSeeds;
+    if(!jumpFlood->seeds(sourceTexture, resolution, true, seeds, cancelled)) {
+        abandonOutput();
+        return;
+    }
+    if(mode == 1 && !jumpFlood->seeds(sourceTexture, resolution, false, innerSeeds, cancelled)) {
+        pool->release(seeds);
+        abandonOutput();
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
+    glViewport(0, 0, resolution.x(), resolution.y());
+    glDisable(GL_DEPTH_TEST);
+    distanceShader->bind();
+    distanceShader->setUniformValue(distanceShader->uniformLocation("mode"), mode);
+    distanceShader->setUniformValue(distanceShader->uniformLocation("maxDistance"), maxDistance);
+    glBindVertexArray(textureVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, seeds.texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, innerSeeds.texture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, colorTexture ? colorTexture : sourceTexture);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    distanceShader->release();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    pool->release(seeds);
+    pool->release(innerSeeds);
+
+    glBindTexture(GL_TEXTURE_2D, distanceTexture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    finishOutput();
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DISTANCE_H
+#define DISTANCE_H
+
+#include <QQuickFramebufferObject>
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLShaderProgram>
+#include "jumpflood.h"
+#include "workerkernel.h"
+
+class DistanceObject: public QQuickFramebufferObject
+{
+    Q_OBJECT
+public:
+    DistanceObject(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, int mode = 0, float maxDistance = 0.25f);
+    QQuickFramebufferObject::Renderer *createRenderer() const;
+    unsigned int &texture();
+    void setTexture(unsigned int texture);
+    void saveTexture(QString fileName);
+    unsigned int sourceTexture();
+    void setSourceTexture(unsigned int texture);
+    unsigned int colorTexture();
+    void setColorTexture(unsigned int texture);
+    int mode();
+    void setMode(int mode);
+    float maxDistance();
+    void setMaxDistance(float dist);
+    QVector2D resolution();
+    void setResolution(QVector2D res);
+    GLint bpc();
+    void setBPC(GLint bpc);
+    bool distanceTex = false;
+    bool resUpdated = false;
+    bool bpcUpdated = false;
+    bool texSaving = false;
+    QString saveName = "";
+signals:
+    void updatePreview(unsigned int previewData);
+    void textureChanged();
+private:
+    QVector2D m_resolution;
+    GLint m_bpc = GL_RGBA16;
+    unsigned int m_texture = 0;
+    unsigned int m_sourceTexture = 0;
+    unsigned int m_colorTexture = 0;
+    int m_mode = 0;
+    float m_maxDistance = 0.25f;
+};
+
+class DistanceKernel: public WorkerKernel
+{
+public:
+    ~DistanceKernel();
+    void distanceField(unsigned int sourceTexture, unsigned int colorTexture, QVector2D resolution, GLint bpc, int mode, float maxDistance, int generation);
+private:
+    QOpenGLShaderProgram *distanceShader;
+    JumpFlood *jumpFlood = nullptr;
+};
+
+class DistanceRenderer: public QQuickFramebufferObject::Renderer, public QOpenGLFunctions_4_4_Core
+{
+public:
+    DistanceRenderer(QVector2D res, GLint bpc);
+    ~DistanceRenderer();
+    QOpenGLFramebufferObject *createFramebufferObject(const QSize &size);
+    void synchronize(QQuickFramebufferObject *item);
+    void render();
+private:
+    void saveTexture(QString fileName);
+    QVector2D m_resolution;
+    GLint m_bpc = GL_RGBA16;
+    unsigned int m_sourceTexture = 0;
+    unsigned int m_colorTexture = 0;
+    unsigned int textureVAO = 0;
+    int m_mode = 0;
+    float m_maxDistance = 0.25f;
+    DistanceKernel *m_kernel;
+    QOpenGLShaderProgram *checkerShader;
+    QOpenGLShaderProgram *textureShader;
+};
+
+#endif // DISTANCE_H
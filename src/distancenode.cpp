@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "distancenode.h"
+#include "textureformat.h"
+
+DistanceNode::DistanceNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int mode, float maxDistance):
+    Node(parent, resolution, bpc), m_mode(mode), m_maxDistance(maxDistance)
+{
+    createSockets(2, 1);
+    setTitle("Distance");
+    m_socketsInput[0]->setTip("Shape");
+    m_socketsInput[1]->setTip("Color");
+    preview = new DistanceObject(grNode, m_resolution, m_bpc, m_mode, m_maxDistance);
+    preview->setTransformOrigin(TopLeft);
+    preview->setWidth(174);
+    preview->setHeight(174);
+    preview->setX(3);
+    preview->setY(30);
+    connect(preview, &DistanceObject::textureChanged, this, &DistanceNode::setOutput);
+    connect(preview, &DistanceObject::updatePreview, this, &DistanceNode::updatePreview);
+    connect(this, &Node::changeResolution, preview, &DistanceObject::setResolution);
+    connect(this, &Node::changeBPC, preview, &DistanceObject::setBPC);
+}
+
+DistanceNode::~DistanceNode() {
+    delete preview;
+}
+
+void DistanceNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/DistanceProperty.qml"));
+    propertiesPanel->setProperty("startMode", m_mode);
+    propertiesPanel->setProperty("startMaxDistance", m_maxDistance);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(modeChanged(int)), this, SLOT(updateMode(int)));
+    connect(propertiesPanel, SIGNAL(maxDistanceChanged(qreal)), this, SLOT(updateMaxDistance(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
+void DistanceNode::operation() {
+    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    preview->setColorTexture(m_socketsInput[1]->value().toUInt());
+    if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
+    preview->update();
+}
+
+unsigned int &DistanceNode::getPreviewTexture() {
+    return preview->texture();
+}
+
+void DistanceNode::saveTexture(QString fileName) {
+    preview->saveTexture(fileName);
+}
+
+DistanceNode *DistanceNode::clone() {
+    return new DistanceNode(parentItem(), m_graphResolution, m_bpc, m_mode, m_maxDistance);
+}
+
+void DistanceNode::serialize(QJsonObject &json) const {
+    Node::serialize(json);
+    json["type"] = 33;
+    json["mode"] = m_mode;
+    json["maxDistance"] = m_maxDistance;
+}
+
+void DistanceNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
+    Node::deserialize(json, hash);
+    if(json.contains("mode")) {
+        m_mode = json["mode"].toInt();
+    }
+    if(json.contains("maxDistance")) {
+        m_maxDistance = json["maxDistance"].toVariant().toFloat();
+    }
+    setPropertyOnPanel("startMode", m_mode);
+    setPropertyOnPanel("startMaxDistance", m_maxDistance);
+
+    preview->setMode(m_mode);
+    preview->setMaxDistance(m_maxDistance);
+
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
+
+    preview->update();
+}
+
+int DistanceNode::mode() {
+    return m_mode;
+}
+
+void DistanceNode::setMode(int mode) {
+    if(m_mode == mode) return;
+    m_mode = mode;
+    modeChanged(mode);
+    preview->setMode(mode);
+    preview->update();
+}
+
+float DistanceNode::maxDistance() {
+    return m_maxDistance;
+}
+
+void DistanceNode::setMaxDistance(float dist) {
+    if(m_maxDistance == dist) return;
+    m_maxDistance = dist;
+    maxDistanceChanged(dist);
+    preview->setMaxDistance(dist);
+    preview->update();
+}
+
+void DistanceNode::setOutput() {
+    m_socketOutput[0]->setValue(preview->texture());
+}
+
+void DistanceNode::updateMode(int mode) {
+    setMode(mode);
+    dataChanged();
+}
+
+void DistanceNode::updateMaxDistance(qreal dist) {
+    setMaxDistance(dist);
+    dataChanged();
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DISTANCENODE_H
+#define DISTANCENODE_H
+
+#include "node.h"
+#include "distance.h"
+
+class DistanceNode: public Node
+{
+    Q_OBJECT
+public:
+    DistanceNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, int mode = 0, float maxDistance = 0.25f);
+    ~DistanceNode();
+    void operation() override;
+    unsigned int &getPreviewTexture() override;
+    void saveTexture(QString fileName) override;
+    DistanceNode *clone() override;
+    void serialize(QJsonObject &json) const override;
+    void deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) override;
+    int mode();
+    void setMode(int mode);
+    float maxDistance();
+    void setMaxDistance(float dist);
+signals:
+    void modeChanged(int mode);
+    void maxDistanceChanged(float dist);
+public slots:
+    void setOutput();
+    void updateMode(int mode);
+    void updateMaxDistance(qreal dist);
+protected:
+    void createPropertiesPanel() override;
+private:
+    DistanceObject *preview;
+    int m_mode = 0;
+    float m_maxDistance = 0.25f;
+};
+
+#endif // DISTANCENODE_H
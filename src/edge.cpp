@@ -29,13 +29,10 @@ Edge::Edge(QQuickItem *parent): QQuickItem(parent)
 {
     selEdge = new CubicBezier(this);
     grEdge = new CubicBezier(this);
-    if(parent) {
-        Scene *scene = reinterpret_cast<Scene*>(parent);
-        connect(scene->background(), &BackgroundObject::scaleChanged, this, &Edge::updateScale);
-        grEdge->setLineWidth(3.0f*scene->background()->viewScale());
-        selEdge->setLineWidth(5.0f*scene->background()->viewScale());
-        selEdge->setColor(QColor(219, 219, 219));
-    }
+    //lines keep their width in pixels while the canvas zooms
+    grEdge->setLineWidth(3.0f);
+    selEdge->setLineWidth(5.0f);
+    selEdge->setColor(QColor(219, 219, 219));
     selEdge->setVisible(false);
     setZ(3);
 }
@@ -164,10 +161,9 @@ void Edge::setEndSocket(Socket *socket) {
 }
 
 Socket* Edge::findSockets(Scene *scene, float x, float y) {
-    QQuickItem *item = scene->childAt(x, y);
-    if(qobject_cast<Node*>(item)) {
-        Node *n = qobject_cast<Node*>(item);
-        QPointF childPos = n->mapFromItem(scene, QPointF(x, y));
+    Node *n = scene->nodeAt(x, y);
+    if(n) {
+        QPointF childPos = n->mapFromItem(scene->canvas(), QPointF(x, y));
         QQuickItem *child = n->childAt(childPos.x(), childPos.y());
         if(qobject_cast<Socket*>(child)) {
             Socket *s = qobject_cast<Socket*>(child);
@@ -212,14 +208,8 @@ void Edge::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
     }
 }
 
-void Edge::updateScale(float scale) {
-    m_scale = scale;
-    grEdge->setLineWidth(std::max(3.0f*scale, 1.0f));
-    selEdge->setLineWidth(std::max(5.0f*scale, 1.0f));
-}
-
 void Edge::pressedEdge(bool control) {
-    Scene *scene = reinterpret_cast<Scene*>(parentItem());
+    Scene *scene = Scene::sceneOf(this);
     if(control) {
         setSelected(!m_selected);
         if(m_selected) {
@@ -22,7 +22,7 @@
 #ifndef EDGE_H
 #define EDGE_H
 #include <QQuickItem>
-#include <QQuickView>
+#include <QQuickWindow>
 #include <QJsonObject>
 #include "cubicbezier.h"
 
@@ -58,7 +58,6 @@ signals:
     void startPositionChanged(QVector2D pos);
     void endPositionChanged(QVector2D pos);
 public slots:
-    void updateScale(float scale);
     void pressedEdge(bool controlModifier);
 private:
     CubicBezier *grEdge;
@@ -67,7 +66,6 @@ private:
     QVector2D m_endPos;
     Socket *m_startSocket = nullptr;
     Socket *m_endSocket = nullptr;
-    float m_scale = 1.0f;
     bool m_selected = false;
 };
 
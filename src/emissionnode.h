@@ -19,6 +19,8 @@ public slots:
     void emissionSave(QString dir);
 signals:
     void emissionChanged(unsigned int emission);
+protected:
+    void createPropertiesPanel();
 private:
     NormalObject *preview;
 };
@@ -53,25 +53,22 @@ Frame::Frame(QQuickItem *parent): QQuickItem (parent)
     setTransformOrigin(TopLeft);
     setWidth(200);
     setHeight(100);
-    m_view = new QQuickView();
-    m_view->setSource(QUrl(QStringLiteral("qrc:/qml/NodeFrame.qml")));
-    m_grFrame = qobject_cast<QQuickItem *>(m_view->rootObject());
+    m_grFrame = QmlLoader::create(QStringLiteral("qrc:/qml/NodeFrame.qml"));
     m_grFrame->setParentItem(this);    
-    connect(this, SIGNAL(nameInput()), m_grFrame, SLOT(createNameInput()));
-    connect(m_grFrame, SIGNAL(titleChanged(QString, QString)), this, SLOT(titleChanged(QString, QString)));
-    m_propView = new QQuickView();
-    m_propView->setSource(QUrl(QStringLiteral("qrc:/qml/ColorProperty.qml")));
-    m_propertiesPanel = qobject_cast<QQuickItem*>(m_propView->rootObject());
-    connect(m_propertiesPanel, SIGNAL(colorChanged(QVector3D)), this, SLOT(updateColor(QVector3D)));
-    connect(m_propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+    m_propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/ColorProperty.qml"));
+    //headless items are plain QQuickItems without the QML signals
+    if(!QmlLoader::headless()) {
+        connect(this, SIGNAL(nameInput()), m_grFrame, SLOT(createNameInput()));
+        connect(m_grFrame, SIGNAL(titleChanged(QString, QString)), this, SLOT(titleChanged(QString, QString)));
+        connect(m_propertiesPanel, SIGNAL(colorChanged(QVector3D)), this, SLOT(updateColor(QVector3D)));
+        connect(m_propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+    }
     m_propertiesPanel->setProperty("startColor", m_color);
 }
 
 Frame::~Frame() {
     delete m_grFrame;
-    delete m_view;
     delete m_propertiesPanel;
-    delete m_propView;
 }
 
 float Frame::baseX() {
@@ -93,7 +90,8 @@ void Frame::setBaseX(float x) {
         }*/
     }
     m_baseX = x;
-    setX(x*m_scale - m_pan.x());
+    setX(x);
+    changeBaseX(x);
 }
 
 float Frame::baseY() {
@@ -115,7 +113,8 @@ void Frame::setBaseY(float y) {
         }*/
     }
     m_baseY = y;
-    setY(y*m_scale - m_pan.y());
+    setY(y);
+    changeBaseY(y);
 }
 
 QString Frame::title() {
@@ -139,22 +138,6 @@ void Frame::setColor(QVector3D color) {
     m_grFrame->setProperty("startColor", m_color);
 }
 
-QVector2D Frame::pan() {
-    return m_pan;
-}
-
-void Frame::setPan(QVector2D pan) {
-    m_pan = pan;
-    setX(m_baseX*m_scale - pan.x());
-    setY(m_baseY*m_scale - pan.y());
-}
-
-void Frame::setScaleView(float scale) {
-    m_scale = scale;
-    setScale(scale);
-    m_grFrame->setProperty("scaleView", scale);
-}
-
 void Frame::resizeByContent() {
     double minX = std::numeric_limits<double>::max();
     double minY = minX;
@@ -169,25 +152,27 @@ void Frame::resizeByContent() {
             maxY = std::max(maxY, static_cast<double>(node->baseY()) + node->height());
         }
     }
-    setX((minX - 10)*m_scale - m_pan.x());
-    setY((minY - 55)*m_scale - m_pan.y());
     m_baseX = minX - 10;
     m_baseY = minY - 55;
+    setX(m_baseX);
+    setY(m_baseY);
     setWidth(maxX - minX + 20);
     setHeight(maxY - minY + 75);
+    changeBaseX(m_baseX);
+    changeBaseY(m_baseY);
 }
 
 void Frame::mousePressEvent(QMouseEvent *event) {
     if(event->button() == Qt::LeftButton) {
         setFocus(true);
         setFocus(false);
-        lastX = event->pos().x()*m_scale;
-        lastY = event->pos().y()*m_scale;
+        lastX = event->pos().x();
+        lastY = event->pos().y();
         m_oldX = m_baseX;
         m_oldY = m_baseY;
         m_moved = false;
         if(event->pos().y() < 45.0f && currentResize == resize::NOT) {
-            Scene *scene = qobject_cast<Scene*>(parentItem());
+            Scene *scene = Scene::sceneOf(this);
             if(event->modifiers() == Qt::ControlModifier) {
                setSelected(!m_selected);
                QList<QQuickItem*> selectedList = scene->selectedList();
@@ -221,109 +206,109 @@ void Frame::mouseMoveEvent(QMouseEvent *event) {
         QPointF point = mapToItem(parentItem(), QPointF(event->pos().x(), event->pos().y()));
         float offsetX = point.x() - x();
         float offsetY = point.y() - y();
-        Scene *scene = qobject_cast<Scene*>(parentItem());
+        Scene *scene = Scene::sceneOf(this);
         float offX = 0;
         float offY = 0;
         float offW = 0;
         float offH = 0;
         switch (currentResize) {
         case LEFT:
-            if(width() - offsetX/m_scale > m_minWidth) {
-                offX = (point.x() + m_pan.x())/m_scale - m_baseX;
-                offW = -offsetX/m_scale;
+            if(width() - offsetX > m_minWidth) {
+                offX = point.x() - m_baseX;
+                offW = -offsetX;
             }
             else {
-                offsetX = (width() - m_minWidth)*m_scale;
-                offX = (x() + offsetX + m_pan.x())/m_scale - m_baseX;
-                offW = -offsetX/m_scale;
+                offsetX = width() - m_minWidth;
+                offX = x() + offsetX - m_baseX;
+                offW = -offsetX;
             }
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case RIGHT:
-            if(offsetX/m_scale < m_minWidth) offsetX = m_minWidth*m_scale;
-            offW = (offsetX/m_scale - width());
+            if(offsetX < m_minWidth) offsetX = m_minWidth;
+            offW = (offsetX - width());
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case TOP:
-            if(height() - offsetY/m_scale > m_minHeight) {
-                offY = (point.y() + m_pan.y())/m_scale - m_baseY;
-                offH = -offsetY/m_scale;
+            if(height() - offsetY > m_minHeight) {
+                offY = point.y() - m_baseY;
+                offH = -offsetY;
             }
             else {
-                offsetY = (height() - m_minHeight)*m_scale;
-                offY = (y() + offsetY + m_pan.y())/m_scale - m_baseY;
-                offH = -offsetY/m_scale;
+                offsetY = height() - m_minHeight;
+                offY = y() + offsetY - m_baseY;
+                offH = -offsetY;
             }
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case BOTTOM:
-            if(offsetY/m_scale < m_minHeight) offsetY = m_minHeight*m_scale;
-            offH = offsetY/m_scale - height();
+            if(offsetY < m_minHeight) offsetY = m_minHeight;
+            offH = offsetY - height();
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case TOPLEFT:
-            if(width() - offsetX/m_scale > m_minWidth) {
-                offX = (point.x() + m_pan.x())/m_scale - m_baseX;
-                offW = -offsetX/m_scale;
+            if(width() - offsetX > m_minWidth) {
+                offX = point.x() - m_baseX;
+                offW = -offsetX;
             }
             else {
-                offsetX = (width() - m_minWidth)*m_scale;
-                offX = (x() + offsetX + m_pan.x())/m_scale - m_baseX;
-                offW = -offsetX/m_scale;
+                offsetX = width() - m_minWidth;
+                offX = x() + offsetX - m_baseX;
+                offW = -offsetX;
             }
-            if(height() - offsetY/m_scale > m_minHeight) {
-                offY = (point.y() + m_pan.y())/m_scale - m_baseY;
-                offH = -offsetY/m_scale;
+            if(height() - offsetY > m_minHeight) {
+                offY = point.y() - m_baseY;
+                offH = -offsetY;
             }
             else {
-                offsetY = (height() - m_minHeight)*m_scale;
-                offY = (y() + offsetY + m_pan.y())/m_scale - m_baseY;
-                offH = -offsetY/m_scale;
+                offsetY = height() - m_minHeight;
+                offY = y() + offsetY - m_baseY;
+                offH = -offsetY;
             }
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case TOPRIGHT:
-            if(offsetX/m_scale < m_minWidth) offsetX = m_minWidth*m_scale;
-            offW = offsetX/m_scale - width();
-            if(height() - offsetY/m_scale > m_minHeight) {
-                offY = (point.y() + m_pan.y())/m_scale - m_baseY;
-                offH = -offsetY/m_scale;
+            if(offsetX < m_minWidth) offsetX = m_minWidth;
+            offW = offsetX - width();
+            if(height() - offsetY > m_minHeight) {
+                offY = point.y() - m_baseY;
+                offH = -offsetY;
             }
             else {
-                offsetY = (height() - m_minHeight)*m_scale;
-                offY = (y() + offsetY + m_pan.y())/m_scale - m_baseY;
-                offH = -offsetY/m_scale;
+                offsetY = height() - m_minHeight;
+                offY = y() + offsetY - m_baseY;
+                offH = -offsetY;
             }
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case BOTTOMLEFT:
-            if(width() - offsetX/m_scale > m_minWidth) {
-                offX = (point.x() + m_pan.x())/m_scale - m_baseX;
-                offW = -offsetX/m_scale;
+            if(width() - offsetX > m_minWidth) {
+                offX = point.x() - m_baseX;
+                offW = -offsetX;
             }
             else {
-                offsetX = (width() - m_minWidth)*m_scale;
-                offX = (x() + offsetX + m_pan.x())/m_scale - m_baseX;
-                offW = -offsetX/m_scale;
+                offsetX = width() - m_minWidth;
+                offX = x() + offsetX - m_baseX;
+                offW = -offsetX;
             }
-            if(offsetY/m_scale < m_minHeight) offsetY = m_minHeight*m_scale;
-            offH = offsetY/m_scale - height();
+            if(offsetY < m_minHeight) offsetY = m_minHeight;
+            offH = offsetY - height();
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case BOTTOMRIGHT:
-            if(offsetX/m_scale < m_minWidth) offsetX = m_minWidth*m_scale;
-            offW = offsetX/m_scale - width();
-            if(offsetY/m_scale < m_minHeight) offsetY = m_minHeight*m_scale;
-            offH = offsetY/m_scale - height();
+            if(offsetX < m_minWidth) offsetX = m_minWidth;
+            offW = offsetX - width();
+            if(offsetY < m_minHeight) offsetY = m_minHeight;
+            offH = offsetY - height();
             scene->resizedFrame(this, offX, offY, offW, offH);
             break;
         case NOT:
             m_moved = true;
-            Scene *scene = qobject_cast<Scene*>(parentItem());
+            Scene *scene = Scene::sceneOf(this);
             setX(point.x() - lastX);
-            float offsetBaseX = (x() + m_pan.x())/m_scale - m_baseX;
+            float offsetBaseX = x() - m_baseX;
             setY(point.y() - lastY);
-            float offsetBaseY = (y() + m_pan.y())/m_scale - m_baseY;
+            float offsetBaseY = y() - m_baseY;
             for(int i = 0; i < scene->countSelected(); ++i) {
                 QQuickItem *item = scene->atSelected(i);
                 if(qobject_cast<Node*>(item)) {
@@ -343,7 +328,7 @@ void Frame::mouseMoveEvent(QMouseEvent *event) {
 
 void Frame::mouseReleaseEvent(QMouseEvent *event) {
     if(event->button() == Qt::LeftButton && event->modifiers() == Qt::NoModifier) {
-        Scene *scene = qobject_cast<Scene*>(parentItem());
+        Scene *scene = Scene::sceneOf(this);
         if(m_selected && !m_moved) {            
             if(scene->countSelected() == 1) return;
             QList<QQuickItem*> selectedList = scene->selectedList();
@@ -361,7 +346,7 @@ void Frame::mouseReleaseEvent(QMouseEvent *event) {
 void Frame::mouseDoubleClickEvent(QMouseEvent *event) {
     int eventX = event->pos().x();
     int eventY = event->pos().y();
-    if(eventX >= 5*m_scale && eventX <= (width() - 5*m_scale) && eventY >= 10*m_scale && eventY <= 35*m_scale){
+    if(eventX >= 5 && eventX <= (width() - 5) && eventY >= 10 && eventY <= 35){
         nameInput();
     }
 }
@@ -383,36 +368,38 @@ void Frame::hoverMoveEvent(QHoverEvent *event) {
         setCursor(QCursor(Qt::ArrowCursor));
         return;
     }
-    float mouseAreaSize = 3.0f;
-    if(event->pos().x() < mouseAreaSize/m_scale && (event->pos().y() > mouseAreaSize/m_scale && event->pos().y() < height() - mouseAreaSize/m_scale)) {
+    //resize handles stay three pixels wide at any zoom
+    Scene *scene = Scene::sceneOf(this);
+    float mouseAreaSize = 3.0f/(scene ? scene->background()->viewScale() : 1.0f);
+    if(event->pos().x() < mouseAreaSize && (event->pos().y() > mouseAreaSize && event->pos().y() < height() - mouseAreaSize)) {
         currentResize = LEFT;
         window()->setCursor(QCursor(Qt::SizeHorCursor));
     }
-    else if(event->pos().x() > width() - mouseAreaSize/m_scale && (event->pos().y() > mouseAreaSize/m_scale && event->pos().y() < height() - mouseAreaSize/m_scale)) {
+    else if(event->pos().x() > width() - mouseAreaSize && (event->pos().y() > mouseAreaSize && event->pos().y() < height() - mouseAreaSize)) {
         currentResize = RIGHT;
         window()->setCursor(QCursor(Qt::SizeHorCursor));
     }
-    else if((event->pos().x() > mouseAreaSize/m_scale && event->pos().x() < width() - mouseAreaSize/m_scale) && event->pos().y() < mouseAreaSize/m_scale) {
+    else if((event->pos().x() > mouseAreaSize && event->pos().x() < width() - mouseAreaSize) && event->pos().y() < mouseAreaSize) {
         currentResize = TOP;
         window()->setCursor(QCursor(Qt::SizeVerCursor));
     }
-    else if((event->pos().x() > mouseAreaSize/m_scale && event->pos().x() < width() - mouseAreaSize/m_scale) && event->pos().y() > height() - mouseAreaSize/m_scale) {
+    else if((event->pos().x() > mouseAreaSize && event->pos().x() < width() - mouseAreaSize) && event->pos().y() > height() - mouseAreaSize) {
         currentResize = BOTTOM;
         window()->setCursor(QCursor(Qt::SizeVerCursor));
     }
-    else if(event->pos().x() < mouseAreaSize/m_scale && event->pos().y() < mouseAreaSize/m_scale) {
+    else if(event->pos().x() < mouseAreaSize && event->pos().y() < mouseAreaSize) {
         currentResize = TOPLEFT;
         window()->setCursor(QCursor(Qt::SizeFDiagCursor));
     }
-    else if(event->pos().x() > width() - mouseAreaSize/m_scale && event->pos().y() < mouseAreaSize/m_scale) {
+    else if(event->pos().x() > width() - mouseAreaSize && event->pos().y() < mouseAreaSize) {
         currentResize = TOPRIGHT;
         window()->setCursor(QCursor(Qt::SizeBDiagCursor));
     }
-    else if(event->pos().x() < mouseAreaSize/m_scale && event->pos().y() > height() - mouseAreaSize/m_scale) {
+    else if(event->pos().x() < mouseAreaSize && event->pos().y() > height() - mouseAreaSize) {
         currentResize = BOTTOMLEFT;
         window()->setCursor(QCursor(Qt::SizeBDiagCursor));
     }
-    else if(event->pos().x() > width() - mouseAreaSize/m_scale && event->pos().y() > height() - mouseAreaSize/m_scale) {
+    else if(event->pos().x() > width() - mouseAreaSize && event->pos().y() > height() - mouseAreaSize) {
         currentResize = BOTTOMRIGHT;
         window()->setCursor(QCursor(Qt::SizeFDiagCursor));
     }
@@ -509,7 +496,7 @@ void Frame::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
     }
     if(json.contains("nodes") && json["nodes"].isArray()) {
         m_content.clear();
-        Scene *scene = qobject_cast<Scene*>(parentItem());
+        Scene *scene = Scene::sceneOf(this);
         QJsonArray nodes = json["nodes"].toArray();
         for(int i = 0; i < nodes.size(); ++i) {
             QJsonObject nodesObject = nodes[i].toObject();
@@ -528,7 +515,7 @@ void Frame::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
 }
 
 void Frame::titleChanged(QString newTitle, QString oldTitle) {
-    Scene *scene = qobject_cast<Scene*>(parentItem());
+    Scene *scene = Scene::sceneOf(this);
     scene->changedTitle(this, newTitle, oldTitle);
 }
 
@@ -536,7 +523,7 @@ void Frame::updateColor(QVector3D color) {
     setColor(color);
 }
 void Frame::propertyChanged(QString propName, QVariant newValue, QVariant oldValue) {
-    Scene* scene = reinterpret_cast<Scene*>(parentItem());
+    Scene* scene = Scene::sceneOf(this);
     if(scene) {
         std::string prop = propName.toStdString();
         char *name = new char[prop.size() + 1];
@@ -22,7 +22,6 @@
 #ifndef FRAME_H
 #define FRAME_H
 #include <QQuickItem>
-#include <QQuickView>
 #include "node.h"
 
 enum resize {LEFT, RIGHT, TOP, BOTTOM, TOPLEFT, TOPRIGHT, BOTTOMLEFT, BOTTOMRIGHT, NOT};
@@ -46,9 +45,6 @@ public:
     QQuickItem *getPropertyPanel();
     QVector3D color();
     void setColor(QVector3D color);
-    QVector2D pan();
-    void setPan(QVector2D pan);
-    void setScaleView(float scale);
     void resizeByContent();
     void mousePressEvent(QMouseEvent *event);
     void mouseMoveEvent(QMouseEvent *event);
@@ -68,22 +64,20 @@ public:
 signals:
     void nameInput();
     void colorChanged(QVector3D color);
+    void changeBaseX(float value);
+    void changeBaseY(float value);
 public slots:
     void titleChanged(QString newTitle, QString oldTitle);
     void updateColor(QVector3D color);
     void propertyChanged(QString propName, QVariant newValue, QVariant oldValue);
 private:
-    QQuickView *m_view = nullptr;
     QQuickItem *m_grFrame = nullptr;
     QQuickItem *m_propertiesPanel = nullptr;
-    QQuickView *m_propView = nullptr;
     QList<QQuickItem*> m_content;
     float m_baseX;
     float m_baseY;
     //float m_baseWidth = 200;
     //float m_baseHeight = 100;
-    float m_scale = 1.0f;
-    QVector2D m_pan = QVector2D(0, 0);
     float lastX = 0;
     float lastY = 0;
     float m_oldX = 0;
@@ -0,0 +1,161 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "glworker.h"
+#include <QCoreApplication>
+#include <QOpenGLExtraFunctions>
+#include <QDebug>
+
+GLWorker::GLWorker() {
+}
+
+GLWorker *GLWorker::instance() {
+    static GLWorker *worker = nullptr;
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    if(!worker) {
+        worker = new GLWorker();
+        worker->moveToThread(QCoreApplication::instance()->thread());
+    }
+    return worker;
+}
+
+bool GLWorker::isWorkerThread() {
+    QThread *thread = instance()->m_thread;
+    return thread && QThread::currentThread() == thread;
+}
+
+bool GLWorker::start(QOpenGLContext *shareContext) {
+    if(m_thread || !shareContext) return m_running;
+    m_context = new QOpenGLContext();
+    m_context->setFormat(shareContext->format());
+    m_context->setShareContext(shareContext);
+    if(!m_context->create()) {
+        qWarning("gl worker context couldn`t be created, nodes are evaluated on the render thread");
+        delete m_context;
+        m_context = nullptr;
+        return false;
+    }
+    m_surface = new QOffscreenSurface();
+    m_surface->setFormat(m_context->format());
+    m_surface->create();
+    m_running = true;
+    m_thread = QThread::create([this]() { run(); });
+    m_context->moveToThread(m_thread);
+    m_thread->start();
+    return true;
+}
+
+void GLWorker::stop() {
+    {
+        QMutexLocker locker(&m_mutex);
+        if(!m_thread) return;
+        m_running = false;
+        m_stopped = true;
+        m_condition.wakeAll();
+    }
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    delete m_surface;
+    m_surface = nullptr;
+}
+
+bool GLWorker::isBusy() {
+    QMutexLocker locker(&m_mutex);
+    return !m_jobs.isEmpty() || m_working || m_unpublished.load() > 0;
+}
+
+bool GLWorker::hasJob(const void *owner) {
+    QMutexLocker locker(&m_mutex);
+    if(m_current == owner) return true;
+    for(auto &job: m_jobs) {
+        if(job.owner == owner) return true;
+    }
+    return false;
+}
+
+void GLWorker::waitForJobs() {
+    QMutexLocker locker(&m_mutex);
+    while(!m_jobs.isEmpty() || m_working) {
+        m_done.wait(&m_mutex);
+    }
+}
+
+void GLWorker::post(const void *owner, std::function<void()> job) {
+    QMutexLocker locker(&m_mutex);
+    if(!m_running) {
+        locker.unlock();
+        //without a worker kernels run on the calling thread, after stop their contexts are gone
+        if(!m_stopped) job();
+        return;
+    }
+    //the worker waits on the gpu until everything the caller rendered so far is done
+    QOpenGLExtraFunctions *gl = QOpenGLContext::currentContext()->extraFunctions();
+    GLsync ready = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    gl->glFlush();
+    for(auto &j: m_jobs) {
+        if(j.owner != owner) continue;
+        //a queued job of the same owner is superseded, the newer fence covers the older one
+        gl->glDeleteSync(j.ready);
+        j.run = job;
+        j.ready = ready;
+        return;
+    }
+    m_jobs.append({owner, job, ready});
+    m_condition.wakeOne();
+}
+
+void GLWorker::run() {
+    QMutexLocker locker(&m_mutex);
+    if(!m_context->makeCurrent(m_surface)) {
+        //no job may issue gl calls without a context, later posts run on the calling thread
+        qWarning("gl worker context couldn`t be made current, nodes are evaluated on the render thread");
+        m_running = false;
+        m_jobs.clear();
+        m_done.wakeAll();
+        locker.unlock();
+        delete m_context;
+        m_context = nullptr;
+        return;
+    }
+    QOpenGLExtraFunctions *gl = m_context->extraFunctions();
+    while(true) {
+        while(m_running && m_jobs.isEmpty()) {
+            m_condition.wait(&m_mutex);
+        }
+        if(m_jobs.isEmpty()) break;
+        Job job = m_jobs.takeFirst();
+        m_working = true;
+        m_current = job.owner;
+        locker.unlock();
+        gl->glWaitSync(job.ready, 0, GL_TIMEOUT_IGNORED);
+        gl->glDeleteSync(job.ready);
+        job.run();
+        locker.relock();
+        m_working = false;
+        m_current = nullptr;
+        m_done.wakeAll();
+    }
+    locker.unlock();
+    delete m_context;
+    m_context = nullptr;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GLWORKER_H
+#define GLWORKER_H
+
+#include <QObject>
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <functional>
+
+class GLWorker: public QObject
+{
+    Q_OBJECT
+public:
+    static GLWorker *instance();
+    static bool isWorkerThread();
+    bool start(QOpenGLContext *shareContext = QOpenGLContext::globalShareContext());
+    void stop();
+    bool isBusy();
+    bool hasJob(const void *owner);
+    void waitForJobs();
+    void post(const void *owner, std::function<void()> job);
+private:
+    friend class WorkerKernel;
+    struct Job {
+        const void *owner;
+        std::function<void()> run;
+        GLsync ready;
+    };
+    GLWorker();
+    void run();
+    QThread *m_thread = nullptr;
+    QOpenGLContext *m_context = nullptr;
+    QOffscreenSurface *m_surface = nullptr;
+    QList<Job> m_jobs;
+    const void *m_current = nullptr;
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QWaitCondition m_done;
+    QAtomicInt m_unpublished;
+    bool m_running = false;
+    bool m_stopped = false;
+    bool m_working = false;
+};
+
+#endif // GLWORKER_H
@@ -1,5 +1,9 @@
 #include "gradient.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
 
 GradientObject::GradientObject(QQuickItem *parent, QVector2D resolution, GLint bpc, QString type,
                                float startX, float startY, float endX, float endY, float centerWidth,
@@ -131,24 +135,14 @@ void GradientObject::setBPC(GLint bpc) {
 
 GradientRenderer::GradientRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc){
     initializeOpenGLFunctions();
-    gradientShader = new QOpenGLShaderProgram();
-    gradientShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    gradientShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/gradient.frag");
-    gradientShader->link();
+    gradientShader = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/gradient.frag");
 
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
 
-    renderTexture = new QOpenGLShaderProgram();
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    renderTexture->link();
+    renderTexture = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     renderTexture->bind();
     renderTexture->setUniformValue(renderTexture->uniformLocation("texture"), 0);
-    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     renderTexture->release();
 
     gradientShader->bind();
@@ -191,12 +185,7 @@ GradientRenderer::GradientRenderer(QVector2D res, GLint bpc): m_resolution(res),
     glBindFramebuffer(GL_FRAMEBUFFER, gradientFBO);
     glGenTextures(1, &gradientTexture);
     glBindTexture(GL_TEXTURE_2D, gradientTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -211,9 +200,10 @@ GradientRenderer::GradientRenderer(QVector2D res, GLint bpc): m_resolution(res),
 }
 
 GradientRenderer::~GradientRenderer() {
-    delete gradientShader;
-    delete checkerShader;
-    delete renderTexture;
+    Resampler::release(this);
+    ShaderCache::release(gradientShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(renderTexture);
     glDeleteTextures(1, &gradientTexture);
     glDeleteFramebuffers(1, &gradientFBO);
     glDeleteVertexArrays(1, &gradientVAO);
@@ -246,15 +236,12 @@ void GradientRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(gradientItem->generatedGradient) {
             gradientItem->generatedGradient = false;
-            m_maskTexture = gradientItem->maskTexture();
+            m_maskTexture = Resampler::instance()->resample(this, 0, gradientItem->maskTexture(), gradientItem->resolution());
             m_gradientType = gradientItem->gradientType();
-            gradientShader->bind();
-            gradientShader->setUniformValue(gradientShader->uniformLocation("startPos"), QVector2D(gradientItem->startX(), gradientItem->startY()));
-            gradientShader->setUniformValue(gradientShader->uniformLocation("endPos"), QVector2D(gradientItem->endX(), gradientItem->endY()));
-            gradientShader->setUniformValue(gradientShader->uniformLocation("whiteWidth"), gradientItem->reflectedWidth());
-            gradientShader->setUniformValue(gradientShader->uniformLocation("tiling"), gradientItem->tiling());
-            gradientShader->setUniformValue(gradientShader->uniformLocation("useMask"), m_maskTexture);
-            gradientShader->release();
+            m_startPos = QVector2D(gradientItem->startX(), gradientItem->startY());
+            m_endPos = QVector2D(gradientItem->endX(), gradientItem->endY());
+            m_whiteWidth = gradientItem->reflectedWidth();
+            m_tiling = gradientItem->tiling();
         }
         createGradient();
         gradientItem->setTexture(gradientTexture);
@@ -282,6 +269,7 @@ void GradientRenderer::render() {
 
     glBindVertexArray(textureVAO);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, gradientTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -298,6 +286,11 @@ void GradientRenderer::createGradient() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(gradientVAO);
     gradientShader->bind();
+    gradientShader->setUniformValue(gradientShader->uniformLocation("startPos"), m_startPos);
+    gradientShader->setUniformValue(gradientShader->uniformLocation("endPos"), m_endPos);
+    gradientShader->setUniformValue(gradientShader->uniformLocation("whiteWidth"), m_whiteWidth);
+    gradientShader->setUniformValue(gradientShader->uniformLocation("tiling"), m_tiling);
+    gradientShader->setUniformValue(gradientShader->uniformLocation("useMask"), m_maskTexture);
     gradientShader->setUniformValue(gradientShader->uniformLocation("res"), m_resolution);
     GLuint index = glGetSubroutineIndex(gradientShader->programId(), GL_FRAGMENT_SHADER, m_gradientType.toStdString().c_str());
     glUniformSubroutinesuiv(GL_FRAGMENT_SHADER, 1, &index);
@@ -317,12 +310,7 @@ void GradientRenderer::createGradient() {
 
 void GradientRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, gradientTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -334,12 +322,7 @@ void GradientRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -353,6 +336,7 @@ void GradientRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, gradientTexture);
@@ -361,41 +345,7 @@ void GradientRenderer::saveTexture(QString fileName) {
     glBindTexture(GL_TEXTURE_2D, 0);
     renderTexture->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
@@ -69,6 +69,10 @@ private:
     void createGradient();
     void updateTexResolution();
     void saveTexture(QString fileName);
+    QVector2D m_startPos;
+    QVector2D m_endPos;
+    float m_whiteWidth = 0.0f;
+    bool m_tiling = false;
     QOpenGLShaderProgram *gradientShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *renderTexture;
@@ -1,4 +1,5 @@
 #include "gradientnode.h"
+#include "textureformat.h"
 
 GradientNode::GradientNode(QQuickItem *parent, QVector2D resolution, GLint bpc, GradientParams linear,
                            GradientParams reflected, GradientParams angular, GradientParams radial,
@@ -10,22 +11,25 @@ GradientNode::GradientNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
     setTitle("Gradient");
     m_socketsInput[0]->setTip("Mask");
     preview = new GradientObject(grNode, m_resolution, m_bpc, m_gradientType, startX(), startY(), endX(), endY(), centerWidth(), tiling());
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &GradientNode::previewGenerated);
     connect(this, &GradientNode::gradientTypeChanged, preview, &GradientObject::setGradientType);
     connect(preview, &GradientObject::changedTexture, this, &GradientNode::setOutput);
     connect(preview, &GradientObject::updatePreview, this, &GradientNode::updatePreview);
     connect(this, &Node::changeResolution, preview, &GradientObject::setResolution);
     connect(this, &Node::changeBPC, preview, &GradientObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/GradientProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+GradientNode::~GradientNode() {
+    delete preview;
+}
+
+void GradientNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/GradientProperty.qml"));
     int index = 0;
     if(m_gradientType == "reflected") index = 1;
     else if (m_gradientType == "angular") index = 2;
@@ -37,8 +41,7 @@ GradientNode::GradientNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
     propertiesPanel->setProperty("startEndY", endY());
     propertiesPanel->setProperty("startCenterWidth", centerWidth());
     propertiesPanel->setProperty("startTiling", tiling());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(gradientTypeChanged(QString)), this, SLOT(updateGradientType(QString)));
     connect(propertiesPanel, SIGNAL(startXChanged(qreal)), this, SLOT(updateStartX(qreal)));
     connect(propertiesPanel, SIGNAL(startYChanged(qreal)), this, SLOT(updateStartY(qreal)));
@@ -50,22 +53,12 @@ GradientNode::GradientNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-GradientNode::~GradientNode() {
-    delete preview;
-}
-
 void GradientNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
     preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
-    deserializing = false;
 }
 
 GradientNode *GradientNode::clone() {
-    return new GradientNode(parentItem(), m_resolution, m_bpc, m_linear, m_reflected, m_angular, m_radial,
+    return new GradientNode(parentItem(), m_graphResolution, m_bpc, m_linear, m_reflected, m_angular, m_radial,
                             m_gradientType);
 }
 
@@ -180,13 +173,13 @@ void GradientNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &
         if(m_gradientType == "reflected") index = 1;
         else if (m_gradientType == "angular") index = 2;
         else if(m_gradientType == "radial") index = 3;
-        propertiesPanel->setProperty("type", index);
-        propertiesPanel->setProperty("startStartX", startX());
-        propertiesPanel->setProperty("startStartY", startY());
-        propertiesPanel->setProperty("startEndX", endX());
-        propertiesPanel->setProperty("startEndY", endY());
-        propertiesPanel->setProperty("startCenterWidth", centerWidth());
-        propertiesPanel->setProperty("startTiling", tiling());
+        setPropertyOnPanel("type", index);
+        setPropertyOnPanel("startStartX", startX());
+        setPropertyOnPanel("startStartY", startY());
+        setPropertyOnPanel("startEndX", endX());
+        setPropertyOnPanel("startEndY", endY());
+        setPropertyOnPanel("startCenterWidth", centerWidth());
+        setPropertyOnPanel("startTiling", tiling());
 
         preview->setStartX(startX());
         preview->setStartY(startY());
@@ -195,8 +188,7 @@ void GradientNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &
         preview->setReflectedWidth(centerWidth());
         preview->setTiling(tiling());
     }
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
     preview->update();
 }
 
@@ -230,12 +222,12 @@ QString GradientNode::gradientType() {
 
 void GradientNode::setGradientType(QString type) {
     m_gradientType = type;
-    propertiesPanel->setProperty("startStartX", startX());
-    propertiesPanel->setProperty("startStartY", startY());
-    propertiesPanel->setProperty("startEndX", endX());
-    propertiesPanel->setProperty("startEndY", endY());
-    propertiesPanel->setProperty("startCenterWidth", centerWidth());
-    propertiesPanel->setProperty("startTiling", tiling());
+    setPropertyOnPanel("startStartX", startX());
+    setPropertyOnPanel("startStartY", startY());
+    setPropertyOnPanel("startEndX", endX());
+    setPropertyOnPanel("startEndY", endY());
+    setPropertyOnPanel("startCenterWidth", centerWidth());
+    setPropertyOnPanel("startTiling", tiling());
     gradientTypeChanged(type);
 
     preview->setStartX(startX());
@@ -61,6 +61,8 @@ public slots:
     void updateTiling(bool tiling);
     void setOutput();
     void previewGenerated();
+protected:
+    void createPropertiesPanel() override;
 private:
     GradientObject *preview;
     QString m_gradientType = "linear";
@@ -0,0 +1,277 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "graphevaluator.h"
+#include "node.h"
+#include "glworker.h"
+#include "workerkernel.h"
+#include "pointchain.h"
+#include <QGuiApplication>
+
+GraphEvaluator::GraphEvaluator(QObject *parent): QObject(parent)
+{
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(300);
+    connect(&m_settleTimer, &QTimer::timeout, this, &GraphEvaluator::settle);
+}
+
+void GraphEvaluator::markDirty(Node *node) {
+    QList<Node*> stack({node});
+    while(!stack.isEmpty()) {
+        Node *n = stack.takeLast();
+        m_pending.remove(n);
+        if(m_dirty.contains(n)) continue;
+        m_dirty.insert(n);
+        stack.append(n->outputNodes());
+    }
+    m_orderValid = false;
+    schedule();
+}
+
+void GraphEvaluator::nodeChanged(Node *node) {
+    if(!m_dirty.contains(node)) m_pending[node] = m_syncFrame.load();
+    for(auto n: node->outputNodes()) {
+        markDirty(n);
+    }
+    schedule();
+}
+
+void GraphEvaluator::outputChanged(Node *node) {
+    if(m_pending.remove(node)) {
+        schedule();
+        return;
+    }
+    if(m_dirty.contains(node)) return;
+    for(auto n: node->outputNodes()) {
+        markDirty(n);
+    }
+}
+
+void GraphEvaluator::resized(Node *node) {
+    //the renderer reallocates its output on the next sync, the node renders again after it
+    if(!m_window) {
+        markDirty(node);
+        return;
+    }
+    m_resized[node] = m_syncFrame.load();
+    m_window->update();
+}
+
+void GraphEvaluator::interact(Node *node) {
+    //the edited node and everything downstream render at proxy resolution
+    //until the input settles, unchanged inputs are resampled at the edges
+    if(!m_window) return;
+    QList<Node*> stack({node});
+    while(!stack.isEmpty()) {
+        Node *n = stack.takeLast();
+        if(m_proxy.contains(n)) continue;
+        m_proxy.insert(n);
+        //some renderers reallocate only after rendering, the proxy render waits a frame like any resize
+        QVector2D res = n->resolution();
+        n->setProxy(true);
+        if(n->resolution() != res) resized(n);
+        stack.append(n->outputNodes());
+    }
+    m_settleTimer.start();
+}
+
+void GraphEvaluator::removeNode(Node *node) {
+    m_dirty.remove(node);
+    m_pending.remove(node);
+    m_resized.remove(node);
+    m_proxy.remove(node);
+    m_order.removeAll(node);
+    m_fused.remove(node);
+    schedule();
+}
+
+bool GraphEvaluator::isDirty(Node *node) const {
+    return m_dirty.contains(node) || m_pending.contains(node);
+}
+
+bool GraphEvaluator::isIdle() const {
+    return m_dirty.isEmpty() && m_pending.isEmpty() && !GLWorker::instance()->isBusy();
+}
+
+void GraphEvaluator::suspend() {
+    m_suspended = true;
+}
+
+void GraphEvaluator::resume() {
+    m_suspended = false;
+    if(!m_dirty.isEmpty() || !m_pending.isEmpty()) schedule();
+}
+
+void GraphEvaluator::evaluate() {
+    m_scheduled = false;
+    if(m_evaluating) return;
+    m_evaluating = true;
+    for(auto node: m_fused.values()) {
+        if(canFuse(node)) continue;
+        m_fused.remove(node);
+        node->setFused(false);
+        markDirty(node);
+    }
+    if(!m_orderValid) sortDirty();
+    QList<Node*> order = m_order;
+    for(auto node: order) {
+        if(!m_dirty.contains(node) || !isReady(node)) continue;
+        m_dirty.remove(node);
+        if(canFuse(node)) {
+            //the consumer renders this node's stage in its own shader
+            if(!node->fused()) node->setFused(true);
+            m_fused.insert(node);
+            markDirty(node->outputNodes().first());
+            continue;
+        }
+        if(node->fused()) {
+            node->setFused(false);
+            m_fused.remove(node);
+        }
+        if(!node->outputNodes().isEmpty()) m_pending[node] = m_syncFrame.load();
+        node->operation();
+    }
+    QList<Node*> remaining;
+    for(auto node: m_order) {
+        if(m_dirty.contains(node)) remaining.append(node);
+    }
+    m_order = remaining;
+    m_evaluating = false;
+}
+
+void GraphEvaluator::viewChanged() {
+    //fused nodes have to render again once their preview becomes visible
+    if(!m_fused.isEmpty()) schedule();
+}
+
+void GraphEvaluator::setWindow(QQuickWindow *window) {
+    if(m_window) disconnect(m_window, nullptr, this, nullptr);
+    m_window = window;
+    if(!m_window) return;
+    connect(m_window, &QQuickWindow::afterAnimating, this, [this]() {
+        if(m_scheduled) evaluate();
+    });
+    connect(m_window, &QQuickWindow::beforeSynchronizing, this, [this]() {
+        m_syncFrame.ref();
+    }, Qt::DirectConnection);
+    connect(m_window, &QQuickWindow::afterRendering, this, [this]() {
+        int frame = m_syncFrame.load();
+        QMetaObject::invokeMethod(this, [this, frame]() { frameRendered(frame); }, Qt::QueuedConnection);
+    }, Qt::DirectConnection);
+}
+
+void GraphEvaluator::schedule() {
+    if(m_scheduled || m_suspended) return;
+    m_scheduled = true;
+    if(m_window) m_window->update();
+    else QMetaObject::invokeMethod(this, "evaluate", Qt::QueuedConnection);
+}
+
+void GraphEvaluator::sortDirty() {
+    QHash<Node*, int> inDegree;
+    for(auto node: m_dirty) {
+        int degree = 0;
+        for(auto input: node->inputNodes()) {
+            if(m_dirty.contains(input)) ++degree;
+        }
+        inDegree[node] = degree;
+    }
+    QList<Node*> queue;
+    for(auto it = inDegree.begin(); it != inDegree.end(); ++it) {
+        if(it.value() == 0) queue.append(it.key());
+    }
+    m_order.clear();
+    while(!queue.isEmpty()) {
+        Node *node = queue.takeFirst();
+        m_order.append(node);
+        for(auto output: node->outputNodes()) {
+            if(!inDegree.contains(output)) continue;
+            if(--inDegree[output] == 0) queue.append(output);
+        }
+    }
+    m_orderValid = true;
+}
+
+bool GraphEvaluator::isReady(Node *node) const {
+    if(m_resized.contains(node)) return false;
+    for(auto input: node->inputNodes()) {
+        if(m_dirty.contains(input) || m_pending.contains(input)) return false;
+    }
+    return true;
+}
+
+bool GraphEvaluator::canFuse(Node *node) const {
+    PointStage stage;
+    if(!node->pointStage(stage) || node->isPreviewVisible()) return false;
+    Socket *output = node->getOutputSocket(0);
+    if(!output || output->countEdge() != 1) return false;
+    Socket *end = output->getEdges()[0]->endSocket();
+    Node *consumer = qobject_cast<Node*>(end->parentItem());
+    if(!consumer || consumer->getInputSocket(0) != end || !consumer->pointStage(stage)) return false;
+    if(consumer->resolution() != node->resolution() || end->format() != consumer->bpc()) return false;
+    int length = 2;
+    Socket *input = node->getInputSocket(0);
+    while(input && input->countEdge() > 0) {
+        Node *upstream = qobject_cast<Node*>(input->getEdges()[0]->startSocket()->parentItem());
+        if(!upstream || !upstream->fused()) break;
+        ++length;
+        input = upstream->getInputSocket(0);
+    }
+    return length <= PointChain::maxStages();
+}
+
+void GraphEvaluator::frameRendered(int frame) {
+    for(auto it = m_resized.begin(); it != m_resized.end();) {
+        if(it.value() < frame) {
+            markDirty(it.key());
+            it = m_resized.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    //nodes synchronized without producing a texture must not block their consumers,
+    //but kernels on the gl worker publish their textures some frames later
+    bool released = false;
+    for(auto it = m_pending.begin(); it != m_pending.end();) {
+        if(it.value() < frame && !WorkerKernel::isBusy(it.key())) {
+            it = m_pending.erase(it);
+            released = true;
+        }
+        else {
+            ++it;
+        }
+    }
+    if(released) schedule();
+}
+
+void GraphEvaluator::settle() {
+    if(QGuiApplication::mouseButtons() != Qt::NoButton) {
+        m_settleTimer.start();
+        return;
+    }
+    for(auto node: m_proxy) {
+        QVector2D res = node->resolution();
+        node->setProxy(false);
+        if(node->resolution() != res) resized(node);
+    }
+    m_proxy.clear();
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRAPHEVALUATOR_H
+#define GRAPHEVALUATOR_H
+
+#include <QObject>
+#include <QQuickWindow>
+#include <QAtomicInt>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+class Node;
+
+class GraphEvaluator: public QObject
+{
+    Q_OBJECT
+public:
+    GraphEvaluator(QObject *parent = nullptr);
+    void markDirty(Node *node);
+    void nodeChanged(Node *node);
+    void outputChanged(Node *node);
+    void resized(Node *node);
+    void interact(Node *node);
+    void removeNode(Node *node);
+    bool isDirty(Node *node) const;
+    bool isIdle() const;
+    void suspend();
+    void resume();
+public slots:
+    void evaluate();
+    void viewChanged();
+    void setWindow(QQuickWindow *window);
+private:
+    void schedule();
+    void sortDirty();
+    bool isReady(Node *node) const;
+    bool canFuse(Node *node) const;
+    void frameRendered(int frame);
+    void settle();
+    QSet<Node*> m_dirty;
+    QHash<Node*, int> m_pending;
+    QHash<Node*, int> m_resized;
+    QList<Node*> m_order;
+    QSet<Node*> m_fused;
+    QSet<Node*> m_proxy;
+    QTimer m_settleTimer;
+    bool m_orderValid = true;
+    bool m_scheduled = false;
+    bool m_evaluating = false;
+    bool m_suspended = false;
+    QQuickWindow *m_window = nullptr;
+    QAtomicInt m_syncFrame;
+};
+
+#endif // GRAPHEVALUATOR_H
@@ -1,5 +1,9 @@
 #include "grayscale.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
 
 GrayscaleObject::GrayscaleObject(QQuickItem *parent, QVector2D resolution, GLint bpc):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc)
@@ -29,6 +33,14 @@ void GrayscaleObject::setSourceTexture(unsigned int texture) {
     grayscaledTex = true;
 }
 
+QList<PointStage> GrayscaleObject::stages() {
+    return m_stages;
+}
+
+void GrayscaleObject::setStages(const QList<PointStage> &stages) {
+    m_stages = stages;
+}
+
 void GrayscaleObject::saveTexture(QString fileName) {
     saveName = fileName;
     texSaving = true;
@@ -57,24 +69,14 @@ void GrayscaleObject::setBPC(GLint bpc) {
 
 GrayscaleRenderer::GrayscaleRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    grayscaleShader = new QOpenGLShaderProgram();
-    grayscaleShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    grayscaleShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/grayscale.frag");
-    grayscaleShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    grayscaleShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/grayscale.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     grayscaleShader->bind();
     grayscaleShader->setUniformValue(grayscaleShader->uniformLocation("sourceTexture"), 0);
     grayscaleShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -96,16 +98,7 @@ GrayscaleRenderer::GrayscaleRenderer(QVector2D res, GLint bpc): m_resolution(res
     glGenTextures(1, &m_grayscaleTexture);
     glBindFramebuffer(GL_FRAMEBUFFER, m_grayscaleFBO);
     glBindTexture(GL_TEXTURE_2D, m_grayscaleTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -121,9 +114,10 @@ GrayscaleRenderer::GrayscaleRenderer(QVector2D res, GLint bpc): m_resolution(res
 }
 
 GrayscaleRenderer::~GrayscaleRenderer() {
-    delete grayscaleShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(grayscaleShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_grayscaleTexture);
     glDeleteFramebuffers(1, &m_grayscaleFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -151,9 +145,10 @@ void GrayscaleRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(grayscaleItem->grayscaledTex) {
             grayscaleItem->grayscaledTex = false;
-            m_sourceTexture = grayscaleItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, grayscaleItem->sourceTexture(), grayscaleItem->resolution());
+            m_stages = grayscaleItem->stages();
         }
-        if(m_sourceTexture) {
+        if(m_sourceTexture && !grayscaleItem->fused) {
             toGrayscale();
             grayscaleItem->setTexture(m_grayscaleTexture);
             grayscaleItem->updatePreview(m_grayscaleTexture);
@@ -182,6 +177,7 @@ void GrayscaleRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_grayscaleTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -193,6 +189,16 @@ void GrayscaleRenderer::render() {
 }
 
 void GrayscaleRenderer::toGrayscale() {
+    if(!m_stages.isEmpty()) {
+        QList<PointStage> stages = m_stages;
+        stages.append(PointStage::grayscale());
+        pointChain.render(stages, m_sourceTexture, m_grayscaleFBO, m_resolution);
+        glBindTexture(GL_TEXTURE_2D, m_grayscaleTexture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFlush();
+        return;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, m_grayscaleFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
@@ -209,21 +215,11 @@ void GrayscaleRenderer::toGrayscale() {
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     glFlush();
-    glFinish();
 }
 
 void GrayscaleRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_grayscaleTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -234,12 +230,7 @@ void GrayscaleRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -254,6 +245,7 @@ void GrayscaleRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_grayscaleTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -261,41 +253,7 @@ void GrayscaleRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
@@ -5,6 +5,7 @@
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
 #include "FreeImage.h"
+#include "pointchain.h"
 
 class GrayscaleObject: public QQuickFramebufferObject
 {
@@ -16,6 +17,8 @@ public:
     void setTexture(unsigned int texture);
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
+    QList<PointStage> stages();
+    void setStages(const QList<PointStage> &stages);
     void saveTexture(QString fileName);
     QVector2D resolution();
     void setResolution(QVector2D res);
@@ -24,6 +27,7 @@ public:
     bool grayscaledTex = false;
     bool resUpdated = false;
     bool bpcUpdated = false;
+    bool fused = false;
     bool texSaving = false;
     QString saveName = "";
 signals:
@@ -33,6 +37,7 @@ private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
     unsigned int m_texture = 0;
+    QList<PointStage> m_stages;
     unsigned int m_sourceTexture = 0;
 };
 
@@ -52,6 +57,8 @@ private:
     GLint m_bpc = GL_RGBA8;
     unsigned int m_grayscaleFBO;
     unsigned int m_grayscaleTexture = 0;
+    QList<PointStage> m_stages;
+    PointChain pointChain;
     unsigned int m_sourceTexture = 0;
     unsigned int textureVAO = 0;
     QOpenGLShaderProgram *grayscaleShader;
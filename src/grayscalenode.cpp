@@ -1,4 +1,5 @@
 #include "grayscalenode.h"
+#include "textureformat.h"
 
 GrayscaleNode::GrayscaleNode(QQuickItem *parent, QVector2D resolution, GLint bpc):
     Node(parent, resolution, bpc)
@@ -7,41 +8,36 @@ GrayscaleNode::GrayscaleNode(QQuickItem *parent, QVector2D resolution, GLint bpc
     setTitle("Grayscale");
     m_socketsInput[0]->setTip("Texture");
     preview = new GrayscaleObject(grNode, m_resolution, m_bpc);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &GrayscaleNode::previewGenerated);
     connect(this, &Node::changeResolution, preview, &GrayscaleObject::setResolution);
     connect(this, &Node::changeBPC, preview, &GrayscaleObject::setBPC);
     connect(preview, &GrayscaleObject::textureChanged, this, &GrayscaleNode::setOutput);
     connect(preview, &GrayscaleObject::updatePreview, this, &GrayscaleNode::updatePreview);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/BitsProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
 GrayscaleNode::~GrayscaleNode() {
     delete preview;
 }
 
+void GrayscaleNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/BitsProperty.qml"));
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void GrayscaleNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    QList<PointStage> stages;
+    unsigned int source = fusedSource(stages);
+    preview->setStages(stages);
+    preview->setSourceTexture(source);
     preview->update();
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &GrayscaleNode::getPreviewTexture() {
@@ -52,8 +48,18 @@ void GrayscaleNode::saveTexture(QString fileName) {
     preview->saveTexture(fileName);
 }
 
+bool GrayscaleNode::pointStage(PointStage &stage) {
+    stage = PointStage::grayscale();
+    return true;
+}
+
+void GrayscaleNode::setFused(bool fused) {
+    Node::setFused(fused);
+    preview->fused = fused;
+}
+
 GrayscaleNode *GrayscaleNode::clone() {
-    return new GrayscaleNode(parentItem(), m_resolution, m_bpc);
+    return new GrayscaleNode(parentItem(), m_graphResolution, m_bpc);
 }
 
 void GrayscaleNode::serialize(QJsonObject &json) const {
@@ -63,8 +69,7 @@ void GrayscaleNode::serialize(QJsonObject &json) const {
 
 void GrayscaleNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
     Node::deserialize(json, hash);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 void GrayscaleNode::previewGenerated() {
@@ -0,0 +1,230 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "headlessrenderer.h"
+#include "albedonode.h"
+#include "metalnode.h"
+#include "roughnode.h"
+#include "normalnode.h"
+#include "heightnode.h"
+#include "emissionnode.h"
+#include "texturepool.h"
+#include "textureexporter.h"
+#include "glworker.h"
+#include <iostream>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QFile>
+#include <QRegularExpression>
+
+HeadlessRenderer::HeadlessRenderer(QObject *parent): QObject(parent)
+{
+}
+
+HeadlessRenderer::~HeadlessRenderer() {
+    if(m_context) m_context->makeCurrent(m_surface);
+    delete m_scene;
+    delete m_renderControl;
+    delete m_window;
+    delete m_fbo;
+    GLWorker::instance()->stop();
+    if(m_context) m_context->doneCurrent();
+    delete m_context;
+    delete m_surface;
+}
+
+bool HeadlessRenderer::initialize() {
+    QSurfaceFormat format;
+    format.setVersion(4, 4);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+    m_context = new QOpenGLContext();
+    m_context->setFormat(format);
+    if(!m_context->create()) {
+        std::cerr << "Couldn`t create OpenGL 4.4 context" << std::endl;
+        return false;
+    }
+    m_surface = new QOffscreenSurface();
+    m_surface->setFormat(m_context->format());
+    m_surface->create();
+    if(!m_context->makeCurrent(m_surface)) {
+        std::cerr << "Couldn`t make OpenGL context current" << std::endl;
+        return false;
+    }
+    m_renderControl = new QQuickRenderControl();
+    m_window = new QQuickWindow(m_renderControl);
+    m_window->setGeometry(0, 0, 64, 64);
+    m_renderControl->initialize(m_context);
+    m_fbo = new QOpenGLFramebufferObject(QSize(64, 64), QOpenGLFramebufferObject::CombinedDepthStencil);
+    m_window->setRenderTarget(m_fbo);
+    TextureExporter::instance()->attach(m_window);
+    GLWorker::instance()->start(m_context);
+    return true;
+}
+
+bool HeadlessRenderer::loadScene(QString fileName, QVector2D resolution, GLint bpc, const QStringList &overrides) {
+    QFile loadFile(fileName);
+    if(!loadFile.open(QIODevice::ReadOnly)) {
+        std::cerr << "Couldn`t open scene file " << fileName.toStdString() << std::endl;
+        return false;
+    }
+    QJsonObject json = QJsonDocument::fromJson(loadFile.readAll()).object();
+    if(resolution.x() > 0 && resolution.y() > 0) {
+        json["resX"] = resolution.x();
+        json["resY"] = resolution.y();
+    }
+    int index = 0;
+    QSet<int> applied;
+    QJsonArray frames = json["frames"].toArray();
+    for(int i = 0; i < frames.size(); ++i) {
+        QJsonObject frame = frames[i].toObject();
+        QJsonArray nodes = frame["nodes"].toArray();
+        applyOverrides(nodes, index, overrides, bpc, applied);
+        frame["nodes"] = nodes;
+        frames[i] = frame;
+    }
+    json["frames"] = frames;
+    QJsonArray nodes = json["nodes"].toArray();
+    applyOverrides(nodes, index, overrides, bpc, applied);
+    json["nodes"] = nodes;
+    bool unmatched = false;
+    for(int i = 0; i < overrides.size(); ++i) {
+        if(applied.contains(i)) continue;
+        std::cerr << "Override " << overrides[i].toStdString() << " doesn`t match any node parameter" << std::endl;
+        unmatched = true;
+    }
+    if(unmatched) return false;
+
+    QVector2D sceneRes(1024, 1024);
+    if(json.contains("resX") && json.contains("resY")) {
+        sceneRes = QVector2D(json["resX"].toInt(), json["resY"].toInt());
+    }
+    m_scene = new Scene(m_window->contentItem(), sceneRes);
+    m_scene->deserialize(json);
+    return true;
+}
+
+void HeadlessRenderer::listNodes() {
+    for(int i = 0; i < m_scene->nodesCount(); ++i) {
+        Node *node = m_scene->node(i);
+        std::cout << i << "\t" << node->metaObject()->className() << std::endl;
+    }
+}
+
+bool HeadlessRenderer::render() {
+    GraphEvaluator *evaluator = m_scene->evaluator();
+    for(auto node: m_scene->nodes()) {
+        evaluator->markDirty(node);
+    }
+    int maxFrames = m_scene->nodesCount()*4 + 16;
+    for(int frame = 0; !evaluator->isIdle(); ++frame) {
+        if(frame == maxFrames) {
+            std::cerr << "Graph evaluation did not settle" << std::endl;
+            return false;
+        }
+        evaluator->evaluate();
+        renderFrame();
+        GLWorker::instance()->waitForJobs();
+    }
+    return true;
+}
+
+qint64 HeadlessRenderer::texturePoolPeak() {
+    m_context->makeCurrent(m_surface);
+    TexturePool *pool = TexturePool::instance();
+    return pool ? pool->highWaterMark() : 0;
+}
+
+bool HeadlessRenderer::saveOutputs(QString dir) {
+    int outputs = 0;
+    for(auto node: m_scene->nodes()) {
+        if(qobject_cast<AlbedoNode*>(node) || qobject_cast<MetalNode*>(node) ||
+           qobject_cast<RoughNode*>(node) || qobject_cast<NormalNode*>(node) ||
+           qobject_cast<HeightNode*>(node) || qobject_cast<EmissionNode*>(node)) {
+            ++outputs;
+        }
+    }
+    if(outputs == 0) {
+        std::cerr << "Scene has no output nodes" << std::endl;
+        return false;
+    }
+    TextureExporter *exporter = TextureExporter::instance();
+    QAtomicInt failed;
+    QMetaObject::Connection connection = connect(exporter, &TextureExporter::exported, this, [&failed](QString, bool success) {
+        if(!success) failed.ref();
+    }, Qt::DirectConnection);
+    m_scene->outputsSave(dir);
+    renderFrame();
+    while(exporter->hasPendingReadbacks()) {
+        renderFrame();
+    }
+    exporter->waitForDone();
+    disconnect(connection);
+    if(failed.load() > 0) {
+        std::cerr << "Failed saving " << failed.load() << " textures" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void HeadlessRenderer::renderFrame() {
+    QCoreApplication::processEvents();
+    m_context->makeCurrent(m_surface);
+    m_renderControl->polishItems();
+    m_renderControl->sync();
+    m_renderControl->render();
+    m_context->functions()->glFlush();
+}
+
+void HeadlessRenderer::applyOverrides(QJsonArray &nodes, int &index, const QStringList &overrides, GLint bpc, QSet<int> &applied) {
+    for(int i = 0; i < nodes.size(); ++i) {
+        QJsonObject node = nodes[i].toObject();
+        if(!node.contains("type")) continue;
+        if(bpc) node["bpc"] = bpc;
+        for(int j = 0; j < overrides.size(); ++j) {
+            if(applyOverride(node, index, overrides[j])) applied.insert(j);
+        }
+        nodes[i] = node;
+        ++index;
+    }
+}
+
+bool HeadlessRenderer::isValidOverride(const QString &override) {
+    return overridePattern().match(override).hasMatch();
+}
+
+QRegularExpression HeadlessRenderer::overridePattern() {
+    return QRegularExpression("^(\\d+):([^=]+)=(.*)$");
+}
+
+bool HeadlessRenderer::applyOverride(QJsonObject &json, int index, const QString &override) {
+    QRegularExpressionMatch match = overridePattern().match(override);
+    if(!match.hasMatch() || match.captured(1).toInt() != index) return false;
+    QString key = match.captured(2);
+    //only parameters the node serializes can be overridden
+    if(key == "type" || !json.contains(key)) return false;
+    QString value = match.captured(3);
+    QJsonDocument doc = QJsonDocument::fromJson(QString("[%1]").arg(value).toUtf8());
+    if(doc.isArray() && doc.array().size() == 1) json[key] = doc.array()[0];
+    else json[key] = value;
+    return true;
+}
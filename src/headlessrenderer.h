@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HEADLESSRENDERER_H
+#define HEADLESSRENDERER_H
+
+#include <QObject>
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QOpenGLFramebufferObject>
+#include <QQuickRenderControl>
+#include <QQuickWindow>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSet>
+#include "scene.h"
+
+class HeadlessRenderer: public QObject
+{
+    Q_OBJECT
+public:
+    HeadlessRenderer(QObject *parent = nullptr);
+    ~HeadlessRenderer();
+    bool initialize();
+    bool loadScene(QString fileName, QVector2D resolution = QVector2D(0, 0), GLint bpc = 0,
+                   const QStringList &overrides = QStringList());
+    void listNodes();
+    bool render();
+    bool saveOutputs(QString dir);
+    qint64 texturePoolPeak();
+    static bool isValidOverride(const QString &override);
+private:
+    static QRegularExpression overridePattern();
+    void renderFrame();
+    bool applyOverride(QJsonObject &json, int index, const QString &override);
+    void applyOverrides(QJsonArray &nodes, int &index, const QStringList &overrides, GLint bpc, QSet<int> &applied);
+    QOpenGLContext *m_context = nullptr;
+    QOffscreenSurface *m_surface = nullptr;
+    QQuickRenderControl *m_renderControl = nullptr;
+    QQuickWindow *m_window = nullptr;
+    QOpenGLFramebufferObject *m_fbo = nullptr;
+    Scene *m_scene = nullptr;
+};
+
+#endif // HEADLESSRENDERER_H
@@ -1,5 +1,6 @@
 #include "heightnode.h"
 #include <iostream>
+#include "textureformat.h"
 
 HeightNode::HeightNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Node(parent, resolution, bpc)
 {
@@ -7,39 +8,31 @@ HeightNode::HeightNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Nod
     setTitle("Height");
     m_socketsInput[0]->setTip("Height");
     preview = new NormalObject(grNode, m_resolution, m_bpc);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &NormalObject::updatePreview, this, &HeightNode::updatePreview);
     connect(preview, &NormalObject::updateNormal, this, &HeightNode::heightChanged);
     connect(this, &Node::changeResolution, preview, &NormalObject::setResolution);
     connect(this, &Node::changeBPC, preview, &NormalObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/BitsProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
 HeightNode::~HeightNode() {
     delete preview;
 }
 
+void HeightNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/BitsProperty.qml"));
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void HeightNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
     preview->setNormalTexture(m_socketsInput[0]->value().toUInt());
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &HeightNode::getPreviewTexture() {
@@ -57,8 +50,7 @@ void HeightNode::serialize(QJsonObject &json) const {
 
 void HeightNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
     Node::deserialize(json, hash);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 void HeightNode::heightSave(QString dir) {
@@ -9,7 +9,7 @@ class HeightNode: public Node
 {
     Q_OBJECT
 public:
-    HeightNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16);
+    HeightNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_R16);
     ~HeightNode();
     void operation();
     unsigned int &getPreviewTexture();
@@ -20,6 +20,8 @@ public slots:
     void heightSave(QString dir);
 signals:
     void heightChanged(unsigned int heightMap);
+protected:
+    void createPropertiesPanel();
 private:
     NormalObject *preview;
 };
@@ -1,7 +1,11 @@
 #include "hexagons.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 HexagonsObject::HexagonsObject(QQuickItem *parent, QVector2D resolution, GLint bpc, int columns, int rows,
                                float size,float smooth, float mask, int seed):
@@ -122,25 +126,17 @@ void HexagonsObject::setBPC(GLint bpc) {
 HexagonsRenderer::HexagonsRenderer(QVector2D res, GLint bpc): m_resolution(res) {
     initializeOpenGLFunctions();
 
-    hexagonsShader = new QOpenGLShaderProgram();
-    hexagonsShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    hexagonsShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/hexagons.frag");
-    hexagonsShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    hexagonsShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/hexagons.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     hexagonsShader->bind();
     hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("maskTexture"), 0);
+    hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("cellsTexture"), 1);
     hexagonsShader->release();
+    cellMasks = new CellTable(":/shaders/hexagoncells.comp", GL_R32F);
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -162,16 +158,7 @@ HexagonsRenderer::HexagonsRenderer(QVector2D res, GLint bpc): m_resolution(res)
     glGenTextures(1, &m_hexagonsTexture);
     glBindFramebuffer(GL_FRAMEBUFFER, hexagonsFBO);
     glBindTexture(GL_TEXTURE_2D, m_hexagonsTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -187,9 +174,11 @@ HexagonsRenderer::HexagonsRenderer(QVector2D res, GLint bpc): m_resolution(res)
 }
 
 HexagonsRenderer::~HexagonsRenderer() {
-    delete hexagonsShader;
-    delete textureShader;
-    delete checkerShader;
+    Resampler::release(this);
+    ShaderCache::release(hexagonsShader);
+    ShaderCache::release(textureShader);
+    ShaderCache::release(checkerShader);
+    delete cellMasks;
     glDeleteTextures(1, &m_hexagonsTexture);
     glDeleteFramebuffers(1, &hexagonsFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -211,15 +200,13 @@ void HexagonsRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(hexagonsItem->generatedTex) {
             hexagonsItem->generatedTex = false;
-            m_maskTexture = hexagonsItem->maskTexture();
-            hexagonsShader->bind();
-            hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("columns"), hexagonsItem->columns());
-            hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("rows"), hexagonsItem->rows());
-            hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("size"), hexagonsItem->hexSize());
-            hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("hexSmooth"), hexagonsItem->hexSmooth());
-            hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("maskStrength"), hexagonsItem->mask());
-            hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("seed"), hexagonsItem->seed());
-            hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("useMask"), m_maskTexture);
+            m_maskTexture = Resampler::instance()->resample(this, 0, hexagonsItem->maskTexture(), hexagonsItem->resolution());
+            m_columns = hexagonsItem->columns();
+            m_rows = hexagonsItem->rows();
+            m_size = hexagonsItem->hexSize();
+            m_hexSmooth = hexagonsItem->hexSmooth();
+            m_maskStrength = hexagonsItem->mask();
+            m_seed = hexagonsItem->seed();
         }
         createHexagons();
         hexagonsItem->setTexture(m_hexagonsTexture);
@@ -255,6 +242,7 @@ void HexagonsRenderer::render() {
 
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_hexagonsTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -265,6 +253,7 @@ void HexagonsRenderer::render() {
 }
 
 void HexagonsRenderer::createHexagons() {
+    unsigned int cells = cellMasks->update(QSize(m_columns, m_rows), m_seed);
     glBindFramebuffer(GL_FRAMEBUFFER, hexagonsFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glEnable(GL_BLEND);
@@ -272,9 +261,17 @@ void HexagonsRenderer::createHexagons() {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, cells);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_maskTexture);
     hexagonsShader->bind();
+    hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("columns"), m_columns);
+    hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("rows"), m_rows);
+    hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("size"), m_size);
+    hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("hexSmooth"), m_hexSmooth);
+    hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("maskStrength"), m_maskStrength);
+    hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("useMask"), m_maskTexture);
     hexagonsShader->setUniformValue(hexagonsShader->uniformLocation("res"), m_resolution);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     hexagonsShader->release();
@@ -289,16 +286,7 @@ void HexagonsRenderer::createHexagons() {
 
 void HexagonsRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_hexagonsTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -309,12 +297,7 @@ void HexagonsRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -329,6 +312,7 @@ void HexagonsRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_hexagonsTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -336,41 +320,7 @@ void HexagonsRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
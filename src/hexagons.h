@@ -4,6 +4,7 @@
 #include <QQuickFramebufferObject>
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
+#include "celltable.h"
 
 class HexagonsObject: public QQuickFramebufferObject
 {
@@ -70,9 +71,16 @@ private:
     unsigned int m_hexagonsTexture = 0;
     unsigned int m_maskTexture = 0;
     unsigned int textureVAO = 0;
+    int m_columns = 0;
+    int m_rows = 0;
+    float m_size = 0.0f;
+    float m_hexSmooth = 0.0f;
+    float m_maskStrength = 0.0f;
+    int m_seed = 0;
     QOpenGLShaderProgram *hexagonsShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
+    CellTable *cellMasks;
 };
 
 #endif // HEXAGONS_H
@@ -1,4 +1,5 @@
 #include "hexagonsnode.h"
+#include "textureformat.h"
 
 HexagonsNode::HexagonsNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int columns, int rows,
                            float size, float smooth, float mask, int seed): Node(parent, resolution, bpc),
@@ -9,29 +10,31 @@ HexagonsNode::HexagonsNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
     setTitle("Hexagons");
     preview = new HexagonsObject(grNode, m_resolution, m_bpc, m_columns, m_rows, m_size, m_smooth, m_mask,
                                  m_seed);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &HexagonsObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &HexagonsObject::changedTexture, this, &HexagonsNode::setOutput);
     connect(this, &Node::changeResolution, preview, &HexagonsObject::setResolution);
     connect(this, &Node::changeBPC, preview, &HexagonsObject::setBPC);
     connect(this, &Node::generatePreview, this, &HexagonsNode::previewGenerated);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/HexagonsProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+HexagonsNode::~HexagonsNode() {
+    delete preview;
+}
+
+void HexagonsNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/HexagonsProperty.qml"));
     propertiesPanel->setProperty("startColumns", m_columns);
     propertiesPanel->setProperty("startRows", m_rows);
     propertiesPanel->setProperty("startSize", m_size);
     propertiesPanel->setProperty("startSmooth", m_smooth);
     propertiesPanel->setProperty("startMask", m_mask);
     propertiesPanel->setProperty("startSeed", m_seed);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(columnsChanged(int)), this, SLOT(updateColumns(int)));
     connect(propertiesPanel, SIGNAL(rowsChanged(int)), this, SLOT(updateRows(int)));
     connect(propertiesPanel, SIGNAL(hexSizeChanged(qreal)), this, SLOT(updateHexSize(qreal)));
@@ -42,10 +45,6 @@ HexagonsNode::HexagonsNode(QQuickItem *parent, QVector2D resolution, GLint bpc,
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-HexagonsNode::~HexagonsNode() {
-    delete preview;
-}
-
 unsigned int &HexagonsNode::getPreviewTexture() {
     return preview->texture();
 }
@@ -55,18 +54,12 @@ void HexagonsNode::saveTexture(QString fileName) {
 }
 
 void HexagonsNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
     preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 HexagonsNode *HexagonsNode::clone() {
-    return new HexagonsNode(parentItem(), m_resolution, m_bpc, m_columns, m_rows, m_size, m_smooth, m_mask,
+    return new HexagonsNode(parentItem(), m_graphResolution, m_bpc, m_columns, m_rows, m_size, m_smooth, m_mask,
                             m_seed);
 }
 
@@ -101,12 +94,12 @@ void HexagonsNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &
     if(json.contains("seed")) {
         m_seed = json["seed"].toInt();
     }
-    propertiesPanel->setProperty("startColumns", m_columns);
-    propertiesPanel->setProperty("startRows", m_rows);
-    propertiesPanel->setProperty("startSize", m_size);
-    propertiesPanel->setProperty("startSmooth", m_smooth);
-    propertiesPanel->setProperty("startMask", m_mask);
-    propertiesPanel->setProperty("startSeed", m_seed);
+    setPropertyOnPanel("startColumns", m_columns);
+    setPropertyOnPanel("startRows", m_rows);
+    setPropertyOnPanel("startSize", m_size);
+    setPropertyOnPanel("startSmooth", m_smooth);
+    setPropertyOnPanel("startMask", m_mask);
+    setPropertyOnPanel("startSeed", m_seed);
 
     preview->setColumns(m_columns);
     preview->setRows(m_rows);
@@ -115,8 +108,7 @@ void HexagonsNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &
     preview->setMask(m_mask);
     preview->setSeed(m_seed);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -44,6 +44,8 @@ public slots:
     void updateMask(qreal mask);
     void updateSeed(int seed);
     void previewGenerated();
+protected:
+    void createPropertiesPanel() override;
 private:
     HexagonsObject *preview;
     int m_columns = 5;
@@ -26,6 +26,7 @@
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
 #include "FreeImage.h"
+#include "pointchain.h"
 
 class InverseObject: public QQuickFramebufferObject
 {
@@ -37,6 +38,8 @@ public:
     void setTexture(unsigned int texture);
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
+    QList<PointStage> stages();
+    void setStages(const QList<PointStage> &stages);
     void saveTexture(QString fileName);
     QVector2D resolution();
     void setResolution(QVector2D res);
@@ -46,6 +49,7 @@ public:
     bool resUpdated = false;
     bool bpcUpdated = false;
     bool selectedItem = false;
+    bool fused = false;
     bool texSaving = false;
     QString saveName = "";
 signals:
@@ -55,6 +59,7 @@ private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
     unsigned int m_texture = 0;
+    QList<PointStage> m_stages;
     unsigned int m_sourceTexture = 0;
 };
 
@@ -73,6 +78,8 @@ private:
     GLint m_bpc = GL_RGBA8;
     unsigned int inverseFBO;
     unsigned int m_inversedTexture = 0;
+    QList<PointStage> m_stages;
+    PointChain pointChain;
     unsigned int m_sourceTexture = 0;
     unsigned int textureVAO = 0;
     QOpenGLShaderProgram *inverseShader;
@@ -20,17 +20,16 @@
  */
 
 #include "inversenode.h"
+#include "textureformat.h"
 
 InverseNode::InverseNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Node(parent, resolution, bpc)
 {
     preview = new InverseObject(grNode, m_resolution, m_bpc);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &InverseNode::previewGenerated);
     connect(this, &Node::changeResolution, preview, &InverseObject::setResolution);
     connect(this, &Node::changeBPC, preview, &InverseObject::setBPC);
@@ -39,30 +38,27 @@ InverseNode::InverseNode(QQuickItem *parent, QVector2D resolution, GLint bpc): N
     createSockets(1, 1);
     setTitle("Inverse");
     m_socketsInput[0]->setTip("Color");
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/BitsProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
 InverseNode::~InverseNode() {
     delete preview;
 }
 
+void InverseNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/BitsProperty.qml"));
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void InverseNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    QList<PointStage> stages;
+    unsigned int source = fusedSource(stages);
+    preview->setStages(stages);
+    preview->setSourceTexture(source);
     preview->update();
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &InverseNode::getPreviewTexture() {
@@ -73,8 +69,18 @@ void InverseNode::saveTexture(QString fileName) {
     preview->saveTexture(fileName);
 }
 
+bool InverseNode::pointStage(PointStage &stage) {
+    stage = PointStage::inverse();
+    return true;
+}
+
+void InverseNode::setFused(bool fused) {
+    Node::setFused(fused);
+    preview->fused = fused;
+}
+
 InverseNode *InverseNode::clone() {
-    return new InverseNode(parentItem(), m_resolution, m_bpc);
+    return new InverseNode(parentItem(), m_graphResolution, m_bpc);
 }
 
 void InverseNode::serialize(QJsonObject &json) const {
@@ -84,8 +90,7 @@ void InverseNode::serialize(QJsonObject &json) const {
 
 void InverseNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
     Node::deserialize(json, hash);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 void InverseNode::previewGenerated() {
@@ -34,12 +34,16 @@ public:
     void operation() override;
     unsigned int &getPreviewTexture() override;
     void saveTexture(QString fileName) override;
+    bool pointStage(PointStage &stage) override;
+    void setFused(bool fused) override;
     InverseNode *clone() override;
     void serialize(QJsonObject &json) const override;
     void deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) override;
 public slots:
     void previewGenerated();
     void setOutput();
+protected:
+    void createPropertiesPanel() override;
 private:
     InverseObject *preview;
 };
@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jumpflood.h"
+#include "shadercache.h"
+#include <QtMath>
+
+JumpFlood::JumpFlood() {
+    initializeOpenGLFunctions();
+    seedShader = ShaderCache::acquireCompute(":/shaders/jfaseed.comp");
+    seedShader->bind();
+    seedShader->setUniformValue(seedShader->uniformLocation("sourceTexture"), 0);
+    seedShader->release();
+    stepShader = ShaderCache::acquireCompute(":/shaders/jfastep.comp");
+}
+
+JumpFlood::~JumpFlood() {
+    ShaderCache::release(seedShader);
+    ShaderCache::release(stepShader);
+}
+
+int JumpFlood::passCount(QVector2D resolution) {
+    int side = qMax(resolution.x(), resolution.y());
+    int count = 0;
+    while((1 << count) < side) ++count;
+    return count;
+}
+
+GLenum JumpFlood::seedFormat() {
+    //texture sizes stay below 65535, so texel coordinates fit into 16 bits
+    return GL_RG16UI;
+}
+
+bool JumpFlood::seeds(unsigned int source, QVector2D resolution, bool outer, TexturePool::Target &result, std::function<bool()> cancelled) {
+    int width = resolution.x();
+    int height = resolution.y();
+    TexturePool *pool = TexturePool::instance();
+    TexturePool::Target pingpong[2] = {
+        pool->acquire(width, height, seedFormat()),
+        pool->acquire(width, height, seedFormat())
+    };
+
+    seedShader->bind();
+    seedShader->setUniformValue(seedShader->uniformLocation("outer"), outer);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glBindImageTexture(0, pingpong[0].texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, seedFormat());
+    dispatch(width, height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    seedShader->release();
+
+    //1+JFA: a unit step before the halving steps removes most of the flooding errors
+    QList<int> steps;
+    if(correction) steps.append(1);
+    for(int i = passCount(resolution) - 1; i >= 0; --i) {
+        steps.append(1 << i);
+    }
+    int current = 0;
+    stepShader->bind();
+    for(auto step: steps) {
+        if(cancelled && cancelled()) {
+            stepShader->release();
+            pool->release(pingpong[0]);
+            pool->release(pingpong[1]);
+            return false;
+        }
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        stepShader->setUniformValue(stepShader->uniformLocation("step"), step);
+        glBindImageTexture(0, pingpong[current].texture, 0, GL_FALSE, 0, GL_READ_ONLY, seedFormat());
+        glBindImageTexture(1, pingpong[1 - current].texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, seedFormat());
+        dispatch(width, height);
+        current = 1 - current;
+    }
+    stepShader->release();
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_ONLY, seedFormat());
+    glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, seedFormat());
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+    pool->release(pingpong[1 - current]);
+    result = pingpong[current];
+    return true;
+}
+
+void JumpFlood::dispatch(int width, int height) {
+    glDispatchCompute((width + 7)/8, (height + 7)/8, 1);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef JUMPFLOOD_H
+#define JUMPFLOOD_H
+
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLShaderProgram>
+#include <QVector2D>
+#include <functional>
+#include "texturepool.h"
+
+class JumpFlood: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    JumpFlood();
+    ~JumpFlood();
+    //nearest seed texel of every pixel in a pooled target, pixels without seeds hold 0xffff
+    bool seeds(unsigned int source, QVector2D resolution, bool outer, TexturePool::Target &result, std::function<bool()> cancelled = nullptr);
+    static int passCount(QVector2D resolution);
+    static GLenum seedFormat();
+    bool correction = true;
+private:
+    void dispatch(int width, int height);
+    QOpenGLShaderProgram *seedShader;
+    QOpenGLShaderProgram *stepShader;
+};
+
+#endif // JUMPFLOOD_H
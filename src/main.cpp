@@ -27,18 +27,25 @@
 #include "scene.h"
 #include "node.h"
 #include "mainwindow.h"
+#include "shadercache.h"
+#include "glworker.h"
+#include "qmlloader.h"
 #include <iostream>
 //#include "vld.h"
 
 int main(int argc, char *argv[])
 {
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
-
-    QApplication app(argc, argv);
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
     QSurfaceFormat format;
     format.setSamples(16);
     QSurfaceFormat::setDefaultFormat(format);
 
+    QApplication app(argc, argv);
+    ShaderCache::warmUp();
+    GLWorker::instance()->start();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, GLWorker::instance(), &GLWorker::stop);
+
     qmlRegisterType<BackgroundObject>("backgroundobject", 1, 0, "BackgroundObject");
     qmlRegisterType<PreviewObject>("preview", 1, 0, "PreviewObject");
     qmlRegisterType<Preview3DObject>("preview3d", 1, 0, "Preview3DObject");
@@ -49,6 +56,8 @@ int main(int argc, char *argv[])
     qRegisterMetaType<QList<Node*>>("QList<Node*>");
 
     QQmlApplicationEngine engine;
+    //node, socket and panel visuals are created from components of the main engine
+    QmlLoader::setEngine(&engine);
     engine.load(QUrl(QStringLiteral("qrc:/main.qml")));
 
     if(QApplication::arguments().size() > 1) {
@@ -554,6 +554,12 @@ MainWindow {
                     mainWindow.createNode(addNode.x, addNode.y, 29)
                 }
             }
+            Action {
+                text: "Distance"
+                onTriggered: {
+                    mainWindow.createNode(addNode.x, addNode.y, 33)
+                }
+            }
             background: Rectangle {
                             implicitWidth: 100
                             implicitHeight: 30
@@ -682,8 +688,11 @@ MainWindow {
         tabsList.tabs.push(tab)
     }
     onPropertiesPanelChanged: {
+        resolutionProperty.node = mainWindow.activeNode
+        resolutionProperty.visible = mainWindow.activeNode != null
         if(newPanel) {
             newPanel.parent = flickable.contentItem
+            newPanel.y = resolutionProperty.visible ? resolutionProperty.height : 0
         }
         if(oldPanel) oldPanel.parent = null
     }
@@ -843,6 +852,12 @@ MainWindow {
                     }
                 }
 
+                ResolutionProperty {
+                    id: resolutionProperty
+                    parent: flickable.contentItem
+                    visible: false
+                }
+
                 ScrollBar.vertical: ScrollBar{
                      z: active ? 0 : -1
                 }
@@ -1181,6 +1196,14 @@ MainWindow {
             }
         }
 
+        Rectangle {
+            y: parent.height - 2
+            height: 2
+            width: parent.width*mainWindow.exportProgress
+            visible: mainWindow.exportProgress < 1.0
+            color: colors.node_selected
+        }
+
         Item {
             property var tabs: []
             id: tabsList
@@ -20,6 +20,7 @@
  */
 
 #include "mainwindow.h"
+#include "textureexporter.h"
 #include <iostream>
 #include <QtWidgets/QFileDialog>
 #include <QApplication>
@@ -28,6 +29,11 @@ MainWindow::MainWindow(QWindow *parent):QQuickWindow (parent)
 {
     setVisibility(QWindow::Maximized);
     m_clipboard = new Clipboard();
+    TextureExporter::instance()->attach(this);
+    connect(TextureExporter::instance(), &TextureExporter::progressChanged, this, [this](int finished, int total) {
+        m_exportProgress = total > 0 ? qreal(finished)/total : 1.0;
+        exportProgressChanged();
+    });
 }
 
 MainWindow::~MainWindow() {
@@ -149,16 +155,17 @@ void MainWindow::createNode(float x, float y, int nodeType) {
             case 32:
                 n = new HexagonsNode(activeTab->scene(), activeTab->scene()->resolution());
                 break;
+            case 33:
+                n = new DistanceNode(activeTab->scene(), activeTab->scene()->resolution());
+                break;
             default:
                 break;
         }
         if(!n) return;
         activeTab->scene()->addNode(n);
-        QVector2D pan = activeTab->scene()->background()->viewPan();
-        float scale = activeTab->scene()->background()->viewScale();
-        n->setBaseX((x + pan.x())/scale);
-        n->setBaseY((y + pan.y())/scale);
-        n->setPan(pan);
+        QPointF pos = activeTab->scene()->canvas()->mapFromItem(activeTab->scene(), QPointF(x, y));
+        n->setBaseX(pos.x());
+        n->setBaseY(pos.y());
         activeTab->scene()->addedNode(n);
     }
 }
@@ -167,10 +174,9 @@ void MainWindow::createFrame(float x, float y) {
     if(activeTab) {
         Frame *frame = new Frame(activeTab->scene());
         activeTab->scene()->addFrame(frame);
-        QVector2D pan = activeTab->scene()->background()->viewPan();
-        float scale = activeTab->scene()->background()->viewScale();
-        frame->setBaseX((x + pan.x())/scale);
-        frame->setBaseY((y + pan.y())/scale);
+        QPointF pos = activeTab->scene()->canvas()->mapFromItem(activeTab->scene(), QPointF(x, y));
+        frame->setBaseX(pos.x());
+        frame->setBaseY(pos.y());
         activeTab->scene()->addedFrame(frame);
     }
 }
@@ -266,7 +272,7 @@ void MainWindow::saveCurrentTexture() {
     if(m_pinnedNode || m_activeNode) {
         QString fileName = QFileDialog::getSaveFileName(nullptr,
                 tr("Save Node Texture"), "",
-                tr("Node Texture (*.png);"));
+                tr("Node Texture (*.png *.tga *.exr);"));
         if(fileName.isEmpty()) return;
         if(m_pinnedNode) m_pinnedNode->saveTexture(fileName);
         else if(m_activeNode) m_activeNode->saveTexture(fileName);
@@ -509,6 +515,10 @@ Node *MainWindow::pinnedNode() {
     return m_pinnedNode;
 }
 
+qreal MainWindow::exportProgress() {
+    return m_exportProgress;
+}
+
 Node *MainWindow::activeNode() {
     return m_activeNode;
 }
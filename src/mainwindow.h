@@ -57,6 +57,7 @@
 #include "polartransformnode.h"
 #include "bricksnode.h"
 #include "hexagonsnode.h"
+#include "distancenode.h"
 #include "frame.h"
 
 class MainWindow: public QQuickWindow
@@ -64,6 +65,7 @@ class MainWindow: public QQuickWindow
     Q_OBJECT
     Q_PROPERTY(Node* activeNode READ activeNode)
     Q_PROPERTY(Node* pinnedNode READ pinnedNode)
+    Q_PROPERTY(qreal exportProgress READ exportProgress NOTIFY exportProgressChanged)
 public:
     Q_INVOKABLE void createNode(float x, float y, int nodeType);
     Q_INVOKABLE void createFrame(float x, float y);
@@ -102,6 +104,7 @@ public:
     void setActiveTab(Tab *tab);    
     Node *pinnedNode();
     Node *activeNode();
+    qreal exportProgress();
     void activeItemChanged();
     void loadFile(QString filename);
 signals:
@@ -111,6 +114,7 @@ signals:
     void preview3DChanged(QQuickItem *oldPreview, QQuickItem *newPreview);
     void previewUpdate(unsigned int previewData);
     void resolutionChanged(QVector2D res);
+    void exportProgressChanged();
 private:
     Tab *activeTab = nullptr;
     QQuickItem *m_activeItem = nullptr;
@@ -118,6 +122,7 @@ private:
     Node *m_pinnedNode = nullptr;
     QList<Tab*> tabs;
     Clipboard *m_clipboard = nullptr;
+    qreal m_exportProgress = 1.0;
 };
 
 #endif // MAINWINDOW_H
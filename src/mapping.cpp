@@ -20,7 +20,11 @@
  */
 
 #include "mapping.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
 
 MappingObject::MappingObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float inputMin,
                              float inputMax, float outputMin, float outputMax):
@@ -61,6 +65,14 @@ void MappingObject::setSourceTexture(unsigned int texture) {
     mappedTex = true;
 }
 
+QList<PointStage> MappingObject::stages() {
+    return m_stages;
+}
+
+void MappingObject::setStages(const QList<PointStage> &stages) {
+    m_stages = stages;
+}
+
 void MappingObject::saveTexture(QString fileName) {
     texSaving = true;
     saveName = fileName;
@@ -128,9 +140,10 @@ void MappingObject::setBPC(GLint bpc) {
 }
 
 MappingRenderer::~MappingRenderer() {
-    delete mappingShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(mappingShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_mappingTexture);
     glDeleteFramebuffers(1, &mappingFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -138,25 +151,15 @@ MappingRenderer::~MappingRenderer() {
 
 MappingRenderer::MappingRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    mappingShader = new QOpenGLShaderProgram();
-    mappingShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    mappingShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/mapping.frag");
-    mappingShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    mappingShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/mapping.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     mappingShader->bind();
     mappingShader->setUniformValue(mappingShader->uniformLocation("sourceTexture"), 0);
     mappingShader->setUniformValue(mappingShader->uniformLocation("maskTexture"), 1);
     mappingShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                            -1.0f, 1.0f, 0.0f, 1.0f,
@@ -179,16 +182,7 @@ MappingRenderer::MappingRenderer(QVector2D res, GLint bpc): m_resolution(res), m
     glBindFramebuffer(GL_FRAMEBUFFER, mappingFBO);
     glGenTextures(1, &m_mappingTexture);
     glBindTexture(GL_TEXTURE_2D, m_mappingTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -222,19 +216,17 @@ void MappingRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(mappingItem->mappedTex) {
             mappingItem->mappedTex = false;
-            m_sourceTexture = mappingItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, mappingItem->sourceTexture(), mappingItem->resolution());
+            m_stages = mappingItem->stages();
             if(m_sourceTexture) {
-                maskTexture = mappingItem->maskTexture();
-                mappingShader->bind();
-                mappingShader->setUniformValue(mappingShader->uniformLocation("inputMin"), mappingItem->inputMin());
-                mappingShader->setUniformValue(mappingShader->uniformLocation("inputMax"), mappingItem->inputMax());
-                mappingShader->setUniformValue(mappingShader->uniformLocation("outputMin"), mappingItem->outputMin());
-                mappingShader->setUniformValue(mappingShader->uniformLocation("outputMax"), mappingItem->outputMax());
-                mappingShader->setUniformValue(mappingShader->uniformLocation("useMask"), maskTexture);
-                mappingShader->release();
+                maskTexture = Resampler::instance()->resample(this, 1, mappingItem->maskTexture(), mappingItem->resolution());
+                m_inputMin = mappingItem->inputMin();
+                m_inputMax = mappingItem->inputMax();
+                m_outputMin = mappingItem->outputMin();
+                m_outputMax = mappingItem->outputMax();
             }
         }
-        if(m_sourceTexture) {
+        if(m_sourceTexture && !mappingItem->fused) {
             map();
             mappingItem->setTexture(m_mappingTexture);
             mappingItem->updatePreview(m_mappingTexture);
@@ -262,6 +254,7 @@ void MappingRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_mappingTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -273,12 +266,27 @@ void MappingRenderer::render() {
 }
 
 void MappingRenderer::map() {
+    if(!m_stages.isEmpty()) {
+        QList<PointStage> stages = m_stages;
+        stages.append(PointStage::mapping(m_inputMin, m_inputMax, m_outputMin, m_outputMax, maskTexture));
+        pointChain.render(stages, m_sourceTexture, mappingFBO, m_resolution);
+        glBindTexture(GL_TEXTURE_2D, m_mappingTexture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFlush();
+        return;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, mappingFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     mappingShader->bind();
+    mappingShader->setUniformValue(mappingShader->uniformLocation("inputMin"), m_inputMin);
+    mappingShader->setUniformValue(mappingShader->uniformLocation("inputMax"), m_inputMax);
+    mappingShader->setUniformValue(mappingShader->uniformLocation("outputMin"), m_outputMin);
+    mappingShader->setUniformValue(mappingShader->uniformLocation("outputMax"), m_outputMax);
+    mappingShader->setUniformValue(mappingShader->uniformLocation("useMask"), maskTexture);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glActiveTexture(GL_TEXTURE1);
@@ -292,21 +300,11 @@ void MappingRenderer::map() {
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     glFlush();
-    glFinish();
 }
 
 void MappingRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_mappingTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -318,12 +316,7 @@ void MappingRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -338,6 +331,7 @@ void MappingRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_mappingTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -345,41 +339,7 @@ void MappingRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
@@ -26,6 +26,7 @@
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
 #include "FreeImage.h"
+#include "pointchain.h"
 
 class MappingObject: public QQuickFramebufferObject
 {
@@ -39,6 +40,8 @@ public:
     void setMaskTexture(unsigned int texture);
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
+    QList<PointStage> stages();
+    void setStages(const QList<PointStage> &stages);
     void saveTexture(QString fileName);
     float inputMin();
     void setInputMin(float value);
@@ -56,6 +59,7 @@ public:
     bool selectedItem = false;
     bool resUpdated = false;
     bool bpcUpdated = false;
+    bool fused = false;
     bool texSaving = false;
     QString saveName = "";
 signals:
@@ -64,6 +68,7 @@ signals:
 private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
+    QList<PointStage> m_stages;
     unsigned int m_sourceTexture = 0;
     unsigned int m_texture = 0;
     unsigned int m_maskTexture = 0;
@@ -88,9 +93,15 @@ private:
     GLint m_bpc = GL_RGBA8;
     unsigned int mappingFBO;
     unsigned int m_mappingTexture = 0;
+    QList<PointStage> m_stages;
+    PointChain pointChain;
     unsigned int m_sourceTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
+    float m_inputMin = 0.0f;
+    float m_inputMax = 0.0f;
+    float m_outputMin = 0.0f;
+    float m_outputMax = 0.0f;
     QOpenGLShaderProgram *mappingShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
@@ -20,39 +20,23 @@
  */
 
 #include "mappingnode.h"
+#include "textureformat.h"
 
 MappingNode::MappingNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float inputMin,
                          float inputMax, float outputMin, float outputMax):Node(parent, resolution, bpc),
     m_inputMin(inputMin), m_inputMax(inputMax), m_outputMin(outputMin), m_outputMax(outputMax)
 {
     preview = new MappingObject(grNode, m_resolution, m_bpc, m_inputMin, m_inputMax, m_outputMin, m_outputMax);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &MappingNode::previewGenerated);
     connect(this, &Node::changeResolution, preview, &MappingObject::setResolution);
     connect(this, &Node::changeBPC, preview, &MappingObject::setBPC);
     connect(preview, &MappingObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &MappingObject::textureChanged, this, &MappingNode::setOutput);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/MappingProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    connect(propertiesPanel, SIGNAL(inputMinChanged(qreal)), this, SLOT(updateInputMin(qreal)));
-    connect(propertiesPanel, SIGNAL(inputMaxChanged(qreal)), this, SLOT(updateInputMax(qreal)));
-    connect(propertiesPanel, SIGNAL(outputMinChanged(qreal)), this, SLOT(updateOutputMin(qreal)));
-    connect(propertiesPanel, SIGNAL(outputMaxChanged(qreal)), this, SLOT(updateOutputMax(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
-    propertiesPanel->setProperty("startInputMin", m_inputMin);
-    propertiesPanel->setProperty("startInputMax", m_inputMax);
-    propertiesPanel->setProperty("startOutputMin", m_outputMin);
-    propertiesPanel->setProperty("startOutputMax", m_outputMax);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
     createSockets(2, 1);
     setTitle("Map Range");
     m_socketsInput[0]->setTip("Texture");
@@ -63,23 +47,30 @@ MappingNode::~MappingNode() {
     delete preview;
 }
 
+void MappingNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/MappingProperty.qml"));
+    propertiesPanel->setProperty("startInputMin", m_inputMin);
+    propertiesPanel->setProperty("startInputMax", m_inputMax);
+    propertiesPanel->setProperty("startOutputMin", m_outputMin);
+    propertiesPanel->setProperty("startOutputMax", m_outputMax);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(inputMinChanged(qreal)), this, SLOT(updateInputMin(qreal)));
+    connect(propertiesPanel, SIGNAL(inputMaxChanged(qreal)), this, SLOT(updateInputMax(qreal)));
+    connect(propertiesPanel, SIGNAL(outputMinChanged(qreal)), this, SLOT(updateOutputMin(qreal)));
+    connect(propertiesPanel, SIGNAL(outputMaxChanged(qreal)), this, SLOT(updateOutputMax(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void MappingNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
-    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    QList<PointStage> stages;
+    unsigned int source = fusedSource(stages);
+    preview->setStages(stages);
+    preview->setSourceTexture(source);
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &MappingNode::getPreviewTexture() {
@@ -90,8 +81,18 @@ void MappingNode::saveTexture(QString fileName) {
     preview->saveTexture(fileName);
 }
 
+bool MappingNode::pointStage(PointStage &stage) {
+    stage = PointStage::mapping(m_inputMin, m_inputMax, m_outputMin, m_outputMax, m_socketsInput[1]->value().toUInt());
+    return true;
+}
+
+void MappingNode::setFused(bool fused) {
+    Node::setFused(fused);
+    preview->fused = fused;
+}
+
 MappingNode *MappingNode::clone() {
-    return new MappingNode(parentItem(), m_resolution, m_bpc, m_inputMin, m_inputMax, m_outputMin,
+    return new MappingNode(parentItem(), m_graphResolution, m_bpc, m_inputMin, m_inputMax, m_outputMin,
                            m_outputMax);
 }
 
@@ -108,19 +109,19 @@ void MappingNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &ha
     Node::deserialize(json, hash);
     if(json.contains("inputMin")) {
         updateInputMin(json["inputMin"].toVariant().toReal());
-        propertiesPanel->setProperty("startInputMin", m_inputMin);
+        setPropertyOnPanel("startInputMin", m_inputMin);
     }
     if(json.contains("inputMax")) {
         updateInputMax(json["inputMax"].toVariant().toReal());
-        propertiesPanel->setProperty("startInputMax", m_inputMax);
+        setPropertyOnPanel("startInputMax", m_inputMax);
     }
     if(json.contains("outputMin")) {
         updateOutputMin(json["outputMin"].toVariant().toReal());
-        propertiesPanel->setProperty("startOutputMin", m_outputMin);
+        setPropertyOnPanel("startOutputMin", m_outputMin);
     }
     if(json.contains("outputMax")) {
         updateOutputMax(json["outputMax"].toVariant().toReal());
-        propertiesPanel->setProperty("startOutputMax", m_outputMax);
+        setPropertyOnPanel("startOutputMax", m_outputMax);
     }
 
     preview->setInputMin(m_inputMin);
@@ -128,8 +129,7 @@ void MappingNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &ha
     preview->setOutputMin(m_outputMin);
     preview->setOutputMax(m_outputMax);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -34,6 +34,8 @@ public:
     void operation() override;
     unsigned int &getPreviewTexture() override;
     void saveTexture(QString fileName) override;
+    bool pointStage(PointStage &stage) override;
+    void setFused(bool fused) override;
     MappingNode *clone() override;
     void serialize(QJsonObject &json) const override;
     void deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) override;
@@ -57,6 +59,8 @@ public slots:
     void updateInputMax(qreal value);
     void updateOutputMin(qreal value);
     void updateOutputMax(qreal value);
+protected:
+    void createPropertiesPanel() override;
 private:
     MappingObject *preview;
     float m_inputMin = 0.0f;
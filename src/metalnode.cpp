@@ -20,6 +20,7 @@
  */
 
 #include "metalnode.h"
+#include "textureformat.h"
 
 MetalNode::MetalNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Node(parent, resolution, bpc)
 {
@@ -27,36 +28,32 @@ MetalNode::MetalNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Node(
     setTitle("Metalness");
     m_socketsInput[0]->setTip("Metalness");
     preview = new OneChanelObject(grNode, m_resolution, m_bpc);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &OneChanelObject::updatePreview, this, &MetalNode::updatePreview);
     connect(preview, &OneChanelObject::updateValue, this, &MetalNode::metalChanged);
     connect(this, &Node::changeResolution, preview, &OneChanelObject::setResolution);
     connect(this, &Node::changeBPC, preview, &OneChanelObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/MetalProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(metalChanged(qreal)), this, SLOT(updateMetal(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
 MetalNode::~MetalNode() {
     delete preview;
 }
 
+void MetalNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/MetalProperty.qml"));
+    propertiesPanel->setProperty("startMetal", m_metal);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(metalChanged(qreal)), this, SLOT(updateMetal(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void MetalNode::operation() {
     if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
         preview->useTex = true;
         preview->setValue(m_socketsInput[0]->value().toUInt());
     }
@@ -66,7 +63,6 @@ void MetalNode::operation() {
     }
     preview->selectedItem = selected();
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &MetalNode::getPreviewTexture() {
@@ -86,10 +82,10 @@ void MetalNode::serialize(QJsonObject &json) const {
 void MetalNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) {
     Node::deserialize(json, hash);
     if(json.contains("metal")) {
-        propertiesPanel->setProperty("startMetal", m_metal);
+        updateMetal(json["metal"].toVariant().toReal());
+        setPropertyOnPanel("startMetal", m_metal);
     }
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 void MetalNode::updateMetal(qreal metal) {
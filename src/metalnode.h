@@ -29,7 +29,7 @@ class MetalNode: public Node
 {
     Q_OBJECT
 public:
-    MetalNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA8);
+    MetalNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_R8);
     ~MetalNode();
     void operation();
     unsigned int &getPreviewTexture();
@@ -41,6 +41,8 @@ public slots:
     void saveMetal(QString dir);
 signals:
     void metalChanged(QVariant metal, bool useTexture);
+protected:
+    void createPropertiesPanel();
 private:
     OneChanelObject *preview;
     float m_metal = 0.0f;
@@ -20,7 +20,11 @@
  */
 
 #include "mirror.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
+#include "textureformat.h"
+#include "resampler.h"
 
 MirrorObject::MirrorObject(QQuickItem *parent, QVector2D resolution, GLint bpc, int dir):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc), m_direction(dir)
@@ -95,25 +99,15 @@ void MirrorObject::setBPC(GLint bpc) {
 
 MirrorRenderer::MirrorRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    mirrorShader = new QOpenGLShaderProgram();
-    mirrorShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    mirrorShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/mirror.frag");
-    mirrorShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    mirrorShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/mirror.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     mirrorShader->bind();
     mirrorShader->setUniformValue(mirrorShader->uniformLocation("sourceTexture"), 0);
     mirrorShader->setUniformValue(mirrorShader->uniformLocation("maskTexture"), 1);
     mirrorShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                            -1.0f, 1.0f, 0.0f, 1.0f,
@@ -136,16 +130,7 @@ MirrorRenderer::MirrorRenderer(QVector2D res, GLint bpc): m_resolution(res), m_b
     glBindFramebuffer(GL_FRAMEBUFFER, mirrorFBO);
     glGenTextures(1, &m_mirrorTexture);
     glBindTexture(GL_TEXTURE_2D, m_mirrorTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -159,9 +144,10 @@ MirrorRenderer::MirrorRenderer(QVector2D res, GLint bpc): m_resolution(res), m_b
 }
 
 MirrorRenderer::~MirrorRenderer() {
-    delete mirrorShader;
-    delete textureShader;
-    delete checkerShader;
+    Resampler::release(this);
+    ShaderCache::release(mirrorShader);
+    ShaderCache::release(textureShader);
+    ShaderCache::release(checkerShader);
     glDeleteTextures(1, &m_mirrorTexture);
     glDeleteFramebuffers(1, &mirrorFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -188,13 +174,10 @@ void MirrorRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(mirrorItem->mirroredTex) {
             mirrorItem->mirroredTex = false;
-            m_sourceTexture = mirrorItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, mirrorItem->sourceTexture(), mirrorItem->resolution());
             if(m_sourceTexture) {
-                maskTexture = mirrorItem->maskTexture();
-                mirrorShader->bind();
-                mirrorShader->setUniformValue(mirrorShader->uniformLocation("dir"), mirrorItem->direction());
-                mirrorShader->setUniformValue(mirrorShader->uniformLocation("useMask"), maskTexture);
-                mirrorShader->release();
+                maskTexture = Resampler::instance()->resample(this, 1, mirrorItem->maskTexture(), mirrorItem->resolution());
+                m_dir = mirrorItem->direction();
             }
         }
         if(m_sourceTexture) {
@@ -224,6 +207,7 @@ void MirrorRenderer::render() {
 
     if(m_sourceTexture) {
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glBindVertexArray(textureVAO);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_mirrorTexture);
@@ -242,6 +226,8 @@ void MirrorRenderer::mirror() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     mirrorShader->bind();
+    mirrorShader->setUniformValue(mirrorShader->uniformLocation("dir"), m_dir);
+    mirrorShader->setUniformValue(mirrorShader->uniformLocation("useMask"), maskTexture);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glActiveTexture(GL_TEXTURE1);
@@ -259,16 +245,7 @@ void MirrorRenderer::mirror() {
 
 void MirrorRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_mirrorTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -280,12 +257,7 @@ void MirrorRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -299,6 +271,7 @@ void MirrorRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_mirrorTexture);
@@ -307,41 +280,7 @@ void MirrorRenderer::saveTexture(QString fileName) {
     glBindVertexArray(0);
     textureShader->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
@@ -82,6 +82,7 @@ private:
     unsigned int m_sourceTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
+    int m_dir = 0;
     QOpenGLShaderProgram *mirrorShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
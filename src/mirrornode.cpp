@@ -20,32 +20,22 @@
  */
 
 #include "mirrornode.h"
+#include "textureformat.h"
 
 MirrorNode::MirrorNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int dir):
     Node(parent, resolution, bpc), m_direction(dir)
 {
     preview = new MirrorObject(grNode, m_resolution, m_bpc, m_direction);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &MirrorNode::previewGenerated);
     connect(preview, &MirrorObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &MirrorObject::textureChanged, this, &MirrorNode::setOutput);
     connect(this, &Node::changeResolution, preview, &MirrorObject::setResolution);
     connect(this, &Node::changeBPC, preview, &MirrorObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/MirrorProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    propertiesPanel->setProperty("startDirection", m_direction);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(directionChanged(int)), this, SLOT(updateDirection(int)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(2, 1);
     setTitle("Mirror");
     m_socketsInput[0]->setTip("Texture");
@@ -56,23 +46,21 @@ MirrorNode::~MirrorNode() {
     delete preview;
 }
 
+void MirrorNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/MirrorProperty.qml"));
+    propertiesPanel->setProperty("startDirection", m_direction);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(directionChanged(int)), this, SLOT(updateDirection(int)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void MirrorNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->mirroredTex = true;
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &MirrorNode::getPreviewTexture() {
@@ -84,7 +72,7 @@ void MirrorNode::saveTexture(QString fileName) {
 }
 
 MirrorNode *MirrorNode::clone() {
-    return new MirrorNode(parentItem(), m_resolution, m_bpc, m_direction);
+    return new MirrorNode(parentItem(), m_graphResolution, m_bpc, m_direction);
 }
 
 void MirrorNode::serialize(QJsonObject &json) const {
@@ -97,13 +85,12 @@ void MirrorNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &ha
     Node::deserialize(json, hash);
     if(json.contains("direction")) {
         updateDirection(json["direction"].toInt());
-        propertiesPanel->setProperty("startDirection", m_direction);
+        setPropertyOnPanel("startDirection", m_direction);
     }
 
     preview->setDirection(m_direction);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
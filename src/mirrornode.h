@@ -44,6 +44,8 @@ public slots:
     void previewGenerated();
     void setOutput();
     void updateDirection(int dir);
+protected:
+    void createPropertiesPanel() override;
 private:
     MirrorObject *preview;
     int m_direction = 0;
@@ -20,8 +20,12 @@
  */
 
 #include "mix.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 MixObject::MixObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float factor,
                      int foregroundOpacity, int backgroundOpacity, int mode, bool includingAlpha):
@@ -145,9 +149,10 @@ void MixObject::setTexture(unsigned int texture) {
 }
 
 MixRenderer::~MixRenderer() {
-    delete mixShader;
-    delete checkerShader;
-    delete renderTexture;
+    Resampler::release(this);
+    ShaderCache::release(mixShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(renderTexture);
     glDeleteTextures(1, &mixTexture);
     glDeleteFramebuffers(1, &mixFBO);
     glDeleteVertexArrays(1, &VAO);
@@ -156,20 +161,11 @@ MixRenderer::~MixRenderer() {
 MixRenderer::MixRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
 
-    mixShader = new QOpenGLShaderProgram();
-    mixShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    mixShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/mix.frag");
-    mixShader->link();
+    mixShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/mix.frag");
 
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
 
-    renderTexture = new QOpenGLShaderProgram();
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    renderTexture->link();
+    renderTexture = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     mixShader->bind();
     mixShader->setUniformValue(mixShader->uniformLocation("firstTexture"), 0);
@@ -180,7 +176,6 @@ MixRenderer::MixRenderer(QVector2D resolution, GLint bpc): m_resolution(resoluti
 
     renderTexture->bind();
     renderTexture->setUniformValue(renderTexture->uniformLocation("texture"), 0);
-    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     renderTexture->release();
 
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
@@ -204,12 +199,7 @@ MixRenderer::MixRenderer(QVector2D resolution, GLint bpc): m_resolution(resoluti
     glBindFramebuffer(GL_FRAMEBUFFER, mixFBO);
     glGenTextures(1, &mixTexture);
     glBindTexture(GL_TEXTURE_2D, mixTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -243,18 +233,15 @@ void MixRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(mixItem->mixedTex) {
             mixItem->mixedTex = false;
-            firstTexture = mixItem->firstTexture();
-            secondTexture = mixItem->secondTexture();
+            firstTexture = Resampler::instance()->resample(this, 0, mixItem->firstTexture(), mixItem->resolution());
+            secondTexture = Resampler::instance()->resample(this, 1, mixItem->secondTexture(), mixItem->resolution());
             if((firstTexture && secondTexture) || (!firstTexture && !secondTexture)) {
-                maskTexture = mixItem->maskTexture();
+                maskTexture = Resampler::instance()->resample(this, 2, mixItem->maskTexture(), mixItem->resolution());
                 currentMode = mixItem->mode();
-                mixShader->bind();
-                mixShader->setUniformValue(mixShader->uniformLocation("useFactorTex"), mixItem->useFactorTexture);
-                mixShader->setUniformValue(mixShader->uniformLocation("includingAlpha"), mixItem->includingAlpha());
-                mixShader->setUniformValue(mixShader->uniformLocation("useMask"), maskTexture);
-                mixShader->setUniformValue(mixShader->uniformLocation("foregroundOpacity"), mixItem->foregroundOpacity()*0.01f);
-                mixShader->setUniformValue(mixShader->uniformLocation("backgroundOpacity"), mixItem->backgroundOpacity()*0.01f);
-                mixShader->release();
+                m_useFactorTex = mixItem->useFactorTexture;
+                m_includingAlpha = mixItem->includingAlpha();
+                m_foregroundOpacity = mixItem->foregroundOpacity()*0.01f;
+                m_backgroundOpacity = mixItem->backgroundOpacity()*0.01f;
                 if(mixItem->useFactorTexture) {
                     factorTexture = mixItem->factor().toUInt();
                 }
@@ -304,6 +291,7 @@ void MixRenderer::render() {
 
     if(firstTexture && secondTexture) {
         renderTexture->bind();
+        renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
         glBindVertexArray(VAO);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, mixTexture);
@@ -314,6 +302,7 @@ void MixRenderer::render() {
     }
     else if(firstTexture) {
         renderTexture->bind();
+        renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
         glBindVertexArray(VAO);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, firstTexture);
@@ -324,6 +313,7 @@ void MixRenderer::render() {
     }
     else if(secondTexture) {
         renderTexture->bind();
+        renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
         glBindVertexArray(VAO);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, secondTexture);
@@ -342,6 +332,11 @@ void MixRenderer::mix() {
     glClear(GL_COLOR_BUFFER_BIT);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     mixShader->bind();
+    mixShader->setUniformValue(mixShader->uniformLocation("useFactorTex"), m_useFactorTex);
+    mixShader->setUniformValue(mixShader->uniformLocation("includingAlpha"), m_includingAlpha);
+    mixShader->setUniformValue(mixShader->uniformLocation("useMask"), maskTexture);
+    mixShader->setUniformValue(mixShader->uniformLocation("foregroundOpacity"), m_foregroundOpacity);
+    mixShader->setUniformValue(mixShader->uniformLocation("backgroundOpacity"), m_backgroundOpacity);
     mixShader->setUniformValue(mixShader->uniformLocation("mixFactor"), mixFactor);
     GLuint indexMode = glGetSubroutineIndex(mixShader->programId(), GL_FRAGMENT_SHADER, blendFunc[currentMode].c_str());
     glUniformSubroutinesuiv(GL_FRAGMENT_SHADER, 1, &indexMode);
@@ -368,12 +363,7 @@ void MixRenderer::mix() {
 
 void MixRenderer::updateTextureRes() {
     glBindTexture(GL_TEXTURE_2D, mixTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -385,12 +375,7 @@ void MixRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -403,6 +388,7 @@ void MixRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(VAO);
     glActiveTexture(GL_TEXTURE0);
     if(firstTexture && secondTexture) glBindTexture(GL_TEXTURE_2D, mixTexture);
@@ -413,41 +399,7 @@ void MixRenderer::saveTexture(QString fileName) {
     glBindVertexArray(0);
     renderTexture->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
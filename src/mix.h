@@ -91,6 +91,10 @@ private:
     void mix();
     void updateTextureRes();
     void saveTexture(QString fileName);
+    bool m_useFactorTex = false;
+    bool m_includingAlpha = false;
+    float m_foregroundOpacity = 0.0f;
+    float m_backgroundOpacity = 0.0f;
     QOpenGLShaderProgram *mixShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *renderTexture;
@@ -21,6 +21,7 @@
 
 #include "mixnode.h"
 #include <iostream>
+#include "textureformat.h"
 
 MixNode::MixNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float factor, int foregroundOpacity,
                  int backgroundOpacity, int mode, bool includingAlpha): Node(parent, resolution, bpc),
@@ -29,13 +30,11 @@ MixNode::MixNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float fact
 {
     preview = new MixObject(grNode, m_resolution, m_bpc, m_factor, m_fOpacity, m_bOpacity, m_mode,
                             m_includingAlpha);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     createSockets(4, 1);
     setTitle("Mix");
     m_socketsInput[0]->setTip("Background");
@@ -47,9 +46,20 @@ MixNode::MixNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float fact
     connect(preview, &MixObject::updatePreview, this, &MixNode::updatePreview);
     connect(this, &Node::changeResolution, preview, &MixObject::setResolution);
     connect(this, &Node::changeBPC, preview, &MixObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/MixProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+MixNode::~MixNode() {
+    delete preview;
+}
+
+void MixNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/MixProperty.qml"));
+    propertiesPanel->setProperty("startFactor", m_factor);
+    propertiesPanel->setProperty("startMode", m_mode);
+    propertiesPanel->setProperty("startIncludingAlpha", m_includingAlpha);
+    propertiesPanel->setProperty("startForegroundOpacity", m_fOpacity);
+    propertiesPanel->setProperty("startBackgroundOpacity", m_bOpacity);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(factorChanged(qreal)), this, SLOT(updateFactor(qreal)));
     connect(propertiesPanel, SIGNAL(modeChanged(int)), this, SLOT(updateMode(int)));
     connect(propertiesPanel, SIGNAL(includingAlphaChanged(bool)), this, SLOT(updateIncludingAlpha(bool)));
@@ -57,41 +67,10 @@ MixNode::MixNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float fact
     connect(propertiesPanel, SIGNAL(backgroundOpacityChanged(int)), this, SLOT(updateBackgroundOpacity(int)));
     connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
-    propertiesPanel->setProperty("startFactor", m_factor);
-    propertiesPanel->setProperty("startMode", m_mode);
-    propertiesPanel->setProperty("startIncludingAlpha", m_includingAlpha);
-    propertiesPanel->setProperty("startForegroundOpacity", m_fOpacity);
-    propertiesPanel->setProperty("startBackgroundOpacity", m_bOpacity);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-}
-
-MixNode::~MixNode() {
-    delete preview;
 }
 
 void MixNode::operation() {
 
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[2]->getEdges().isEmpty()) {
-        Node *inputNode2 = static_cast<Node*>(m_socketsInput[2]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode2 && inputNode2->resolution() != m_resolution) return;
-        if(m_socketsInput[2]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[3]->getEdges().isEmpty()) {
-        Node *inputNode3 = static_cast<Node*>(m_socketsInput[3]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode3 && inputNode3->resolution() != m_resolution) return;
-        if(m_socketsInput[3]->value() == 0 && deserializing) return;
-    }
 
     preview->setFirstTexture((m_socketsInput[0]->value().toUInt()));
     preview->setSecondTexture((m_socketsInput[1]->value().toUInt()));
@@ -107,7 +86,6 @@ void MixNode::operation() {
     }
     preview->mixedTex = true;
     preview->update();
-    deserializing = false;
 
     if(m_socketsInput[0]->countEdge() == 0 && m_socketsInput[1]->countEdge() == 0) m_socketOutput[0]->setValue(0);
 }
@@ -187,7 +165,7 @@ void MixNode::setOutput() {
 }
 
 MixNode *MixNode::clone() {
-    return new MixNode(parentItem(), m_resolution, m_bpc, m_factor, m_fOpacity, m_bOpacity, m_mode,
+    return new MixNode(parentItem(), m_graphResolution, m_bpc, m_factor, m_fOpacity, m_bOpacity, m_mode,
                        m_includingAlpha);
 }
 
@@ -205,23 +183,23 @@ void MixNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash)
     Node::deserialize(json, hash);
     if(json.contains("factor")) {
         setFactor(json["factor"].toVariant().toFloat());
-        propertiesPanel->setProperty("startFactor", m_factor);
+        setPropertyOnPanel("startFactor", m_factor);
     }
     if(json.contains("mode")) {
         setMode(json["mode"].toInt());
-        propertiesPanel->setProperty("startMode", m_mode);
+        setPropertyOnPanel("startMode", m_mode);
     }
     if(json.contains("includingAlpha")) {
         setIncludingAlpha(json["includingAlpha"].toBool());
-        propertiesPanel->setProperty("startIncludingAlpha", m_includingAlpha);
+        setPropertyOnPanel("startIncludingAlpha", m_includingAlpha);
     }
     if(json.contains("foregroundOpacity")) {
         setForegroundOpacity(json["foregroundOpacity"].toInt());
-        propertiesPanel->setProperty("startForegroundOpacity", m_fOpacity);
+        setPropertyOnPanel("startForegroundOpacity", m_fOpacity);
     }
     if(json.contains("backgroundOpacity")) {
         setBackgroundOpacity(json["backgroundOpacity"].toInt());
-        propertiesPanel->setProperty("startBackgroundOpacity", m_bOpacity);
+        setPropertyOnPanel("startBackgroundOpacity", m_bOpacity);
     }
 
     preview->setFactor(m_factor);
@@ -230,8 +208,7 @@ void MixNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash)
     preview->setForegroundOpacity(m_fOpacity);
     preview->setBackgroundOpacity(m_bOpacity);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -60,6 +60,8 @@ public slots:
     void updateIncludingAlpha(bool including);
     void updateForegroundOpacity(int opacity);
     void updateBackgroundOpacity(int opacity);
+protected:
+    void createPropertiesPanel() override;
 private:
     MixObject *preview = nullptr;
     float m_factor = 1.0f;
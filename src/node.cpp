@@ -21,18 +21,29 @@
 
 #include "node.h"
 #include "scene.h"
+#include "textureformat.h"
 #include <iostream>
 #include <QQmlProperty>
 
-Node::Node(QQuickItem *parent, QVector2D resolution, GLint bpc): QQuickItem (parent), m_resolution(resolution), m_bpc(bpc)
+//entries of the resolution drop down, a size sets the width and keeps the graph aspect
+static const struct {
+    float scale;
+    int size;
+} resolutionOverrides[] = {{1.0f, 0}, {0.25f, 0}, {0.5f, 0}, {2.0f, 0}, {1.0f, 256}, {1.0f, 512}, {1.0f, 1024}, {1.0f, 2048}, {1.0f, 4096}};
+static const int resolutionOverrideCount = sizeof(resolutionOverrides)/sizeof(resolutionOverrides[0]);
+
+//nodes holding a property panel, the least recently shown first
+static QList<Node*> panelNodes;
+static const int maxPanels = 32;
+
+Node::Node(QQuickItem *parent, QVector2D resolution, GLint bpc): QQuickItem (parent), m_resolution(resolution),
+    m_graphResolution(resolution), m_bpc(bpc)
 {
     setFlag(ItemHasContents, true);
     setAcceptedMouseButtons(Qt::AllButtons);
     setAcceptHoverEvents(true);
     setTransformOrigin(TopLeft);
-    view = new QQuickView();
-    view->setSource(QUrl(QStringLiteral("qrc:/qml/Node.qml")));
-    grNode = qobject_cast<QQuickItem *>(view->rootObject());
+    grNode = QmlLoader::create(QStringLiteral("qrc:/qml/Node.qml"));
     grNode->setParentItem(this);
     grNode->setX(8);
     setZ(4);
@@ -62,9 +73,7 @@ Node::~Node() {
     }
 
     delete grNode;
-    delete view;
-    delete propertiesPanel;
-    delete propView;
+    releasePropertyPanel();
 }
 
 float Node::baseX() {
@@ -73,19 +82,12 @@ float Node::baseX() {
 
 void Node::setBaseX(float value) {
     m_baseX = value;
-    setX(m_baseX*m_scale - m_pan.x());
-    for(auto s: m_socketsInput) {
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
-    }
-    for(auto s: m_socketOutput) {
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
-    }
-    for(auto s: m_additionalInputs) {
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
+    setX(m_baseX);
+    if(isLoading()) {
+        emit changeBaseX(value);
+        return;
     }
+    updateSocketsPosition();
     if(m_attachedFrame && !m_attachedFrame->selected()) {
         m_attachedFrame->resizeByContent();
     }
@@ -98,33 +100,19 @@ float Node::baseY() {
 
 void Node::setBaseY(float value) {
     m_baseY = value;
-    setY(m_baseY*m_scale - m_pan.y());
-    for(auto s: m_socketsInput) {
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
-    }
-    for(auto s: m_socketOutput) {
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
-    }
-    for(auto s: m_additionalInputs) {
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
+    setY(m_baseY);
+    if(isLoading()) {
+        emit changeBaseY(value);
+        return;
     }
+    updateSocketsPosition();
     if(m_attachedFrame && !m_attachedFrame->selected()) {
         m_attachedFrame->resizeByContent();
     }
     emit changeBaseY(value);
 }
 
-QVector2D Node::pan() {
-    return m_pan;
-}
-
-void Node::setPan(QVector2D pan) {
-    m_pan = pan;
-    setX(m_baseX*m_scale - m_pan.x());
-    setY(m_baseY*m_scale - m_pan.y());
+void Node::updateSocketsPosition() {
     for(auto s: m_socketsInput) {
         QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
         s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
@@ -137,7 +125,12 @@ void Node::setPan(QVector2D pan) {
         QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
         s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
     }
-    emit changePan(pan);
+}
+
+bool Node::isLoading() const {
+    //sockets and frames are laid out once the whole scene is loaded
+    Scene *scene = Scene::sceneOf(this);
+    return scene && scene->isLoading();
 }
 
 QVector2D Node::resolution() {
@@ -145,8 +138,54 @@ QVector2D Node::resolution() {
 }
 
 void Node::setResolution(QVector2D res) {
-    m_resolution = res;
-    emit changeResolution(res);
+    m_graphResolution = res;
+    QVector2D oldResolution = m_resolution;
+    float scale = resolutionOverrides[m_resolutionOverride].scale;
+    int size = resolutionOverrides[m_resolutionOverride].size;
+    if(size > 0) {
+        m_resolution = QVector2D(size, qMax(1, qRound(size*res.y()/res.x())));
+    }
+    else {
+        m_resolution = QVector2D(qMax(1, qRound(res.x()*scale)), qMax(1, qRound(res.y()*scale)));
+    }
+    if(m_proxy) {
+        //interactive edits render at a quarter, but not below 256 pixels
+        float proxyScale = qBound(0.25f, 256.0f/m_resolution.x(), 1.0f);
+        m_resolution = QVector2D(qMax(1, qRound(m_resolution.x()*proxyScale)), qMax(1, qRound(m_resolution.y()*proxyScale)));
+    }
+    if(m_resolution == oldResolution) return;
+    emit changeResolution(m_resolution);
+}
+
+QVector2D Node::graphResolution() {
+    return m_graphResolution;
+}
+
+int Node::resolutionOverride() {
+    return m_resolutionOverride;
+}
+
+void Node::setResolutionOverride(int index) {
+    if(index < 0 || index >= resolutionOverrideCount) index = 0;
+    if(m_resolutionOverride == index) return;
+    m_resolutionOverride = index;
+    QVector2D res = m_resolution;
+    setResolution(m_graphResolution);
+    emit changeResolutionOverride(index);
+    if(m_resolution == res) return;
+    //copies on the clipboard are not part of the graph
+    Scene *scene = Scene::sceneOf(this);
+    if(scene && !scene->isLoading() && scene->nodes().contains(this)) scene->evaluator()->resized(this);
+}
+
+bool Node::proxy() {
+    return m_proxy;
+}
+
+void Node::setProxy(bool proxy) {
+    if(m_proxy == proxy) return;
+    m_proxy = proxy;
+    setResolution(m_graphResolution);
 }
 
 GLint Node::bpc() {
@@ -156,13 +195,12 @@ GLint Node::bpc() {
 void Node::setBPC(GLint bpc) {
     if(m_bpc == bpc) return;
     m_bpc = bpc;
+    for(auto s: m_socketOutput) {
+        s->setFormat(bpc);
+    }
     emit changeBPC(bpc);
 }
 
-float Node::scaleView(){
-    return m_scale;
-}
-
 bool Node::selected() {
     return m_selected;
 }
@@ -171,6 +209,8 @@ void Node::setSelected(bool select) {
     m_selected = select;
     grNode->setProperty("selected", select);
     emit changeSelected(select);
+    Scene *scene = Scene::sceneOf(this);
+    if(scene) scene->evaluator()->viewChanged();
 }
 
 bool Node::checkConnected(Node *node, socketType type) {
@@ -225,7 +265,7 @@ bool Node::checkConnected(Node *node, socketType type) {
 }
 
 bool Node::isPointInRadius(QVector2D point) {
-    return (x() - 30 < point.x() && x() + width()*scale() + 30 > point.x() && y() - 30 < point.y() && y() + height()*scale() + 30 > point.y());
+    return (x() - 30 < point.x() && x() + width() + 30 > point.x() && y() - 30 < point.y() && y() + height() + 30 > point.y());
 }
 
 Socket *Node::getNearestOutputSocket(QVector2D center, float radius) {
@@ -297,10 +337,65 @@ QList<Edge*> Node::getEdges() const {
     return edges;
 }
 
+QList<Node*> Node::inputNodes() const {
+    QList<Node*> nodes;
+    for(auto s: m_socketsInput) {
+        for(auto edge: s->getEdges()) {
+            if(edge->startSocket() && qobject_cast<Node*>(edge->startSocket()->parentItem())) {
+                nodes.append(qobject_cast<Node*>(edge->startSocket()->parentItem()));
+            }
+        }
+    }
+    for(auto s: m_additionalInputs) {
+        for(auto edge: s->getEdges()) {
+            if(edge->startSocket() && qobject_cast<Node*>(edge->startSocket()->parentItem())) {
+                nodes.append(qobject_cast<Node*>(edge->startSocket()->parentItem()));
+            }
+        }
+    }
+    return nodes;
+}
+
+QList<Node*> Node::outputNodes() const {
+    QList<Node*> nodes;
+    for(auto s: m_socketOutput) {
+        for(auto edge: s->getEdges()) {
+            if(edge->endSocket() && qobject_cast<Node*>(edge->endSocket()->parentItem())) {
+                nodes.append(qobject_cast<Node*>(edge->endSocket()->parentItem()));
+            }
+        }
+    }
+    return nodes;
+}
+
 QQuickItem *Node::getPropertyPanel() {
+    //panels are built from the current parameters on first use, headless runs have no panels to wire
+    if(!propertiesPanel && !QmlLoader::headless()) createPropertiesPanel();
+    if(!propertiesPanel) return nullptr;
+    panelNodes.removeOne(this);
+    panelNodes.append(this);
+    //hidden panels of the least recently shown nodes are released
+    for(int i = 0; i < panelNodes.size() - 1 && panelNodes.size() > maxPanels;) {
+        Node *node = panelNodes[i];
+        if(node->propertiesPanel->parentItem()) {
+            ++i;
+            continue;
+        }
+        node->releasePropertyPanel();
+    }
     return propertiesPanel;
 }
 
+void Node::releasePropertyPanel() {
+    panelNodes.removeOne(this);
+    delete propertiesPanel;
+    propertiesPanel = nullptr;
+}
+
+void Node::createPropertiesPanel() {
+
+}
+
 Frame *Node::attachedFrame() {
     return m_attachedFrame;
 }
@@ -318,10 +413,10 @@ void Node::mousePressEvent(QMouseEvent *event) {
     setFocus(false);
     moved = false;
     m_intersectingEdge = nullptr;
-    Scene *scene = reinterpret_cast<Scene*>(parentItem());
+    Scene *scene = Scene::sceneOf(this);
     QPointF point = mapToItem(scene, QPointF(event->pos().x(), event->pos().y())); 
-    dragX = event->pos().x()*scale();
-    dragY = event->pos().y()*scale();
+    dragX = event->pos().x();
+    dragY = event->pos().y();
     oldX = m_baseX;
     oldY = m_baseY;
     if(event->button() == Qt::LeftButton && event->modifiers() == Qt::ControlModifier) {
@@ -356,12 +451,12 @@ void Node::mouseMoveEvent(QMouseEvent *event) {
             moved = true;
         }
 
-        Scene* scene = reinterpret_cast<Scene*>(parentItem());
-        QPointF point = mapToItem(scene, QPointF(event->pos().x(), event->pos().y()));
+        Scene* scene = Scene::sceneOf(this);
+        QPointF point = mapToItem(parentItem(), QPointF(event->pos().x(), event->pos().y()));
         setX(point.x() - dragX);
         setY(point.y() - dragY);
-        int offsetBaseX = m_baseX - (x() + m_pan.x())/m_scale;
-        int offsetBaseY = m_baseY - (y() + m_pan.y())/m_scale;
+        int offsetBaseX = m_baseX - x();
+        int offsetBaseY = m_baseY - y();
         for(int i = 0; i < scene->countSelected(); ++i) {
             QQuickItem *item = scene->atSelected(i);
             if(qobject_cast<Node*>(item)) {
@@ -378,8 +473,8 @@ void Node::mouseMoveEvent(QMouseEvent *event) {
 
         if(scene->countSelected() == 1 && getEdges().count() == 0 && !m_socketsInput.empty() && !m_socketOutput.empty()) {
             Edge *edge = nullptr;
-            for(auto e: scene->edges()) {
-                bool intersecting = e->intersectWith(x(), y(), width()*m_scale, height()*m_scale);
+            for(auto e: scene->edgesIn(QRectF(x(), y(), width(), height()))) {
+                bool intersecting = e->intersectWith(x(), y(), width(), height());
                 if(intersecting) {
                     edge = e;
                     break;
@@ -403,7 +498,7 @@ void Node::mouseReleaseEvent(QMouseEvent *event) {
     if(event->button() == Qt::LeftButton && event->modifiers() != Qt::ControlModifier) {
         QVector2D offset(m_baseX - oldX, m_baseY - oldY);
 
-        Scene* scene = reinterpret_cast<Scene*>(parentItem());
+        Scene* scene = Scene::sceneOf(this);
         if(!moved && m_selected){
             QList<QQuickItem*> selected = scene->selectedList();
             if(selected.size() > 1) {
@@ -414,7 +509,7 @@ void Node::mouseReleaseEvent(QMouseEvent *event) {
             }
         }
         else {
-            QPointF scenePoint = mapToItem(scene, QPointF(width()*0.5f, height()*0.16f));
+            QPointF scenePoint = mapToItem(parentItem(), QPointF(width()*0.5f, height()*0.16f));
             Frame *frame = scene->frameAt(scenePoint.x(), scenePoint.y());
             if(m_intersectingEdge) m_intersectingEdge->setSelected(false);
             frame = attachedFrame() ? nullptr : frame;
@@ -446,7 +541,7 @@ void Node::hoverLeaveEvent(QHoverEvent *event) {
 }
 
 Node *Node::clone() {
-    return new Node(parentItem(), m_resolution, m_bpc);
+    return new Node(parentItem(), m_graphResolution, m_bpc);
 }
 
 void Node::serialize(QJsonObject &json) const {
@@ -454,6 +549,7 @@ void Node::serialize(QJsonObject &json) const {
     json["baseX"] = m_baseX;
     json["baseY"] = m_baseY;
     json["bpc"] = m_bpc;
+    json["resolutionOverride"] = m_resolutionOverride;
     QJsonArray inputs;
     for(Socket *s: m_socketsInput) {
         QJsonObject socketObject;
@@ -478,7 +574,6 @@ void Node::serialize(QJsonObject &json) const {
 }
 
 void Node::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
-    deserializing = true;
     if(json.contains("baseX")) {        
         setBaseX(json["baseX"].toVariant().toFloat());
     }
@@ -488,6 +583,9 @@ void Node::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
     if(json.contains("bpc")) {
         setBPC(json["bpc"].toInt());
     }
+    if(json.contains("resolutionOverride")) {
+        setResolutionOverride(json["resolutionOverride"].toInt());
+    }
     if(json.contains("inputs")) {
         QJsonArray inputs = json["inputs"].toArray();
         for(int i = 0; i < inputs.size(); ++i) {
@@ -520,15 +618,14 @@ void Node::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
 void Node::createSockets(int inputCount, int outputCount) {
     m_socketsInput.clear();
     m_socketOutput.clear();
-    float inputStart = (grNode->height() - 30*m_scale)/2 + 22*m_scale - 42*m_scale*(inputCount - 1)/2;
-    float outputStart = (grNode->height() - 30*m_scale)/2 + 22*m_scale - 42*m_scale*(outputCount - 1)/2;
+    float inputStart = (grNode->height() - 30)/2 + 22 - 42*(inputCount - 1)/2;
+    float outputStart = (grNode->height() - 30)/2 + 22 - 42*(outputCount - 1)/2;
     for(int i = 0; i < inputCount; ++i) {
         Socket *s = new Socket(this);
         s->setType(INPUTS);
-        s->setY(inputStart + 42*m_scale*i);
-        s->setX(2*m_scale);
-        s->updateScale(m_scale);
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8*m_scale, s->y() + 8*m_scale));
+        s->setY(inputStart + 42*i);
+        s->setX(2);
+        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
         s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
         m_socketsInput.append(s);
     }
@@ -536,9 +633,9 @@ void Node::createSockets(int inputCount, int outputCount) {
         Socket *s = new Socket(this);
         s->setType(OUTPUTS);
         s->setTip("Output");
-        s->setY(outputStart + 42*m_scale*i);
-        s->setX(178*m_scale);
-        s->updateScale(m_scale);
+        s->setFormat(m_bpc);
+        s->setY(outputStart + 42*i);
+        s->setX(178);
         QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
         s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
         m_socketOutput.append(s);
@@ -547,15 +644,14 @@ void Node::createSockets(int inputCount, int outputCount) {
 
 void Node::createAdditionalInputs(int count) {
     m_additionalInputs.clear();
-    float start = grNode->height() + 12*m_scale;
+    float start = grNode->height() + 12;
     for(int i = 0; i < count; ++i) {
         Socket *s = new Socket(this);
         s->setType(INPUTS);
         s->setAdditional(true);
-        s->setY(start + 28*m_scale*i);
-        s->setX(2*m_scale);
-        s->updateScale(m_scale);
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8*m_scale, s->y() + 8*m_scale));
+        s->setY(start + 28*i);
+        s->setX(2);
+        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
         s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
         m_additionalInputs.append(s);
     }
@@ -566,11 +662,11 @@ void Node::setTitle(QString title) {
 }
 
 void Node::setPropertyOnPanel(const char *name, QVariant value) {
-    propertiesPanel->setProperty(name, value);
+    if(propertiesPanel) propertiesPanel->setProperty(name, value);
 }
 
 void Node::propertyChanged(QString propName, QVariant newValue, QVariant oldValue) {
-    Scene* scene = reinterpret_cast<Scene*>(parentItem());
+    Scene* scene = Scene::sceneOf(this);
     if(scene) {
         std::string prop = propName.toStdString();
         char *name = new char[prop.size() + 1];
@@ -592,41 +688,39 @@ void Node::saveTexture(QString fileName) {
 
 }
 
-void Node::scaleUpdate(float scale) {
-    setScale(scale);
-    grNode->setProperty("scaleView", scale);
-    int inputCount = m_socketsInput.length();
-    int outputCount = m_socketOutput.length();
-    for(int i = 0; i < inputCount; ++i) {
-        Socket *s = m_socketsInput[i];
-        s->updateScale(scale);
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
-    }
-    for(int i = 0; i < outputCount; ++i) {
-        Socket *s = m_socketOutput[i];
-        s->updateScale(scale);
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
-    }
-    for(int i = 0; i < m_additionalInputs.length(); ++i) {
-        Socket *s = m_additionalInputs[i];
-        s->updateScale(scale);
-        QPointF sPos = mapToItem(parentItem(), QPointF(s->x() + 8, s->y() + 8));
-        s->setGlobalPos(QVector2D(sPos.x(), sPos.y()));
+bool Node::pointStage(PointStage &stage) {
+    return false;
+}
+
+bool Node::fused() {
+    return m_fused;
+}
+
+void Node::setFused(bool fused) {
+    m_fused = fused;
+}
+
+bool Node::isPreviewVisible() {
+    Scene *scene = Scene::sceneOf(this);
+    if(m_selected || !scene) return true;
+    QRectF view(0, 0, scene->width(), scene->height());
+    return view.intersects(mapRectToItem(scene, boundingRect()));
+}
+
+unsigned int Node::fusedSource(QList<PointStage> &stages) {
+    //fused nodes upstream write no texture, their stages run in this node's shader
+    Socket *input = m_socketsInput[0];
+    while(input->countEdge() > 0) {
+        Node *node = qobject_cast<Node*>(input->getEdges()[0]->startSocket()->parentItem());
+        PointStage stage;
+        if(!node || !node->fused() || !node->pointStage(stage)) break;
+        stage.normalized = !TextureFormat::isFloat(node->bpc());
+        stages.prepend(stage);
+        input = node->getInputSocket(0);
     }
-    m_scale = scale;
-    changeScaleView(scale);
+    return input->value().toUInt();
 }
 
 void Node::bpcUpdate(int bpcType) {
-    switch (bpcType) {
-        case 0:
-        default:
-            setBPC(GL_RGBA8);
-            break;
-        case 1:
-            setBPC(GL_RGBA16);
-            break;
-    }
+    setBPC(TextureFormat::fromIndex(bpcType));
 }
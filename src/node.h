@@ -22,10 +22,11 @@
 #ifndef NODE_H
 #define NODE_H
 #include <QQuickItem>
-#include <QQuickView>
 #include <QJsonObject>
 #include <QJsonArray>
 #include "socket.h"
+#include "qmlloader.h"
+#include "pointstage.h"
 
 class Frame;
 
@@ -34,8 +35,8 @@ class Node: public QQuickItem
     Q_OBJECT
     Q_PROPERTY(float baseX READ baseX WRITE setBaseX NOTIFY changeBaseX)
     Q_PROPERTY(float baseY READ baseY WRITE setBaseY NOTIFY changeBaseY)
-    Q_PROPERTY(QVector2D pan READ pan WRITE setPan NOTIFY changePan)
     Q_PROPERTY(bool selected READ selected WRITE setSelected NOTIFY changeSelected)
+    Q_PROPERTY(int resolutionOverride READ resolutionOverride WRITE setResolutionOverride NOTIFY changeResolutionOverride)
 public:
     Node(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA8);
     Node(const Node &node);
@@ -44,13 +45,16 @@ public:
     void setBaseX(float value);
     float baseY();
     void setBaseY(float value);
-    QVector2D pan();
-    void setPan(QVector2D pan);
+    void updateSocketsPosition();
     QVector2D resolution();
     void setResolution(QVector2D res);
+    QVector2D graphResolution();
+    int resolutionOverride();
+    void setResolutionOverride(int index);
+    bool proxy();
+    void setProxy(bool proxy);
     GLint bpc();
     void setBPC(GLint bpc);
-    float scaleView();
     bool selected();
     void setSelected(bool select);
     bool checkConnected(Node* node, socketType type);
@@ -60,7 +64,10 @@ public:
     Socket *getInputSocket(int index) const;
     Socket *getOutputSocket(int index) const;
     QList<Edge*> getEdges() const;
+    QList<Node*> inputNodes() const;
+    QList<Node*> outputNodes() const;
     QQuickItem *getPropertyPanel();
+    void releasePropertyPanel();
     Frame *attachedFrame();
     void setAttachedFrame(Frame *frame);
     void mousePressEvent(QMouseEvent *event);
@@ -78,40 +85,44 @@ public:
     virtual void operation();
     virtual unsigned int &getPreviewTexture();
     virtual void saveTexture(QString fileName);
+    virtual bool pointStage(PointStage &stage);
+    bool fused();
+    virtual void setFused(bool fused);
+    bool isPreviewVisible();
+    unsigned int fusedSource(QList<PointStage> &stages);
 public slots:
-    void scaleUpdate(float scale);
     void bpcUpdate(int bpcType);
     void propertyChanged(QString propName, QVariant newValue, QVariant oldValue);
 signals:
     void changeBaseX(float value);
     void changeBaseY(float value);
-    void changePan(QVector2D pan);
     void changeResolution(QVector2D res);
+    void changeResolutionOverride(int index);
     void changeBPC(GLint bpc);
     void changeSelected(bool select);
-    void changeScaleView(float scale);
     void updatePreview(unsigned int previewData);
     void dataChanged();
     void generatePreview();
 protected:
+    virtual void createPropertiesPanel();
+    bool isLoading() const;
     QQuickItem *grNode = nullptr;
     QQuickItem *propertiesPanel = nullptr;
-    QQuickView *propView = nullptr;
     QVector<Socket *> m_socketsInput;
     QVector<Socket *> m_socketOutput;
     QVector<Socket *> m_additionalInputs;
     QVector2D m_resolution;
+    QVector2D m_graphResolution;
+    int m_resolutionOverride = 0;
+    bool m_proxy = false;
     GLint m_bpc;
-    bool deserializing = false;
 private:
-    QQuickView *view;
     Frame *m_attachedFrame = nullptr;
     Edge *m_intersectingEdge = nullptr;
     float m_baseX = 0;
     float m_baseY = 0;
-    float m_scale = 1.0f;
-    QVector2D m_pan = QVector2D(0, 0);
     bool m_selected = false;
+    bool m_fused = false;
     float dragX = 0.0f;
     float dragY = 0.0f;
     float oldX;
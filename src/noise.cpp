@@ -20,8 +20,13 @@
  */
 
 #include "noise.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
+#include <QtMath>
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 NoiseObject::NoiseObject(QQuickItem *parent, QVector2D resolution, GLint bpc, QString type,
                          float noiseScale, float scaleX, float scaleY, int layers, float persistence,
@@ -132,6 +137,16 @@ void NoiseObject::setSeed(int seed) {
     generatedNoise = true;
 }
 
+bool NoiseObject::channels() {
+    return m_channels;
+}
+
+void NoiseObject::setChannels(bool channels) {
+    if(m_channels == channels) return;
+    m_channels = channels;
+    generatedNoise = true;
+}
+
 QVector2D NoiseObject::resolution() {
     return m_resolution;
 }
@@ -164,20 +179,11 @@ void NoiseObject::setTexture(unsigned int texture) {
 NoiseRenderer::NoiseRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
 
-    generateNoise = new QOpenGLShaderProgram();
-    generateNoise->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    generateNoise->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/noise.frag");
-    generateNoise->link();
+    generateNoise = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/noise.frag");
 
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
 
-    renderTexture = new QOpenGLShaderProgram();
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    renderTexture->link();
+    renderTexture = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     generateNoise->bind();
     generateNoise->setUniformValue(generateNoise->uniformLocation("maskTexture"), 0);
@@ -185,7 +191,6 @@ NoiseRenderer::NoiseRenderer(QVector2D resolution, GLint bpc): m_resolution(reso
 
     renderTexture->bind();
     renderTexture->setUniformValue(renderTexture->uniformLocation("textureSample"), 0);
-    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     renderTexture->release();
 
     float vertQuad[] = {-1.0f, -1.0f,
@@ -224,12 +229,7 @@ NoiseRenderer::NoiseRenderer(QVector2D resolution, GLint bpc): m_resolution(reso
     glBindFramebuffer(GL_FRAMEBUFFER, noiseFBO);
     glGenTextures(1, &noiseTexture);
     glBindTexture(GL_TEXTURE_2D, noiseTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -243,9 +243,10 @@ NoiseRenderer::NoiseRenderer(QVector2D resolution, GLint bpc): m_resolution(reso
 }
 
 NoiseRenderer::~NoiseRenderer() {
-    delete generateNoise;
-    delete checkerShader;
-    delete renderTexture;
+    Resampler::release(this);
+    ShaderCache::release(generateNoise);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(renderTexture);
     glDeleteTextures(1, &noiseTexture);
     glDeleteFramebuffers(1, &noiseFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -278,17 +279,15 @@ void NoiseRenderer::synchronize(QQuickFramebufferObject *item) {
         if(noiseItem->generatedNoise) {
             noiseItem->generatedNoise = false;
             m_noiseType = noiseItem->noiseType();
-            m_maskTexture = noiseItem->maskTexture();
-            generateNoise->bind();
-            generateNoise->setUniformValue(generateNoise->uniformLocation("scale"), noiseItem->noiseScale());
-            generateNoise->setUniformValue(generateNoise->uniformLocation("scaleX"), noiseItem->scaleX());
-            generateNoise->setUniformValue(generateNoise->uniformLocation("scaleY"), noiseItem->scaleY());
-            generateNoise->setUniformValue(generateNoise->uniformLocation("octaves"), noiseItem->layers());
-            generateNoise->setUniformValue(generateNoise->uniformLocation("persistence"), noiseItem->persistence());
-            generateNoise->setUniformValue(generateNoise->uniformLocation("amplitude"), noiseItem->amplitude());
-            generateNoise->setUniformValue(generateNoise->uniformLocation("seed"), noiseItem->seed());
-            generateNoise->setUniformValue(generateNoise->uniformLocation("res"), m_resolution);
-            generateNoise->setUniformValue(generateNoise->uniformLocation("useMask"), m_maskTexture);
+            m_maskTexture = Resampler::instance()->resample(this, 0, noiseItem->maskTexture(), noiseItem->resolution());
+            m_scale = noiseItem->noiseScale();
+            m_scaleX = noiseItem->scaleX();
+            m_scaleY = noiseItem->scaleY();
+            m_octaves = noiseItem->layers();
+            m_persistence = noiseItem->persistence();
+            m_amplitude = noiseItem->amplitude();
+            m_seed = noiseItem->seed();
+            m_channels = noiseItem->channels();
         }
         createNoise();
         noiseItem->setTexture(noiseTexture);
@@ -314,6 +313,7 @@ void NoiseRenderer::render() {
     checkerShader->release();
 
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, noiseTexture);
@@ -333,6 +333,15 @@ void NoiseRenderer::createNoise() {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     generateNoise->bind();
+    generateNoise->setUniformValue(generateNoise->uniformLocation("scale"), m_scale);
+    generateNoise->setUniformValue(generateNoise->uniformLocation("scaleX"), m_scaleX);
+    generateNoise->setUniformValue(generateNoise->uniformLocation("scaleY"), m_scaleY);
+    generateNoise->setUniformValue(generateNoise->uniformLocation("octaves"), visibleOctaves());
+    generateNoise->setUniformValue(generateNoise->uniformLocation("persistence"), m_persistence);
+    generateNoise->setUniformValue(generateNoise->uniformLocation("amplitude"), m_amplitude);
+    generateNoise->setUniformValue(generateNoise->uniformLocation("seed"), m_seed);
+    generateNoise->setUniformValue(generateNoise->uniformLocation("useMask"), m_maskTexture);
+    generateNoise->setUniformValue(generateNoise->uniformLocation("channels"), m_channels);
     generateNoise->setUniformValue(generateNoise->uniformLocation("res"), m_resolution);
     GLuint index = glGetSubroutineIndex(generateNoise->programId(), GL_FRAGMENT_SHADER, m_noiseType.toStdString().c_str());
     glUniformSubroutinesuiv(GL_FRAGMENT_SHADER, 1, &index);
@@ -349,14 +358,18 @@ void NoiseRenderer::createNoise() {
     glFinish();    
 }
 
+int NoiseRenderer::visibleOctaves() {
+    //octaves with cells smaller than two pixels only add aliasing, so they are not evaluated
+    float frequency = qFloor(m_scale)*qMax(m_scaleX, m_scaleY);
+    float limit = 0.5f*m_resolution.y();
+    int octaves = m_octaves;
+    while(octaves > 0 && frequency*(1 << octaves) > limit) --octaves;
+    return octaves;
+}
+
 void NoiseRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, noiseTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -368,12 +381,7 @@ void NoiseRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -387,6 +395,7 @@ void NoiseRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, noiseTexture);
@@ -395,41 +404,7 @@ void NoiseRenderer::saveTexture(QString fileName) {
     glBindTexture(GL_TEXTURE_2D, 0);
     renderTexture->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
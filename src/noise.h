@@ -52,6 +52,8 @@ public:
     void setAmplitude(float value);
     int seed();
     void setSeed(int seed);
+    bool channels();
+    void setChannels(bool channels);
     QVector2D resolution();
     void setResolution(QVector2D res);
     GLint bpc();
@@ -76,6 +78,7 @@ private:
     float m_persistence = 0.5f;
     float m_amplitude = 1.0f;
     int m_seed = 1;
+    bool m_channels = false;
     unsigned int m_texture = 0;
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA16;
@@ -91,8 +94,17 @@ public:
     void render();   
 private:
     void createNoise();
+    int visibleOctaves();
     void updateTexResolution();
     void saveTexture(QString fileName);
+    float m_scale = 0.0f;
+    float m_scaleX = 0.0f;
+    float m_scaleY = 0.0f;
+    int m_octaves = 0;
+    float m_persistence = 0.0f;
+    float m_amplitude = 0.0f;
+    int m_seed = 0;
+    bool m_channels = false;
     QOpenGLShaderProgram *generateNoise;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *renderTexture;
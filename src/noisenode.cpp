@@ -21,19 +21,19 @@
 
 #include "noisenode.h"
 #include <iostream>
+#include "textureformat.h"
 
 NoiseNode::NoiseNode(QQuickItem *parent, QVector2D resolution, GLint bpc, NoiseParams perlin,
-                     NoiseParams simple, QString noiseType): Node(parent, resolution, bpc),
-    m_noiseType(noiseType), perlinNoise(perlin), simpleNoise(simple)
+                     NoiseParams simple, QString noiseType, bool channels): Node(parent, resolution, bpc),
+    m_noiseType(noiseType), perlinNoise(perlin), simpleNoise(simple), m_channels(channels)
 {
     preview = new NoiseObject(grNode, m_resolution, m_bpc, m_noiseType, noiseScale(), scaleX(), scaleY(), layers(), persistence(), amplitude(), seed());
-    float s = scaleView();
+    preview->setChannels(m_channels);
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &NoiseNode::generatePreview, this, &NoiseNode::previewGenerated);
     connect(this, &NoiseNode::noiseTypeChanged, preview, &NoiseObject::setNoiseType);
     connect(preview, &NoiseObject::updatePreview, this, &NoiseNode::updatePreview);
@@ -43,9 +43,14 @@ NoiseNode::NoiseNode(QQuickItem *parent, QVector2D resolution, GLint bpc, NoiseP
     createSockets(1, 1);
     m_socketsInput[0]->setTip("Mask");
     setTitle("Noise");
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/NoiseProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+NoiseNode::~NoiseNode() {
+    delete preview;
+}
+
+void NoiseNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/NoiseProperty.qml"));
     int index = 0;
     if(m_noiseType == "noiseSimple") index = 1;
     propertiesPanel->setProperty("type", index);
@@ -56,8 +61,8 @@ NoiseNode::NoiseNode(QQuickItem *parent, QVector2D resolution, GLint bpc, NoiseP
     propertiesPanel->setProperty("startPersistence", persistence());
     propertiesPanel->setProperty("startAmplitude", amplitude());
     propertiesPanel->setProperty("startSeed", seed());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startChannels", m_channels);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(noiseScaleChanged(qreal)), this, SLOT(updateNoiseScale(qreal)));
     connect(propertiesPanel, SIGNAL(scaleXChanged(qreal)), this, SLOT(updateScaleX(qreal)));
     connect(propertiesPanel, SIGNAL(scaleYChanged(qreal)), this, SLOT(updateScaleY(qreal)));
@@ -65,15 +70,12 @@ NoiseNode::NoiseNode(QQuickItem *parent, QVector2D resolution, GLint bpc, NoiseP
     connect(propertiesPanel, SIGNAL(persistenceChanged(qreal)), this, SLOT(updatePersistence(qreal)));
     connect(propertiesPanel, SIGNAL(amplitudeChanged(qreal)), this, SLOT(updateAmplitude(qreal)));
     connect(propertiesPanel, SIGNAL(seedChanged(int)), this, SLOT(updateSeed(int)));
+    connect(propertiesPanel, SIGNAL(channelsChanged(bool)), this, SLOT(updateChannels(bool)));
     connect(propertiesPanel, SIGNAL(noiseTypeChanged(QString)), this, SLOT(updateNoiseType(QString)));
     connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-NoiseNode::~NoiseNode() {
-    delete preview;
-}
-
 QString NoiseNode::noiseType() {
     return m_noiseType;
 }
@@ -81,13 +83,13 @@ QString NoiseNode::noiseType() {
 void NoiseNode::setNoiseType(QString type) {
     if(m_noiseType == type) return;
     m_noiseType = type;    
-    propertiesPanel->setProperty("startNoiseScale", noiseScale());
-    propertiesPanel->setProperty("startScaleX", scaleX());
-    propertiesPanel->setProperty("startScaleY", scaleY());
-    propertiesPanel->setProperty("startLayers", layers());
-    propertiesPanel->setProperty("startPersistence", persistence());
-    propertiesPanel->setProperty("startAmplitude", amplitude());
-    propertiesPanel->setProperty("startSeed", seed());
+    setPropertyOnPanel("startNoiseScale", noiseScale());
+    setPropertyOnPanel("startScaleX", scaleX());
+    setPropertyOnPanel("startScaleY", scaleY());
+    setPropertyOnPanel("startLayers", layers());
+    setPropertyOnPanel("startPersistence", persistence());
+    setPropertyOnPanel("startAmplitude", amplitude());
+    setPropertyOnPanel("startSeed", seed());
     noiseTypeChanged(type);
 
     preview->setNoiseScale(noiseScale());
@@ -248,6 +250,23 @@ void NoiseNode::setSeed(int seed) {
     preview->update();
 }
 
+bool NoiseNode::channels() {
+    return m_channels;
+}
+
+void NoiseNode::setChannels(bool channels) {
+    if(m_channels == channels) return;
+    m_channels = channels;
+    channelsChanged(channels);
+    //separate channels need the green channel a gray format drops
+    if(channels && TextureFormat::isScalar(m_bpc)) {
+        setBPC(GL_RGBA16);
+        setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
+    }
+    preview->setChannels(channels);
+    preview->update();
+}
+
 unsigned int &NoiseNode::getPreviewTexture() {
     return preview->texture();
 }
@@ -258,18 +277,12 @@ void NoiseNode::saveTexture(QString fileName) {
 
 void NoiseNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value().toUInt() == 0 && deserializing) return;
-    }
     preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
     m_socketOutput[0]->setValue(preview->texture());
-    deserializing = false;
 }
 
 NoiseNode *NoiseNode::clone() {
-    return new NoiseNode(parentItem(), m_resolution, m_bpc, perlinNoise, simpleNoise, m_noiseType);
+    return new NoiseNode(parentItem(), m_graphResolution, m_bpc, perlinNoise, simpleNoise, m_noiseType, m_channels);
 }
 
 void NoiseNode::serialize(QJsonObject &json) const {
@@ -294,6 +307,7 @@ void NoiseNode::serialize(QJsonObject &json) const {
     simpleParams["seed"] = simpleNoise.seed;
     json["simpleParams"] = simpleParams;
     json["noiseType"] = m_noiseType;
+    json["channels"] = m_channels;
 }
 
 void NoiseNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
@@ -351,14 +365,14 @@ void NoiseNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &has
         noiseTypeChanged(m_noiseType);
         int index = 0;
         if(m_noiseType == "noiseSimple") index = 1;
-        propertiesPanel->setProperty("type", index);
-        propertiesPanel->setProperty("startNoiseScale", noiseScale());
-        propertiesPanel->setProperty("startScaleX", scaleX());
-        propertiesPanel->setProperty("startScaleY", scaleY());
-        propertiesPanel->setProperty("startLayers", layers());
-        propertiesPanel->setProperty("startPersistence", persistence());
-        propertiesPanel->setProperty("startAmplitude", amplitude());
-        propertiesPanel->setProperty("startSeed", seed());
+        setPropertyOnPanel("type", index);
+        setPropertyOnPanel("startNoiseScale", noiseScale());
+        setPropertyOnPanel("startScaleX", scaleX());
+        setPropertyOnPanel("startScaleY", scaleY());
+        setPropertyOnPanel("startLayers", layers());
+        setPropertyOnPanel("startPersistence", persistence());
+        setPropertyOnPanel("startAmplitude", amplitude());
+        setPropertyOnPanel("startSeed", seed());
 
         preview->setNoiseScale(noiseScale());
         preview->setScaleX(scaleX());
@@ -368,8 +382,12 @@ void NoiseNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &has
         preview->setAmplitude(amplitude());
         preview->setSeed(seed());
     }
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    if(json.contains("channels")) {
+        m_channels = json["channels"].toBool();
+        setPropertyOnPanel("startChannels", m_channels);
+        preview->setChannels(m_channels);
+    }
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
     preview->update();
 }
 
@@ -413,6 +431,11 @@ void NoiseNode::updateSeed(int seed) {
     dataChanged();
 }
 
+void NoiseNode::updateChannels(bool channels) {
+    setChannels(channels);
+    dataChanged();
+}
+
 void NoiseNode::previewGenerated() {
     preview->generatedNoise = true;
     preview->update();
@@ -38,7 +38,7 @@ class NoiseNode: public Node
 {
     Q_OBJECT
 public:
-    NoiseNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, NoiseParams perlin = NoiseParams(), NoiseParams simple = NoiseParams{0.5f, 1.0f, 1, 1, 20, 8, 1}, QString noiseType = "noisePerlin");
+    NoiseNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, NoiseParams perlin = NoiseParams(), NoiseParams simple = NoiseParams{0.5f, 1.0f, 1, 1, 20, 8, 1}, QString noiseType = "noisePerlin", bool channels = false);
     ~NoiseNode();
     QString noiseType();    
     void setNoiseType(QString type);
@@ -58,6 +58,8 @@ public:
     void setAmplitude(float value);
     int seed();
     void setSeed(int seed);
+    bool channels();
+    void setChannels(bool channels);
     unsigned int &getPreviewTexture() override;
     void saveTexture(QString fileName) override;
     void operation() override;
@@ -73,6 +75,7 @@ signals:
     void persistenceChanged(float persistence);
     void amplitudeChanged(float amplitude);
     void seedChanged(int seed);
+    void channelsChanged(bool channels);
 public slots:
     void updateNoiseType(QString type);
     void updateNoiseScale(qreal scale);
@@ -83,12 +86,16 @@ public slots:
     void updatePersistence(qreal value);
     void updateAmplitude(qreal value);
     void updateSeed(int seed);
+    void updateChannels(bool channels);
     void previewGenerated();
+protected:
+    void createPropertiesPanel() override;
 private:
     NoiseObject *preview = nullptr;
     QString m_noiseType = "perlinNoise";
     NoiseParams perlinNoise;
     NoiseParams simpleNoise;
+    bool m_channels = false;
 };
 
 #endif // NOISENODE_H
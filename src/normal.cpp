@@ -20,8 +20,12 @@
  */
 
 #include "normal.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 NormalObject::NormalObject(QQuickItem *parent, QVector2D resolution, GLint bpc):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc)
@@ -67,10 +71,7 @@ void NormalObject::saveTexture(QString fileName) {
 NormalRenderer::NormalRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
 
-    renderNormal = new QOpenGLShaderProgram();
-    renderNormal->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderNormal->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    renderNormal->link();
+    renderNormal = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     renderNormal->bind();
     renderNormal->setUniformValue(renderNormal->uniformLocation("textureSample"), 0);
@@ -95,7 +96,8 @@ NormalRenderer::NormalRenderer(QVector2D resolution, GLint bpc): m_resolution(re
 }
 
 NormalRenderer::~NormalRenderer() {
-    delete renderNormal;
+    Resampler::release(this);
+    ShaderCache::release(renderNormal);
     glDeleteVertexArrays(1, &VAO);
 }
 
@@ -107,7 +109,7 @@ QOpenGLFramebufferObject *NormalRenderer::createFramebufferObject(const QSize &s
 
 void NormalRenderer::synchronize(QQuickFramebufferObject *item) {
     NormalObject *normalItem = static_cast<NormalObject*>(item);
-    m_normalTexture = normalItem->normalTexture();
+    m_normalTexture = Resampler::instance()->resample(this, 0, normalItem->normalTexture(), normalItem->resolution());
     m_resolution = normalItem->resolution();
     m_bpc = normalItem->bpc();
     normalItem->updateNormal(m_normalTexture);
@@ -126,6 +128,7 @@ void NormalRenderer::render() {
     glClear(GL_COLOR_BUFFER_BIT);
     if(m_normalTexture) {
         renderNormal->bind();
+        renderNormal->setUniformValue(renderNormal->uniformLocation("lod"), 0.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_normalTexture);
         glBindVertexArray(VAO);
@@ -144,12 +147,7 @@ void NormalRenderer::saveTexture(QString name) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::rgbFormat(TextureFormat::exportFormat(m_bpc)), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -161,6 +159,7 @@ void NormalRenderer::saveTexture(QString name) {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderNormal->bind();
+    renderNormal->setUniformValue(renderNormal->uniformLocation("lod"), 0.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_normalTexture);
     glBindVertexArray(VAO);
@@ -170,40 +169,7 @@ void NormalRenderer::saveTexture(QString name) {
     renderNormal->release();
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGB16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGB16 *bits = (FIRGB16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*3 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*3 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, name.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 3 * m_resolution.x(), 24, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, name.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, name, m_resolution.x(), m_resolution.y(), m_bpc, 3);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
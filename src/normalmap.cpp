@@ -20,8 +20,12 @@
  */
 
 #include "normalmap.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 NormalMapObject::NormalMapObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float strenght):
     QQuickFramebufferObject (parent), m_strenght(strenght), m_resolution(resolution), m_bpc(bpc)
@@ -91,15 +95,9 @@ void NormalMapObject::setNormalTexture(unsigned int texture) {
 NormalMapRenderer::NormalMapRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
 
-    normalMap = new QOpenGLShaderProgram();
-    normalMap->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    normalMap->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/normalmap.frag");
-    normalMap->link();
+    normalMap = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/normalmap.frag");
 
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     normalMap->bind();
     normalMap->setUniformValue(normalMap->uniformLocation("grayscaleTexture"), 0);
@@ -107,7 +105,6 @@ NormalMapRenderer::NormalMapRenderer(QVector2D resolution, GLint bpc): m_resolut
 
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
 
     float vertQuad[] = {-1.0f, -1.0f,
@@ -146,10 +143,10 @@ NormalMapRenderer::NormalMapRenderer(QVector2D resolution, GLint bpc): m_resolut
     glBindFramebuffer(GL_FRAMEBUFFER, normalMapFBO);
     glGenTextures(1, &m_normalTexture);
     glBindTexture(GL_TEXTURE_2D, m_normalTexture);
-    if(m_bpc == GL_RGBA8) {
+    if(TextureFormat::exportFormat(m_bpc) == GL_RGBA8) {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
     }
-    else if(m_bpc == GL_RGBA16) {
+    else {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_SHORT, nullptr);
     }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
@@ -165,8 +162,9 @@ NormalMapRenderer::NormalMapRenderer(QVector2D resolution, GLint bpc): m_resolut
 }
 
 NormalMapRenderer::~NormalMapRenderer() {
-    delete textureShader;
-    delete normalMap;
+    Resampler::release(this);
+    ShaderCache::release(textureShader);
+    ShaderCache::release(normalMap);
     glDeleteTextures(1, &m_normalTexture);
     glDeleteFramebuffers(1, &normalMapFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -194,7 +192,7 @@ void NormalMapRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(normalItem->normalGenerated) {
             normalItem->normalGenerated = false;
-            m_grayscaleTexture = normalItem->grayscaleTexture();
+            m_grayscaleTexture = Resampler::instance()->resample(this, 0, normalItem->grayscaleTexture(), normalItem->resolution());
             if(m_grayscaleTexture) {
                 strenght = normalItem->strenght();
             }
@@ -218,6 +216,7 @@ void NormalMapRenderer::render() {
     glClear(GL_COLOR_BUFFER_BIT);
     if(m_grayscaleTexture) {
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_normalTexture);
         glBindVertexArray(textureVAO);
@@ -255,10 +254,10 @@ void NormalMapRenderer::createNormalMap() {
 
 void NormalMapRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_normalTexture);
-    if(m_bpc == GL_RGBA8) {
+    if(TextureFormat::exportFormat(m_bpc) == GL_RGBA8) {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
     }
-    else if(m_bpc == GL_RGBA16) {
+    else {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_SHORT, nullptr);
     }
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -271,12 +270,7 @@ void NormalMapRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::rgbFormat(TextureFormat::exportFormat(m_bpc)), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -288,6 +282,7 @@ void NormalMapRenderer::saveTexture(QString fileName) {
     glClearColor(0.6f, 0.6f, 0.6f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_normalTexture);
     glBindVertexArray(textureVAO);
@@ -296,40 +291,7 @@ void NormalMapRenderer::saveTexture(QString fileName) {
     glBindTexture(GL_TEXTURE_2D, 0);
     textureShader->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGB16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGB16 *bits = (FIRGB16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*3 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*3 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 3 * m_resolution.x(), 24, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc, 3);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
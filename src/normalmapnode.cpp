@@ -20,6 +20,7 @@
  */
 
 #include "normalmapnode.h"
+#include "textureformat.h"
 
 NormalMapNode::NormalMapNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float strenght):
     Node(parent, resolution, bpc), m_strenght(strenght)
@@ -28,43 +29,35 @@ NormalMapNode::NormalMapNode(QQuickItem *parent, QVector2D resolution, GLint bpc
     setTitle("Normal Map");
     m_socketsInput[0]->setTip("Height");
     preview = new NormalMapObject(grNode, m_resolution, m_bpc, m_strenght);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
-    propView = new QQuickView();
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &NormalMapObject::textureChanged, this, &NormalMapNode::setOutput);
     connect(this, &NormalMapNode::generatePreview, this, &NormalMapNode::previewGenerated);
     connect(preview, &NormalMapObject::updatePreview, this, &NormalMapNode::updatePreview);
     connect(this, &Node::changeResolution, preview, &NormalMapObject::setResolution);
     connect(this, &Node::changeBPC, preview, &NormalMapObject::setBPC);
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/NormalMapProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    connect(propertiesPanel, SIGNAL(strenghtChanged(qreal)), this, SLOT(updateStrenght(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
-    propertiesPanel->setProperty("startStrenght", m_strenght/10.0f);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
 }
 
 NormalMapNode::~NormalMapNode() {
     delete preview;
 }
 
+void NormalMapNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/NormalMapProperty.qml"));
+    propertiesPanel->setProperty("startStrenght", m_strenght/10.0f);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(strenghtChanged(qreal)), this, SLOT(updateStrenght(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void NormalMapNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
     preview->setGrayscaleTexture(m_socketsInput[0]->value().toUInt());
     preview->selectedItem = selected();
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
-    deserializing = false;
 }
 
 unsigned int &NormalMapNode::getPreviewTexture() {
@@ -80,7 +73,7 @@ float NormalMapNode::strenght() {
 }
 
 NormalMapNode *NormalMapNode::clone() {
-    return new NormalMapNode(parentItem(), m_resolution, m_bpc, m_strenght);
+    return new NormalMapNode(parentItem(), m_graphResolution, m_bpc, m_strenght);
 }
 
 void NormalMapNode::serialize(QJsonObject &json) const {
@@ -93,13 +86,12 @@ void NormalMapNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *>
     Node::deserialize(json, hash);
     if(json.contains("strength")) {
         updateStrenght(json["strength"].toVariant().toFloat());
-        propertiesPanel->setProperty("startStrenght", m_strenght/10.0f);
+        setPropertyOnPanel("startStrenght", m_strenght/10.0f);
     }
 
     preview->setStrenght(m_strenght);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -44,6 +44,8 @@ public slots:
     void previewGenerated();
 signals:
     void strenghtChanged(float strenght);
+protected:
+    void createPropertiesPanel();
 private:
     NormalMapObject *preview;
     float m_strenght = 6.0f;
@@ -40,6 +40,8 @@ public slots:
     void saveNormal(QString dir);
 signals:
     void normalChanged(unsigned int normalMap);
+protected:
+    void createPropertiesPanel();
 private:
     NormalObject *preview;
 };
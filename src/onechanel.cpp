@@ -20,9 +20,13 @@
  */
 
 #include "onechanel.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 OneChanelObject::OneChanelObject(QQuickItem *parent, QVector2D resolution, GLint bpc): QQuickFramebufferObject (parent),
     m_resolution(resolution), m_bpc(bpc)
@@ -81,10 +85,7 @@ void OneChanelObject::setBPC(GLint bpc) {
 OneChanelRenderer::OneChanelRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
 
-    renderChanel = new QOpenGLShaderProgram();
-    renderChanel->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderChanel->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/onechanel.frag");
-    renderChanel->link();
+    renderChanel = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/onechanel.frag");
 
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -104,9 +105,7 @@ OneChanelRenderer::OneChanelRenderer(QVector2D resolution, GLint bpc): m_resolut
     glBindVertexArray(0);
 
     renderChanel->bind();
-    renderChanel->setUniformValue(renderChanel->uniformLocation("useTex"), false);
     renderChanel->setUniformValue(renderChanel->uniformLocation("tex"), 0);
-    renderChanel->setUniformValue(renderChanel->uniformLocation("val"), val);
     renderChanel->release();
 
     glGenFramebuffers(1, &m_colorFBO);
@@ -125,7 +124,8 @@ OneChanelRenderer::OneChanelRenderer(QVector2D resolution, GLint bpc): m_resolut
 }
 
 OneChanelRenderer::~OneChanelRenderer() {
-    delete renderChanel;
+    Resampler::release(this);
+    ShaderCache::release(renderChanel);
     glDeleteTextures(1, &m_colorTexture);
     glDeleteFramebuffers(1, &m_colorFBO);
     glDeleteVertexArrays(1, &VAO);
@@ -139,25 +139,22 @@ QOpenGLFramebufferObject *OneChanelRenderer::createFramebufferObject(const QSize
 
 void OneChanelRenderer::synchronize(QQuickFramebufferObject *item) {
     OneChanelObject *oneChanelItem = static_cast<OneChanelObject*>(item);
-    renderChanel->bind();
-    renderChanel->setUniformValue(renderChanel->uniformLocation("useTex"), oneChanelItem->useTex);
+    m_useTex = oneChanelItem->useTex;
     m_resolution = oneChanelItem->resolution();
     m_bpc = oneChanelItem->bpc();
     if(oneChanelItem->useTex) {
-        texture = oneChanelItem->value().toUInt();
+        texture = Resampler::instance()->resample(this, 0, oneChanelItem->value().toUInt(), m_resolution);
         oneChanelItem->setSourceTexture(texture);
         oneChanelItem->updatePreview(texture);
         oneChanelItem->updateValue(texture, true);
     }
     else {
         val = oneChanelItem->value().toFloat();
-        renderChanel->setUniformValue(renderChanel->uniformLocation("val"), val);
         createColor();
         oneChanelItem->setColorTexture(m_colorTexture);
         oneChanelItem->updatePreview(m_colorTexture);
         oneChanelItem->updateValue(val, false);
     }
-    renderChanel->release();
 
     if(oneChanelItem->texSaving) {
         oneChanelItem->texSaving = false;
@@ -173,6 +170,8 @@ void OneChanelRenderer::render() {
     glClear(GL_COLOR_BUFFER_BIT);
 
     renderChanel->bind();
+    renderChanel->setUniformValue(renderChanel->uniformLocation("useTex"), m_useTex);
+    renderChanel->setUniformValue(renderChanel->uniformLocation("val"), val);
     glBindVertexArray(VAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, texture);
@@ -190,6 +189,8 @@ void OneChanelRenderer::createColor() {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderChanel->bind();
+    renderChanel->setUniformValue(renderChanel->uniformLocation("useTex"), m_useTex);
+    renderChanel->setUniformValue(renderChanel->uniformLocation("val"), val);
     glBindVertexArray(VAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
@@ -207,12 +208,7 @@ void OneChanelRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, m_resolution.x(), m_resolution.y(), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::rgbFormat(TextureFormat::exportFormat(m_bpc)), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -226,6 +222,8 @@ void OneChanelRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderChanel->bind();
+    renderChanel->setUniformValue(renderChanel->uniformLocation("useTex"), m_useTex);
+    renderChanel->setUniformValue(renderChanel->uniformLocation("val"), val);
     renderChanel->setUniformValue(renderChanel->uniformLocation("albedoVal"), val);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, texture);
@@ -236,40 +234,7 @@ void OneChanelRenderer::saveTexture(QString fileName) {
     renderChanel->release();
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGB16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGB16 *bits = (FIRGB16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*3 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*3 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(3*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGR, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 3 * m_resolution.x(), 24, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc, 3);
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
@@ -70,6 +70,7 @@ private:
     void saveTexture(QString fileName);
     QOpenGLShaderProgram *renderChanel;
     float val = 0.0f;
+    bool m_useTex = false;
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
     unsigned int m_colorFBO = 0;
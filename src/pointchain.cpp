@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pointchain.h"
+#include "shadercache.h"
+#include "ramplut.h"
+
+PointChain::PointChain() {
+}
+
+PointChain::~PointChain() {
+    for(auto program: m_programs) {
+        ShaderCache::release(program);
+    }
+    if(!textureVAO) return;
+    for(auto ramp: m_ramps) {
+        RampLut::instance()->release(ramp);
+    }
+    glDeleteVertexArrays(1, &textureVAO);
+}
+
+int PointChain::maxStages() {
+    //every stage may bind a mask and a ramp texture, the source takes one more of 16 units
+    return 7;
+}
+
+void PointChain::render(const QList<PointStage> &stages, unsigned int source, unsigned int targetFBO, QVector2D resolution) {
+    if(!textureVAO) {
+        initializeOpenGLFunctions();
+        float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
+                        -1.0f, 1.0f, 0.0f, 1.0f,
+                        1.0f, -1.0f, 1.0f, 0.0f,
+                        1.0f, 1.0f, 1.0f, 1.0f};
+        unsigned int VBO;
+        glGenVertexArrays(1, &textureVAO);
+        glBindVertexArray(textureVAO);
+        glGenBuffers(1, &VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertQuadTex), vertQuadTex, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), nullptr);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+    QString fragment = fragmentSource(stages);
+    QOpenGLShaderProgram *program = m_programs.value(fragment, nullptr);
+    if(!program) {
+        program = ShaderCache::acquireSource(":/shaders/texture.vert", fragment);
+        m_programs.insert(fragment, program);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glViewport(0, 0, resolution.x(), resolution.y());
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    program->bind();
+    program->setUniformValue(program->uniformLocation("sourceTexture"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, source);
+    int unit = 1;
+    for(int i = 0; i < stages.size(); ++i) {
+        const PointStage &stage = stages[i];
+        QByteArray index = QByteArray::number(i);
+        program->setUniformValue(program->uniformLocation("params" + index), stage.params);
+        if(stage.mask) {
+            program->setUniformValue(program->uniformLocation("maskTexture" + index), unit);
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_2D, stage.mask);
+            ++unit;
+        }
+        if(stage.type == PointStage::ColorRamp) {
+            while(m_ramps.size() <= i) m_ramps.append(0);
+            RampLut *lut = RampLut::instance();
+            unsigned int ramp = lut->acquire(stage.stops);
+            lut->release(m_ramps[i]);
+            m_ramps[i] = ramp;
+            program->setUniformValue(program->uniformLocation("rampTexture" + index), unit);
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_1D, ramp);
+            ++unit;
+        }
+    }
+    glBindVertexArray(textureVAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    for(int i = unit - 1; i >= 0; --i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindTexture(GL_TEXTURE_1D, 0);
+    }
+    program->release();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+QString PointChain::fragmentSource(const QList<PointStage> &stages) {
+    QString declarations;
+    QString body;
+    for(int i = 0; i < stages.size(); ++i) {
+        const PointStage &stage = stages[i];
+        declarations += QString("uniform vec4 params%1;\n").arg(i);
+        switch(stage.type) {
+        case PointStage::Inverse:
+            body += "    color = vec4(vec3(1.0) - color.rgb, color.a);\n";
+            break;
+        case PointStage::BrightnessContrast:
+            body += QString("    color.rgb = (color.rgb - 0.5)*(params%1.y + 1.0) + 0.5 + params%1.x;\n").arg(i);
+            break;
+        case PointStage::Threshold:
+            body += QString("    color = vec4(vec3(step(params%1.x, 0.33333*(color.r + color.g + color.b))), step(params%1.x, color.a));\n").arg(i);
+            break;
+        case PointStage::Grayscale:
+            body += "    color = vec4(vec3(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722))), color.a);\n";
+            break;
+        case PointStage::Coloring:
+            body += QString("    color.rgb *= params%1.rgb;\n").arg(i);
+            break;
+        case PointStage::ColorRamp:
+            declarations += QString("uniform sampler1D rampTexture%1;\n").arg(i);
+            body += QString("    color = vec4(rampValue(rampTexture%1, (color.r + color.g + color.b)/3.0), color.a);\n").arg(i);
+            break;
+        case PointStage::Mapping:
+            body += QString("    color.rgb = (color.rgb - vec3(params%1.x))/vec3(params%1.y - params%1.x)*vec3(params%1.w - params%1.z) + vec3(params%1.z);\n").arg(i);
+            break;
+        }
+        if(stage.mask) {
+            declarations += QString("uniform sampler2D maskTexture%1;\n").arg(i);
+            body += QString("    color *= maskValue(maskTexture%1);\n").arg(i);
+        }
+        //the separate node would store this step in its own texture, clamped unless it is a float format
+        if(stage.normalized) body += "    color = clamp(color, 0.0, 1.0);\n";
+    }
+    return QString(
+        "#version 440 core\n"
+        "uniform sampler2D sourceTexture;\n") + declarations + QString(
+        "in vec2 texCoords;\n"
+        "out vec4 FragColor;\n"
+        "\n"
+        "float maskValue(sampler2D maskTexture) {\n"
+        "    vec4 maskColor = texture(maskTexture, texCoords);\n"
+        "    return 0.33333*(maskColor.r + maskColor.g + maskColor.b);\n"
+        "}\n"
+        "\n"
+        "vec3 rampValue(sampler1D rampTexture, float x) {\n"
+        "    float width = textureSize(rampTexture, 0);\n"
+        "    return texture(rampTexture, (x*(width - 1.0) + 0.5)/width).rgb;\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec4 color = texture(sourceTexture, texCoords);\n") + body + QString(
+        "    FragColor = color;\n"
+        "}\n");
+}
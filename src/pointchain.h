@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef POINTCHAIN_H
+#define POINTCHAIN_H
+
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLShaderProgram>
+#include <QVector2D>
+#include <QHash>
+#include "pointstage.h"
+
+class PointChain: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    PointChain();
+    ~PointChain();
+    void render(const QList<PointStage> &stages, unsigned int source, unsigned int targetFBO, QVector2D resolution);
+    static int maxStages();
+private:
+    QString fragmentSource(const QList<PointStage> &stages);
+    QHash<QString, QOpenGLShaderProgram*> m_programs;
+    QVector<unsigned int> m_ramps;
+    unsigned int textureVAO = 0;
+};
+
+#endif // POINTCHAIN_H
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pointstage.h"
+
+PointStage PointStage::inverse() {
+    PointStage stage;
+    stage.type = Inverse;
+    return stage;
+}
+
+PointStage PointStage::brightnessContrast(float brightness, float contrast) {
+    PointStage stage;
+    stage.type = BrightnessContrast;
+    stage.params = QVector4D(brightness, contrast, 0.0f, 0.0f);
+    return stage;
+}
+
+PointStage PointStage::threshold(float threshold, unsigned int mask) {
+    PointStage stage;
+    stage.type = Threshold;
+    stage.params = QVector4D(threshold, 0.0f, 0.0f, 0.0f);
+    stage.mask = mask;
+    return stage;
+}
+
+PointStage PointStage::grayscale() {
+    PointStage stage;
+    stage.type = Grayscale;
+    return stage;
+}
+
+PointStage PointStage::coloring(QVector3D color) {
+    PointStage stage;
+    stage.type = Coloring;
+    stage.params = QVector4D(color, 0.0f);
+    return stage;
+}
+
+PointStage PointStage::colorRamp(const std::vector<QVector4D> &stops, unsigned int mask) {
+    PointStage stage;
+    stage.type = ColorRamp;
+    stage.stops = stops;
+    stage.mask = mask;
+    return stage;
+}
+
+PointStage PointStage::mapping(float inputMin, float inputMax, float outputMin, float outputMax, unsigned int mask) {
+    PointStage stage;
+    stage.type = Mapping;
+    stage.params = QVector4D(inputMin, inputMax, outputMin, outputMax);
+    stage.mask = mask;
+    return stage;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef POINTSTAGE_H
+#define POINTSTAGE_H
+
+#include <QVector3D>
+#include <QVector4D>
+#include <vector>
+
+//per-pixel operation of a node, chains of them are rendered with one generated shader
+struct PointStage
+{
+    enum Type {
+        Inverse,
+        BrightnessContrast,
+        Threshold,
+        Grayscale,
+        Coloring,
+        ColorRamp,
+        Mapping
+    };
+    static PointStage inverse();
+    static PointStage brightnessContrast(float brightness, float contrast);
+    static PointStage threshold(float threshold, unsigned int mask);
+    static PointStage grayscale();
+    static PointStage coloring(QVector3D color);
+    static PointStage colorRamp(const std::vector<QVector4D> &stops, unsigned int mask);
+    static PointStage mapping(float inputMin, float inputMax, float outputMin, float outputMax, unsigned int mask);
+    Type type = Inverse;
+    QVector4D params;
+    unsigned int mask = 0;
+    std::vector<QVector4D> stops;
+    bool normalized = true;
+};
+
+#endif // POINTSTAGE_H
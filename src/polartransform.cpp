@@ -1,7 +1,11 @@
 #include "polartransform.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
 #include <iostream>
+#include "textureformat.h"
+#include "resampler.h"
 
 PolarTransformObject::PolarTransformObject(QQuickItem *parent, QVector2D resolution, GLint bpc,
                                            float radius, bool clamp, int angle):
@@ -99,25 +103,15 @@ void PolarTransformObject::setBPC(GLint bpc) {
 PolarTransformRenderer::PolarTransformRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
 
-    polarShader = new QOpenGLShaderProgram();
-    polarShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    polarShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/polartransform.frag");
-    polarShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    polarShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/polartransform.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     polarShader->bind();
     polarShader->setUniformValue(polarShader->uniformLocation("sourceTexture"), 0);
     polarShader->setUniformValue(polarShader->uniformLocation("maskTexture"), 1);
     polarShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -139,16 +133,7 @@ PolarTransformRenderer::PolarTransformRenderer(QVector2D res, GLint bpc): m_reso
     glGenTextures(1, &m_polarTexture);
     glBindFramebuffer(GL_FRAMEBUFFER, polarFBO);
     glBindTexture(GL_TEXTURE_2D, m_polarTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -164,9 +149,10 @@ PolarTransformRenderer::PolarTransformRenderer(QVector2D res, GLint bpc): m_reso
 }
 
 PolarTransformRenderer::~PolarTransformRenderer() {
-    delete polarShader;
-    delete textureShader;
-    delete checkerShader;
+    Resampler::release(this);
+    ShaderCache::release(polarShader);
+    ShaderCache::release(textureShader);
+    ShaderCache::release(checkerShader);
     glDeleteTextures(1, &m_polarTexture);
     glDeleteFramebuffers(1, &polarFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -189,14 +175,12 @@ void PolarTransformRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(polarItem->polaredTex) {
             polarItem->polaredTex = false;
-            m_sourceTexture = polarItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, polarItem->sourceTexture(), polarItem->resolution());
             if(m_sourceTexture) {
-                m_maskTexture = polarItem->maskTexture();
-                polarShader->bind();
-                polarShader->setUniformValue(polarShader->uniformLocation("radius"), polarItem->radius());
-                polarShader->setUniformValue(polarShader->uniformLocation("useClamp"), polarItem->clamp());
-                polarShader->setUniformValue(polarShader->uniformLocation("angle"), polarItem->angle());
-                polarShader->setUniformValue(polarShader->uniformLocation("useMask"), m_maskTexture);
+                m_maskTexture = Resampler::instance()->resample(this, 1, polarItem->maskTexture(), polarItem->resolution());
+                m_radius = polarItem->radius();
+                m_useClamp = polarItem->clamp();
+                m_angle = polarItem->angle();
             }
         }
         if(m_sourceTexture) {
@@ -232,6 +216,7 @@ void PolarTransformRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_polarTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -251,6 +236,10 @@ void PolarTransformRenderer::transformToPolar() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     polarShader->bind();
+    polarShader->setUniformValue(polarShader->uniformLocation("radius"), m_radius);
+    polarShader->setUniformValue(polarShader->uniformLocation("useClamp"), m_useClamp);
+    polarShader->setUniformValue(polarShader->uniformLocation("angle"), m_angle);
+    polarShader->setUniformValue(polarShader->uniformLocation("useMask"), m_maskTexture);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glActiveTexture(GL_TEXTURE1);
@@ -269,16 +258,7 @@ void PolarTransformRenderer::transformToPolar() {
 
 void PolarTransformRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_polarTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -289,12 +269,7 @@ void PolarTransformRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &texture);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, texture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -309,6 +284,7 @@ void PolarTransformRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_polarTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -316,41 +292,7 @@ void PolarTransformRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &fbo);
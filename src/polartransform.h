@@ -65,6 +65,9 @@ private:
     unsigned int m_sourceTexture = 0;
     unsigned int m_maskTexture = 0;
     unsigned int textureVAO = 0;
+    float m_radius = 0.0f;
+    bool m_useClamp = false;
+    int m_angle = 0;
     QOpenGLShaderProgram *polarShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
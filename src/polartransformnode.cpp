@@ -1,4 +1,5 @@
 #include "polartransformnode.h"
+#include "textureformat.h"
 
 PolarTransformNode::PolarTransformNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float radius,
                                        bool clamp, int angle): Node (parent, resolution, bpc),
@@ -9,25 +10,27 @@ PolarTransformNode::PolarTransformNode(QQuickItem *parent, QVector2D resolution,
     m_socketsInput[0]->setTip("Texture");
     m_socketsInput[1]->setTip("Mask");
     preview = new PolarTransformObject(grNode, m_resolution, m_bpc, m_radius, m_clamp, m_angle);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &PolarTransformObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &PolarTransformObject::textureChanged, this, &PolarTransformNode::setOutput);
     connect(this, &Node::changeResolution, preview, &PolarTransformObject::setResolution);
     connect(this, &Node::changeBPC, preview, &PolarTransformObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/PolarTransformProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+PolarTransformNode::~PolarTransformNode() {
+    delete preview;
+}
+
+void PolarTransformNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/PolarTransformProperty.qml"));
     propertiesPanel->setProperty("startRadius", m_radius);
     propertiesPanel->setProperty("startClamp", m_clamp);
     propertiesPanel->setProperty("startRotation", m_angle);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(radiusChanged(qreal)), this, SLOT(updateRadius(qreal)));
     connect(propertiesPanel, SIGNAL(clampChanged(bool)), this, SLOT(updateClamp(bool)));
     connect(propertiesPanel, SIGNAL(angleChanged(int)), this, SLOT(updateAngle(int)));
@@ -35,27 +38,12 @@ PolarTransformNode::PolarTransformNode(QQuickItem *parent, QVector2D resolution,
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-PolarTransformNode::~PolarTransformNode() {
-    delete preview;
-}
-
 void PolarTransformNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->polaredTex = true;
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &PolarTransformNode::getPreviewTexture() {
@@ -67,7 +55,7 @@ void PolarTransformNode::saveTexture(QString fileName) {
 }
 
 PolarTransformNode *PolarTransformNode::clone() {
-    return new PolarTransformNode(parentItem(), m_resolution, m_bpc, m_radius, m_clamp, m_angle);
+    return new PolarTransformNode(parentItem(), m_graphResolution, m_bpc, m_radius, m_clamp, m_angle);
 }
 
 void PolarTransformNode::serialize(QJsonObject &json) const {
@@ -89,16 +77,15 @@ void PolarTransformNode::deserialize(const QJsonObject &json, QHash<QUuid, Socke
     if(json.contains("angle")) {
         m_angle = json["angle"].toInt();
     }
-    propertiesPanel->setProperty("startRadius", m_radius);
-    propertiesPanel->setProperty("startClamp", m_clamp);
-    propertiesPanel->setProperty("startRotation", m_angle);
+    setPropertyOnPanel("startRadius", m_radius);
+    setPropertyOnPanel("startClamp", m_clamp);
+    setPropertyOnPanel("startRotation", m_angle);
 
     preview->setRadius(m_radius);
     preview->setClamp(m_clamp);
     preview->setAngle(m_angle);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -31,6 +31,8 @@ public slots:
     void updateRadius(qreal radius);
     void updateClamp(bool clamp);
     void updateAngle(int angle);
+protected:
+    void createPropertiesPanel() override;
 private:
     PolarTransformObject *preview;
     float m_radius = 2.0;
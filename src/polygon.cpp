@@ -20,9 +20,13 @@
  */
 
 #include "polygon.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include "QOpenGLFramebufferObjectFormat"
 #include <iostream>
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 PolygonObject::PolygonObject(QQuickItem *parent, QVector2D resolution, GLint bpc, int sides,
                              float polygonScale, float smooth, bool useAlpha):
@@ -123,24 +127,14 @@ void PolygonObject::setBPC(GLint bpc) {
 
 PolygonRenderer::PolygonRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    generatePolygon = new QOpenGLShaderProgram();
-    generatePolygon->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    generatePolygon->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/polygon.frag");
-    generatePolygon->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    renderTexture = new QOpenGLShaderProgram();
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    renderTexture->link();
+    generatePolygon = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/polygon.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    renderTexture = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     generatePolygon->bind();
     generatePolygon->setUniformValue(generatePolygon->uniformLocation("maskTexture"), 0);
     generatePolygon->release();
     renderTexture->bind();
     renderTexture->setUniformValue(renderTexture->uniformLocation("texture"), 0);
-    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     renderTexture->release();
     float vertQuad[] = {-1.0f, -1.0f,
                     -1.0f, 1.0f,
@@ -185,12 +179,7 @@ PolygonRenderer::PolygonRenderer(QVector2D resolution, GLint bpc): m_resolution(
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, 2);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, polygonTexture, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -198,9 +187,10 @@ PolygonRenderer::PolygonRenderer(QVector2D resolution, GLint bpc): m_resolution(
 }
 
 PolygonRenderer::~PolygonRenderer() {
-    delete generatePolygon;
-    delete checkerShader;
-    delete renderTexture;
+    Resampler::release(this);
+    ShaderCache::release(generatePolygon);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(renderTexture);
     glDeleteTextures(1, &polygonTexture);
     glDeleteFramebuffers(1, &polygonFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -232,14 +222,11 @@ void PolygonRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(polygonItem->generatedPolygon) {
             polygonItem->generatedPolygon = false;
-            maskTexture = polygonItem->maskTexture();
-            generatePolygon->bind();
-            generatePolygon->setUniformValue(generatePolygon->uniformLocation("sides"), polygonItem->sides());
-            generatePolygon->setUniformValue(generatePolygon->uniformLocation("scale"), polygonItem->polygonScale());
-            generatePolygon->setUniformValue(generatePolygon->uniformLocation("smoothValue"), polygonItem->smooth());
-            generatePolygon->setUniformValue(generatePolygon->uniformLocation("useAlpha"), polygonItem->useAlpha());
-            generatePolygon->setUniformValue(generatePolygon->uniformLocation("useMask"), maskTexture);
-            generatePolygon->release();
+            maskTexture = Resampler::instance()->resample(this, 0, polygonItem->maskTexture(), polygonItem->resolution());
+            m_sides = polygonItem->sides();
+            m_scale = polygonItem->polygonScale();
+            m_smoothValue = polygonItem->smooth();
+            m_useAlpha = polygonItem->useAlpha();
         }
         createPolygon();
         polygonItem->setTexture(polygonTexture);
@@ -265,6 +252,7 @@ void PolygonRenderer::render() {
     checkerShader->release();
 
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, polygonTexture);
@@ -282,6 +270,11 @@ void PolygonRenderer::createPolygon() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(polygonVAO);
     generatePolygon->bind();
+    generatePolygon->setUniformValue(generatePolygon->uniformLocation("sides"), m_sides);
+    generatePolygon->setUniformValue(generatePolygon->uniformLocation("scale"), m_scale);
+    generatePolygon->setUniformValue(generatePolygon->uniformLocation("smoothValue"), m_smoothValue);
+    generatePolygon->setUniformValue(generatePolygon->uniformLocation("useAlpha"), m_useAlpha);
+    generatePolygon->setUniformValue(generatePolygon->uniformLocation("useMask"), maskTexture);
     generatePolygon->setUniformValue(generatePolygon->uniformLocation("res"), m_resolution);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, maskTexture);
@@ -298,12 +291,7 @@ void PolygonRenderer::createPolygon() {
 
 void PolygonRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, polygonTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -314,12 +302,7 @@ void PolygonRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -331,6 +314,7 @@ void PolygonRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, polygonTexture);
@@ -339,41 +323,7 @@ void PolygonRenderer::saveTexture(QString fileName) {
     glBindVertexArray(0);
     renderTexture->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
     glDeleteFramebuffers(1, &fbo);
@@ -80,6 +80,10 @@ private:
     void createPolygon();
     void updateTexResolution();
     void saveTexture(QString fileName);
+    int m_sides = 0;
+    float m_scale = 0.0f;
+    float m_smoothValue = 0.0f;
+    bool m_useAlpha = false;
     QOpenGLShaderProgram *generatePolygon;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *renderTexture;
@@ -21,19 +21,18 @@
 
 #include "polygonnode.h"
 #include <iostream>
+#include "textureformat.h"
 
 PolygonNode::PolygonNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int sides, float polygonScale,
                          float smooth, bool useAlpha): Node(parent, resolution, bpc), m_sides(sides),
     m_polygonScale(polygonScale), m_smooth(smooth), m_useAlpha(useAlpha)
 {
     preview = new PolygonObject(grNode, m_resolution, m_bpc, m_sides, m_polygonScale, m_smooth, m_useAlpha);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &PolygonNode::generatePreview, this, &PolygonNode::previewGenerated);
     connect(preview, &PolygonObject::changedTexture, this, &PolygonNode::setOutput);
     connect(preview, &PolygonObject::updatePreview, this, &PolygonNode::updatePreview);
@@ -42,16 +41,20 @@ PolygonNode::PolygonNode(QQuickItem *parent, QVector2D resolution, GLint bpc, in
     createSockets(1, 1);
     m_socketsInput[0]->setTip("Mask");
     setTitle("Polygon");
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/PolygonProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+PolygonNode::~PolygonNode() {
+    delete preview;
+}
+
+void PolygonNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/PolygonProperty.qml"));
     propertiesPanel->setProperty("startSides", m_sides);
     propertiesPanel->setProperty("startScale", m_polygonScale);
     propertiesPanel->setProperty("startSmooth", m_smooth);
     propertiesPanel->setProperty("startUseAlpha", m_useAlpha);
     propertiesPanel->setProperty("startBits", m_useAlpha);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(sidesChanged(int)), this, SLOT(updateSides(int)));
     connect(propertiesPanel, SIGNAL(polygonScaleChanged(qreal)), this, SLOT(updatePolygonScale(qreal)));
     connect(propertiesPanel, SIGNAL(polygonSmoothChanged(qreal)), this, SLOT(updateSmooth(qreal)));
@@ -60,21 +63,12 @@ PolygonNode::PolygonNode(QQuickItem *parent, QVector2D resolution, GLint bpc, in
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-PolygonNode::~PolygonNode() {
-    delete preview;
-}
-
 void PolygonNode::operation() {
     preview->selectedItem = selected();
 
     if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && (inputNode->resolution() == m_resolution)) {
-            preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
-        }        
+        preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
     }
-    deserializing = false;
 }
 
 unsigned int &PolygonNode::getPreviewTexture() {
@@ -86,7 +80,7 @@ void PolygonNode::saveTexture(QString fileName) {
 }
 
 PolygonNode *PolygonNode::clone() {
-    return new PolygonNode(parentItem(), m_resolution, m_bpc, m_sides, m_polygonScale, m_smooth, m_useAlpha);
+    return new PolygonNode(parentItem(), m_graphResolution, m_bpc, m_sides, m_polygonScale, m_smooth, m_useAlpha);
 }
 
 void PolygonNode::serialize(QJsonObject &json) const {
@@ -112,12 +106,11 @@ void PolygonNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &h
     if(json.contains("useAlpha")) {
         m_useAlpha = json["useAlpha"].toBool();
     }
-    propertiesPanel->setProperty("startSides", m_sides);
-    propertiesPanel->setProperty("startScale", m_polygonScale);
-    propertiesPanel->setProperty("startSmooth", m_smooth);
-    propertiesPanel->setProperty("startUseAlpha", m_useAlpha);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startSides", m_sides);
+    setPropertyOnPanel("startScale", m_polygonScale);
+    setPropertyOnPanel("startSmooth", m_smooth);
+    setPropertyOnPanel("startUseAlpha", m_useAlpha);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->setSides(m_sides);
     preview->setPolygonScale(m_polygonScale);
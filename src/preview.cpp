@@ -20,6 +20,7 @@
  */
 
 #include "preview.h"
+#include "shadercache.h"
 #include <iostream>
 #include <QOpenGLFramebufferObjectFormat>
 
@@ -164,14 +165,8 @@ unsigned int &PreviewObject::previewData() {
 
 PreviewRenderer::PreviewRenderer() {
     initializeOpenGLFunctions();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texmatrix.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
+    textureShader = ShaderCache::acquire(":/shaders/texmatrix.vert", ":/shaders/texture.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
     textureShader->release();
@@ -259,8 +254,8 @@ PreviewRenderer::PreviewRenderer() {
 }
 
 PreviewRenderer::~PreviewRenderer() {
-    delete textureShader;
-    delete checkerShader;
+    ShaderCache::release(textureShader);
+    ShaderCache::release(checkerShader);
     glDeleteTextures(1, &checkerTexture);
     glDeleteVertexArrays(1, &VAO);
     glDeleteVertexArrays(1, &checkerVAO);
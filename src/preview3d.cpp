@@ -20,6 +20,7 @@
  */
 
 #include "preview3d.h"
+#include "shadercache.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include <iostream>
 #include <QDir>
@@ -349,55 +350,23 @@ void Preview3DObject::sizeUpdated(bool resize) {
 Preview3DRenderer::Preview3DRenderer() {
     initializeOpenGLFunctions();
 
-    pbrShader = new QOpenGLShaderProgram();
-    pbrShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/pbr.vert");
-    pbrShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/pbr.frag");
-    pbrShader->link();
-
-    equirectangularShader = new QOpenGLShaderProgram();
-    equirectangularShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/cubemap.vert");
-    equirectangularShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/equirectangular.frag");
-    equirectangularShader->link();
-
-    irradianceShader = new QOpenGLShaderProgram();
-    irradianceShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/cubemap.vert");
-    irradianceShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/irradiance.frag");
-    irradianceShader->link();
-
-    prefilteredShader = new QOpenGLShaderProgram();
-    prefilteredShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/cubemap.vert");
-    prefilteredShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/prefiltered.frag");
-    prefilteredShader->link();
-
-    brdfShader = new QOpenGLShaderProgram();
-    brdfShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/brdf.vert");
-    brdfShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/brdf.frag");
-    brdfShader->link();
-
-    backgroundShader = new QOpenGLShaderProgram();
-    backgroundShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/background.vert");
-    backgroundShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/background.frag");
-    backgroundShader->link();
-
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/brdf.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
-
-    blurShader = new QOpenGLShaderProgram();
-    blurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    blurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/brightblur.frag");
-    blurShader->link();
-
-    bloomShader = new QOpenGLShaderProgram();
-    bloomShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    bloomShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/applybloom.frag");
-    bloomShader->link();
-
-    brightShader = new QOpenGLShaderProgram();
-    brightShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    brightShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/brightforbloom.frag");
-    brightShader->link();
+    pbrShader = ShaderCache::acquire(":/shaders/pbr.vert", ":/shaders/pbr.frag");
+
+    equirectangularShader = ShaderCache::acquire(":/shaders/cubemap.vert", ":/shaders/equirectangular.frag");
+
+    irradianceShader = ShaderCache::acquire(":/shaders/cubemap.vert", ":/shaders/irradiance.frag");
+
+    prefilteredShader = ShaderCache::acquire(":/shaders/cubemap.vert", ":/shaders/prefiltered.frag");
+
+    brdfShader = ShaderCache::acquire(":/shaders/brdf.vert", ":/shaders/brdf.frag");
+
+    backgroundShader = ShaderCache::acquire(":/shaders/background.vert", ":/shaders/background.frag");
+
+    textureShader = ShaderCache::acquire(":/shaders/brdf.vert", ":/shaders/texture.frag");
+
+    bloomShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/applybloom.frag");
+
+    brightShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/brightforbloom.frag");
 
     pbrShader->bind();
     pbrShader->setUniformValue(pbrShader->uniformLocation("irradianceMap"), 0);
@@ -409,11 +378,6 @@ Preview3DRenderer::Preview3DRenderer() {
     pbrShader->setUniformValue(pbrShader->uniformLocation("roughnessMap"), 6);
     pbrShader->setUniformValue(pbrShader->uniformLocation("heightMap"), 7);
     pbrShader->setUniformValue(pbrShader->uniformLocation("emissionMap"), 8);
-    pbrShader->setUniformValue(pbrShader->uniformLocation("albedoVal"), QVector3D(1.0f, 1.0f, 1.0f));
-    pbrShader->setUniformValue(pbrShader->uniformLocation("metallicVal"), 0.0f);
-    pbrShader->setUniformValue(pbrShader->uniformLocation("roughnessVal"), 0.2f);
-    pbrShader->setUniformValue(pbrShader->uniformLocation("cameraPos"), positionV);
-    pbrShader->setUniformValue(pbrShader->uniformLocation("res"), m_texResolution.x());
     pbrShader->release();
 
     backgroundShader->bind();
@@ -424,9 +388,6 @@ Preview3DRenderer::Preview3DRenderer() {
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
     textureShader->release();
 
-    blurShader->bind();
-    blurShader->setUniformValue(blurShader->uniformLocation("image"), 0);
-    blurShader->release();
 
     bloomShader->bind();
     bloomShader->setUniformValue(bloomShader->uniformLocation("scene"), 0);
@@ -656,18 +617,15 @@ Preview3DRenderer::Preview3DRenderer() {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
     //FBO for blur
-    glGenFramebuffers(2, pingpongFBO);
-    glGenTextures(2, pingpongBuffer);
-    for (unsigned int i = 0; i < 2; i++)
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[i]);
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[i]);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pingpongBuffer[i], 0);
-    }
+    glGenFramebuffers(1, &bloomFBO);
+    glGenTextures(1, &bloomTexture);
+    glBindFramebuffer(GL_FRAMEBUFFER, bloomFBO);
+    glBindTexture(GL_TEXTURE_2D, bloomTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, bloomTexture, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
@@ -729,23 +687,22 @@ Preview3DRenderer::Preview3DRenderer() {
 }
 
 Preview3DRenderer::~Preview3DRenderer() {
-    delete pbrShader;
-    delete irradianceShader;
-    delete backgroundShader;
-    delete equirectangularShader;
-    delete prefilteredShader;
-    delete textureShader;
-    delete brdfShader;
-    delete blurShader;
-    delete bloomShader;
-    delete brightShader;
+    ShaderCache::release(pbrShader);
+    ShaderCache::release(irradianceShader);
+    ShaderCache::release(backgroundShader);
+    ShaderCache::release(equirectangularShader);
+    ShaderCache::release(prefilteredShader);
+    ShaderCache::release(textureShader);
+    ShaderCache::release(brdfShader);
+    ShaderCache::release(bloomShader);
+    ShaderCache::release(brightShader);
     glDeleteTextures(1, &hdrTexture);
     glDeleteTextures(1, &envCubemap);
     glDeleteTextures(1, &irradianceMap);
     glDeleteTextures(1, &prefilterMap);
     glDeleteTextures(1, &brdfLUTTexture);
     glDeleteTextures(1, &brightTexture);
-    glDeleteTextures(2, &pingpongBuffer[0]);
+    glDeleteTextures(1, &bloomTexture);
     glDeleteTextures(1, &screenTexture);
     glDeleteTextures(1, &multisampleTexture);
     glDeleteTextures(1, &combinedTexture);
@@ -761,7 +718,7 @@ Preview3DRenderer::~Preview3DRenderer() {
     glDeleteVertexArrays(1, &quadVAO);
     glDeleteVertexArrays(1, &planeVAO);
     glDeleteFramebuffers(1, &hdrFBO);
-    glDeleteFramebuffers(2, &pingpongFBO[0]);
+    glDeleteFramebuffers(1, &bloomFBO);
     glDeleteFramebuffers(1, &screenFBO);
     glDeleteFramebuffers(1, &multisampleFBO);
     glDeleteFramebuffers(1, &combinedFBO);
@@ -788,6 +745,8 @@ void Preview3DRenderer::synchronize(QQuickFramebufferObject *item) {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, wWidth, wHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
         glBindTexture(GL_TEXTURE_2D, screenTexture);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, wWidth, wHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+        glBindTexture(GL_TEXTURE_2D, bloomTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, wWidth, wHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
         glBindTexture(GL_TEXTURE_2D, 0);
         glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisampleTexture);
         glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, 8, GL_RGBA16F, wWidth, wHeight, GL_TRUE);
@@ -805,13 +764,11 @@ void Preview3DRenderer::synchronize(QQuickFramebufferObject *item) {
         zoom = previewItem->zoomCam();
         rotQuat = previewItem->rotQuat();
         updateMatrix();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("cameraPos"), positionV);
     }
     if(previewItem->translationView) {
         previewItem->translationView = false;
         positionV = previewItem->posCam();
         updateMatrix();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("cameraPos"), positionV);
     }
     if(previewItem->zoomView) {
         previewItem->zoomView = false;
@@ -823,128 +780,77 @@ void Preview3DRenderer::synchronize(QQuickFramebufferObject *item) {
         rotQuat = previewItem->rotQuat();
         updateMatrix();
     }
-    pbrShader->bind();
     if(previewItem->updateRes) {
         previewItem->updateRes = false;
         m_texResolution = previewItem->texResolution();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("resolution"), m_texResolution);
     }
 
     //reduce the number of samples when transforming the view
     if(previewItem->transformView != transformating) {
         transformating = previewItem->transformView;
-        pbrShader->setUniformValue(pbrShader->uniformLocation("transformating"), transformating);
         samples = transformating ? 4 : 16;
         if(!previewItem->resized) invalidateFramebufferObject();
     }
 
-    if(tilesSize != previewItem->tilesSize()) {
-        tilesSize = previewItem->tilesSize();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("tilesSize"), tilesSize);
-    }
-    if(heightScale != previewItem->heightScale()) {
-        heightScale = previewItem->heightScale();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("heightScale"), heightScale);
-    }
-    if(emissiveStrength != previewItem->emissiveStrenght()) {
-        emissiveStrength = previewItem->emissiveStrenght();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("emissiveStrenght"), emissiveStrength);
-    }
-    if(bloom != previewItem->bloom()) {
-        bloom = previewItem->bloom();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("bloom"), bloom);
-    }
+    tilesSize = previewItem->tilesSize();
+    heightScale = previewItem->heightScale();
+    emissiveStrength = previewItem->emissiveStrenght();
+    bloom = previewItem->bloom();
 
-    if(useAlbedoTex != previewItem->useAlbedoTex) {
-        useAlbedoTex = previewItem->useAlbedoTex;
-        pbrShader->setUniformValue(pbrShader->uniformLocation("useAlbMap"), useAlbedoTex);
-    }
+    useAlbedoTex = previewItem->useAlbedoTex;
     if(previewItem->changedAlbedo) {
         previewItem->changedAlbedo = false;
         if(previewItem->useAlbedoTex) {
             updateOutputsTexture(albedoTexture, previewItem->albedo().toUInt());
-            pbrShader->bind();
         }
         else {
-            pbrShader->setUniformValue(pbrShader->uniformLocation("albedoVal"), qvariant_cast<QVector3D>(previewItem->albedo()));
+            albedoVal = qvariant_cast<QVector3D>(previewItem->albedo());
         }
     }
 
-    if(useMetalTex != previewItem->useMetalTex) {
-        useMetalTex = previewItem->useMetalTex;
-        pbrShader->setUniformValue(pbrShader->uniformLocation("useMetalMap"), useMetalTex);
-    }
+    useMetalTex = previewItem->useMetalTex;
     if(previewItem->changedMetal) {
         previewItem->changedMetal = false;
         if(previewItem->useMetalTex) {
             updateOutputsTexture(metalTexture, previewItem->metalness().toUInt());
-            pbrShader->bind();
         }
         else {
-            pbrShader->setUniformValue(pbrShader->uniformLocation("metallicVal"), previewItem->metalness().toFloat());
+            metallicVal = previewItem->metalness().toFloat();
         }
     }
 
-    if(useRoughTex != previewItem->useRoughTex) {
-        useRoughTex = previewItem->useRoughTex;
-        pbrShader->setUniformValue(pbrShader->uniformLocation("useRoughMap"), useRoughTex);
-    }
+    useRoughTex = previewItem->useRoughTex;
     if(previewItem->changedRough) {
         previewItem->changedRough = false;
         if(previewItem->useRoughTex) {
             updateOutputsTexture(roughTexture, previewItem->roughness().toUInt());
-            pbrShader->bind();
         }
         else {
-            pbrShader->setUniformValue(pbrShader->uniformLocation("roughnessVal"), previewItem->roughness().toFloat());
+            roughnessVal = previewItem->roughness().toFloat();
         }
     }
 
     if(previewItem->changedNormal) {
         previewItem->changedNormal = false;
         updateOutputsTexture(normalTexture, previewItem->normal());
-        pbrShader->bind();
-    }
-    bool useNorm = previewItem->normal() ? true : false;
-    if(useNormalTex != useNorm) {
-        useNormalTex = useNorm;
-        pbrShader->setUniformValue(pbrShader->uniformLocation("useNormMap"), useNormalTex);
     }
+    useNormalTex = previewItem->normal() ? true : false;
 
     if(previewItem->changedHeight) {
         previewItem->changedHeight = false;
         updateOutputsTexture(heightTexture, previewItem->heightMap());
-        pbrShader->bind();
-    }
-    bool useHeight = previewItem->heightMap();
-    if(useHeightTex != useHeight) {
-        useHeightTex = useHeight;
-        pbrShader->setUniformValue(pbrShader->uniformLocation("useHeightMap"), useHeightTex);
     }
+    useHeightTex = previewItem->heightMap();
 
     if(previewItem->changedEmission) {
         previewItem->changedEmission = false;
         updateOutputsTexture(emissionTexture, previewItem->emission());
-        pbrShader->bind();
     }
-    if(useEmisTex != previewItem->emission()) {
-        useEmisTex = previewItem->emission();
-        pbrShader->setUniformValue(pbrShader->uniformLocation("useEmisMap"), useEmisTex);
-    }
-
-    pbrShader->release();
-
-    bloom = previewItem->bloom();
+    useEmisTex = previewItem->emission();
 
     if(bloom) {
-        bloomShader->bind();
-        bloomShader->setUniformValue(bloomShader->uniformLocation("intensity"), previewItem->bloomIntensity());
-        bloomShader->release();
-
-        brightShader->bind();
-        brightShader->setUniformValue(brightShader->uniformLocation("threshold"), previewItem->bloomThreshold());
-        brightShader->release();
-
+        bloomIntensity = previewItem->bloomIntensity();
+        bloomThreshold = previewItem->bloomThreshold();
         bloomRadius = previewItem->bloomRadius();
         renderForBloom();
         brightnessBlur();
@@ -954,10 +860,11 @@ void Preview3DRenderer::synchronize(QQuickFramebufferObject *item) {
 void Preview3DRenderer::render() {
     if(bloom) {
         bloomShader->bind();
+        bloomShader->setUniformValue(bloomShader->uniformLocation("intensity"), bloomIntensity);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, screenTexture);
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, pingpongBuffer[1]);
+        glBindTexture(GL_TEXTURE_2D, bloomTexture);
         renderQuad();
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, 0);
@@ -1390,6 +1297,25 @@ void Preview3DRenderer::renderPlane() {
 
 void Preview3DRenderer::renderScene() {
     pbrShader->bind();
+    pbrShader->setUniformValue(pbrShader->uniformLocation("projection"), projection);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("view"), view);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("model"), model);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("cameraPos"), positionV);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("resolution"), m_texResolution);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("transformating"), transformating);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("tilesSize"), tilesSize);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("heightScale"), heightScale);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("emissiveStrenght"), emissiveStrength);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("bloom"), bloom);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("useAlbMap"), useAlbedoTex);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("albedoVal"), albedoVal);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("useMetalMap"), useMetalTex);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("metallicVal"), metallicVal);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("useRoughMap"), useRoughTex);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("roughnessVal"), roughnessVal);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("useNormMap"), useNormalTex);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("useHeightMap"), useHeightTex);
+    pbrShader->setUniformValue(pbrShader->uniformLocation("useEmisMap"), useEmisTex);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap);
@@ -1457,6 +1383,7 @@ void Preview3DRenderer::renderForBloom() {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     brightShader->bind();
+    brightShader->setUniformValue(brightShader->uniformLocation("threshold"), bloomThreshold);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, screenTexture);
     renderQuad();
@@ -1467,45 +1394,9 @@ void Preview3DRenderer::renderForBloom() {
 }
 
 void Preview3DRenderer::brightnessBlur(){
-    bool first_iteration = true;
-    QVector2D dir = QVector2D(1, 0);
-    int amount = 50;
+    //same spread as the former 50 passes of the 9-tap kernel over the 1/bloomRadius downscaled image
     glDisable(GL_DEPTH_TEST);
-    unsigned int width = wWidth*(1.0f/bloomRadius);
-    unsigned int height = wHeight*(1.0f/bloomRadius);
-    glBindTexture(GL_TEXTURE_2D, pingpongBuffer[0]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    glBindTexture(GL_TEXTURE_2D, pingpongBuffer[1]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-
-    for (unsigned int i = 0; i < amount; i++)
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[i%2]);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(
-            GL_TEXTURE_2D, first_iteration ? brightTexture : pingpongBuffer[1 - (i%2)]
-        );
-
-        glViewport(0, 0, width, height);
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        blurShader->bind();
-        blurShader->setUniformValue(blurShader->uniformLocation("direction"), dir);
-        blurShader->setUniformValue(blurShader->uniformLocation("zoom"), zoom);
-        dir = QVector2D(1, 1) - dir;
-        blurShader->setUniformValue(blurShader->uniformLocation("resolution"), QVector2D(width, height));
-        renderQuad();
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        blurShader->release();
-        glBindVertexArray(0);
-        if (first_iteration)
-            first_iteration = false;
-    }
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
+    blurEngine.gaussian(brightTexture, bloomFBO, QVector2D(wWidth, wHeight), GL_RGBA16F, QVector2D(8.45f, 8.45f)*bloomRadius, 0, GL_CLAMP_TO_EDGE);
 }
 
 void Preview3DRenderer::updateMatrix() {
@@ -1516,10 +1407,6 @@ void Preview3DRenderer::updateMatrix() {
     model = QMatrix4x4();
     model.translate(0.0f, 0.0f, 0.0f);
     model.rotate(rotQuat);
-    pbrShader->bind();
-    pbrShader->setUniformValue(pbrShader->uniformLocation("projection"), projection);
-    pbrShader->setUniformValue(pbrShader->uniformLocation("view"), view);
-    pbrShader->setUniformValue(pbrShader->uniformLocation("model"), model);
 }
 
 void Preview3DRenderer::updateTexResolution() {
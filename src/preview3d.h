@@ -28,6 +28,7 @@
 #include <QTimer>
 #include <QLabel>
 #include "FreeImage.h"
+#include "blurengine.h"
 
 class Preview3DObject: public QQuickFramebufferObject
 {
@@ -145,7 +146,6 @@ private:
     QOpenGLShaderProgram *brdfShader;
     QOpenGLShaderProgram *backgroundShader;
     QOpenGLShaderProgram *textureShader;
-    QOpenGLShaderProgram *blurShader;
     QOpenGLShaderProgram *bloomShader;
     QOpenGLShaderProgram *brightShader;
     QMatrix4x4 projection;
@@ -183,11 +183,17 @@ private:
     bool useNormalTex = false;
     bool useHeightTex = false;
     bool useEmisTex = false;
+    QVector3D albedoVal = QVector3D(1.0f, 1.0f, 1.0f);
+    float metallicVal = 0.0f;
+    float roughnessVal = 0.2f;
+    float bloomIntensity = 1.0f;
+    float bloomThreshold = 1.0f;
     unsigned int hdrFBO = 0;
     unsigned int rboDepth = 0;
     unsigned int brightTexture = 0;
-    unsigned int pingpongFBO[2];
-    unsigned int pingpongBuffer[2];
+    unsigned int bloomFBO = 0;
+    unsigned int bloomTexture = 0;
+    BlurEngine blurEngine;
     unsigned int screenFBO = 0;
     unsigned int screenTexture = 0;
     unsigned int multisampleFBO = 0;
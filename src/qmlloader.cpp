@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qmlloader.h"
+#include <QDebug>
+
+bool QmlLoader::m_headless = false;
+QQmlEngine *QmlLoader::m_engine = nullptr;
+QHash<QString, QQmlComponent*> QmlLoader::m_components;
+
+QQuickItem *QmlLoader::create(const QString &source) {
+    if(m_headless) return new QQuickItem();
+    QQmlComponent *qmlComponent = component(source);
+    QQuickItem *item = qobject_cast<QQuickItem*>(qmlComponent->create());
+    if(!item) {
+        qWarning() << qmlComponent->errors();
+        return new QQuickItem();
+    }
+    QQmlEngine::setObjectOwnership(item, QQmlEngine::CppOwnership);
+    return item;
+}
+
+QQmlEngine *QmlLoader::engine() {
+    if(!m_engine) setEngine(new QQmlEngine());
+    return m_engine;
+}
+
+void QmlLoader::setEngine(QQmlEngine *engine) {
+    m_components.clear();
+    m_engine = engine;
+    //components are children of the engine and go away with it
+    QObject::connect(m_engine, &QObject::destroyed, [engine]() {
+        if(m_engine != engine) return;
+        m_engine = nullptr;
+        m_components.clear();
+    });
+}
+
+QQmlComponent *QmlLoader::component(const QString &source) {
+    QQmlComponent *qmlComponent = m_components.value(source, nullptr);
+    if(!qmlComponent) {
+        qmlComponent = new QQmlComponent(engine(), QUrl(source), engine());
+        m_components.insert(source, qmlComponent);
+    }
+    return qmlComponent;
+}
+
+bool QmlLoader::headless() {
+    return m_headless;
+}
+
+void QmlLoader::setHeadless(bool headless) {
+    m_headless = headless;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QMLLOADER_H
+#define QMLLOADER_H
+#include <QQuickItem>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QHash>
+
+class QmlLoader
+{
+public:
+    static QQuickItem *create(const QString &source);
+    static QQmlEngine *engine();
+    static void setEngine(QQmlEngine *engine);
+    static bool headless();
+    static void setHeadless(bool headless);
+private:
+    static QQmlComponent *component(const QString &source);
+    static bool m_headless;
+    static QQmlEngine *m_engine;
+    static QHash<QString, QQmlComponent*> m_components;
+};
+
+#endif // QMLLOADER_H
@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ramplut.h"
+#include <QVector3D>
+#include <algorithm>
+
+QHash<QOpenGLContext*, RampLut*> RampLut::m_luts;
+QMutex RampLut::m_mutex;
+
+RampLut::RampLut() {
+    initializeOpenGLFunctions();
+}
+
+RampLut::~RampLut() {
+    for(auto entry: m_entries) {
+        glDeleteTextures(1, &entry.texture);
+    }
+}
+
+RampLut *RampLut::instance() {
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if(!context) return nullptr;
+    QMutexLocker locker(&m_mutex);
+    RampLut *lut = m_luts.value(context, nullptr);
+    if(!lut) {
+        lut = new RampLut();
+        m_luts.insert(context, lut);
+        QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, [context](){
+            QMutexLocker locker(&m_mutex);
+            delete m_luts.take(context);
+        });
+    }
+    return lut;
+}
+
+int RampLut::width() {
+    return 4096;
+}
+
+std::vector<QVector4D> RampLut::sortedStops(const std::vector<QVector4D> &stops) {
+    //later stops win on equal positions
+    std::vector<QVector4D> sorted = stops;
+    std::reverse(sorted.begin(), sorted.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const QVector4D &f, const QVector4D &s) {
+        return f.w() < s.w();
+    });
+    return sorted;
+}
+
+unsigned int RampLut::acquire(const std::vector<QVector4D> &stops) {
+    std::vector<QVector4D> sorted = sortedStops(stops);
+    QByteArray key(reinterpret_cast<const char*>(sorted.data()), int(sorted.size()*sizeof(QVector4D)));
+    Entry &entry = m_entries[key];
+    if(entry.texture == 0) {
+        glGenTextures(1, &entry.texture);
+        bake(entry.texture, sorted);
+    }
+    ++entry.references;
+    return entry.texture;
+}
+
+void RampLut::release(unsigned int texture) {
+    if(texture == 0) return;
+    for(auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if(it->texture != texture) continue;
+        if(--it->references == 0) {
+            glDeleteTextures(1, &it->texture);
+            m_entries.erase(it);
+        }
+        return;
+    }
+}
+
+void RampLut::bake(unsigned int texture, const std::vector<QVector4D> &stops) {
+    int count = int(stops.size());
+    std::vector<QVector4D> texels(width(), QVector4D(1.0f, 1.0f, 1.0f, 1.0f));
+    for(int i = 0; i < width() && count > 0; ++i) {
+        float x = float(i)/(width() - 1);
+        QVector3D color = stops[0].toVector3D();
+        for(int j = 1; j < count; ++j) {
+            if(x > stops[j - 1].w() && x <= stops[j].w()) {
+                float f = (x - stops[j - 1].w())/(stops[j].w() - stops[j - 1].w());
+                color = stops[j - 1].toVector3D()*(1.0f - f) + stops[j].toVector3D()*f;
+                break;
+            }
+        }
+        if(x > stops[count - 1].w()) color = stops[count - 1].toVector3D();
+        texels[i] = QVector4D(color, 1.0f);
+    }
+    glBindTexture(GL_TEXTURE_1D, texture);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA32F, width(), 0, GL_RGBA, GL_FLOAT, texels.data());
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RAMPLUT_H
+#define RAMPLUT_H
+
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLContext>
+#include <QVector4D>
+#include <QHash>
+#include <QMutex>
+#include <vector>
+
+class RampLut: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    static RampLut *instance();
+    //baked 1D texture of the ramp, shared by every user of equal stops
+    unsigned int acquire(const std::vector<QVector4D> &stops);
+    void release(unsigned int texture);
+    static int width();
+    static std::vector<QVector4D> sortedStops(const std::vector<QVector4D> &stops);
+private:
+    struct Entry {
+        unsigned int texture = 0;
+        int references = 0;
+    };
+    RampLut();
+    ~RampLut();
+    void bake(unsigned int texture, const std::vector<QVector4D> &stops);
+    QHash<QByteArray, Entry> m_entries;
+    static QHash<QOpenGLContext*, RampLut*> m_luts;
+    static QMutex m_mutex;
+};
+
+#endif // RAMPLUT_H
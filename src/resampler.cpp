@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "resampler.h"
+#include "shadercache.h"
+
+QHash<QOpenGLContext*, Resampler*> Resampler::m_resamplers;
+QMutex Resampler::m_mutex;
+
+Resampler::Resampler() {
+    initializeOpenGLFunctions();
+    resampleShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/resample.frag");
+    resampleShader->bind();
+    resampleShader->setUniformValue(resampleShader->uniformLocation("sourceTexture"), 0);
+    resampleShader->release();
+    float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
+                    -1.0f, 1.0f, 0.0f, 1.0f,
+                    1.0f, -1.0f, 1.0f, 0.0f,
+                    1.0f, 1.0f, 1.0f, 1.0f};
+    unsigned int VBO;
+    glGenVertexArrays(1, &textureVAO);
+    glBindVertexArray(textureVAO);
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertQuadTex), vertQuadTex, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), nullptr);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    //sources keep their own nearest filtering for every other user
+    glGenSamplers(1, &sampler);
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+Resampler::~Resampler() {
+    TexturePool *pool = TexturePool::instance();
+    for(auto &target: m_targets) {
+        if(pool) pool->release(target);
+    }
+    ShaderCache::release(resampleShader);
+    glDeleteSamplers(1, &sampler);
+    glDeleteVertexArrays(1, &textureVAO);
+}
+
+Resampler *Resampler::instance() {
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if(!context) return nullptr;
+    QMutexLocker locker(&m_mutex);
+    Resampler *resampler = m_resamplers.value(context, nullptr);
+    if(!resampler) {
+        resampler = new Resampler();
+        m_resamplers.insert(context, resampler);
+        QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, [context](){
+            QMutexLocker locker(&m_mutex);
+            delete m_resamplers.take(context);
+        });
+    }
+    return resampler;
+}
+
+unsigned int Resampler::resample(const void *owner, int slot, unsigned int texture, QVector2D resolution) {
+    QPair<const void*, int> key(owner, slot);
+    TexturePool *pool = TexturePool::instance();
+    int width = resolution.x();
+    int height = resolution.y();
+    GLint sourceWidth = 0;
+    GLint sourceHeight = 0;
+    GLint format = 0;
+    if(texture) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &sourceWidth);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &sourceHeight);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if(!texture || (sourceWidth == width && sourceHeight == height) || sourceWidth == 0 || sourceHeight == 0) {
+        if(m_targets.contains(key)) pool->release(m_targets[key]);
+        m_targets.remove(key);
+        return texture;
+    }
+    TexturePool::Target &target = m_targets[key];
+    if(target.width != width || target.height != height || target.format != GLenum(format)) {
+        pool->release(target);
+        target = pool->acquire(width, height, format, GL_LINEAR);
+    }
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+    glViewport(0, 0, width, height);
+    glDisable(GL_BLEND);
+    glBindVertexArray(textureVAO);
+    resampleShader->bind();
+    resampleShader->setUniformValue(resampleShader->uniformLocation("ratio"), QVector2D(float(sourceWidth)/width, float(sourceHeight)/height));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindSampler(0, sampler);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindSampler(0, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    resampleShader->release();
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    return target.texture;
+}
+
+void Resampler::release(const void *owner) {
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if(!context) return;
+    QMutexLocker locker(&m_mutex);
+    Resampler *resampler = m_resamplers.value(context, nullptr);
+    if(!resampler) return;
+    locker.unlock();
+    TexturePool *pool = TexturePool::instance();
+    auto &targets = resampler->m_targets;
+    for(auto it = targets.begin(); it != targets.end();) {
+        if(it.key().first != owner) {
+            ++it;
+            continue;
+        }
+        if(pool) pool->release(it.value());
+        it = targets.erase(it);
+    }
+}
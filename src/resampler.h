@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLContext>
+#include <QVector2D>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include "texturepool.h"
+
+class Resampler: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    static Resampler *instance();
+    //input texture of a renderer at the renderer resolution, resampled only across
+    //edges between nodes of different resolutions
+    unsigned int resample(const void *owner, int slot, unsigned int texture, QVector2D resolution);
+    static void release(const void *owner);
+private:
+    Resampler();
+    ~Resampler();
+    QHash<QPair<const void*, int>, TexturePool::Target> m_targets;
+    QOpenGLShaderProgram *resampleShader;
+    unsigned int textureVAO = 0;
+    unsigned int sampler = 0;
+    static QHash<QOpenGLContext*, Resampler*> m_resamplers;
+    static QMutex m_mutex;
+};
+
+#endif // RESAMPLER_H
@@ -20,6 +20,7 @@
  */
 
 #include "roughnode.h"
+#include "textureformat.h"
 
 RoughNode::RoughNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Node(parent, resolution, bpc)
 {
@@ -27,37 +28,33 @@ RoughNode::RoughNode(QQuickItem *parent, QVector2D resolution, GLint bpc): Node(
     setTitle("Roughness");
     m_socketsInput[0]->setTip("Roughness");
     preview = new OneChanelObject(grNode, m_resolution, m_bpc);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     preview->setValue(0.2f);
     connect(preview, &OneChanelObject::updatePreview, this, &RoughNode::updatePreview);
     connect(preview, &OneChanelObject::updateValue, this, &RoughNode::roughChanged);
     connect(this, &Node::changeResolution, preview, &OneChanelObject::setResolution);
     connect(this, &Node::changeBPC, preview, &OneChanelObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/RoughProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(roughChanged(qreal)), this, SLOT(updateRough(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
 RoughNode::~RoughNode() {
     delete preview;
 }
 
+void RoughNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/RoughProperty.qml"));
+    propertiesPanel->setProperty("startRough", m_rough);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(roughChanged(qreal)), this, SLOT(updateRough(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void RoughNode::operation() {
     if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
         preview->useTex = true;
         preview->setValue(m_socketsInput[0]->value().toUInt());
     }
@@ -67,7 +64,6 @@ void RoughNode::operation() {
     }
     preview->selectedItem = selected();
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &RoughNode::getPreviewTexture() {
@@ -87,10 +83,10 @@ void RoughNode::serialize(QJsonObject &json) const {
 void RoughNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) {
     Node::deserialize(json, hash);
     if(json.contains("rough")) {
-        propertiesPanel->setProperty("startRough", m_rough);
+        updateRough(json["rough"].toVariant().toReal());
+        setPropertyOnPanel("startRough", m_rough);
     }
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 }
 
 void RoughNode::updateRough(qreal rough) {
@@ -29,7 +29,7 @@ class RoughNode: public Node
 {
     Q_OBJECT
 public:
-    RoughNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA8);
+    RoughNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_R8);
     ~RoughNode();
     void operation();
     unsigned int &getPreviewTexture();
@@ -41,6 +41,8 @@ public slots:
     void saveRough(QString dir);
 signals:
     void roughChanged(QVariant rough, bool useTexture);
+protected:
+    void createPropertiesPanel();
 private:
     OneChanelObject *preview;
     float m_rough = 0.2f;
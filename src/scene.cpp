@@ -54,17 +54,29 @@
 #include "polartransformnode.h"
 #include "bricksnode.h"
 #include "hexagonsnode.h"
+#include "distancenode.h"
 #include <QtWidgets/QFileDialog>
+#include <QGuiApplication>
+#include <QSet>
 
 Scene::Scene(QQuickItem *parent, QVector2D resolution): QQuickItem (parent), m_resolution(resolution)
 {
     setFlag(ItemHasContents, true);
     setAcceptedMouseButtons(Qt::AllButtons);    
     m_background = new BackgroundObject(this);
+    //nodes, frames and edges are laid out in graph coordinates, pan and zoom only move the canvas
+    m_canvas = new QQuickItem(this);
+    m_canvas->setTransformOrigin(TopLeft);
+    connect(m_background, &BackgroundObject::panChanged, this, &Scene::updateView);
+    connect(m_background, &BackgroundObject::scaleChanged, this, &Scene::updateView);
     m_preview3d = new Preview3DObject();
     m_undoStack = new QUndoStack(this);
     m_undoStack->setUndoLimit(32);   
-    rectView = new QQuickView();
+    m_evaluator = new GraphEvaluator(this);
+    connect(this, &QQuickItem::windowChanged, m_evaluator, &GraphEvaluator::setWindow);
+    m_evaluator->setWindow(window());
+    connect(m_background, &BackgroundObject::panChanged, m_evaluator, &GraphEvaluator::viewChanged);
+    connect(m_background, &BackgroundObject::scaleChanged, m_evaluator, &GraphEvaluator::viewChanged);
     setClip(true);
     connect(this, &Scene::resolutionUpdate, m_preview3d, &Preview3DObject::setTexResolution);
 }
@@ -75,7 +87,6 @@ Scene::~Scene() {
     cutLine = nullptr;
     m_selectedItem.clear();
     if(rectSelect) delete rectSelect;
-    if(rectView) delete rectView;
     if(cutLine) delete cutLine;
     for(Node *node: m_nodes) {
         delete node;
@@ -117,10 +128,24 @@ BackgroundObject *Scene::background() const {
     return m_background;
 }
 
+QQuickItem *Scene::canvas() const {
+    return m_canvas;
+}
+
+Scene *Scene::sceneOf(const QQuickItem *item) {
+    QQuickItem *parent = item->parentItem();
+    while(parent && !qobject_cast<Scene*>(parent)) parent = parent->parentItem();
+    return qobject_cast<Scene*>(parent);
+}
+
 Preview3DObject *Scene::preview3d() const {
     return m_preview3d;
 }
 
+GraphEvaluator *Scene::evaluator() const {
+    return m_evaluator;
+}
+
 bool Scene::addSelected(QQuickItem *item) {
     if(m_selectedItem.contains(item)) return false;
     m_selectedItem.push_back(item);
@@ -203,6 +228,7 @@ void Scene::deleteNode(Node *node) {
         activeItemChanged();
     }
     m_nodes.removeOne(node);
+    m_evaluator->removeNode(node);
     if(qobject_cast<AlbedoNode*>(node)) {
         AlbedoNode * albedoNode = qobject_cast<AlbedoNode*>(node);
         disconnect(albedoNode, &AlbedoNode::albedoChanged, m_preview3d, &Preview3DObject::updateAlbedo);
@@ -246,8 +272,11 @@ void Scene::deleteNode(Node *node) {
         m_preview3d->updateEmission(0);
     }
     disconnect(node, &Node::dataChanged, this, &Scene::nodeDataChanged);
-    disconnect(m_background, &BackgroundObject::scaleChanged, node, &Node::scaleUpdate);
-    disconnect(m_background, &BackgroundObject::panChanged, node, &Node::setPan);
+    disconnect(node, &Node::changeBaseX, this, &Scene::nodeMoved);
+    disconnect(node, &Node::changeBaseY, this, &Scene::nodeMoved);
+    disconnect(node, &Node::widthChanged, this, &Scene::nodeMoved);
+    disconnect(node, &Node::heightChanged, this, &Scene::nodeMoved);
+    m_nodeIndex.remove(node);
     if(!m_modified) {
         m_modified = true;
         fileNameUpdate(m_fileName, m_modified);
@@ -257,6 +286,7 @@ void Scene::deleteNode(Node *node) {
 void Scene::addNode(Node *node) {
     if(m_nodes.contains(node)) return;
     m_nodes.append(node);
+    node->setParentItem(m_canvas);
     if(qobject_cast<AlbedoNode*>(node)) {
         AlbedoNode * albedoNode = qobject_cast<AlbedoNode*>(node);
         connect(albedoNode, &AlbedoNode::albedoChanged, m_preview3d, &Preview3DObject::updateAlbedo);
@@ -294,10 +324,11 @@ void Scene::addNode(Node *node) {
         m_emissionConnected = true;
     }
     connect(node, &Node::dataChanged, this, &Scene::nodeDataChanged);
-    connect(m_background, &BackgroundObject::scaleChanged, node, &Node::scaleUpdate);
-    connect(m_background, &BackgroundObject::panChanged, node, &Node::setPan);
-    node->scaleUpdate(m_background->viewScale());
-    node->setPan(m_background->viewPan());
+    connect(node, &Node::changeBaseX, this, &Scene::nodeMoved);
+    connect(node, &Node::changeBaseY, this, &Scene::nodeMoved);
+    connect(node, &Node::widthChanged, this, &Scene::nodeMoved);
+    connect(node, &Node::heightChanged, this, &Scene::nodeMoved);
+    m_nodeIndex.update(node, QRectF(node->baseX(), node->baseY(), node->width(), node->height()));
     if(!m_modified) {
         m_modified = true;
         fileNameUpdate(m_fileName, m_modified);
@@ -305,15 +336,23 @@ void Scene::addNode(Node *node) {
 }
 
 Node *Scene::nodeAt(float x, float y) {
-    for(Node *node: m_nodes) {
-        if(node->x() <= x && node->x() + node->width()*node->scale() >= x && node->y() <= y && node->y() + node->height()*node->scale() >= y) {
-            return node;
+    Node *result = nullptr;
+    for(QQuickItem *item: m_nodeIndex.query(QRectF(x, y, 0, 0))) {
+        Node *node = static_cast<Node*>(item);
+        if(node->x() <= x && node->x() + node->width() >= x && node->y() <= y && node->y() + node->height() >= y) {
+            if(!result || node->z() > result->z()) result = node;
         }
     }
-    return nullptr;
+    return result;
 }
 
 void Scene::nodeDataChanged() {
+    Node *node = qobject_cast<Node*>(sender());
+    if(node) {
+        //a held mouse button means a slider or a picker is being dragged
+        if(QGuiApplication::mouseButtons() != Qt::NoButton) m_evaluator->interact(node);
+        m_evaluator->nodeChanged(node);
+    }
     if(!m_modified) {
         m_modified = true;
         fileNameUpdate(m_fileName, m_modified);
@@ -322,6 +361,9 @@ void Scene::nodeDataChanged() {
 
 void Scene::deleteEdge(Edge *edge) {
     m_edges.removeOne(edge);
+    disconnect(edge, &Edge::startPositionChanged, this, &Scene::edgeMoved);
+    disconnect(edge, &Edge::endPositionChanged, this, &Scene::edgeMoved);
+    m_edgeIndex.remove(edge);
     if(!m_modified) {
         m_modified = true;
         fileNameUpdate(m_fileName, m_modified);
@@ -331,6 +373,10 @@ void Scene::deleteEdge(Edge *edge) {
 void Scene::addEdge(Edge *edge) {
     if(m_edges.contains(edge)) return;
     m_edges.append(edge);
+    edge->setParentItem(m_canvas);
+    connect(edge, &Edge::startPositionChanged, this, &Scene::edgeMoved);
+    connect(edge, &Edge::endPositionChanged, this, &Scene::edgeMoved);
+    m_edgeIndex.update(edge, edgeBounds(edge));
     if(!m_modified) {
         m_modified = true;
         fileNameUpdate(m_fileName, m_modified);
@@ -343,8 +389,11 @@ void Scene::deleteFrame(Frame *frame) {
         activeItemChanged();
     }
     m_frames.removeOne(frame);
-    disconnect(m_background, &BackgroundObject::panChanged, frame, &Frame::setPan);
-    disconnect(m_background, &BackgroundObject::scaleChanged, frame, &Frame::setScaleView);
+    disconnect(frame, &Frame::changeBaseX, this, &Scene::frameMoved);
+    disconnect(frame, &Frame::changeBaseY, this, &Scene::frameMoved);
+    disconnect(frame, &Frame::widthChanged, this, &Scene::frameMoved);
+    disconnect(frame, &Frame::heightChanged, this, &Scene::frameMoved);
+    m_frameIndex.remove(frame);
     if(!m_modified) {
         m_modified = true;
         fileNameUpdate(m_fileName, m_modified);
@@ -354,10 +403,12 @@ void Scene::deleteFrame(Frame *frame) {
 void Scene::addFrame(Frame *frame) {
     if(m_frames.contains(frame)) return;
     m_frames.insert(0, frame);
-    connect(m_background, &BackgroundObject::panChanged, frame, &Frame::setPan);
-    connect(m_background, &BackgroundObject::scaleChanged, frame, &Frame::setScaleView);
-    frame->setScaleView(m_background->viewScale());
-    frame->setPan(m_background->viewPan());
+    frame->setParentItem(m_canvas);
+    connect(frame, &Frame::changeBaseX, this, &Scene::frameMoved);
+    connect(frame, &Frame::changeBaseY, this, &Scene::frameMoved);
+    connect(frame, &Frame::widthChanged, this, &Scene::frameMoved);
+    connect(frame, &Frame::heightChanged, this, &Scene::frameMoved);
+    m_frameIndex.update(frame, QRectF(frame->baseX(), frame->baseY(), frame->width(), frame->height()));
     if(!m_modified) {
         m_modified = true;
         fileNameUpdate(m_fileName, m_modified);
@@ -365,13 +416,54 @@ void Scene::addFrame(Frame *frame) {
 }
 
 Frame *Scene::frameAt(float x, float y) {
-    for(Frame *frame: m_frames) {
+    Frame *result = nullptr;
+    for(QQuickItem *item: m_frameIndex.query(QRectF(x, y, 0, 0))) {
+        Frame *frame = static_cast<Frame*>(item);
         if(frame->selected()) continue;
-        if((frame->x() <= x && frame->x() + frame->width()*frame->scale() >= x) && (frame->y() <= y && frame->y() + frame->height()*frame->scale() >= y)){
-            return frame;
+        if((frame->x() <= x && frame->x() + frame->width() >= x) && (frame->y() <= y && frame->y() + frame->height() >= y)){
+            //the most recently added frame is on top
+            if(!result || m_frames.indexOf(frame) < m_frames.indexOf(result)) result = frame;
         }
     }
-    return nullptr;
+    return result;
+}
+
+QList<Edge*> Scene::edgesIn(const QRectF &rect) {
+    QList<Edge*> result;
+    for(QQuickItem *item: m_edgeIndex.query(rect)) {
+        result.append(static_cast<Edge*>(item));
+    }
+    return result;
+}
+
+void Scene::updateView() {
+    QVector2D pan = m_background->viewPan();
+    m_canvas->setScale(m_background->viewScale());
+    m_canvas->setPosition(QPointF(-pan.x(), -pan.y()));
+}
+
+QRectF Scene::edgeBounds(Edge *edge) const {
+    QVector2D start = edge->startPosition();
+    QVector2D end = edge->endPosition();
+    QRectF bounds = QRectF(QPointF(start.x(), start.y()), QPointF(end.x(), end.y())).normalized();
+    //control points of a backward edge stick out by half of its width
+    float margin = 0.5f*bounds.width() + 5.0f;
+    return bounds.adjusted(-margin, -5.0f, margin, 5.0f);
+}
+
+void Scene::nodeMoved() {
+    Node *node = qobject_cast<Node*>(sender());
+    if(node) m_nodeIndex.update(node, QRectF(node->baseX(), node->baseY(), node->width(), node->height()));
+}
+
+void Scene::frameMoved() {
+    Frame *frame = qobject_cast<Frame*>(sender());
+    if(frame) m_frameIndex.update(frame, QRectF(frame->baseX(), frame->baseY(), frame->width(), frame->height()));
+}
+
+void Scene::edgeMoved() {
+    Edge *edge = qobject_cast<Edge*>(sender());
+    if(edge) m_edgeIndex.update(edge, edgeBounds(edge));
 }
 
 QList<QQuickItem*> Scene::selectedList() const {
@@ -415,8 +507,7 @@ void Scene::mouseMoveEvent(QMouseEvent *event) {
     }
     else if(event->buttons() == Qt::LeftButton) {
         if(!rectSelect) {
-            rectView->setSource(QUrl(QStringLiteral("qrc:/qml/RectSelection.qml")));
-            rectSelect = qobject_cast<QQuickItem*>(rectView->rootObject());
+            rectSelect = QmlLoader::create(QStringLiteral("qrc:/qml/RectSelection.qml"));
             rectSelect->setParentItem(this);
             rectSelect->setProperty("rotCenterX", event->pos().x());
             rectSelect->setProperty("rotCenterY", event->pos().y());
@@ -441,36 +532,53 @@ void Scene::mouseMoveEvent(QMouseEvent *event) {
         rectSelect->setWidth(abs(difX));
         rectSelect->setHeight(abs(difY));
 
-        for(auto n: m_nodes) {
-            if(rectSelect->x() + rectSelect->width() < n->x() + 6*n->scale() || rectSelect->x() > n->x() + (n->width() - 6)*n->scale() ||
-               rectSelect->y() + rectSelect->height() < n->y() || rectSelect->y() > n->y() + n->height()*n->scale()) {
-                if(n->selected()) {
-                    n->setSelected(false);
-                    m_selectedItem.removeOne(n);
-                }
+        QRectF area = m_canvas->mapRectFromItem(this, QRectF(rectSelect->x(), rectSelect->y(), rectSelect->width(), rectSelect->height()));
+        QList<QQuickItem*> covered;
+        QSet<QQuickItem*> coveredSet;
+        for(QQuickItem *item: m_nodeIndex.query(area)) {
+            Node *n = static_cast<Node*>(item);
+            if(area.right() < n->x() + 6 || area.left() > n->x() + n->width() - 6 ||
+               area.bottom() < n->y() || area.top() > n->y() + n->height()) continue;
+            covered.append(n);
+            coveredSet.insert(n);
+        }
+        for(QQuickItem *item: m_frameIndex.query(area)) {
+            Frame *f = static_cast<Frame*>(item);
+            if(area.right() < f->x() || area.left() > f->x() + f->width() ||
+               area.bottom() < f->y() || area.top() > f->y() + 45.0f) continue;
+            covered.append(f);
+            coveredSet.insert(f);
+        }
+        //rebuild the selection in one pass instead of removing items one by one
+        QList<QQuickItem*> selected;
+        for(QQuickItem *item: m_selectedItem) {
+            if(coveredSet.contains(item)) {
+                selected.append(item);
+            }
+            else if(qobject_cast<Node*>(item)) {
+                qobject_cast<Node*>(item)->setSelected(false);
+            }
+            else if(qobject_cast<Frame*>(item)) {
+                qobject_cast<Frame*>(item)->setSelected(false);
             }
             else {
-                if(!n->selected()) {
-                    n->setSelected(true);
-                    m_selectedItem.push_back(n);
-                }
+                selected.append(item);
             }
         }
-        for(auto f: m_frames) {
-            if(rectSelect->x() + rectSelect->width() < f->x() || rectSelect->x() > f->x() + f->width()*f->scale() ||
-               rectSelect->y() + rectSelect->height() < f->y() || rectSelect->y() > f->y() + 45.0f*f->scale()) {
-                if(f->selected()) {
-                    f->setSelected(false);
-                    m_selectedItem.removeOne(f);
-                }
+        for(QQuickItem *item: covered) {
+            if(qobject_cast<Node*>(item)) {
+                Node *n = qobject_cast<Node*>(item);
+                if(n->selected()) continue;
+                n->setSelected(true);
             }
             else {
-                if(!f->selected()) {
-                    f->setSelected(true);
-                    m_selectedItem.push_back(f);
-                }
+                Frame *f = qobject_cast<Frame*>(item);
+                if(f->selected()) continue;
+                f->setSelected(true);
             }
+            selected.append(item);
         }
+        m_selectedItem = selected;
     }
 }
 
@@ -482,13 +590,16 @@ void Scene::mouseReleaseEvent(QMouseEvent *event) {
     }
     if(cutLine) {
         QList<QQuickItem*> intersectedEdges;
+        QSet<Edge*> intersectedSet;
         int cutLineSize = cutLine->pointCount();
-        for(auto e: m_edges) {
-            for(int i = 0; i < cutLineSize - 1; ++i) {
-                bool intersected = e->intersectWith(cutLine->pointAt(i), cutLine->pointAt(i + 1));
-                if(intersected) {
+        for(int i = 0; i < cutLineSize - 1; ++i) {
+            QPointF p1 = m_canvas->mapFromItem(this, cutLine->pointAt(i));
+            QPointF p2 = m_canvas->mapFromItem(this, cutLine->pointAt(i + 1));
+            for(Edge *e: edgesIn(QRectF(p1, p2))) {
+                if(intersectedSet.contains(e)) continue;
+                if(e->intersectWith(p1, p2)) {
+                    intersectedSet.insert(e);
                     intersectedEdges.append(e);
-                    break;
                 }
             }
         }
@@ -530,6 +641,10 @@ void Scene::serialize(QJsonObject &json) const {
 }
 
 void Scene::deserialize(const QJsonObject &json) {
+    //the graph is wired completely before sockets are laid out and nodes evaluated
+    m_loading = true;
+    m_evaluator->suspend();
+    int firstNode = m_nodes.size();
     background()->setViewScale(1.0f);
     background()->setViewPan(QVector2D(0, 0));
     if(json.contains("resX") && json.contains("resY")) {
@@ -566,12 +681,19 @@ void Scene::deserialize(const QJsonObject &json) {
         QJsonArray edges = json["edges"].toArray();
         for(int i = 0; i < edges.size(); ++i) {
             QJsonObject edgesObject = edges[i].toObject();
-            Edge *e = new Edge(this);
+            Edge *e = new Edge(m_canvas);
             e->deserialize(edgesObject, socketsHash);
-            if(e->startSocket() && e->endSocket()) m_edges.append(e);
+            if(e->startSocket() && e->endSocket()) addEdge(e);
             else delete e;
         }
     }
+
+    m_loading = false;
+    for(auto node: m_nodes.mid(firstNode)) {
+        node->updateSocketsPosition();
+        m_evaluator->markDirty(node);
+    }
+    m_evaluator->resume();
 }
 
 Node *Scene::deserializeNode(const QJsonObject &json) {
@@ -677,6 +799,9 @@ Node *Scene::deserializeNode(const QJsonObject &json) {
     case 32:
         node = new HexagonsNode(this, m_resolution);
         break;
+    case 33:
+        node = new DistanceNode(this, m_resolution);
+        break;
     default:
         std::cout << "nonexistent type" << std::endl;
     }
@@ -742,6 +867,10 @@ bool Scene::isModified() {
     return m_modified;
 }
 
+bool Scene::isLoading() const {
+    return m_loading;
+}
+
 void Scene::undo() {
     m_undoStack->undo();
 }
@@ -791,20 +920,20 @@ void Scene::addToFrame() {
 
 void Scene::focusNode() {
     if(m_nodes.size() > 0) {
-        float maxX = m_nodes[0]->x() + m_nodes[0]->width()*m_nodes[0]->scale();
-        float maxY = m_nodes[0]->y() + m_nodes[0]->height()*m_nodes[0]->scale();
+        float maxX = m_nodes[0]->x() + m_nodes[0]->width();
+        float maxY = m_nodes[0]->y() + m_nodes[0]->height();
         float minX = m_nodes[0]->x();
         float minY = m_nodes[0]->y();
         for(int i = 1; i< m_nodes.size(); ++i) {
             auto n = m_nodes[i];
-            maxX = std::max(maxX, static_cast<float>(n->x() + n->width()*n->scale()));
-            maxY = std::max(maxY, static_cast<float>(n->y() + n->height()*n->scale()));
+            maxX = std::max(maxX, static_cast<float>(n->x() + n->width()));
+            maxY = std::max(maxY, static_cast<float>(n->y() + n->height()));
             minX = std::min(minX, static_cast<float>(n->x()));
             minY = std::min(minY, static_cast<float>(n->y()));
         }
         QVector2D center = QVector2D((maxX - minX)*0.5 + minX, (maxY - minY)*0.5 + minY);
 
-        m_background->setViewPan((m_background->viewPan() + center) - QVector2D(width()*0.5, height()*0.5));
+        m_background->setViewPan(center*m_background->viewScale() - QVector2D(width()*0.5, height()*0.5));
     }
 
 }
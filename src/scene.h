@@ -36,6 +36,8 @@
 #include "clipboard.h"
 #include "preview3d.h"
 #include "cutline.h"
+#include "graphevaluator.h"
+#include "spatialindex.h"
 
 class Scene: public QQuickItem
 {
@@ -52,7 +54,10 @@ public:
     QList<Edge*> edges() const;
     void setEdges(const QList<Edge*> &edges);
     BackgroundObject *background() const;
+    QQuickItem *canvas() const;
+    static Scene *sceneOf(const QQuickItem *item);
     Preview3DObject *preview3d() const;
+    GraphEvaluator *evaluator() const;
     void deleteNode(Node* node);
     void addNode(Node *node);
     Node *nodeAt(float x, float y);
@@ -62,6 +67,7 @@ public:
     void deleteFrame(Frame *frame);
     void addFrame(Frame *frame);
     Frame *frameAt(float x, float y);
+    QList<Edge*> edgesIn(const QRectF &rect);
     QList<QQuickItem*> selectedList() const;
     bool addSelected(QQuickItem *item);
     bool deleteSelected(QQuickItem *item);
@@ -79,6 +85,7 @@ public:
     bool loadScene(QString fileName);
     QString fileName();
     bool isModified();
+    bool isLoading() const;
     void undo();
     void redo();
     void cut();
@@ -110,7 +117,6 @@ public:
     Edge* dragEdge = nullptr;
     Frame* dropFrame = nullptr;
     QQuickItem* rectSelect = nullptr;
-    QQuickView* rectView = nullptr;
     CutLine* cutLine = nullptr;
 signals:
     void activeItemChanged();
@@ -118,15 +124,26 @@ signals:
     void outputsSave(QString dir);
     void resolutionUpdate(QVector2D res);
 private:
+    void updateView();
+    QRectF edgeBounds(Edge *edge) const;
+    void nodeMoved();
+    void frameMoved();
+    void edgeMoved();
     BackgroundObject *m_background = nullptr;
+    QQuickItem *m_canvas = nullptr;
     Preview3DObject *m_preview3d = nullptr;
+    GraphEvaluator *m_evaluator = nullptr;
     QList<Node*> m_nodes;
     QList<Edge*> m_edges;
     QList<Frame*> m_frames;
     QList<QQuickItem*> m_selectedItem;
+    SpatialIndex m_nodeIndex;
+    SpatialIndex m_frameIndex;
+    SpatialIndex m_edgeIndex;
     QQuickItem *m_activeItem = nullptr;
     QString m_fileName = "";
     bool m_modified = false;
+    bool m_loading = false;
     QUndoStack *m_undoStack = nullptr;
     bool m_albedoConnected = false;
     bool m_metalConnected = false;
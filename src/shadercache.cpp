@@ -0,0 +1,193 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "shadercache.h"
+#include "glworker.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QOffscreenSurface>
+#include <QThread>
+
+QHash<ShaderCache::Key, ShaderCache::Entry> ShaderCache::m_programs;
+QSet<QOpenGLContext*> ShaderCache::m_contexts;
+QMutex ShaderCache::m_mutex;
+
+QOpenGLShaderProgram *ShaderCache::acquire(const QString &vertex, const QString &fragment) {
+    return acquire(currentOwner(), vertex, fragment);
+}
+
+QOpenGLShaderProgram *ShaderCache::acquireSource(const QString &vertex, const QString &fragmentSource) {
+    return acquire(currentOwner(), vertex, fragmentSource, FragmentSource);
+}
+
+QOpenGLShaderProgram *ShaderCache::acquireCompute(const QString &compute) {
+    return acquire(currentOwner(), QString(), compute, ComputeFile);
+}
+
+const void *ShaderCache::currentOwner() {
+    //uniforms set on the gl worker would race with the render thread, so it links its own copies
+    if(GLWorker::isWorkerThread()) {
+        QOpenGLContext *context = QOpenGLContext::currentContext();
+        watch(context);
+        return context;
+    }
+    return QOpenGLContextGroup::currentContextGroup();
+}
+
+void ShaderCache::watch(QOpenGLContext *context) {
+    //programs keyed by a context go away with it, before its address can be reused
+    QMutexLocker locker(&m_mutex);
+    if(!context || m_contexts.contains(context)) return;
+    m_contexts.insert(context);
+    QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, [context](){
+        QMutexLocker locker(&m_mutex);
+        m_contexts.remove(context);
+        for(auto it = m_programs.begin(); it != m_programs.end();) {
+            if(it.key().first == context) {
+                delete it->program;
+                it = m_programs.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    });
+}
+
+QOpenGLShaderProgram *ShaderCache::acquire(const void *owner, const QString &vertex, const QString &fragment, Stage stage) {
+    QMutexLocker locker(&m_mutex);
+    Key key(owner, qMakePair(vertex, fragment));
+    auto it = m_programs.find(key);
+    if(it != m_programs.end()) {
+        ++it->refs;
+        return it->program;
+    }
+    //compiling can take a while, other threads keep looking up their programs meanwhile
+    locker.unlock();
+    QOpenGLShaderProgram *program = new QOpenGLShaderProgram();
+    if(stage == ComputeFile) {
+        program->addCacheableShaderFromSourceFile(QOpenGLShader::Compute, fragment);
+    }
+    else {
+        program->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, vertex);
+        if(stage == FragmentSource) program->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, fragment);
+        else program->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, fragment);
+    }
+    if(!program->link()) {
+        qWarning() << "shader link failed" << vertex << (stage == FragmentSource ? QStringLiteral("generated") : fragment) << program->log();
+    }
+    locker.relock();
+    it = m_programs.find(key);
+    if(it != m_programs.end()) {
+        //another thread of the same group linked it first
+        delete program;
+        ++it->refs;
+        return it->program;
+    }
+    m_programs.insert(key, {program, 1});
+    return program;
+}
+
+void ShaderCache::release(QOpenGLShaderProgram *program) {
+    QMutexLocker locker(&m_mutex);
+    for(auto it = m_programs.begin(); it != m_programs.end(); ++it) {
+        if(it->program != program) continue;
+        if(--it->refs == 0) {
+            delete it->program;
+            m_programs.erase(it);
+        }
+        return;
+    }
+}
+
+void ShaderCache::warmUp() {
+    QOpenGLContext *shareContext = QOpenGLContext::globalShareContext();
+    if(!shareContext) return;
+    QOffscreenSurface *surface = new QOffscreenSurface();
+    surface->setFormat(shareContext->format());
+    surface->create();
+    QThread *thread = QThread::create([surface, shareContext]() {
+        QOpenGLContext context;
+        context.setFormat(shareContext->format());
+        context.setShareContext(shareContext);
+        if(!context.create() || !context.makeCurrent(surface)) return;
+        //programs stay referenced by the cache so renderers only look them up
+        for(auto program: nodePrograms()) {
+            acquire(context.shareGroup(), program.first, program.second);
+        }
+        context.doneCurrent();
+    });
+    QObject::connect(thread, &QThread::finished, qApp, [thread, surface]() {
+        delete surface;
+        thread->deleteLater();
+    });
+    thread->start(QThread::LowPriority);
+}
+
+QList<QPair<QString, QString>> ShaderCache::nodePrograms() {
+    return QList<QPair<QString, QString>>()
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/albedo.frag"))
+        << qMakePair(QStringLiteral(":/shaders/grid.vert"), QStringLiteral(":/shaders/grid.frag"))
+        << qMakePair(QStringLiteral(":/shaders/checker.vert"), QStringLiteral(":/shaders/checker.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/texture.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/beveldisplay.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/distance.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/bricks.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/brightnesscontrast.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/circle.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/color.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/coloring.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/colorramp.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/gaussianblur.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/directionalwarp.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/gradient.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/grayscale.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/hexagons.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/inverse.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/mapping.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/mirror.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/mix.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/noise.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/normalmap.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/onechanel.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/polartransform.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/polygon.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texmatrix.vert"), QStringLiteral(":/shaders/texture.frag"))
+        << qMakePair(QStringLiteral(":/shaders/pbr.vert"), QStringLiteral(":/shaders/pbr.frag"))
+        << qMakePair(QStringLiteral(":/shaders/cubemap.vert"), QStringLiteral(":/shaders/equirectangular.frag"))
+        << qMakePair(QStringLiteral(":/shaders/cubemap.vert"), QStringLiteral(":/shaders/irradiance.frag"))
+        << qMakePair(QStringLiteral(":/shaders/cubemap.vert"), QStringLiteral(":/shaders/prefiltered.frag"))
+        << qMakePair(QStringLiteral(":/shaders/brdf.vert"), QStringLiteral(":/shaders/brdf.frag"))
+        << qMakePair(QStringLiteral(":/shaders/background.vert"), QStringLiteral(":/shaders/background.frag"))
+        << qMakePair(QStringLiteral(":/shaders/brdf.vert"), QStringLiteral(":/shaders/texture.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/applybloom.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/brightforbloom.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/resample.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/slopeblur.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/slopegradient.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/threshold.frag"))
+        << qMakePair(QStringLiteral(":/shaders/tile.vert"), QStringLiteral(":/shaders/tile.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/tileresolve.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/random.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/transform.frag"))
+        << qMakePair(QStringLiteral(":/shaders/noise.vert"), QStringLiteral(":/shaders/voronoi.frag"))
+        << qMakePair(QStringLiteral(":/shaders/texture.vert"), QStringLiteral(":/shaders/warp.frag"));
+}
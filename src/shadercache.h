@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+#include <QOpenGLShaderProgram>
+#include <QOpenGLContext>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+
+class ShaderCache
+{
+public:
+    static QOpenGLShaderProgram *acquire(const QString &vertex, const QString &fragment);
+    static QOpenGLShaderProgram *acquireSource(const QString &vertex, const QString &fragmentSource);
+    static QOpenGLShaderProgram *acquireCompute(const QString &compute);
+    static void release(QOpenGLShaderProgram *program);
+    static void warmUp();
+private:
+    struct Entry {
+        QOpenGLShaderProgram *program;
+        int refs;
+    };
+    enum Stage {
+        FragmentFile,
+        FragmentSource,
+        ComputeFile
+    };
+    typedef QPair<const void*, QPair<QString, QString>> Key;
+    static QOpenGLShaderProgram *acquire(const void *owner, const QString &vertex, const QString &fragment, Stage stage = FragmentFile);
+    static const void *currentOwner();
+    static void watch(QOpenGLContext *context);
+    static QList<QPair<QString, QString>> nodePrograms();
+    static QHash<Key, Entry> m_programs;
+    static QSet<QOpenGLContext*> m_contexts;
+    static QMutex m_mutex;
+};
+
+#endif // SHADERCACHE_H
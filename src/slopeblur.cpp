@@ -1,11 +1,16 @@
 #include "slopeblur.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 
 SlopeBlurObject::SlopeBlurObject(QQuickItem *parent, QVector2D resolution, GLint bpc, int mode,
-                                 float intensity, int samples): QQuickFramebufferObject (parent),
-    m_resolution(resolution), m_bpc(bpc), m_mode(mode), m_intensity(intensity), m_samples(samples)
+                                 float intensity, int samples, int iterations): QQuickFramebufferObject (parent),
+    m_resolution(resolution), m_bpc(bpc), m_mode(mode), m_intensity(intensity), m_samples(samples),
+    m_iterations(iterations)
 {
 
 }
@@ -45,6 +50,7 @@ unsigned int SlopeBlurObject::slopeTexture() {
 
 void SlopeBlurObject::setSlopeTexture(unsigned int texture) {
     m_slopeTexture = texture;
+    slopeUpdated = true;
 }
 
 void SlopeBlurObject::saveTexture(QString fileName) {
@@ -83,6 +89,16 @@ void SlopeBlurObject::setSamples(int samples) {
     slopedTex = true;
 }
 
+int SlopeBlurObject::iterations() {
+    return m_iterations;
+}
+
+void SlopeBlurObject::setIterations(int iterations) {
+    if(m_iterations == iterations) return;
+    m_iterations = iterations;
+    slopedTex = true;
+}
+
 QVector2D SlopeBlurObject::resolution() {
     return m_resolution;
 }
@@ -106,26 +122,20 @@ void SlopeBlurObject::setBPC(GLint bpc) {
 SlopeBlurRenderer::SlopeBlurRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc)
 {
     initializeOpenGLFunctions();
-    slopeBlurShader = new QOpenGLShaderProgram();
-    slopeBlurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    slopeBlurShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/slopeblur.frag");
-    slopeBlurShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    slopeBlurShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/slopeblur.frag");
+    gradientShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/slopegradient.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     slopeBlurShader->bind();
     slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("sourceTexture"), 0);
-    slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("slopeTexture"), 1);
+    slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("gradientTexture"), 1);
     slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("maskTexture"), 2);
     slopeBlurShader->release();
+    gradientShader->bind();
+    gradientShader->setUniformValue(gradientShader->uniformLocation("slopeTexture"), 0);
+    gradientShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -147,12 +157,7 @@ SlopeBlurRenderer::SlopeBlurRenderer(QVector2D res, GLint bpc): m_resolution(res
     glBindFramebuffer(GL_FRAMEBUFFER, slopeFBO);
     glGenTextures(1, &m_slopedTexture);
     glBindTexture(GL_TEXTURE_2D, m_slopedTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -167,9 +172,13 @@ SlopeBlurRenderer::SlopeBlurRenderer(QVector2D res, GLint bpc): m_resolution(res
 
 SlopeBlurRenderer::~SlopeBlurRenderer()
 {
-    delete slopeBlurShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(slopeBlurShader);
+    ShaderCache::release(gradientShader);
+    TexturePool *pool = TexturePool::instance();
+    if(pool) pool->release(m_gradient);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_slopedTexture);
     glDeleteFramebuffers(1, &slopeFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -191,15 +200,18 @@ void SlopeBlurRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(slopeBlurItem->slopedTex) {
             slopeBlurItem->slopedTex = false;
-            m_sourceTexture = slopeBlurItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, slopeBlurItem->sourceTexture(), slopeBlurItem->resolution());
             if(m_sourceTexture) {
-                maskTexture = slopeBlurItem->maskTexture();
-                m_slopeTexture = slopeBlurItem->slopeTexture();
-                slopeBlurShader->bind();
-                slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("mode"), slopeBlurItem->mode());
-                slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("intensity"), slopeBlurItem->intensity());
-                slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("samples"), slopeBlurItem->samples());
-                slopeBlurShader->release();
+                maskTexture = Resampler::instance()->resample(this, 1, slopeBlurItem->maskTexture(), slopeBlurItem->resolution());
+                m_slopeTexture = Resampler::instance()->resample(this, 2, slopeBlurItem->slopeTexture(), slopeBlurItem->resolution());
+                m_mode = slopeBlurItem->mode();
+                m_intensity = slopeBlurItem->intensity();
+                m_samples = slopeBlurItem->samples();
+                m_iterations = slopeBlurItem->iterations();
+                if(slopeBlurItem->slopeUpdated) {
+                    slopeBlurItem->slopeUpdated = false;
+                    gradientDirty = true;
+                }
             }
         }
         if(m_sourceTexture) {
@@ -212,6 +224,7 @@ void SlopeBlurRenderer::synchronize(QQuickFramebufferObject *item) {
         slopeBlurItem->resUpdated = false;
         m_resolution = slopeBlurItem->resolution();
         updateTexResolution();
+        gradientDirty = true;
     }
     if(slopeBlurItem->texSaving) {
         slopeBlurItem->texSaving = false;
@@ -235,6 +248,7 @@ void SlopeBlurRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_slopedTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -245,25 +259,70 @@ void SlopeBlurRenderer::render() {
     glFlush();
 }
 
+void SlopeBlurRenderer::createGradient() {
+    int width = m_resolution.x();
+    int height = m_resolution.y();
+    TexturePool *pool = TexturePool::instance();
+    if(m_gradient.width != width || m_gradient.height != height) {
+        pool->release(m_gradient);
+        m_gradient = pool->acquire(width, height, GL_RG16F);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, m_gradient.fbo);
+    glViewport(0, 0, width, height);
+    glBindVertexArray(textureVAO);
+    gradientShader->bind();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_slopeTexture);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    gradientShader->release();
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gradientDirty = false;
+}
+
 void SlopeBlurRenderer::createSlopeBlur() {
-    glBindFramebuffer(GL_FRAMEBUFFER, slopeFBO);
+    //the gradient only depends on the slope input, parameter tweaks reuse it
+    if(gradientDirty || !m_gradient.texture) createGradient();
+    int iterations = qMax(m_iterations, 1);
+    TexturePool *pool = TexturePool::instance();
+    TexturePool::Target passes[2];
+    if(iterations > 1) passes[0] = pool->acquire(m_resolution.x(), m_resolution.y(), m_bpc, GL_LINEAR);
+    if(iterations > 2) passes[1] = pool->acquire(m_resolution.x(), m_resolution.y(), m_bpc, GL_LINEAR);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     slopeBlurShader->bind();
-    slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("useMask"), maskTexture);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
+    slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("mode"), m_mode);
+    slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("intensity"), m_intensity);
+    slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("samples"), m_samples);
     glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, m_slopeTexture);
+    glBindTexture(GL_TEXTURE_2D, m_gradient.texture);
     glActiveTexture(GL_TEXTURE2);
     glBindTexture(GL_TEXTURE_2D, maskTexture);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glActiveTexture(GL_TEXTURE0);    
+    unsigned int source = m_sourceTexture;
+    for(int i = 0; i < iterations; ++i) {
+        bool last = i == iterations - 1;
+        TexturePool::Target &pass = passes[i%2];
+        glBindFramebuffer(GL_FRAMEBUFFER, last ? slopeFBO : pass.fbo);
+        glClear(GL_COLOR_BUFFER_BIT);
+        //mask once on the final pass instead of compounding it
+        slopeBlurShader->setUniformValue(slopeBlurShader->uniformLocation("useMask"), last && maskTexture);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, source);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        source = pass.texture;
+    }
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
     slopeBlurShader->release();
     glBindVertexArray(0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    pool->release(passes[0]);
+    pool->release(passes[1]);
     glBindTexture(GL_TEXTURE_2D, m_slopedTexture);
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -273,12 +332,7 @@ void SlopeBlurRenderer::createSlopeBlur() {
 
 void SlopeBlurRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_slopedTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -289,12 +343,7 @@ void SlopeBlurRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -307,6 +356,7 @@ void SlopeBlurRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_slopedTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -314,41 +364,7 @@ void SlopeBlurRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
     glDeleteFramebuffers(1, &fbo);
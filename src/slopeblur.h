@@ -4,12 +4,13 @@
 #include <QQuickFramebufferObject>
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
+#include "texturepool.h"
 
 class SlopeBlurObject: public QQuickFramebufferObject
 {
     Q_OBJECT
 public:
-    SlopeBlurObject(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, int mode = 0, float intensity = 0.5f, int samples = 0);
+    SlopeBlurObject(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, int mode = 0, float intensity = 0.5f, int samples = 0, int iterations = 1);
     QQuickFramebufferObject::Renderer *createRenderer() const;
     unsigned int &texture();
     void setTexture(unsigned int texture);
@@ -26,11 +27,14 @@ public:
     void setIntensity(float intensity);
     int samples();
     void setSamples(int samples);
+    int iterations();
+    void setIterations(int iterations);
     QVector2D resolution();
     void setResolution(QVector2D res);
     GLint bpc();
     void setBPC(GLint bpc);
     bool slopedTex = false;
+    bool slopeUpdated = false;
     bool resUpdated = false;
     bool bpcUpdated = false;
     bool texSaving = false;
@@ -48,6 +52,7 @@ private:
     int m_mode = 0;
     float m_intensity = 0.5f;
     int m_samples = 1;
+    int m_iterations = 1;
 };
 
 class SlopeBlurRenderer: public QQuickFramebufferObject::Renderer, public QOpenGLFunctions_4_4_Core
@@ -60,6 +65,7 @@ public:
     void render();
 private:
     void createSlopeBlur();
+    void createGradient();
     void updateTexResolution();
     void saveTexture(QString fileName);
     QVector2D m_resolution;
@@ -70,7 +76,14 @@ private:
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
     unsigned int slopeFBO = 0;
+    int m_mode = 0;
+    float m_intensity = 0.0f;
+    int m_samples = 0;
+    int m_iterations = 1;
+    bool gradientDirty = true;
+    TexturePool::Target m_gradient;
     QOpenGLShaderProgram *slopeBlurShader;
+    QOpenGLShaderProgram *gradientShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
 };
@@ -1,67 +1,52 @@
 #include "slopeblurnode.h"
+#include "textureformat.h"
 
-SlopeBlurNode::SlopeBlurNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int mode, float intensity, int samples):
-    Node(parent, resolution, bpc), m_mode(mode), m_intensity(intensity), m_samples(samples)
+SlopeBlurNode::SlopeBlurNode(QQuickItem *parent, QVector2D resolution, GLint bpc, int mode, float intensity, int samples, int iterations):
+    Node(parent, resolution, bpc), m_mode(mode), m_intensity(intensity), m_samples(samples), m_iterations(iterations)
 {
     createSockets(3, 1);
     setTitle("Slope Blur");
     m_socketsInput[0]->setTip("Texture");
     m_socketsInput[1]->setTip("Slope");
     m_socketsInput[2]->setTip("Mask");
-    preview = new SlopeBlurObject(grNode, m_resolution, m_bpc, m_mode, m_intensity, m_samples);
-    float s = scaleView();
+    preview = new SlopeBlurObject(grNode, m_resolution, m_bpc, m_mode, m_intensity, m_samples, m_iterations);
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(preview, &SlopeBlurObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &SlopeBlurObject::textureChanged, this, &SlopeBlurNode::setOutput);
     connect(this, &Node::changeResolution, preview, &SlopeBlurObject::setResolution);
     connect(this, &Node::changeBPC, preview, &SlopeBlurObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/SlopeBlurProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+SlopeBlurNode::~SlopeBlurNode() {
+    delete preview;
+}
+
+void SlopeBlurNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/SlopeBlurProperty.qml"));
     propertiesPanel->setProperty("mode", m_mode);
     propertiesPanel->setProperty("startIntensity", m_intensity);
     propertiesPanel->setProperty("startSamples", m_samples);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startIterations", m_iterations);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(blendModeChanged(int)), this, SLOT(updateMode(int)));
     connect(propertiesPanel, SIGNAL(intensityChanged(qreal)), this, SLOT(updateIntensity(qreal)));
     connect(propertiesPanel, SIGNAL(samplesChanged(int)), this, SLOT(updateSamples(int)));
+    connect(propertiesPanel, SIGNAL(iterationsChanged(int)), this, SLOT(updateIterations(int)));
     connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-SlopeBlurNode::~SlopeBlurNode() {
-    delete preview;
-}
-
 void SlopeBlurNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[2]->getEdges().isEmpty()) {
-        Node *inputNode2 = static_cast<Node*>(m_socketsInput[2]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode2 && inputNode2->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setSlopeTexture(m_socketsInput[1]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[2]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->slopedTex = true;
     preview->update();
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &SlopeBlurNode::getPreviewTexture() {
@@ -73,7 +58,7 @@ void SlopeBlurNode::saveTexture(QString fileName) {
 }
 
 SlopeBlurNode *SlopeBlurNode::clone() {
-    return new SlopeBlurNode(parentItem(), m_resolution, m_bpc, m_mode, m_intensity, m_samples);
+    return new SlopeBlurNode(parentItem(), m_graphResolution, m_bpc, m_mode, m_intensity, m_samples, m_iterations);
 }
 
 void SlopeBlurNode::serialize(QJsonObject &json) const {
@@ -82,6 +67,7 @@ void SlopeBlurNode::serialize(QJsonObject &json) const {
     json["mode"] = m_mode;
     json["intensity"] = m_intensity;
     json["samples"] = m_samples;
+    json["iterations"] = m_iterations;
 }
 
 void SlopeBlurNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash) {
@@ -95,16 +81,20 @@ void SlopeBlurNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *>
     if(json.contains("samples")) {
         m_samples = json["samples"].toInt();
     }
-    propertiesPanel->setProperty("mode", m_mode);
-    propertiesPanel->setProperty("startIntensity", m_intensity);
-    propertiesPanel->setProperty("startSamples", m_samples);
+    if(json.contains("iterations")) {
+        m_iterations = json["iterations"].toInt();
+    }
+    setPropertyOnPanel("mode", m_mode);
+    setPropertyOnPanel("startIntensity", m_intensity);
+    setPropertyOnPanel("startSamples", m_samples);
+    setPropertyOnPanel("startIterations", m_iterations);
 
     preview->setMode(m_mode);
     preview->setIntensity(m_intensity);
     preview->setSamples(m_samples);
+    preview->setIterations(m_iterations);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -145,6 +135,18 @@ void SlopeBlurNode::setSamples(int samples) {
     preview->update();
 }
 
+int SlopeBlurNode::iterations() {
+    return m_iterations;
+}
+
+void SlopeBlurNode::setIterations(int iterations) {
+    if(m_iterations == iterations) return;
+    m_iterations = iterations;
+    iterationsChanged(iterations);
+    preview->setIterations(iterations);
+    preview->update();
+}
+
 void SlopeBlurNode::setOutput() {
     m_socketOutput[0]->setValue(preview->texture());
 }
@@ -163,3 +165,8 @@ void SlopeBlurNode::updateSamples(int samples) {
     setSamples(samples);
     dataChanged();
 }
+
+void SlopeBlurNode::updateIterations(int iterations) {
+    setIterations(iterations);
+    dataChanged();
+}
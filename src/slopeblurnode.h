@@ -8,7 +8,7 @@ class SlopeBlurNode: public Node
 {
     Q_OBJECT
 public:
-    SlopeBlurNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, int mode = 0, float intensity = 0.5f, int samples = 1);
+    SlopeBlurNode(QQuickItem *parent = nullptr, QVector2D resolution = QVector2D(1024, 1024), GLint bpc = GL_RGBA16, int mode = 0, float intensity = 0.5f, int samples = 1, int iterations = 1);
     ~SlopeBlurNode();
     void operation() override;
     unsigned int &getPreviewTexture() override;
@@ -22,20 +22,27 @@ public:
     void setIntensity(float intensity);
     int samples();
     void setSamples(int samples);
+    int iterations();
+    void setIterations(int iterations);
 signals:
     void modeChanged(int mode);
     void intensityChanged(float intensity);
     void samplesChanged(int samples);
+    void iterationsChanged(int iterations);
 public slots:
     void setOutput();
     void updateMode(int mode);
     void updateIntensity(qreal intensity);
     void updateSamples(int samples);
+    void updateIterations(int iterations);
+protected:
+    void createPropertiesPanel() override;
 private:
     SlopeBlurObject *preview;
     int m_mode = 0;
     float m_intensity = 0.5f;
     int m_samples = 1;
+    int m_iterations = 1;
 };
 
 #endif // SLOPEBLURNODE_H
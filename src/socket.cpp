@@ -22,6 +22,7 @@
 #include "socket.h"
 #include "scene.h"
 #include "backgroundobject.h"
+#include "qmlloader.h"
 #include <iostream>
 #include <QTime>
 
@@ -30,9 +31,7 @@ Socket::Socket(QQuickItem *parent):QQuickItem (parent)
     setAcceptedMouseButtons(Qt::AllButtons);
     setAcceptHoverEvents(true);
     setTransformOrigin(TopLeft);
-    view = new QQuickView();
-    view->setSource(QUrl(QStringLiteral("qrc:/qml/Socket.qml")));
-    grSocket = qobject_cast<QQuickItem *>(view->rootObject());
+    grSocket = QmlLoader::create(QStringLiteral("qrc:/qml/Socket.qml"));
     grSocket->setParentItem(this);
     m_id = QUuid::createUuid();
     setWidth(16);
@@ -42,7 +41,6 @@ Socket::Socket(QQuickItem *parent):QQuickItem (parent)
 Socket::~Socket() {
     edges.clear();
     delete grSocket;
-    delete view;   
 }
 
 socketType Socket::type() const {
@@ -97,7 +95,7 @@ void Socket::hoverLeaveEvent(QHoverEvent *event) {
 }
 
 void Socket::mousePressEvent(QMouseEvent *event) {
-    Scene *scene = reinterpret_cast<Scene*>(parentItem()->parentItem());
+    Scene *scene = Scene::sceneOf(this);
     if(event->button() == Qt::LeftButton && !scene->isEdgeDrag) {
         scene->isEdgeDrag = true;
         scene->startSocket = this;
@@ -107,7 +105,7 @@ void Socket::mousePressEvent(QMouseEvent *event) {
             disconnect(this, &Socket::globalPosChanged, scene->dragEdge, &Edge::setEndPosition);
         }
         else {
-            Edge *edge = new Edge(scene);
+            Edge *edge = new Edge(scene->canvas());
             scene->dragEdge = edge;
             edge->setStartPosition(m_globalPos);
             edge->setEndPosition(m_globalPos);
@@ -122,9 +120,9 @@ void Socket::mousePressEvent(QMouseEvent *event) {
 }
 
 void Socket::mouseMoveEvent(QMouseEvent *event) {
-    Scene *scene = reinterpret_cast<Scene*>(parentItem()->parentItem());
+    Scene *scene = Scene::sceneOf(this);
     if(event->buttons() == Qt::LeftButton && scene->isEdgeDrag) {
-        QPointF globalPos = mapToItem(scene, QPointF(event->pos().x(), event->pos().y()));
+        QPointF globalPos = mapToItem(scene->canvas(), QPointF(event->pos().x(), event->pos().y()));
         Node *nearestNode = nullptr;
         float minDist = std::numeric_limits<float>::max();
         for(auto node: scene->nodes()) {
@@ -153,7 +151,7 @@ void Socket::mouseMoveEvent(QMouseEvent *event) {
 }
 
 void Socket::mouseReleaseEvent(QMouseEvent *event) {
-    Scene *scene = reinterpret_cast<Scene*>(parentItem()->parentItem());
+    Scene *scene = Scene::sceneOf(this);
     if(event->button() == Qt::LeftButton && scene->isEdgeDrag) {
         bool dragAccepted = false;
         bool connectedNodes = false;
@@ -166,7 +164,7 @@ void Socket::mouseReleaseEvent(QMouseEvent *event) {
         }
         Node *n = scene->nodeAt(childPos.x(), childPos.y());
         if(n) {
-            QPointF nodePos = scene->mapToItem(n, childPos);
+            QPointF nodePos = n->mapFromItem(scene->canvas(), childPos);
             QQuickItem *child = n->childAt(nodePos.x(), nodePos.y());
             Node *parentNode = qobject_cast<Node*>(parentItem());
             connectedNodes = parentNode->checkConnected(n, m_type);
@@ -183,6 +181,8 @@ void Socket::mouseReleaseEvent(QMouseEvent *event) {
                                 scene->startSocket->parentItem() != s->parentItem()) &&
                                 !connectedNodes);
                 if(dragAccepted) {
+                    Socket *input = s->type() == INPUTS ? s : scene->startSocket;
+                    if(s != scene->startSocket) scene->evaluator()->interact(qobject_cast<Node*>(input->parentItem()));
                     if(existEdge) {                        
                         if(s != scene->startSocket) {      
                             if(s->edges.count() > 0) {
@@ -273,14 +273,18 @@ void Socket::setAdditional(bool additional) {
 
 void Socket::setValue(const QVariant &value) {
     m_value = value;
+    Node *node = qobject_cast<Node*>(parentItem());
+    Scene *scene = Scene::sceneOf(node);
     if(m_type == INPUTS) {
-        Node *node = qobject_cast<Node*>(parentItem());
-        node->operation();
+        if(scene) scene->evaluator()->markDirty(node);
+        else node->operation();
     }
     else {
         for(auto edge: edges) {
-            edge->endSocket()->setValue(m_value);
+            if(scene) edge->endSocket()->m_value = m_value;
+            else edge->endSocket()->setValue(m_value);
         }
+        if(scene) scene->evaluator()->outputChanged(node);
     }
 }
 
@@ -288,6 +292,16 @@ QVariant Socket::value() {
     return m_value;
 }
 
+GLint Socket::format() {
+    //inputs carry the storage format of the output they are connected to
+    if(m_type == INPUTS) return edges.isEmpty() ? 0 : edges[0]->startSocket()->format();
+    return m_format;
+}
+
+void Socket::setFormat(GLint format) {
+    m_format = format;
+}
+
 QUuid Socket::id() {
     return m_id;
 }
@@ -295,7 +309,3 @@ QUuid Socket::id() {
 void Socket::reset() {
     m_value = 0;
 }
-
-void Socket::updateScale(float scale) {
-    m_scale = scale;
-}
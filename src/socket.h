@@ -22,9 +22,9 @@
 #ifndef SOCKET_H
 #define SOCKET_H
 #include <QQuickItem>
-#include <QQuickView>
 #include <QJsonObject>
 #include <QUuid>
+#include <qopengl.h>
 #include "edge.h"
 
 enum socketType {INPUTS, OUTPUTS};
@@ -56,19 +56,19 @@ public:
     void setAdditional(bool additional);
     void setValue(const QVariant &value);
     QVariant value();
+    GLint format();
+    void setFormat(GLint format);
     QUuid id();
     void reset();
-    void updateScale(float scale);
 signals:
     void globalPosChanged(QVector2D pos);
 private:
     QVariant m_value = 0;
-    QQuickView *view;
+    GLint m_format = 0;
     QQuickItem *grSocket;
     socketType m_type;
     QList<Edge*> edges;
     QVector2D m_globalPos;
-    float m_scale = 1.0f;
     QString textTip = "Socket";
     QUuid m_id;
 };
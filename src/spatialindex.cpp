@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spatialindex.h"
+#include <cmath>
+
+SpatialIndex::SpatialIndex(float cellSize): m_cellSize(cellSize) {
+
+}
+
+void SpatialIndex::update(QQuickItem *item, const QRectF &bounds) {
+    QRect range = cellRange(bounds);
+    auto it = m_items.find(item);
+    if(it != m_items.end()) {
+        if(it.value() == range) return;
+        remove(item);
+    }
+    m_items.insert(item, range);
+    for(int y = range.top(); y <= range.bottom(); ++y) {
+        for(int x = range.left(); x <= range.right(); ++x) {
+            m_cells[cellKey(x, y)].append(item);
+        }
+    }
+}
+
+void SpatialIndex::remove(QQuickItem *item) {
+    auto it = m_items.find(item);
+    if(it == m_items.end()) return;
+    QRect range = it.value();
+    m_items.erase(it);
+    for(int y = range.top(); y <= range.bottom(); ++y) {
+        for(int x = range.left(); x <= range.right(); ++x) {
+            auto cell = m_cells.find(cellKey(x, y));
+            if(cell == m_cells.end()) continue;
+            cell.value().removeOne(item);
+            if(cell.value().isEmpty()) m_cells.erase(cell);
+        }
+    }
+}
+
+void SpatialIndex::clear() {
+    m_cells.clear();
+    m_items.clear();
+}
+
+QVector<QQuickItem*> SpatialIndex::query(const QRectF &area) const {
+    QVector<QQuickItem*> result;
+    QRect range = cellRange(area);
+    //a wide area is cheaper to test against every item than cell by cell
+    if(static_cast<qint64>(range.width())*range.height() > m_cells.size()) {
+        for(auto it = m_items.begin(); it != m_items.end(); ++it) {
+            if(it.value().intersects(range)) result.append(it.key());
+        }
+        return result;
+    }
+    for(int y = range.top(); y <= range.bottom(); ++y) {
+        for(int x = range.left(); x <= range.right(); ++x) {
+            auto cell = m_cells.find(cellKey(x, y));
+            if(cell == m_cells.end()) continue;
+            for(QQuickItem *item: cell.value()) {
+                //an item spanning several cells is reported only from its first cell in the area
+                QRect itemRange = m_items.value(item);
+                if(x == std::max(itemRange.left(), range.left()) && y == std::max(itemRange.top(), range.top())) {
+                    result.append(item);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+QRect SpatialIndex::cellRange(const QRectF &bounds) const {
+    QRectF r = bounds.normalized();
+    return QRect(QPoint(static_cast<int>(std::floor(r.left()/m_cellSize)), static_cast<int>(std::floor(r.top()/m_cellSize))),
+                 QPoint(static_cast<int>(std::floor(r.right()/m_cellSize)), static_cast<int>(std::floor(r.bottom()/m_cellSize))));
+}
+
+quint64 SpatialIndex::cellKey(int x, int y) {
+    return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
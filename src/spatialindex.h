@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QQuickItem>
+#include <QHash>
+#include <QVector>
+#include <QRectF>
+#include <QRect>
+
+//uniform grid over item bounds in graph space, so hit tests only visit nearby items
+class SpatialIndex
+{
+public:
+    SpatialIndex(float cellSize = 256.0f);
+    void update(QQuickItem *item, const QRectF &bounds);
+    void remove(QQuickItem *item);
+    void clear();
+    QVector<QQuickItem*> query(const QRectF &area) const;
+private:
+    QRect cellRange(const QRectF &bounds) const;
+    static quint64 cellKey(int x, int y);
+    float m_cellSize;
+    QHash<quint64, QVector<QQuickItem*>> m_cells;
+    QHash<QQuickItem*, QRect> m_items;
+};
+
+#endif // SPATIALINDEX_H
@@ -20,6 +20,7 @@
  */
 
 #include "tab.h"
+#include "qmlloader.h"
 #include <iostream>
 #include <QRegularExpression>
 
@@ -30,9 +31,7 @@ Tab::Tab(QQuickItem *parent): QQuickItem (parent)
     setAcceptedMouseButtons(Qt::AllButtons);
     setWidth(24);
     setHeight(25);
-    view = new QQuickView();
-    view->setSource(QUrl(QStringLiteral("qrc:/qml/TabRect.qml")));
-    grTab = qobject_cast<QQuickItem *>(view->rootObject());
+    grTab = QmlLoader::create(QStringLiteral("qrc:/qml/TabRect.qml"));
     grTab->setParentItem(this);
     connect(grTab, SIGNAL(activated()), this, SLOT(activate()));
     connect(grTab, SIGNAL(closed()), this, SLOT(close()));
@@ -41,7 +40,6 @@ Tab::Tab(QQuickItem *parent): QQuickItem (parent)
 Tab::~Tab() {
     delete m_scene;
     delete grTab;
-    delete view;
 }
 
 bool Tab::save() {
@@ -22,7 +22,6 @@
 #ifndef TAB_H
 #define TAB_H
 #include <QQuickItem>
-#include <QQuickView>
 #include "scene.h"
 
 class Tab: public QQuickItem
@@ -47,7 +46,6 @@ signals:
     void movedTab(Tab *tab, int index);
 private:
     Scene *m_scene = nullptr;
-    QQuickView *view;
     QQuickItem *grTab;
     float dragX = 0.0f;
     float dragY = 0.0f;
@@ -0,0 +1,228 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "textureexporter.h"
+#include "textureformat.h"
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThread>
+#include <functional>
+#include <QDebug>
+#include "FreeImage.h"
+
+class EncodeTask: public QRunnable
+{
+public:
+    EncodeTask(std::function<void()> task): m_task(task) {}
+    void run() {
+        m_task();
+    }
+private:
+    std::function<void()> m_task;
+};
+
+TextureExporter::TextureExporter() {
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount() - 1));
+}
+
+TextureExporter *TextureExporter::instance() {
+    static TextureExporter *exporter = nullptr;
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    if(!exporter) {
+        exporter = new TextureExporter();
+        exporter->moveToThread(QCoreApplication::instance()->thread());
+    }
+    return exporter;
+}
+
+void TextureExporter::attach(QQuickWindow *window) {
+    if(!window || m_windows.contains(window)) return;
+    m_windows.insert(window);
+    connect(window, &QQuickWindow::afterRendering, this, [this, window]() {
+        collect(window);
+    }, Qt::DirectConnection);
+    connect(window, &QObject::destroyed, this, [this, window]() {
+        m_windows.remove(window);
+    });
+}
+
+void TextureExporter::read(unsigned int fbo, QString fileName, int width, int height, GLint bpc, int channels) {
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    QOpenGLFunctions_4_4_Core *gl = context->versionFunctions<QOpenGLFunctions_4_4_Core>();
+    GLint format = TextureFormat::exportFormat(bpc);
+    //half float copies are read back as floats for exr only, other files store 16 bit integers
+    if(format == GL_RGBA16F) {
+        format = FreeImage_GetFIFFromFilename(fileName.toUtf8().constData()) == FIF_EXR ? GL_RGBA32F : GL_RGBA16;
+    }
+    Readback readback = {fileName, width, height, format, channels, 0, nullptr, context};
+    //the copy into the pixel buffer runs asynchronously, pixels are collected once the fence is signaled
+    gl->glGenBuffers(1, &readback.pbo);
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    gl->glBufferData(GL_PIXEL_PACK_BUFFER, size(readback), nullptr, GL_STREAM_READ);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    gl->glReadPixels(0, 0, width, height, channels == 4 ? GL_BGRA : GL_BGR, type(readback), nullptr);
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback.fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    gl->glFlush();
+
+    QMutexLocker locker(&m_mutex);
+    if(m_finished == m_total) {
+        m_finished = 0;
+        m_total = 0;
+    }
+    ++m_total;
+    m_pending.append(readback);
+    progressChanged(m_finished, m_total);
+}
+
+bool TextureExporter::hasPendingReadbacks() {
+    QMutexLocker locker(&m_mutex);
+    return !m_pending.isEmpty();
+}
+
+void TextureExporter::waitForDone() {
+    m_pool.waitForDone();
+}
+
+void TextureExporter::collect(QQuickWindow *window) {
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if(!context) return;
+    QOpenGLFunctions_4_4_Core *gl = context->versionFunctions<QOpenGLFunctions_4_4_Core>();
+    QMutexLocker locker(&m_mutex);
+    bool waiting = false;
+    for(int i = 0; i < m_pending.size();) {
+        Readback readback = m_pending.at(i);
+        if(readback.context != context) {
+            ++i;
+            continue;
+        }
+        if(gl->glClientWaitSync(readback.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            waiting = true;
+            ++i;
+            continue;
+        }
+        m_pending.removeAt(i);
+        gl->glDeleteSync(readback.fence);
+        QByteArray pixels;
+        gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+        void *data = gl->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size(readback), GL_MAP_READ_BIT);
+        if(data) {
+            pixels = QByteArray(static_cast<const char*>(data), size(readback));
+            gl->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        gl->glDeleteBuffers(1, &readback.pbo);
+        m_pool.start(new EncodeTask([this, readback, pixels]() {
+            encode(readback, pixels);
+        }));
+    }
+    if(waiting) window->update();
+}
+
+void TextureExporter::encode(const Readback &readback, const QByteArray &pixels) {
+    bool success = save(readback, pixels);
+    if(!success) qWarning() << "failed saving" << readback.fileName;
+    m_mutex.lock();
+    int finished = ++m_finished;
+    int total = m_total;
+    m_mutex.unlock();
+    exported(readback.fileName, success);
+    progressChanged(finished, total);
+    if(finished == total) exportFinished();
+}
+
+bool TextureExporter::save(const Readback &readback, const QByteArray &pixels) {
+    if(pixels.isEmpty()) return false;
+    int width = readback.width;
+    int height = readback.height;
+    int channels = readback.channels;
+    FIBITMAP *image = nullptr;
+    if(readback.bpc == GL_RGBA32F) {
+        const GLfloat *data = reinterpret_cast<const GLfloat*>(pixels.constData());
+        image = FreeImage_AllocateT(channels == 4 ? FIT_RGBAF : FIT_RGBF, width, height);
+        for(int y = 0; y < height; ++y) {
+            const GLfloat *row = data + width*(height - 1 - y)*channels;
+            float *bits = reinterpret_cast<float*>(FreeImage_GetScanLine(image, y));
+            for(int x = 0; x < width; ++x) {
+                bits[0] = row[2];
+                bits[1] = row[1];
+                bits[2] = row[0];
+                if(channels == 4) bits[3] = row[3];
+                bits += channels;
+                row += channels;
+            }
+        }
+    }
+    else if(readback.bpc == GL_RGBA16) {
+        const GLushort *data = reinterpret_cast<const GLushort*>(pixels.constData());
+        image = FreeImage_AllocateT(channels == 4 ? FIT_RGBA16 : FIT_RGB16, width, height);
+        for(int y = 0; y < height; ++y) {
+            const GLushort *row = data + width*(height - 1 - y)*channels;
+            WORD *bits = reinterpret_cast<WORD*>(FreeImage_GetScanLine(image, y));
+            for(int x = 0; x < width; ++x) {
+                bits[0] = row[2];
+                bits[1] = row[1];
+                bits[2] = row[0];
+                if(channels == 4) bits[3] = row[3];
+                bits += channels;
+                row += channels;
+            }
+        }
+    }
+    else {
+        BYTE *data = reinterpret_cast<BYTE*>(const_cast<char*>(pixels.constData()));
+        image = FreeImage_ConvertFromRawBits(data, width, height, channels*width, channels*8, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
+    }
+    if(!image) return false;
+
+    QByteArray fileName = readback.fileName.toUtf8();
+    FREE_IMAGE_FORMAT format = FreeImage_GetFIFFromFilename(fileName.constData());
+    if(format == FIF_UNKNOWN) format = FIF_PNG;
+    FIBITMAP *converted = nullptr;
+    if(format == FIF_EXR) {
+        converted = channels == 4 ? FreeImage_ConvertToRGBAF(image) : FreeImage_ConvertToRGBF(image);
+    }
+    else if(!FreeImage_FIFSupportsExportType(format, FreeImage_GetImageType(image)) ||
+            !FreeImage_FIFSupportsExportBPP(format, FreeImage_GetBPP(image))) {
+        converted = channels == 4 ? FreeImage_ConvertTo32Bits(image) : FreeImage_ConvertTo24Bits(image);
+    }
+    if(converted) {
+        FreeImage_Unload(image);
+        image = converted;
+    }
+    bool success = FreeImage_Save(format, image, fileName.constData(), 0);
+    FreeImage_Unload(image);
+    return success;
+}
+
+int TextureExporter::size(const Readback &readback) {
+    int bytes = readback.bpc == GL_RGBA32F ? 4 : readback.bpc == GL_RGBA16 ? 2 : 1;
+    return readback.width*readback.height*readback.channels*bytes;
+}
+
+GLenum TextureExporter::type(const Readback &readback) {
+    if(readback.bpc == GL_RGBA32F) return GL_FLOAT;
+    return readback.bpc == GL_RGBA16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+}
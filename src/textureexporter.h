@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTUREEXPORTER_H
+#define TEXTUREEXPORTER_H
+
+#include <QObject>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_4_4_Core>
+#include <QQuickWindow>
+#include <QMutex>
+#include <QThreadPool>
+#include <QSet>
+
+class TextureExporter: public QObject
+{
+    Q_OBJECT
+public:
+    static TextureExporter *instance();
+    void read(unsigned int fbo, QString fileName, int width, int height, GLint bpc, int channels = 4);
+    bool hasPendingReadbacks();
+    void waitForDone();
+public slots:
+    void attach(QQuickWindow *window);
+signals:
+    void progressChanged(int finished, int total);
+    void exported(QString fileName, bool success);
+    void exportFinished();
+private:
+    struct Readback {
+        QString fileName;
+        int width;
+        int height;
+        GLint bpc;
+        int channels;
+        unsigned int pbo;
+        GLsync fence;
+        QOpenGLContext *context;
+    };
+    TextureExporter();
+    void collect(QQuickWindow *window);
+    void encode(const Readback &readback, const QByteArray &pixels);
+    static bool save(const Readback &readback, const QByteArray &pixels);
+    static int size(const Readback &readback);
+    static GLenum type(const Readback &readback);
+    QList<Readback> m_pending;
+    QMutex m_mutex;
+    QThreadPool m_pool;
+    QSet<QQuickWindow*> m_windows;
+    int m_finished = 0;
+    int m_total = 0;
+};
+
+#endif // TEXTUREEXPORTER_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "textureformat.h"
+
+//order of the bits drop down in the property panels
+static const GLint formats[] = {GL_RGBA8, GL_RGBA16, GL_RGBA16F, GL_R8, GL_R16, GL_R16F, GL_RG16F};
+static const int formatCount = sizeof(formats)/sizeof(formats[0]);
+
+void TextureFormat::allocate(QOpenGLFunctions_4_4_Core *gl, GLint format, int width, int height) {
+    GLenum channels = GL_RGBA;
+    GLenum type = GL_UNSIGNED_BYTE;
+    switch(format) {
+    case GL_RGBA16:
+        type = GL_UNSIGNED_SHORT;
+        break;
+    case GL_RGBA16F:
+        type = GL_HALF_FLOAT;
+        break;
+    case GL_R8:
+        channels = GL_RED;
+        break;
+    case GL_R16:
+        channels = GL_RED;
+        type = GL_UNSIGNED_SHORT;
+        break;
+    case GL_R16F:
+        channels = GL_RED;
+        type = GL_HALF_FLOAT;
+        break;
+    case GL_RG16F:
+        channels = GL_RG;
+        type = GL_HALF_FLOAT;
+        break;
+    case GL_RGB8:
+        channels = GL_RGB;
+        break;
+    case GL_RGB16:
+        channels = GL_RGB;
+        type = GL_UNSIGNED_SHORT;
+        break;
+    case GL_RGB16F:
+        channels = GL_RGB;
+        type = GL_HALF_FLOAT;
+        break;
+    default:
+        break;
+    }
+    gl->glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, channels, type, nullptr);
+    applySwizzle(gl, format);
+}
+
+void TextureFormat::applySwizzle(QOpenGLFunctions_4_4_Core *gl, GLint format) {
+    //a texture object can be reallocated with another format, so the identity is restored too
+    GLint swizzle[] = {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA};
+    if(isScalar(format)) {
+        swizzle[1] = GL_RED;
+        swizzle[2] = GL_RED;
+        swizzle[3] = GL_ONE;
+    }
+    gl->glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+}
+
+bool TextureFormat::isScalar(GLint format) {
+    return format == GL_R8 || format == GL_R16 || format == GL_R16F;
+}
+
+bool TextureFormat::isFloat(GLint format) {
+    return format == GL_RGBA16F || format == GL_R16F || format == GL_RG16F;
+}
+
+GLint TextureFormat::exportFormat(GLint format) {
+    //exported images are 8 or 16 bit integer rgba, float outputs keep a half float copy for exr
+    if(isFloat(format)) return GL_RGBA16F;
+    return format == GL_RGBA8 || format == GL_R8 ? GL_RGBA8 : GL_RGBA16;
+}
+
+GLint TextureFormat::rgbFormat(GLint format) {
+    switch(format) {
+    case GL_RGBA16:
+        return GL_RGB16;
+    case GL_RGBA16F:
+        return GL_RGB16F;
+    default:
+        return GL_RGB8;
+    }
+}
+
+GLint TextureFormat::colorFormat(GLint format) {
+    switch(format) {
+    case GL_R8:
+        return GL_RGBA8;
+    case GL_R16:
+        return GL_RGBA16;
+    case GL_R16F:
+    case GL_RG16F:
+        return GL_RGBA16F;
+    default:
+        return format;
+    }
+}
+
+GLint TextureFormat::fromIndex(int index) {
+    if(index < 0 || index >= formatCount) return GL_RGBA8;
+    return formats[index];
+}
+
+int TextureFormat::index(GLint format) {
+    for(int i = 0; i < formatCount; ++i) {
+        if(formats[i] == format) return i;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTUREFORMAT_H
+#define TEXTUREFORMAT_H
+
+#include <QOpenGLFunctions_4_4_Core>
+
+//storage formats a node output can use, single channel formats are swizzled so
+//consumers always sample a normalized, opaque grayscale rgba view
+class TextureFormat
+{
+public:
+    static void allocate(QOpenGLFunctions_4_4_Core *gl, GLint format, int width, int height);
+    static void applySwizzle(QOpenGLFunctions_4_4_Core *gl, GLint format);
+    static bool isScalar(GLint format);
+    static bool isFloat(GLint format);
+    static GLint exportFormat(GLint format);
+    static GLint colorFormat(GLint format);
+    static GLint rgbFormat(GLint format);
+    static GLint fromIndex(int index);
+    static int index(GLint format);
+};
+
+#endif // TEXTUREFORMAT_H
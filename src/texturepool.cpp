@@ -0,0 +1,168 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "texturepool.h"
+#include "textureformat.h"
+#include <QDebug>
+
+qint64 TexturePool::m_budget = 512ll*1024*1024;
+QHash<QOpenGLContext*, TexturePool*> TexturePool::m_pools;
+QMutex TexturePool::m_mutex;
+
+TexturePool::TexturePool() {
+    initializeOpenGLFunctions();
+}
+
+TexturePool::~TexturePool() {
+    for(auto target: m_free) {
+        destroy(target);
+    }
+}
+
+TexturePool *TexturePool::instance() {
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if(!context) return nullptr;
+    QMutexLocker locker(&m_mutex);
+    TexturePool *pool = m_pools.value(context, nullptr);
+    if(!pool) {
+        pool = new TexturePool();
+        m_pools.insert(context, pool);
+        QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed, [context](){
+            QMutexLocker locker(&m_mutex);
+            delete m_pools.take(context);
+        });
+    }
+    return pool;
+}
+
+TexturePool::Target TexturePool::acquire(int width, int height, GLenum format, GLint filter, int layers) {
+    //layers above zero request a 2d array texture, its framebuffer has the first layer attached
+    GLenum textureTarget = layers > 0 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+    Target target;
+    for(int i = 0; i < m_free.size(); ++i) {
+        const Target &t = m_free.at(i);
+        if(t.width == width && t.height == height && t.format == format && t.layers == layers) {
+            target = m_free.takeAt(i);
+            break;
+        }
+    }
+    if(target.texture == 0) {
+        target.width = width;
+        target.height = height;
+        target.format = format;
+        target.layers = layers;
+        trim(size(target));
+        glGenTextures(1, &target.texture);
+        glGenFramebuffers(1, &target.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+        if(layers > 0) {
+            glBindTexture(GL_TEXTURE_2D_ARRAY, target.texture);
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, format, width, height, layers);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target.texture, 0, 0);
+        }
+        else {
+            glBindTexture(GL_TEXTURE_2D, target.texture);
+            glTexStorage2D(GL_TEXTURE_2D, 1, format, width, height);
+            TextureFormat::applySwizzle(this, format);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        m_allocated += size(target);
+        m_highWaterMark = qMax(m_highWaterMark, m_allocated);
+    }
+    glBindTexture(textureTarget, target.texture);
+    glTexParameteri(textureTarget, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(textureTarget, GL_TEXTURE_MAG_FILTER, filter);
+    glBindTexture(textureTarget, 0);
+    return target;
+}
+
+void TexturePool::release(Target &target) {
+    if(target.texture == 0) return;
+    m_free.append(target);
+    target = Target();
+    trim(0);
+}
+
+qint64 TexturePool::allocatedBytes() const {
+    return m_allocated;
+}
+
+qint64 TexturePool::highWaterMark() const {
+    return m_highWaterMark;
+}
+
+qint64 TexturePool::budget() {
+    return m_budget;
+}
+
+void TexturePool::setBudget(qint64 bytes) {
+    m_budget = bytes;
+}
+
+qint64 TexturePool::bytesPerPixel(GLenum format) {
+    switch(format) {
+    case GL_R8:
+        return 1;
+    case GL_RG8:
+    case GL_R16:
+    case GL_R16F:
+        return 2;
+    case GL_RGBA8:
+    case GL_RG16:
+    case GL_RG16F:
+    case GL_RG16UI:
+    case GL_R32F:
+        return 4;
+    case GL_RGBA16:
+    case GL_RGBA16F:
+    case GL_RG32F:
+        return 8;
+    case GL_RGBA32F:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+void TexturePool::destroy(const Target &target) {
+    glDeleteFramebuffers(1, &target.fbo);
+    glDeleteTextures(1, &target.texture);
+    m_allocated -= size(target);
+}
+
+void TexturePool::trim(qint64 required) {
+    //evict the least recently released targets first
+    while(!m_free.isEmpty() && m_allocated + required > m_budget) {
+        destroy(m_free.takeFirst());
+    }
+    if(m_allocated + required > m_budget) {
+        qWarning() << "texture pool over budget:" << (m_allocated + required)/(1024*1024) << "MB of" << m_budget/(1024*1024) << "MB";
+    }
+}
+
+qint64 TexturePool::size(const Target &target) {
+    return bytesPerPixel(target.format)*target.width*target.height*qMax(1, target.layers);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTUREPOOL_H
+#define TEXTUREPOOL_H
+#include <QOpenGLFunctions_4_4_Core>
+#include <QOpenGLContext>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+class TexturePool: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    struct Target {
+        unsigned int texture = 0;
+        unsigned int fbo = 0;
+        int width = 0;
+        int height = 0;
+        GLenum format = 0;
+        int layers = 0;
+    };
+    static TexturePool *instance();
+    Target acquire(int width, int height, GLenum format, GLint filter = GL_NEAREST, int layers = 0);
+    void release(Target &target);
+    qint64 allocatedBytes() const;
+    qint64 highWaterMark() const;
+    static qint64 budget();
+    static void setBudget(qint64 bytes);
+    static qint64 bytesPerPixel(GLenum format);
+private:
+    TexturePool();
+    ~TexturePool();
+    void destroy(const Target &target);
+    void trim(qint64 required);
+    static qint64 size(const Target &target);
+    QList<Target> m_free;
+    qint64 m_allocated = 0;
+    qint64 m_highWaterMark = 0;
+    static qint64 m_budget;
+    static QHash<QOpenGLContext*, TexturePool*> m_pools;
+    static QMutex m_mutex;
+};
+
+#endif // TEXTUREPOOL_H
@@ -20,8 +20,12 @@
  */
 
 #include "threshold.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 ThresholdObject::ThresholdObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float threshold):
     QQuickFramebufferObject (parent), m_resolution(resolution), m_bpc(bpc), m_threshold(threshold)
@@ -58,6 +62,14 @@ void ThresholdObject::setSourceTexture(unsigned int texture) {
     m_sourceTexture = texture;
 }
 
+QList<PointStage> ThresholdObject::stages() {
+    return m_stages;
+}
+
+void ThresholdObject::setStages(const QList<PointStage> &stages) {
+    m_stages = stages;
+}
+
 void ThresholdObject::saveTexture(QString fileName) {
     texSaving = true;
     saveName = fileName;
@@ -96,25 +108,15 @@ void ThresholdObject::setBPC(GLint bpc) {
 
 ThresholdRenderer::ThresholdRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    thresholdShader = new QOpenGLShaderProgram();
-    thresholdShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    thresholdShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/threshold.frag");
-    thresholdShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    thresholdShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/threshold.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     thresholdShader->bind();
     thresholdShader->setUniformValue(thresholdShader->uniformLocation("sourceTexture"), 0);
     thresholdShader->setUniformValue(thresholdShader->uniformLocation("maskTexture"), 1);
     thresholdShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                            -1.0f, 1.0f, 0.0f, 1.0f,
@@ -137,16 +139,7 @@ ThresholdRenderer::ThresholdRenderer(QVector2D res, GLint bpc): m_resolution(res
     glBindFramebuffer(GL_FRAMEBUFFER, thresholdFBO);
     glGenTextures(1, &m_thresholdTexture);
     glBindTexture(GL_TEXTURE_2D, m_thresholdTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -160,9 +153,10 @@ ThresholdRenderer::ThresholdRenderer(QVector2D res, GLint bpc): m_resolution(res
 }
 
 ThresholdRenderer::~ThresholdRenderer() {
-    delete thresholdShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(thresholdShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_thresholdTexture);
     glDeleteFramebuffers(1, &thresholdFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -189,16 +183,14 @@ void ThresholdRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(thresholdItem->created) {
             thresholdItem->created = false;
-            m_sourceTexture = thresholdItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, thresholdItem->sourceTexture(), thresholdItem->resolution());
+            m_stages = thresholdItem->stages();
             if(m_sourceTexture) {
-                maskTexture = thresholdItem->maskTexture();
-                thresholdShader->bind();
-                thresholdShader->setUniformValue(thresholdShader->uniformLocation("threshold"), thresholdItem->threshold());
-                thresholdShader->setUniformValue(thresholdShader->uniformLocation("useMask"), maskTexture);
-                thresholdShader->release();
+                maskTexture = Resampler::instance()->resample(this, 1, thresholdItem->maskTexture(), thresholdItem->resolution());
+                m_threshold = thresholdItem->threshold();
             }
         }
-        if(m_sourceTexture) {
+        if(m_sourceTexture && !thresholdItem->fused) {
             create();
             thresholdItem->setTexture(m_thresholdTexture);
             thresholdItem->updatePreview(m_thresholdTexture);
@@ -226,6 +218,7 @@ void ThresholdRenderer::render() {
     if(m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_thresholdTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -237,12 +230,24 @@ void ThresholdRenderer::render() {
 }
 
 void ThresholdRenderer::create() {
+    if(!m_stages.isEmpty()) {
+        QList<PointStage> stages = m_stages;
+        stages.append(PointStage::threshold(m_threshold, maskTexture));
+        pointChain.render(stages, m_sourceTexture, thresholdFBO, m_resolution);
+        glBindTexture(GL_TEXTURE_2D, m_thresholdTexture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFlush();
+        return;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, thresholdFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     thresholdShader->bind();
+    thresholdShader->setUniformValue(thresholdShader->uniformLocation("threshold"), m_threshold);
+    thresholdShader->setUniformValue(thresholdShader->uniformLocation("useMask"), maskTexture);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glActiveTexture(GL_TEXTURE1);
@@ -255,21 +260,11 @@ void ThresholdRenderer::create() {
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     glFlush();
-    glFinish();
 }
 
 void ThresholdRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_thresholdTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
-        );
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr
-        );
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -280,12 +275,7 @@ void ThresholdRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -298,6 +288,7 @@ void ThresholdRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_thresholdTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -305,41 +296,7 @@ void ThresholdRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
     glDeleteFramebuffers(1, &fbo);
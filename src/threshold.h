@@ -25,6 +25,7 @@
 #include <QQuickFramebufferObject>
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
+#include "pointchain.h"
 
 class ThresholdObject: public QQuickFramebufferObject
 {
@@ -38,6 +39,8 @@ public:
     void setMaskTexture(unsigned int texture);
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
+    QList<PointStage> stages();
+    void setStages(const QList<PointStage> &stages);
     void saveTexture(QString fileName);
     float threshold();
     void setThreshold(float value);
@@ -49,6 +52,7 @@ public:
     bool selectedItem = false;
     bool resUpdated = false;
     bool bpcUpdated = false;
+    bool fused = false;
     bool texSaving = false;
     QString saveName = "";
 signals:
@@ -58,6 +62,7 @@ private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
     unsigned int m_texture = 0;
+    QList<PointStage> m_stages;
     unsigned int m_sourceTexture = 0;
     unsigned int m_maskTexture = 0;
     float m_threshold = 0.5f;
@@ -78,9 +83,12 @@ private:
     GLint m_bpc = GL_RGBA8;
     unsigned int thresholdFBO;
     unsigned int m_thresholdTexture = 0;
+    QList<PointStage> m_stages;
+    PointChain pointChain;
     unsigned int m_sourceTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
+    float m_threshold = 0.0f;
     QOpenGLShaderProgram *thresholdShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
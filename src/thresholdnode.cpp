@@ -20,31 +20,21 @@
  */
 
 #include "thresholdnode.h"
+#include "textureformat.h"
 
 ThresholdNode::ThresholdNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float threshold):
     Node(parent, resolution, bpc), m_threshold(threshold)
 {
     preview = new ThresholdObject(grNode, m_resolution, m_bpc, m_threshold);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &ThresholdNode::previewGenerated);
     connect(preview, &ThresholdObject::updatePreview, this, &Node::updatePreview);
     connect(preview, &ThresholdObject::textureChanged, this, &ThresholdNode::setOutput);
     connect(this, &Node::changeBPC, preview, &ThresholdObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/ThresholdProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    propertiesPanel->setProperty("startThreshold", m_threshold);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(thresholdChanged(qreal)), this, SLOT(updateThreshold(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(2, 1);
     setTitle("Threshold");
     m_socketsInput[0]->setTip("Texture");
@@ -55,23 +45,24 @@ ThresholdNode::~ThresholdNode() {
     delete preview;
 }
 
+void ThresholdNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/ThresholdProperty.qml"));
+    propertiesPanel->setProperty("startThreshold", m_threshold);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(thresholdChanged(qreal)), this, SLOT(updateThreshold(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void ThresholdNode::operation() {
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
-    preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
+    QList<PointStage> stages;
+    unsigned int source = fusedSource(stages);
+    preview->setStages(stages);
+    preview->setSourceTexture(source);
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->created = true;
     preview->update();
-    if(deserializing) deserializing == false;
 }
 
 unsigned int &ThresholdNode::getPreviewTexture() {
@@ -82,8 +73,18 @@ void ThresholdNode::saveTexture(QString fileName) {
     preview->saveTexture(fileName);
 }
 
+bool ThresholdNode::pointStage(PointStage &stage) {
+    stage = PointStage::threshold(m_threshold, m_socketsInput[1]->value().toUInt());
+    return true;
+}
+
+void ThresholdNode::setFused(bool fused) {
+    Node::setFused(fused);
+    preview->fused = fused;
+}
+
 ThresholdNode *ThresholdNode::clone() {
-    return new ThresholdNode(parentItem(), m_resolution, m_bpc, m_threshold);
+    return new ThresholdNode(parentItem(), m_graphResolution, m_bpc, m_threshold);
 }
 
 void ThresholdNode::serialize(QJsonObject &json) const{
@@ -96,13 +97,12 @@ void ThresholdNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *>
     Node::deserialize(json, hash);
     if(json.contains("threshold")) {
         updateThreshold(json["threshold"].toVariant().toReal());
-        propertiesPanel->setProperty("startThreshold", m_threshold);
+        setPropertyOnPanel("startThreshold", m_threshold);
     }
 
     preview->setThreshold(m_threshold);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -34,6 +34,8 @@ public:
     void operation() override;
     unsigned int &getPreviewTexture() override;
     void saveTexture(QString fileName) override;
+    bool pointStage(PointStage &stage) override;
+    void setFused(bool fused) override;
     ThresholdNode *clone() override;
     void serialize(QJsonObject &json) const override;
     void deserialize(const QJsonObject &json, QHash<QUuid, Socket*> &hash) override;
@@ -45,6 +47,8 @@ public slots:
     void previewGenerated();
     void setOutput();
     void updateThreshold(qreal value);
+protected:
+    void createPropertiesPanel() override;
 private:
     ThresholdObject *preview;
     float m_threshold = 0.5f;
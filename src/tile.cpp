@@ -20,9 +20,15 @@
  */
 
 #include "tile.h"
+#include "shadercache.h"
+#include "textureexporter.h"
+#include "texturepool.h"
 #include <QOpenGLFramebufferObjectFormat>
+#include <QtMath>
 #include <iostream>
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 TileObject::TileObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float offsetX, float offsetY,
                        int columns, int rows, float scale, float scaleX, float scaleY, int rotation,
@@ -60,57 +66,26 @@ void TileObject::setMaskTexture(unsigned int texture) {
 }
 
 unsigned int TileObject::sourceTexture() {
-    return m_sourceTexture;
+    return m_tiles[0];
 }
 
 void TileObject::setSourceTexture(unsigned int texture) {
-    m_sourceTexture = texture;
-    tiledTex = true;
-}
-
-unsigned int TileObject::tile1() {
-    return m_tile1;
-}
-
-void TileObject::setTile1(unsigned int texture) {
-    m_tile1 = texture;
-    tiledTex = true;
+    setTile(0, texture);
 }
 
-unsigned int TileObject::tile2() {
-    return m_tile2;
+unsigned int TileObject::tile(int index) {
+    return index < m_tiles.size() ? m_tiles[index] : 0;
 }
 
-void TileObject::setTile2(unsigned int texture) {
-    m_tile2 = texture;
+void TileObject::setTile(int index, unsigned int texture) {
+    if(index >= m_tiles.size()) m_tiles.resize(index + 1);
+    m_tiles[index] = texture;
     tiledTex = true;
+    tilesUpdated = true;
 }
 
-unsigned int TileObject::tile3() {
-    return m_tile3;
-}
-
-void TileObject::setTile3(unsigned int texture) {
-    m_tile3 = texture;
-    tiledTex = true;
-}
-
-unsigned int TileObject::tile4() {
-    return m_tile4;
-}
-
-void TileObject::setTile4(unsigned int texture) {
-    m_tile4 = texture;
-    tiledTex = true;
-}
-
-unsigned int TileObject::tile5() {
-    return m_tile5;
-}
-
-void TileObject::setTile5(unsigned int texture) {
-    m_tile5 = texture;
-    tiledTex = true;
+QVector<unsigned int> TileObject::tiles() {
+    return m_tiles;
 }
 
 void TileObject::saveTexture(QString fileName) {
@@ -312,44 +287,33 @@ void TileObject::setBPC(GLint bpc) {
 TileRenderer::TileRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
 
-    tileShader = new QOpenGLShaderProgram();
-    tileShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    tileShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/tile.frag");
-    tileShader->link();
+    tileShader = ShaderCache::acquire(":/shaders/tile.vert", ":/shaders/tile.frag");
 
-    randomShader = new QOpenGLShaderProgram();
-    randomShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    randomShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/random.frag");
-    randomShader->link();
+    instanceShader = ShaderCache::acquireCompute(":/shaders/tileinstances.comp");
 
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
+    resolveShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/tileresolve.frag");
 
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    randomShader = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/random.frag");
+
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
 
     tileShader->bind();
-    tileShader->setUniformValue(tileShader->uniformLocation("textureTile"), 0);
-    tileShader->setUniformValue(tileShader->uniformLocation("maskTexture"), 1);
-    tileShader->setUniformValue(tileShader->uniformLocation("randomTexture"), 2);
-    tileShader->setUniformValue(tileShader->uniformLocation("tile1"), 3);
-    tileShader->setUniformValue(tileShader->uniformLocation("tile2"), 4);
-    tileShader->setUniformValue(tileShader->uniformLocation("tile3"), 5);
-    tileShader->setUniformValue(tileShader->uniformLocation("tile4"), 6);
-    tileShader->setUniformValue(tileShader->uniformLocation("tile5"), 7);
+    tileShader->setUniformValue(tileShader->uniformLocation("tiles"), 0);
     tileShader->release();
 
-    randomShader->bind();
-    randomShader->setUniformValue(randomShader->uniformLocation("seed"), 1);
-    randomShader->release();
+    instanceShader->bind();
+    instanceShader->setUniformValue(instanceShader->uniformLocation("randomTexture"), 0);
+    instanceShader->release();
+
+    resolveShader->bind();
+    resolveShader->setUniformValue(resolveShader->uniformLocation("accumulatedTexture"), 0);
+    resolveShader->setUniformValue(resolveShader->uniformLocation("maskTexture"), 1);
+    resolveShader->release();
 
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
 
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
@@ -373,12 +337,7 @@ TileRenderer::TileRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(b
     glBindFramebuffer(GL_FRAMEBUFFER, tileFBO);
     glGenTextures(1, &m_tiledTexture);
     glBindTexture(GL_TEXTURE_2D, m_tiledTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -402,17 +361,28 @@ TileRenderer::TileRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(b
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_randomTexture, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, maxCells*2*sizeof(QVector4D), nullptr, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
 TileRenderer::~TileRenderer() {
-    delete tileShader;
-    delete checkerShader;
-    delete textureShader;
-    delete randomShader;
+    Resampler::release(this);
+    ShaderCache::release(tileShader);
+    ShaderCache::release(instanceShader);
+    ShaderCache::release(resolveShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
+    ShaderCache::release(randomShader);
     glDeleteTextures(1, &m_tiledTexture);
     glDeleteTextures(1, &m_randomTexture);
     glDeleteFramebuffers(1, &tileFBO);
     glDeleteFramebuffers(1, &randomFBO);
+    TexturePool *pool = TexturePool::instance();
+    if(pool) pool->release(m_tileArray);
+    glDeleteBuffers(1, &instanceBuffer);
     glDeleteVertexArrays(1, &textureVAO);
 }
 
@@ -427,49 +397,51 @@ void TileRenderer::synchronize(QQuickFramebufferObject *item) {
     if(tileItem->resUpdated) {
         tileItem->resUpdated = false;
         m_resolution = tileItem->resolution();
+        m_tilesUpdated = true;
         updateTexResolution();
     }
     if(tileItem->tiledTex || tileItem->bpcUpdated) {
         if(tileItem->bpcUpdated) {
             tileItem->bpcUpdated = false;
             m_bpc = tileItem->bpc();
+            m_tilesUpdated = true;
             updateTexResolution();
         }
         if(tileItem->tiledTex) {
             tileItem->tiledTex = false;
-            m_sourceTexture = tileItem->sourceTexture();
-            m_tile1 = tileItem->tile1();
-            m_tile2 = tileItem->tile2();
-            m_tile3 = tileItem->tile3();
-            m_tile4 = tileItem->tile4();
-            m_tile5 = tileItem->tile5();
-            if(m_sourceTexture || m_tile1 || m_tile2 || m_tile3 || m_tile4 || m_tile5) {
-                maskTexture = tileItem->maskTexture();
-                tileShader->bind();
-                tileShader->setUniformValue(tileShader->uniformLocation("offsetX"), tileItem->offsetX());
-                tileShader->setUniformValue(tileShader->uniformLocation("offsetY"), tileItem->offsetY());
-                tileShader->setUniformValue(tileShader->uniformLocation("columns"), tileItem->columns());
-                tileShader->setUniformValue(tileShader->uniformLocation("rows"), tileItem->rows());
-                tileShader->setUniformValue(tileShader->uniformLocation("scaleX"), tileItem->scaleX());
-                tileShader->setUniformValue(tileShader->uniformLocation("scaleY"), tileItem->scaleY());
-                tileShader->setUniformValue(tileShader->uniformLocation("scale"), tileItem->tileScale());
-                tileShader->setUniformValue(tileShader->uniformLocation("rotationAngle"), tileItem->rotationAngle());
-                tileShader->setUniformValue(tileShader->uniformLocation("randPosition"), tileItem->randPosition());
-                tileShader->setUniformValue(tileShader->uniformLocation("randRotation"), tileItem->randRotation());
-                tileShader->setUniformValue(tileShader->uniformLocation("randScale"), tileItem->randScale());
-                tileShader->setUniformValue(tileShader->uniformLocation("maskStrength"), tileItem->maskStrength());
-                tileShader->setUniformValue(tileShader->uniformLocation("inputCount"), tileItem->inputsCount());
-                tileShader->setUniformValue(tileShader->uniformLocation("keepProportion"), tileItem->keepProportion());
-                tileShader->setUniformValue(tileShader->uniformLocation("useAlpha"), tileItem->useAlpha());
-                tileShader->setUniformValue(tileShader->uniformLocation("depthMask"), tileItem->depthMask());
-                tileShader->setUniformValue(tileShader->uniformLocation("useMask"), maskTexture);
-                tileShader->release();
+            if(tileItem->tilesUpdated) {
+                tileItem->tilesUpdated = false;
+                m_tiles = tileItem->tiles();
+                for(int i = 0; i < m_tiles.size(); ++i) {
+                    m_tiles[i] = Resampler::instance()->resample(this, i + 1, m_tiles[i], tileItem->resolution());
+                }
+                m_tilesUpdated = true;
+            }
+            if(hasTiles()) {
+                maskTexture = Resampler::instance()->resample(this, 0, tileItem->maskTexture(), tileItem->resolution());
+                m_offsetX = tileItem->offsetX();
+                m_offsetY = tileItem->offsetY();
+                m_columns = tileItem->columns();
+                m_rows = tileItem->rows();
+                m_scaleX = tileItem->scaleX();
+                m_scaleY = tileItem->scaleY();
+                m_scale = tileItem->tileScale();
+                m_rotationAngle = tileItem->rotationAngle();
+                m_randPosition = tileItem->randPosition();
+                m_randRotation = tileItem->randRotation();
+                m_randScale = tileItem->randScale();
+                m_maskStrength = tileItem->maskStrength();
+                if(m_inputCount != tileItem->inputsCount()) m_tilesUpdated = true;
+                m_inputCount = tileItem->inputsCount();
+                m_keepProportion = tileItem->keepProportion();
+                m_useAlpha = tileItem->useAlpha();
+                m_depthMask = tileItem->depthMask();
             }
             else {
                 tileItem->setTexture(0);
             }
         }
-        if(m_sourceTexture || m_tile1 || m_tile2 || m_tile3 || m_tile4 || m_tile5) {
+        if(hasTiles()) {
             createTile();
             tileItem->setTexture(m_tiledTexture);
             tileItem->updatePreview(m_tiledTexture);
@@ -477,9 +449,7 @@ void TileRenderer::synchronize(QQuickFramebufferObject *item) {
     }
     if(tileItem->randUpdated) {
         tileItem->randUpdated = false;
-        randomShader->bind();
-        randomShader->setUniformValue(randomShader->uniformLocation("seed"), tileItem->seed());
-        randomShader->release();
+        m_seed = tileItem->seed();
         createRandom();
         createTile();
     }
@@ -502,8 +472,9 @@ void TileRenderer::render() {
     glBindVertexArray(0);
     checkerShader->release();
 
-    if(m_sourceTexture || m_tile1 || m_tile2 || m_tile3 || m_tile4 || m_tile5) {
+    if(hasTiles()) {
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glBindVertexArray(textureVAO);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_tiledTexture);
@@ -515,39 +486,95 @@ void TileRenderer::render() {
     glFlush();
 }
 
+static int layerSide(float texels, int resolution) {
+    int side = 16;
+    while(side < texels && side < resolution) side *= 2;
+    return qMin(side, resolution);
+}
+
 void TileRenderer::createTile() {
-    glBindFramebuffer(GL_FRAMEBUFFER, tileFBO);
+    if(!hasTiles()) return;
+    float size = qMax(qMax(qAbs(m_scaleX), qAbs(m_scaleX - m_randScale)),
+                      qMax(qAbs(m_scaleY), qAbs(m_scaleY - m_randScale)))*m_scale;
+    //layers only need the texels of the largest tile, not of the whole output
+    int layerWidth = layerSide(m_resolution.x()*size/qMax(1, m_columns), m_resolution.x());
+    int layerHeight = layerSide(m_resolution.y()*size/qMax(1, m_rows), m_resolution.y());
+    if(m_tilesUpdated || m_tileArray.width != layerWidth || m_tileArray.height != layerHeight) {
+        m_tilesUpdated = false;
+        updateTileArray(layerWidth, layerHeight);
+    }
+    int count = qMin(m_columns*m_rows, maxCells);
+
+    instanceShader->bind();
+    instanceShader->setUniformValue(instanceShader->uniformLocation("offsetX"), m_offsetX);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("offsetY"), m_offsetY);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("columns"), m_columns);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("rows"), m_rows);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("scaleX"), m_scaleX);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("scaleY"), m_scaleY);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("scale"), m_scale);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("rotationAngle"), m_rotationAngle);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("randPosition"), m_randPosition);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("randRotation"), m_randRotation);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("randScale"), m_randScale);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("maskStrength"), m_maskStrength);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("inputCount"), m_layers);
+    instanceShader->setUniformValue(instanceShader->uniformLocation("depthMask"), m_depthMask);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_randomTexture);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+    glDispatchCompute(1, 1, 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    instanceShader->release();
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    //wrapped copies of every tile, enough to cover tiles reaching over the texture border
+    float reach = 0.7072f*size + 1.5f + qAbs(m_offsetX) + qAbs(m_offsetY) + qAbs(m_randPosition);
+    int copies = qCeil(reach/qMin(m_columns, m_rows));
+    int side = 2*copies + 1;
+
+    TexturePool *pool = TexturePool::instance();
+    TexturePool::Target accumulated = pool->acquire(m_resolution.x(), m_resolution.y(), GL_RGBA16F);
+    glBindFramebuffer(GL_FRAMEBUFFER, accumulated.fbo);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     glBindVertexArray(textureVAO);
     tileShader->bind();
+    tileShader->setUniformValue(tileShader->uniformLocation("columns"), m_columns);
+    tileShader->setUniformValue(tileShader->uniformLocation("rows"), m_rows);
+    tileShader->setUniformValue(tileShader->uniformLocation("keepProportion"), m_keepProportion);
+    tileShader->setUniformValue(tileShader->uniformLocation("copies"), copies);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_tileArray.texture);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count*side*side);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    tileShader->release();
+    glDisable(GL_BLEND);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, tileFBO);
+    glClear(GL_COLOR_BUFFER_BIT);
+    resolveShader->bind();
+    resolveShader->setUniformValue(resolveShader->uniformLocation("useAlpha"), m_useAlpha);
+    resolveShader->setUniformValue(resolveShader->uniformLocation("useMask"), maskTexture);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
+    glBindTexture(GL_TEXTURE_2D, accumulated.texture);
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, maskTexture);
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, m_randomTexture);
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, m_tile1);
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_2D, m_tile2);
-    glActiveTexture(GL_TEXTURE5);
-    glBindTexture(GL_TEXTURE_2D, m_tile3);
-    glActiveTexture(GL_TEXTURE6);
-    glBindTexture(GL_TEXTURE_2D, m_tile4);
-    glActiveTexture(GL_TEXTURE7);
-    glBindTexture(GL_TEXTURE_2D, m_tile5);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glActiveTexture(GL_TEXTURE0);    
-    tileShader->release();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    resolveShader->release();
     glBindVertexArray(0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    pool->release(accumulated);
     glBindTexture(GL_TEXTURE_2D, m_tiledTexture);
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
     glFlush();
-    glFinish();
 }
 
 void TileRenderer::createRandom() {
@@ -557,21 +584,55 @@ void TileRenderer::createRandom() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     randomShader->bind();
+    randomShader->setUniformValue(randomShader->uniformLocation("seed"), m_seed);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     randomShader->release();
     glBindVertexArray(0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void TileRenderer::updateTexResolution() {
-    glBindTexture(GL_TEXTURE_2D, m_tiledTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+void TileRenderer::updateTileArray(int width, int height) {
+    m_layers = qMax(1, qMin(m_inputCount, m_tiles.size()));
+    //layers keep the alpha of their inputs even when the output is gray
+    GLenum format = TextureFormat::colorFormat(m_bpc);
+    if(m_tileArray.width != width || m_tileArray.height != height || m_tileArray.layers != m_layers || m_tileArray.format != format) {
+        TexturePool *pool = TexturePool::instance();
+        pool->release(m_tileArray);
+        m_tileArray = pool->acquire(width, height, format, GL_LINEAR, m_layers);
     }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_tileArray.fbo);
+    glViewport(0, 0, width, height);
+    glDisable(GL_BLEND);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glBindVertexArray(textureVAO);
+    textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 0.0f);
+    glActiveTexture(GL_TEXTURE0);
+    for(int i = 0; i < m_layers; ++i) {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_tileArray.texture, 0, i);
+        glClear(GL_COLOR_BUFFER_BIT);
+        if(m_tiles[i] == 0) continue;
+        glBindTexture(GL_TEXTURE_2D, m_tiles[i]);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
     glBindTexture(GL_TEXTURE_2D, 0);
+    textureShader->release();
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool TileRenderer::hasTiles() {
+    for(auto tile: m_tiles) {
+        if(tile) return true;
+    }
+    return false;
+}
+
+void TileRenderer::updateTexResolution() {
+    glBindTexture(GL_TEXTURE_2D, m_tiledTexture);
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void TileRenderer::saveTexture(QString fileName) {
@@ -581,12 +642,7 @@ void TileRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -598,6 +654,7 @@ void TileRenderer::saveTexture(QString fileName) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glBindVertexArray(textureVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_tiledTexture);
@@ -606,41 +663,7 @@ void TileRenderer::saveTexture(QString fileName) {
     glBindVertexArray(0);
     textureShader->release();
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
     glDeleteFramebuffers(1, &fbo);
@@ -25,6 +25,8 @@
 #include <QQuickFramebufferObject>
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
+#include <QVector>
+#include "texturepool.h"
 
 class TileObject: public QQuickFramebufferObject
 {
@@ -38,16 +40,9 @@ public:
     void setMaskTexture(unsigned int texture);
     unsigned int sourceTexture();
     void setSourceTexture(unsigned int texture);
-    unsigned int tile1();
-    void setTile1(unsigned int texture);
-    unsigned int tile2();
-    void setTile2(unsigned int texture);
-    unsigned int tile3();
-    void setTile3(unsigned int texture);
-    unsigned int tile4();
-    void setTile4(unsigned int texture);
-    unsigned int tile5();
-    void setTile5(unsigned int texture);
+    unsigned int tile(int index);
+    void setTile(int index, unsigned int texture);
+    QVector<unsigned int> tiles();
     void saveTexture(QString fileName);
     float offsetX();
     void setOffsetX(float offset);
@@ -88,6 +83,7 @@ public:
     GLint bpc();
     void setBPC(GLint bpc);
     bool tiledTex = false;
+    bool tilesUpdated = false;
     bool randUpdated = true;
     bool selectedItem = false;
     bool resUpdated = false;
@@ -101,12 +97,7 @@ private:
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
     unsigned int m_texture = 0;
-    unsigned int m_sourceTexture = 0;
-    unsigned int m_tile1 = 0;
-    unsigned int m_tile2 = 0;
-    unsigned int m_tile3 = 0;
-    unsigned int m_tile4 = 0;
-    unsigned int m_tile5 = 0;
+    QVector<unsigned int> m_tiles = QVector<unsigned int>(1, 0);
     unsigned int m_maskTexture = 0;
     float m_offsetX = 0.0f;
     float m_offsetY = 0.0f;
@@ -137,23 +128,44 @@ public:
 private:
     void createTile();
     void createRandom();
+    void updateTileArray(int width, int height);
+    bool hasTiles();
     void updateTexResolution();
     void saveTexture(QString fileName);
     QVector2D m_resolution;
     GLint m_bpc = GL_RGBA8;
-    unsigned int m_sourceTexture = 0;
-    unsigned int m_tile1 = 0;
-    unsigned int m_tile2 = 0;
-    unsigned int m_tile3 = 0;
-    unsigned int m_tile4 = 0;
-    unsigned int m_tile5 = 0;
+    static const int maxCells = 1024;
+    QVector<unsigned int> m_tiles;
+    bool m_tilesUpdated = false;
     unsigned int m_tiledTexture = 0;
+    TexturePool::Target m_tileArray;
+    int m_layers = 0;
     unsigned int m_randomTexture = 0;
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
     unsigned int tileFBO = 0;
     unsigned int randomFBO = 0;
+    unsigned int instanceBuffer = 0;
+    float m_offsetX = 0.0f;
+    float m_offsetY = 0.0f;
+    int m_columns = 0;
+    int m_rows = 0;
+    float m_scaleX = 0.0f;
+    float m_scaleY = 0.0f;
+    float m_scale = 0.0f;
+    int m_rotationAngle = 0;
+    float m_randPosition = 0.0f;
+    float m_randRotation = 0.0f;
+    float m_randScale = 0.0f;
+    float m_maskStrength = 0.0f;
+    int m_inputCount = 0;
+    bool m_keepProportion = false;
+    bool m_useAlpha = false;
+    bool m_depthMask = false;
+    int m_seed = 1;
     QOpenGLShaderProgram *tileShader;
+    QOpenGLShaderProgram *instanceShader;
+    QOpenGLShaderProgram *resolveShader;
     QOpenGLShaderProgram *randomShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
@@ -22,6 +22,7 @@
 #include "tilenode.h"
 #include "frame.h"
 #include <iostream>
+#include "textureformat.h"
 
 TileNode::TileNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float offsetX, float offsetY,
                    int columns, int rows, float scale, float scaleX, float scaleY, int rotation,
@@ -37,22 +38,44 @@ TileNode::TileNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float of
                              m_scaleX, m_scaleY, m_rotationAngle, m_randPosition, m_randRotation,
                              m_randScale, m_maskStrength, m_inputsCount, m_seed, m_keepProportion,
                              m_useAlpha);
-    float s = scaleView();
-    setHeight((207 + 28*(m_inputsCount - 1))*s);
+    setHeight(207 + 28*(m_inputsCount - 1));
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &TileNode::previewGenerated);
     connect(preview, &TileObject::changedTexture, this, &TileNode::setOutput);
     connect(preview, &TileObject::updatePreview, this, &TileNode::updatePreview);
     connect(this, &Node::changeResolution, preview, &TileObject::setResolution);
     connect(this, &Node::changeBPC, preview, &TileObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/TileProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+    createSockets(2, 1);
+    createAdditionalInputs(5);
+    for(int i = 0; i < 5; ++i) {
+        Socket *s = m_additionalInputs[i];
+        if(i < m_inputsCount - 1) {
+            s->setVisible(true);
+        }
+        else {
+            s->setVisible(false);
+        }
+    }
+    setTitle("Tile");
+    m_socketsInput[0]->setTip("Texture");
+    m_socketsInput[1]->setTip("Mask");
+    m_additionalInputs[0]->setTip("Texture");
+    m_additionalInputs[1]->setTip("Texture");
+    m_additionalInputs[2]->setTip("Texture");
+    m_additionalInputs[3]->setTip("Texture");
+    m_additionalInputs[4]->setTip("Texture");
+}
+
+TileNode::~TileNode() {
+    delete preview;
+}
+
+void TileNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/TileProperty.qml"));
     propertiesPanel->setProperty("startOffsetX", m_offsetX);
     propertiesPanel->setProperty("startOffsetY", m_offsetY);
     propertiesPanel->setProperty("startColumns", m_columns);
@@ -69,9 +92,8 @@ TileNode::TileNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float of
     propertiesPanel->setProperty("startSeed", m_seed);
     propertiesPanel->setProperty("startKeepProportion", m_keepProportion);
     propertiesPanel->setProperty("startUseAlpha", m_useAlpha);
-    propertiesPanel->setProperty("startUseAlpha", m_depthMask);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startDepthMask", m_depthMask);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(offsetXChanged(qreal)), this, SLOT(updateOffsetX(qreal)));
     connect(propertiesPanel, SIGNAL(offsetYChanged(qreal)), this, SLOT(updateOffsetY(qreal)));
     connect(propertiesPanel, SIGNAL(columnsChanged(int)), this, SLOT(updateColums(int)));
@@ -91,77 +113,16 @@ TileNode::TileNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float of
     connect(propertiesPanel, SIGNAL(depthMaskChanged(bool)), this, SLOT(updateDepthMask(bool)));
     connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
-    createSockets(2, 1);
-    createAdditionalInputs(5);
-    for(int i = 0; i < 5; ++i) {
-        Socket *s = m_additionalInputs[i];
-        if(i < m_inputsCount - 1) {
-            s->setVisible(true);
-        }
-        else {
-            s->setVisible(false);
-        }
-    }
-    setTitle("Tile");
-    m_socketsInput[0]->setTip("Texture");
-    m_socketsInput[1]->setTip("Mask");
-    m_additionalInputs[0]->setTip("Texture");
-    m_additionalInputs[1]->setTip("Texture");
-    m_additionalInputs[2]->setTip("Texture");
-    m_additionalInputs[3]->setTip("Texture");
-    m_additionalInputs[4]->setTip("Texture");
-}
-
-TileNode::~TileNode() {
-    delete preview;
 }
 
 void TileNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *nodeInput0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(nodeInput0 && nodeInput0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *nodeInput1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(nodeInput1 && nodeInput1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
-    if(!m_additionalInputs[0]->getEdges().isEmpty()) {
-        Node *nodeInput2 = static_cast<Node*>(m_additionalInputs[0]->getEdges()[0]->startSocket()->parentItem());
-        if(nodeInput2 && nodeInput2->resolution() != m_resolution) return;
-        if(m_additionalInputs[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_additionalInputs[1]->getEdges().isEmpty()) {
-        Node *nodeInput3 = static_cast<Node*>(m_additionalInputs[1]->getEdges()[0]->startSocket()->parentItem());
-        if(nodeInput3 && nodeInput3->resolution() != m_resolution) return;
-        if(m_additionalInputs[1]->value() == 0 && deserializing) return;
-    }
-    if(!m_additionalInputs[2]->getEdges().isEmpty()) {
-        Node *nodeInput4 = static_cast<Node*>(m_additionalInputs[2]->getEdges()[0]->startSocket()->parentItem());
-        if(nodeInput4 && nodeInput4->resolution() != m_resolution) return;
-        if(m_additionalInputs[2]->value() == 0 && deserializing) return;
-    }
-    if(!m_additionalInputs[3]->getEdges().isEmpty()) {
-        Node *nodeInput5 = static_cast<Node*>(m_additionalInputs[3]->getEdges()[0]->startSocket()->parentItem());
-        if(nodeInput5 && nodeInput5->resolution() != m_resolution) return;
-        if(m_additionalInputs[3]->value() == 0 && deserializing) return;
-    }
-    if(!m_additionalInputs[4]->getEdges().isEmpty()) {
-        Node *nodeInput6 = static_cast<Node*>(m_additionalInputs[4]->getEdges()[0]->startSocket()->parentItem());
-        if(nodeInput6 && nodeInput6->resolution() != m_resolution) return;
-        if(m_additionalInputs[4]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
-    preview->setTile1(m_additionalInputs[0]->value().toUInt());
-    preview->setTile2(m_additionalInputs[1]->value().toUInt());
-    preview->setTile3(m_additionalInputs[2]->value().toUInt());
-    preview->setTile4(m_additionalInputs[3]->value().toUInt());
-    preview->setTile5(m_additionalInputs[4]->value().toUInt());
+    for(int i = 0; i < m_additionalInputs.size(); ++i) {
+        preview->setTile(i + 1, m_additionalInputs[i]->value().toUInt());
+    }
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &TileNode::getPreviewTexture() {
@@ -173,7 +134,7 @@ void TileNode::saveTexture(QString fileName) {
 }
 
 TileNode *TileNode::clone() {
-    return new TileNode(parentItem(), m_resolution, m_bpc, m_offsetX, m_offsetY, m_columns, m_rows, m_scale,
+    return new TileNode(parentItem(), m_graphResolution, m_bpc, m_offsetX, m_offsetY, m_columns, m_rows, m_scale,
                         m_scaleX, m_scaleY, m_rotationAngle, m_randPosition, m_randRotation, m_randScale,
                         m_maskStrength, m_inputsCount, m_seed, m_keepProportion, m_useAlpha, m_depthMask);
 }
@@ -262,23 +223,23 @@ void TileNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash
             s->setVisible(false);
         }
     }
-    propertiesPanel->setProperty("startOffsetX", m_offsetX);
-    propertiesPanel->setProperty("startOffsetY", m_offsetY);
-    propertiesPanel->setProperty("startColumns", m_columns);
-    propertiesPanel->setProperty("startRows", m_rows);
-    propertiesPanel->setProperty("startTileScale", m_scale);
-    propertiesPanel->setProperty("startScaleX", m_scaleX);
-    propertiesPanel->setProperty("startScaleY", m_scaleY);
-    propertiesPanel->setProperty("startRotation", m_rotationAngle);
-    propertiesPanel->setProperty("startRandPosition", m_randPosition);
-    propertiesPanel->setProperty("startRandRotation", m_randRotation);
-    propertiesPanel->setProperty("startRandScale", m_randScale);
-    propertiesPanel->setProperty("startMask", m_maskStrength);
-    propertiesPanel->setProperty("startInputsCount", m_inputsCount);
-    propertiesPanel->setProperty("startSeed", m_seed);
-    propertiesPanel->setProperty("startKeepProportion", m_keepProportion);
-    propertiesPanel->setProperty("startUseAlpha", m_useAlpha);
-    propertiesPanel->setProperty("startDepthMask", m_depthMask);
+    setPropertyOnPanel("startOffsetX", m_offsetX);
+    setPropertyOnPanel("startOffsetY", m_offsetY);
+    setPropertyOnPanel("startColumns", m_columns);
+    setPropertyOnPanel("startRows", m_rows);
+    setPropertyOnPanel("startTileScale", m_scale);
+    setPropertyOnPanel("startScaleX", m_scaleX);
+    setPropertyOnPanel("startScaleY", m_scaleY);
+    setPropertyOnPanel("startRotation", m_rotationAngle);
+    setPropertyOnPanel("startRandPosition", m_randPosition);
+    setPropertyOnPanel("startRandRotation", m_randRotation);
+    setPropertyOnPanel("startRandScale", m_randScale);
+    setPropertyOnPanel("startMask", m_maskStrength);
+    setPropertyOnPanel("startInputsCount", m_inputsCount);
+    setPropertyOnPanel("startSeed", m_seed);
+    setPropertyOnPanel("startKeepProportion", m_keepProportion);
+    setPropertyOnPanel("startUseAlpha", m_useAlpha);
+    setPropertyOnPanel("startDepthMask", m_depthMask);
 
     preview->setOffsetX(m_offsetX);
     preview->setOffsetY(m_offsetY);
@@ -298,8 +259,7 @@ void TileNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash
     preview->setUseAlpha(m_useAlpha);
     preview->setDepthMask(m_depthMask);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
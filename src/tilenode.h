@@ -109,6 +109,8 @@ public slots:
     void updateKeepProportion(bool keep);
     void updateUseAlpha(bool use);
     void updateDepthMask(bool depth);
+protected:
+    void createPropertiesPanel() override;
 private:
     TileObject *preview;
     float m_offsetX = 0.0f;
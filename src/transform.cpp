@@ -20,8 +20,12 @@
  */
 
 #include "transform.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include "QOpenGLFramebufferObjectFormat"
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 TransformObject::TransformObject(QQuickItem *parent, QVector2D resolution, GLint bpc, float transX,
                                  float transY, float scaleX, float scaleY, int angle, bool clamp):
@@ -150,25 +154,15 @@ void TransformObject::setBPC(GLint bpc) {
 
 TransformRenderer::TransformRenderer(QVector2D resolution, GLint bpc): m_resolution(resolution), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    transformShader = new QOpenGLShaderProgram();
-    transformShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    transformShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/transform.frag");
-    transformShader->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    textureShader = new QOpenGLShaderProgram();
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    textureShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    textureShader->link();
+    transformShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/transform.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    textureShader = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     transformShader->bind();
     transformShader->setUniformValue(transformShader->uniformLocation("transTexture"), 0);
     transformShader->setUniformValue(transformShader->uniformLocation("maskTexture"), 1);
     transformShader->release();
     textureShader->bind();
     textureShader->setUniformValue(textureShader->uniformLocation("textureSample"), 0);
-    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     textureShader->release();
     float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
                     -1.0f, 1.0f, 0.0f, 1.0f,
@@ -190,12 +184,7 @@ TransformRenderer::TransformRenderer(QVector2D resolution, GLint bpc): m_resolut
     glBindFramebuffer(GL_FRAMEBUFFER, transformFBO);
     glGenTextures(1, &m_transformedTexture);
     glBindTexture(GL_TEXTURE_2D, m_transformedTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -209,9 +198,10 @@ TransformRenderer::TransformRenderer(QVector2D resolution, GLint bpc): m_resolut
 }
 
 TransformRenderer::~TransformRenderer() {
-    delete transformShader;
-    delete checkerShader;
-    delete textureShader;
+    Resampler::release(this);
+    ShaderCache::release(transformShader);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(textureShader);
     glDeleteTextures(1, &m_transformedTexture);
     glDeleteFramebuffers(1, &transformFBO);
     glDeleteVertexArrays(1, &textureVAO);
@@ -238,16 +228,13 @@ void TransformRenderer::synchronize(QQuickFramebufferObject *item) {
         }
         if(transformItem->transformedTex) {
             transformItem->transformedTex = false;
-            m_sourceTexture = transformItem->sourceTexture();
+            m_sourceTexture = Resampler::instance()->resample(this, 0, transformItem->sourceTexture(), transformItem->resolution());
             if(m_sourceTexture) {
-                maskTexture = transformItem->maskTexture();
-                transformShader->bind();
-                transformShader->setUniformValue(transformShader->uniformLocation("translate"), QVector2D(transformItem->translateX(), transformItem->translateY()));
-                transformShader->setUniformValue(transformShader->uniformLocation("scale"), QVector2D(transformItem->scaleX(), transformItem->scaleY()));
-                transformShader->setUniformValue(transformShader->uniformLocation("angle"), transformItem->rotation());
-                transformShader->setUniformValue(transformShader->uniformLocation("clampTrans"), transformItem->clampCoords());
-                transformShader->setUniformValue(transformShader->uniformLocation("useMask"), maskTexture);
-                transformShader->release();
+                maskTexture = Resampler::instance()->resample(this, 1, transformItem->maskTexture(), transformItem->resolution());
+                m_translate = QVector2D(transformItem->translateX(), transformItem->translateY());
+                m_scale = QVector2D(transformItem->scaleX(), transformItem->scaleY());
+                m_angle = transformItem->rotation();
+                m_clampTrans = transformItem->clampCoords();
             }
         }
         if(m_sourceTexture) {
@@ -278,6 +265,7 @@ void TransformRenderer::render() {
     if (m_sourceTexture) {
         glBindVertexArray(textureVAO);
         textureShader->bind();
+        textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, m_transformedTexture);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -294,6 +282,11 @@ void TransformRenderer::transformateTexture() {
     glClearColor(0.0f ,0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     transformShader->bind();
+    transformShader->setUniformValue(transformShader->uniformLocation("translate"), m_translate);
+    transformShader->setUniformValue(transformShader->uniformLocation("scale"), m_scale);
+    transformShader->setUniformValue(transformShader->uniformLocation("angle"), m_angle);
+    transformShader->setUniformValue(transformShader->uniformLocation("clampTrans"), m_clampTrans);
+    transformShader->setUniformValue(transformShader->uniformLocation("useMask"), maskTexture);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_sourceTexture);
     glActiveTexture(GL_TEXTURE1);
@@ -312,12 +305,7 @@ void TransformRenderer::transformateTexture() {
 
 void TransformRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, m_transformedTexture);
-    if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
-    else if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -328,12 +316,7 @@ void TransformRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -346,6 +329,7 @@ void TransformRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     textureShader->bind();
+    textureShader->setUniformValue(textureShader->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_transformedTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -353,41 +337,7 @@ void TransformRenderer::saveTexture(QString fileName) {
     textureShader->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
     glDeleteFramebuffers(1, &fbo);
@@ -96,6 +96,10 @@ private:
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
     unsigned int transformFBO = 0;
+    QVector2D m_translate;
+    QVector2D m_scale;
+    int m_angle = 0;
+    bool m_clampTrans = false;
     QOpenGLShaderProgram *transformShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
@@ -20,6 +20,7 @@
  */
 
 #include "transformnode.h"
+#include "textureformat.h"
 
 TransformNode::TransformNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float transX,
                              float transY, float scaleX, float scaleY, int angle, bool clamp):
@@ -28,29 +29,35 @@ TransformNode::TransformNode(QQuickItem *parent, QVector2D resolution, GLint bpc
 {
     preview = new TransformObject(grNode, m_resolution, m_bpc, m_transX, m_transY, m_scaleX, m_scaleY,
                                   m_angle, m_clamp);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &TransformNode::previewGenerated);
     connect(preview, &TransformObject::textureChanged, this, &TransformNode::setOutput);
     connect(preview, &TransformObject::updatePreview, this, &TransformNode::updatePreview);
     connect(this, &Node::changeResolution, preview, &TransformObject::setResolution);
     connect(this, &Node::changeBPC, preview, &TransformObject::setBPC);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/TransformProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+    createSockets(2, 1);
+    setTitle("Transform");
+    m_socketsInput[0]->setTip("Texture");
+    m_socketsInput[1]->setTip("Mask");
+}
+
+TransformNode::~TransformNode() {
+    delete preview;
+}
+
+void TransformNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/TransformProperty.qml"));
     propertiesPanel->setProperty("startTransX", m_transX);
     propertiesPanel->setProperty("startTransY", m_transY);
     propertiesPanel->setProperty("startScaleX", m_scaleX);
     propertiesPanel->setProperty("startScaleY", m_scaleY);
     propertiesPanel->setProperty("startRotation", m_angle);
     propertiesPanel->setProperty("startClamp", m_clamp);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(transXChanged(qreal)), this, SLOT(updateTranslationX(qreal)));
     connect(propertiesPanel, SIGNAL(transYChanged(qreal)), this, SLOT(updateTranslationY(qreal)));
     connect(propertiesPanel, SIGNAL(scaleXChanged(qreal)), this, SLOT(updateScaleX(qreal)));
@@ -59,33 +66,14 @@ TransformNode::TransformNode(QQuickItem *parent, QVector2D resolution, GLint bpc
     connect(propertiesPanel, SIGNAL(clampCoordsChanged(bool)), this, SLOT(updateClampCoords(bool)));
     connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
-    createSockets(2, 1);
-    setTitle("Transform");
-    m_socketsInput[0]->setTip("Texture");
-    m_socketsInput[1]->setTip("Mask");
-}
-
-TransformNode::~TransformNode() {
-    delete preview;
 }
 
 void TransformNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode2 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode2 && inputNode2->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[1]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &TransformNode::getPreviewTexture() {
@@ -97,7 +85,7 @@ void TransformNode::saveTexture(QString fileName) {
 }
 
 TransformNode *TransformNode::clone() {
-    return new TransformNode(parentItem(), m_resolution, m_bpc, m_transX, m_transY, m_scaleX, m_scaleY,
+    return new TransformNode(parentItem(), m_graphResolution, m_bpc, m_transX, m_transY, m_scaleX, m_scaleY,
                              m_angle, m_clamp);
 }
 
@@ -132,14 +120,13 @@ void TransformNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *>
     if(json.contains("clamp")) {
         m_clamp = json["clamp"].toVariant().toBool();
     }
-    propertiesPanel->setProperty("startTransX", m_transX);
-    propertiesPanel->setProperty("startTransY", m_transY);
-    propertiesPanel->setProperty("startScaleX", m_scaleX);
-    propertiesPanel->setProperty("startScaleY", m_scaleY);
-    propertiesPanel->setProperty("startRotation", m_angle);
-    propertiesPanel->setProperty("startClamp", m_clamp);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startTransX", m_transX);
+    setPropertyOnPanel("startTransY", m_transY);
+    setPropertyOnPanel("startScaleX", m_scaleX);
+    setPropertyOnPanel("startScaleY", m_scaleY);
+    setPropertyOnPanel("startRotation", m_angle);
+    setPropertyOnPanel("startClamp", m_clamp);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->setTranslateX(m_transX);
     preview->setTranslateY(m_transY);
@@ -65,6 +65,8 @@ public slots:
     void updateScaleY(qreal y);
     void updateRotation(int angle);
     void updateClampCoords(bool clamp);
+protected:
+    void createPropertiesPanel() override;
 private:
     TransformObject *preview;
     float m_transX = 0.0f;
@@ -21,8 +21,12 @@
 
 #include <iostream>
 #include "voronoi.h"
+#include "shadercache.h"
+#include "textureexporter.h"
 #include <QOpenGLFramebufferObjectFormat>
 #include "FreeImage.h"
+#include "textureformat.h"
+#include "resampler.h"
 
 VoronoiObject::VoronoiObject(QQuickItem *parent, QVector2D resolution, GLint bpc, QString voronoiType,
                              int scale, int scaleX, int scaleY, float jitter, bool inverse, float intensity,
@@ -175,24 +179,16 @@ void VoronoiObject::setBPC(GLint bpc) {
 
 VoronoiRenderer::VoronoiRenderer(QVector2D res, GLint bpc): m_resolution(res), m_bpc(bpc) {
     initializeOpenGLFunctions();
-    generateVoronoi = new QOpenGLShaderProgram();
-    generateVoronoi->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/noise.vert");
-    generateVoronoi->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/voronoi.frag");
-    generateVoronoi->link();
-    checkerShader = new QOpenGLShaderProgram();
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/checker.vert");
-    checkerShader->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/checker.frag");
-    checkerShader->link();
-    renderTexture = new QOpenGLShaderProgram();
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/texture.vert");
-    renderTexture->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/texture.frag");
-    renderTexture->link();
+    generateVoronoi = ShaderCache::acquire(":/shaders/noise.vert", ":/shaders/voronoi.frag");
+    checkerShader = ShaderCache::acquire(":/shaders/checker.vert", ":/shaders/checker.frag");
+    renderTexture = ShaderCache::acquire(":/shaders/texture.vert", ":/shaders/texture.frag");
     generateVoronoi->bind();
     generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("maskTexture"), 0);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("pointsTexture"), 1);
     generateVoronoi->release();
+    featurePoints = new CellTable(":/shaders/voronoipoints.comp", GL_RG32F);
     renderTexture->bind();
     renderTexture->setUniformValue(renderTexture->uniformLocation("texture"), 0);
-    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     renderTexture->release();
     float vertQuad[] = {-1.0f, -1.0f,
                     -1.0f, 1.0f,
@@ -237,12 +233,7 @@ VoronoiRenderer::VoronoiRenderer(QVector2D res, GLint bpc): m_resolution(res), m
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, 2);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, voronoiTexture, 0);    
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -250,9 +241,11 @@ VoronoiRenderer::VoronoiRenderer(QVector2D res, GLint bpc): m_resolution(res), m
 }
 
 VoronoiRenderer::~VoronoiRenderer() {
-    delete generateVoronoi;
-    delete  checkerShader;
-    delete renderTexture;
+    Resampler::release(this);
+    ShaderCache::release(generateVoronoi);
+    ShaderCache::release(checkerShader);
+    ShaderCache::release(renderTexture);
+    delete featurePoints;
     glDeleteTextures(1, &voronoiTexture);
     glDeleteFramebuffers(1, &voronoiFBO);
     glDeleteVertexArrays(1, &voronoiVAO);
@@ -285,18 +278,15 @@ void VoronoiRenderer::synchronize(QQuickFramebufferObject *item) {
         if(voronoiItem->generatedVoronoi) {
             voronoiItem->generatedVoronoi = false;
             m_voronoiType = voronoiItem->voronoiType();
-            maskTexture = voronoiItem->maskTexture();
-            generateVoronoi->bind();
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("scale"), voronoiItem->voronoiScale());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("scaleX"), voronoiItem->scaleX());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("scaleY"), voronoiItem->scaleY());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("jitter"), voronoiItem->jitter());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("inverse"), voronoiItem->inverse());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("intensity"), voronoiItem->intensity());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("bordersSize"), voronoiItem->bordersSize());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("seed"), voronoiItem->seed());
-            generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("useMask"), maskTexture);
-            generateVoronoi->release();
+            maskTexture = Resampler::instance()->resample(this, 0, voronoiItem->maskTexture(), voronoiItem->resolution());
+            m_scale = voronoiItem->voronoiScale();
+            m_scaleX = voronoiItem->scaleX();
+            m_scaleY = voronoiItem->scaleY();
+            m_jitter = voronoiItem->jitter();
+            m_inverse = voronoiItem->inverse();
+            m_intensity = voronoiItem->intensity();
+            m_bordersSize = voronoiItem->bordersSize();
+            m_seed = voronoiItem->seed();
         }
         createVoronoi();
         voronoiItem->setTexture(voronoiTexture);
@@ -323,6 +313,7 @@ void VoronoiRenderer::render() {
 
     glBindVertexArray(textureVAO);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, voronoiTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -333,6 +324,7 @@ void VoronoiRenderer::render() {
 }
 
 void VoronoiRenderer::createVoronoi() {
+    unsigned int points = featurePoints->update(QSize(m_scale*m_scaleX, m_scale*m_scaleY), m_seed);
     glDisable(GL_BLEND);
     glBindFramebuffer(GL_FRAMEBUFFER, voronoiFBO);
     glViewport(0, 0, m_resolution.x(), m_resolution.y());
@@ -340,9 +332,19 @@ void VoronoiRenderer::createVoronoi() {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(voronoiVAO);
     generateVoronoi->bind();
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("scale"), m_scale);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("scaleX"), m_scaleX);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("scaleY"), m_scaleY);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("jitter"), m_jitter);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("inverse"), m_inverse);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("intensity"), m_intensity);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("bordersSize"), m_bordersSize);
+    generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("useMask"), maskTexture);
     GLuint index = glGetSubroutineIndex(generateVoronoi->programId(), GL_FRAGMENT_SHADER, m_voronoiType.toStdString().c_str());
     glUniformSubroutinesuiv(GL_FRAGMENT_SHADER, 1, &index);
     generateVoronoi->setUniformValue(generateVoronoi->uniformLocation("res"), m_resolution);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, points);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, maskTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);    
@@ -358,12 +360,7 @@ void VoronoiRenderer::createVoronoi() {
 
 void VoronoiRenderer::updateTexResolution() {
     glBindTexture(GL_TEXTURE_2D, voronoiTexture);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, m_bpc, m_resolution.x(), m_resolution.y());
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -374,12 +371,7 @@ void VoronoiRenderer::saveTexture(QString fileName) {
     glGenTextures(1, &tex);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     glBindTexture(GL_TEXTURE_2D, tex);
-    if(m_bpc == GL_RGBA16) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
-    }
-    else if(m_bpc == GL_RGBA8) {
-        glTexImage2D(GL_TEXTURE_2D, 0, m_bpc, m_resolution.x(), m_resolution.y(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    TextureFormat::allocate(this, TextureFormat::exportFormat(m_bpc), m_resolution.x(), m_resolution.y());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -392,6 +384,7 @@ void VoronoiRenderer::saveTexture(QString fileName) {
     glClear(GL_COLOR_BUFFER_BIT);
     glBindVertexArray(textureVAO);
     renderTexture->bind();
+    renderTexture->setUniformValue(renderTexture->uniformLocation("lod"), 2.0f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, voronoiTexture);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -399,41 +392,7 @@ void VoronoiRenderer::saveTexture(QString fileName) {
     renderTexture->release();
     glBindVertexArray(0);
 
-    if(m_bpc == GL_RGBA16) {
-        GLushort *pixels = (GLushort*)malloc(sizeof(GLushort)*4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_SHORT, pixels);
-        FIBITMAP *image16 = FreeImage_AllocateT(FIT_RGBA16, m_resolution.x(), m_resolution.y());
-        int m_width = FreeImage_GetWidth(image16);
-        int m_height = FreeImage_GetHeight(image16);
-        for(int y = 0; y < m_height; ++y) {
-            FIRGBA16 *bits = (FIRGBA16*)FreeImage_GetScanLine(image16, y);
-            for(int x = 0; x < m_width; ++x) {
-                bits[x].red = pixels[(m_width*(m_height - 1 - y) + x)*4 + 2];
-                bits[x].green = pixels[(m_width*(m_height - 1 - y) + x)*4 + 1];
-                bits[x].blue = pixels[(m_width*(m_height - 1 - y) + x)*4];
-                bits[x].alpha = pixels[(m_width*(m_height - 1 - y) + x)*4 + 3];
-            }
-        }
-        if (FreeImage_Save(FIF_PNG, image16, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image16);
-        delete [] pixels;
-    }
-    else if(m_bpc == GL_RGBA8) {
-        BYTE *pixels = (BYTE*)malloc(4*m_resolution.x()*m_resolution.y());
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glReadPixels(0, 0, m_resolution.x(), m_resolution.y(), GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        FIBITMAP *image = FreeImage_ConvertFromRawBits(pixels, m_resolution.x(), m_resolution.y(), 4 * m_resolution.x(), 32, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
-        if (FreeImage_Save(FIF_PNG, image, fileName.toUtf8().constData(), 0))
-            printf("Successfully saved!\n");
-        else
-            printf("Failed saving!\n");
-        FreeImage_Unload(image);
-        delete [] pixels;
-    }
+    TextureExporter::instance()->read(fbo, fileName, m_resolution.x(), m_resolution.y(), m_bpc);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDeleteTextures(1, &tex);
     glDeleteFramebuffers(1, &fbo);
@@ -25,6 +25,7 @@
 #include <QQuickFramebufferObject>
 #include <QOpenGLFunctions_4_4_Core>
 #include <QOpenGLShaderProgram>
+#include "celltable.h"
 
 class VoronoiObject: public QQuickFramebufferObject
 {
@@ -96,9 +97,18 @@ private:
     void createVoronoi();
     void updateTexResolution();
     void saveTexture(QString fileName);
+    int m_scale = 0;
+    int m_scaleX = 0;
+    int m_scaleY = 0;
+    float m_jitter = 0.0f;
+    bool m_inverse = false;
+    float m_intensity = 0.0f;
+    float m_bordersSize = 0.0f;
+    int m_seed = 0;
     QOpenGLShaderProgram *generateVoronoi;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *renderTexture;
+    CellTable *featurePoints;
     unsigned int voronoiFBO;
     unsigned int voronoiVAO, textureVAO;
     unsigned int voronoiTexture;
@@ -21,6 +21,7 @@
 
 #include "voronoinode.h"
 #include <iostream>
+#include "textureformat.h"
 
 VoronoiNode::VoronoiNode(QQuickItem *parent, QVector2D resolution, GLint bpc, VoronoiParams crystals,
                          VoronoiParams borders, VoronoiParams solid, VoronoiParams worley,
@@ -29,12 +30,11 @@ VoronoiNode::VoronoiNode(QQuickItem *parent, QVector2D resolution, GLint bpc, Vo
 {
     preview = new VoronoiObject(grNode, m_resolution, m_bpc, m_voronoiType, voronoiScale(), scaleX(),
                                 scaleY(), jitter(), inverse(), intensity(), bordersSize());
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
-    preview->setWidth(174*s);
-    preview->setHeight(174*s);
-    preview->setX(3*s);
-    preview->setY(30*s);
+    preview->setWidth(174);
+    preview->setHeight(174);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &VoronoiNode::generatePreview, this, &VoronoiNode::previewGenerated);
     connect(preview, &VoronoiObject::changedTexture, this, &VoronoiNode::setOutput);
     connect(preview, &VoronoiObject::updatePreview, this, &VoronoiNode::updatePreview);
@@ -44,9 +44,14 @@ VoronoiNode::VoronoiNode(QQuickItem *parent, QVector2D resolution, GLint bpc, Vo
     createSockets(1, 1);
     m_socketsInput[0]->setTip("Mask");
     setTitle("Voronoi");
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/VoronoiProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
+}
+
+VoronoiNode::~VoronoiNode() {
+    delete preview;
+}
+
+void VoronoiNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/VoronoiProperty.qml"));
     int index = 0;
     if(m_voronoiType == "borders") index = 1;
     else if(m_voronoiType == "solid") index = 2;
@@ -60,8 +65,7 @@ VoronoiNode::VoronoiNode(QQuickItem *parent, QVector2D resolution, GLint bpc, Vo
     propertiesPanel->setProperty("startInverse", inverse());
     propertiesPanel->setProperty("startBorders", bordersSize());
     propertiesPanel->setProperty("startSeed", seed());
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
     connect(propertiesPanel, SIGNAL(voronoiTypeChanged(QString)), this, SLOT(updateVoronoiType(QString)));
     connect(propertiesPanel, SIGNAL(voronoiScaleChanged(int)), this, SLOT(updateVoronoiScale(int)));
     connect(propertiesPanel, SIGNAL(scaleXChanged(int)), this, SLOT(updateScaleX(int)));
@@ -75,19 +79,9 @@ VoronoiNode::VoronoiNode(QQuickItem *parent, QVector2D resolution, GLint bpc, Vo
     connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
 }
 
-VoronoiNode::~VoronoiNode() {
-    delete preview;
-}
-
 void VoronoiNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode && inputNode->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value().toUInt() == 0 && deserializing) return;
-    }
     preview->setMaskTexture(m_socketsInput[0]->value().toUInt());
-    if(deserializing) deserializing = false;
 }
 
 unsigned int &VoronoiNode::getPreviewTexture() {
@@ -99,7 +93,7 @@ void VoronoiNode::saveTexture(QString fileName) {
 }
 
 VoronoiNode *VoronoiNode::clone() {
-    return new VoronoiNode(parentItem(), m_resolution, m_bpc, m_crystals, m_borders, m_solid, m_worley,
+    return new VoronoiNode(parentItem(), m_graphResolution, m_bpc, m_crystals, m_borders, m_solid, m_worley,
                            m_voronoiType);
 }
 
@@ -254,15 +248,15 @@ void VoronoiNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &h
         if(m_voronoiType == "borders") index = 1;
         else if(m_voronoiType == "solid") index = 2;
         else if(m_voronoiType == "worley") index = 3;
-        propertiesPanel->setProperty("type", index);
-        propertiesPanel->setProperty("startScale", voronoiScale());
-        propertiesPanel->setProperty("startScaleX", scaleX());
-        propertiesPanel->setProperty("startScaleY", scaleY());
-        propertiesPanel->setProperty("startJitter", jitter());
-        propertiesPanel->setProperty("startInverse", inverse());
-        propertiesPanel->setProperty("startIntensity", intensity());
-        propertiesPanel->setProperty("startBorders", bordersSize());
-        propertiesPanel->setProperty("startSeed", seed());
+        setPropertyOnPanel("type", index);
+        setPropertyOnPanel("startScale", voronoiScale());
+        setPropertyOnPanel("startScaleX", scaleX());
+        setPropertyOnPanel("startScaleY", scaleY());
+        setPropertyOnPanel("startJitter", jitter());
+        setPropertyOnPanel("startInverse", inverse());
+        setPropertyOnPanel("startIntensity", intensity());
+        setPropertyOnPanel("startBorders", bordersSize());
+        setPropertyOnPanel("startSeed", seed());
 
         preview->setVoronoiScale(voronoiScale());
         preview->setScaleX(scaleX());
@@ -272,8 +266,7 @@ void VoronoiNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &h
         preview->setBordersSize(bordersSize());
         preview->setSeed(seed());
     }
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
@@ -302,14 +295,14 @@ void VoronoiNode::setVoronoiType(QString type) {
     if(m_voronoiType == type) return;
     m_voronoiType = type;
     voronoiTypeChanged(type);
-    propertiesPanel->setProperty("startScale", voronoiScale());
-    propertiesPanel->setProperty("startScaleX", scaleX());
-    propertiesPanel->setProperty("startScaleY", scaleY());
-    propertiesPanel->setProperty("startJitter", jitter());
-    propertiesPanel->setProperty("startIntensity", intensity());
-    propertiesPanel->setProperty("startInverse", inverse());
-    propertiesPanel->setProperty("startBorders", bordersSize());
-    propertiesPanel->setProperty("startSeed", seed());
+    setPropertyOnPanel("startScale", voronoiScale());
+    setPropertyOnPanel("startScaleX", scaleX());
+    setPropertyOnPanel("startScaleY", scaleY());
+    setPropertyOnPanel("startJitter", jitter());
+    setPropertyOnPanel("startIntensity", intensity());
+    setPropertyOnPanel("startInverse", inverse());
+    setPropertyOnPanel("startBorders", bordersSize());
+    setPropertyOnPanel("startSeed", seed());
 
     preview->setVoronoiScale(voronoiScale());
     preview->setScaleX(scaleX());
@@ -95,6 +95,8 @@ public slots:
     void updateIntensity(qreal intensity);
     void updateBordersSize(qreal size);
     void updateSeed(int seed);
+protected:
+    void createPropertiesPanel() override;
 private:
     VoronoiObject *preview;
     QString m_voronoiType = "crystals";
@@ -85,6 +85,7 @@ private:
     unsigned int maskTexture = 0;
     unsigned int textureVAO = 0;
     unsigned int warpFBO = 0;
+    float m_intensity = 0.0f;
     QOpenGLShaderProgram *warpShader;
     QOpenGLShaderProgram *checkerShader;
     QOpenGLShaderProgram *textureShader;
@@ -20,32 +20,22 @@
  */
 
 #include "warpnode.h"
+#include "textureformat.h"
 
 WarpNode::WarpNode(QQuickItem *parent, QVector2D resolution, GLint bpc, float intensity):
     Node(parent, resolution, bpc), m_intensity(intensity)
 {
     preview = new WarpObject(grNode, m_resolution, m_bpc, m_intensity);
-    float s = scaleView();
     preview->setTransformOrigin(TopLeft);
     preview->setWidth(174);
     preview->setHeight(174);
-    preview->setX(3*s);
-    preview->setY(30*s);
-    preview->setScale(s);
+    preview->setX(3);
+    preview->setY(30);
     connect(this, &Node::generatePreview, this, &WarpNode::previewGenerated);
     connect(preview, &WarpObject::changedTexture, this, &WarpNode::setOutput);
     connect(this, &Node::changeResolution, preview, &WarpObject::setResolution);
     connect(this, &Node::changeBPC, preview, &WarpObject::setBPC);
     connect(preview, &WarpObject::updatePreview, this, &WarpNode::updatePreview);
-    propView = new QQuickView();
-    propView->setSource(QUrl(QStringLiteral("qrc:/qml/WarpProperty.qml")));
-    propertiesPanel = qobject_cast<QQuickItem*>(propView->rootObject());
-    propertiesPanel->setProperty("startIntensity", m_intensity);
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
-    connect(propertiesPanel, SIGNAL(intensityChanged(qreal)), this, SLOT(updateIntensity(qreal)));
-    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
-    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
     createSockets(3, 1);
     setTitle("Warp");
     m_socketsInput[0]->setTip("Source");
@@ -57,29 +47,22 @@ WarpNode::~WarpNode() {
     delete preview;
 }
 
+void WarpNode::createPropertiesPanel() {
+    propertiesPanel = QmlLoader::create(QStringLiteral("qrc:/qml/WarpProperty.qml"));
+    propertiesPanel->setProperty("startIntensity", m_intensity);
+    propertiesPanel->setProperty("startBits", TextureFormat::index(m_bpc));
+    connect(propertiesPanel, SIGNAL(intensityChanged(qreal)), this, SLOT(updateIntensity(qreal)));
+    connect(propertiesPanel, SIGNAL(bitsChanged(int)), this, SLOT(bpcUpdate(int)));
+    connect(propertiesPanel, SIGNAL(propertyChangingFinished(QString, QVariant, QVariant)), this, SLOT(propertyChanged(QString, QVariant, QVariant)));
+}
+
 void WarpNode::operation() {
     preview->selectedItem = selected();
-    if(!m_socketsInput[0]->getEdges().isEmpty()) {
-        Node *inputNode0 = static_cast<Node*>(m_socketsInput[0]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode0 && inputNode0->resolution() != m_resolution) return;
-        if(m_socketsInput[0]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[1]->getEdges().isEmpty()) {
-        Node *inputNode1 = static_cast<Node*>(m_socketsInput[1]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode1 && inputNode1->resolution() != m_resolution) return;
-        if(m_socketsInput[1]->value() == 0 && deserializing) return;
-    }
-    if(!m_socketsInput[2]->getEdges().isEmpty()) {
-        Node *inputNode2 = static_cast<Node*>(m_socketsInput[2]->getEdges()[0]->startSocket()->parentItem());
-        if(inputNode2 && inputNode2->resolution() != m_resolution) return;
-        if(m_socketsInput[2]->value() == 0 && deserializing) return;
-    }
     preview->setSourceTexture(m_socketsInput[0]->value().toUInt());
     preview->setWarpTexture(m_socketsInput[1]->value().toUInt());
     preview->setMaskTexture(m_socketsInput[2]->value().toUInt());
     if(m_socketsInput[0]->countEdge() == 0) m_socketOutput[0]->setValue(0);
     preview->update();
-    deserializing = false;
 }
 
 unsigned int &WarpNode::getPreviewTexture() {
@@ -91,7 +74,7 @@ void WarpNode::saveTexture(QString fileName) {
 }
 
 WarpNode *WarpNode::clone() {
-    return new WarpNode(parentItem(), m_resolution, m_bpc, m_intensity);
+    return new WarpNode(parentItem(), m_graphResolution, m_bpc, m_intensity);
 }
 
 void WarpNode::serialize(QJsonObject &json) const{
@@ -105,12 +88,11 @@ void WarpNode::deserialize(const QJsonObject &json, QHash<QUuid, Socket *> &hash
     if(json.contains("intensity")) {
         m_intensity = json["intensity"].toVariant().toFloat();
     }
-    propertiesPanel->setProperty("startIntensity", m_intensity);
+    setPropertyOnPanel("startIntensity", m_intensity);
 
     preview->setIntensity(m_intensity);
 
-    if(m_bpc == GL_RGBA8) propertiesPanel->setProperty("startBits", 0);
-    else if(m_bpc == GL_RGBA16) propertiesPanel->setProperty("startBits", 1);
+    setPropertyOnPanel("startBits", TextureFormat::index(m_bpc));
 
     preview->update();
 }
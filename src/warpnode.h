@@ -45,6 +45,8 @@ public slots:
     void previewGenerated();
     void setOutput();
     void updateIntensity(qreal intensity);
+protected:
+    void createPropertiesPanel() override;
 private:
     WarpObject *preview;
     float m_intensity = 0.1f;
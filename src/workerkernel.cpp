@@ -0,0 +1,176 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "workerkernel.h"
+#include "glworker.h"
+#include "textureformat.h"
+
+QList<WorkerKernel*> WorkerKernel::m_kernels;
+QMutex WorkerKernel::m_kernelsMutex;
+
+WorkerKernel::WorkerKernel() {
+    QMutexLocker locker(&m_kernelsMutex);
+    m_kernels.append(this);
+}
+
+WorkerKernel::~WorkerKernel() {
+    {
+        QMutexLocker locker(&m_kernelsMutex);
+        m_kernels.removeOne(this);
+    }
+    if(m_ready >= 0) {
+        glDeleteSync(m_fence);
+        GLWorker::instance()->m_unpublished.deref();
+    }
+    if(!m_initialized) return;
+    glDeleteTextures(2, m_textures);
+    glDeleteFramebuffers(1, &outputFBO);
+    glDeleteVertexArrays(1, &textureVAO);
+}
+
+void WorkerKernel::setItem(QQuickItem *item) {
+    QMutexLocker locker(&m_mutex);
+    m_item = item;
+}
+
+unsigned int WorkerKernel::texture() {
+    QMutexLocker locker(&m_mutex);
+    return m_front < 0 ? 0 : m_textures[m_front];
+}
+
+bool WorkerKernel::publish(QOpenGLFunctions_4_4_Core *gl) {
+    QMutexLocker locker(&m_mutex);
+    if(m_ready < 0) return false;
+    gl->glWaitSync(m_fence, 0, GL_TIMEOUT_IGNORED);
+    gl->glDeleteSync(m_fence);
+    m_fence = nullptr;
+    m_front = m_ready;
+    m_ready = -1;
+    GLWorker::instance()->m_unpublished.deref();
+    return true;
+}
+
+int WorkerKernel::nextGeneration() {
+    return m_generation.fetchAndAddOrdered(1) + 1;
+}
+
+bool WorkerKernel::isBusy(const QQuickItem *item) {
+    //a kernel of the item or of one of its children is queued, running or has an unpublished output,
+    //the queue is checked first because a finished job leaves its output ready before it leaves the queue
+    QMutexLocker locker(&m_kernelsMutex);
+    for(auto kernel: m_kernels) {
+        QMutexLocker kernelLocker(&kernel->m_mutex);
+        QQuickItem *kernelItem = kernel->m_item;
+        if(!kernelItem || (kernelItem != item && !item->isAncestorOf(kernelItem))) continue;
+        kernelLocker.unlock();
+        if(GLWorker::instance()->hasJob(kernel)) return true;
+        kernelLocker.relock();
+        if(kernel->m_ready >= 0) return true;
+    }
+    return false;
+}
+
+bool WorkerKernel::initialize() {
+    if(m_initialized) return false;
+    m_initialized = true;
+    initializeOpenGLFunctions();
+    float vertQuadTex[] = {-1.0f, -1.0f, 0.0f, 0.0f,
+                    -1.0f, 1.0f, 0.0f, 1.0f,
+                    1.0f, -1.0f, 1.0f, 0.0f,
+                    1.0f, 1.0f, 1.0f, 1.0f};
+    unsigned int VBO;
+    glGenVertexArrays(1, &textureVAO);
+    glBindVertexArray(textureVAO);
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertQuadTex), vertQuadTex, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), nullptr);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glGenFramebuffers(1, &outputFBO);
+    glGenTextures(2, m_textures);
+    return true;
+}
+
+bool WorkerKernel::isInitialized() const {
+    return m_initialized;
+}
+
+bool WorkerKernel::isCancelled(int generation) const {
+    return m_generation.load() != generation;
+}
+
+unsigned int WorkerKernel::beginOutput(QVector2D resolution, GLint bpc) {
+    QMutexLocker locker(&m_mutex);
+    if(m_ready >= 0) {
+        //finished but never displayed, it is overwritten by this evaluation
+        glDeleteSync(m_fence);
+        m_fence = nullptr;
+        m_ready = -1;
+        GLWorker::instance()->m_unpublished.deref();
+    }
+    m_back = m_front == 0 ? 1 : 0;
+    int i = m_back;
+    locker.unlock();
+
+    glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+    if(m_resolutions[i] != resolution || m_formats[i] != bpc) {
+        m_resolutions[i] = resolution;
+        m_formats[i] = bpc;
+        TextureFormat::allocate(this, bpc, resolution.x(), resolution.y());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, 2);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_textures[i], 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return m_textures[i];
+}
+
+void WorkerKernel::finishOutput() {
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    QMutexLocker locker(&m_mutex);
+    m_fence = fence;
+    m_ready = m_back;
+    m_back = -1;
+    GLWorker::instance()->m_unpublished.ref();
+    QPointer<QQuickItem> item = m_item;
+    locker.unlock();
+    QMetaObject::invokeMethod(GLWorker::instance(), [item]() {
+        if(item) item->update();
+    }, Qt::QueuedConnection);
+}
+
+void WorkerKernel::abandonOutput() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    QMutexLocker locker(&m_mutex);
+    m_back = -1;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORKERKERNEL_H
+#define WORKERKERNEL_H
+
+#include <QOpenGLFunctions_4_4_Core>
+#include <QQuickItem>
+#include <QPointer>
+#include <QVector2D>
+#include <QMutex>
+#include <QAtomicInt>
+
+//node kernel rendered on the gl worker into two output textures, the renderer keeps
+//displaying the published one while the next is rendered
+class WorkerKernel: protected QOpenGLFunctions_4_4_Core
+{
+public:
+    WorkerKernel();
+    virtual ~WorkerKernel();
+    void setItem(QQuickItem *item);
+    unsigned int texture();
+    bool publish(QOpenGLFunctions_4_4_Core *gl);
+    int nextGeneration();
+    static bool isBusy(const QQuickItem *item);
+protected:
+    bool initialize();
+    bool isInitialized() const;
+    bool isCancelled(int generation) const;
+    unsigned int beginOutput(QVector2D resolution, GLint bpc);
+    void finishOutput();
+    void abandonOutput();
+    unsigned int textureVAO = 0;
+    unsigned int outputFBO = 0;
+private:
+    QMutex m_mutex;
+    unsigned int m_textures[2] = {0, 0};
+    QVector2D m_resolutions[2];
+    GLint m_formats[2] = {0, 0};
+    int m_front = -1;
+    int m_back = -1;
+    int m_ready = -1;
+    GLsync m_fence = nullptr;
+    QPointer<QQuickItem> m_item;
+    QAtomicInt m_generation;
+    bool m_initialized = false;
+    static QList<WorkerKernel*> m_kernels;
+    static QMutex m_kernelsMutex;
+};
+
+#endif // WORKERKERNEL_H
@@ -0,0 +1,22 @@
+QT += quick
+QT += gui
+QT += widgets
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = symbinode-cli
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(symbinode.pri)
+
+SOURCES += \
+    src/cli.cpp \
+    src/headlessrenderer.cpp
+
+HEADERS += \
+    src/headlessrenderer.h
+
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/symbinode/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,15 @@
+QT += quick
+QT += gui
+QT += widgets
+QT += testlib
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = symbinode-tests
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(symbinode.pri)
+
+SOURCES += \
+    tests/tst_socket.cpp
@@ -0,0 +1,200 @@
+INCLUDEPATH += $$PWD/libs/FreeImage
+LIBS += -L$$PWD/libs/FreeImage -lFreeImage
+
+SOURCES += \
+    src/backgroundobject.cpp \
+    src/backgroundrenderer.cpp \
+    src/scene.cpp \
+    src/node.cpp \
+    src/edge.cpp \
+    src/socket.cpp \
+    src/commands.cpp \
+    src/clipboard.cpp \
+    src/mainwindow.cpp \
+    src/tab.cpp \
+    src/preview.cpp \
+    src/noisenode.cpp \
+    src/noise.cpp \
+    src/mixnode.cpp \
+    src/mix.cpp \
+    src/preview3d.cpp \
+    src/albedonode.cpp \
+    src/albedo.cpp \
+    src/metalnode.cpp \
+    src/onechanel.cpp \
+    src/roughnode.cpp \
+    src/normalmapnode.cpp \
+    src/normalmap.cpp \
+    src/normalnode.cpp \
+    src/normal.cpp \
+    src/voronoinode.cpp \
+    src/voronoi.cpp \
+    src/polygonnode.cpp \
+    src/polygon.cpp \
+    src/circlenode.cpp \
+    src/circle.cpp \
+    src/transformnode.cpp \
+    src/transform.cpp \
+    src/tilenode.cpp \
+    src/tile.cpp \
+    src/warpnode.cpp \
+    src/warp.cpp \
+    src/blurnode.cpp \
+    src/blur.cpp \
+    src/inversenode.cpp \
+    src/inverse.cpp \
+    src/colorrampnode.cpp \
+    src/colorramp.cpp \
+    src/colornode.cpp \
+    src/color.cpp \
+    src/coloring.cpp \
+    src/coloringnode.cpp \
+    src/mappingnode.cpp \
+    src/mapping.cpp \
+    src/mirrornode.cpp \
+    src/mirror.cpp \
+    src/brightnesscontrastnode.cpp \
+    src/brightnesscontrast.cpp \
+    src/thresholdnode.cpp \
+    src/threshold.cpp \
+    src/cubicbezier.cpp \
+    src/cutline.cpp \
+    src/frame.cpp \
+    src/heightnode.cpp \
+    src/emissionnode.cpp \
+    src/grayscalenode.cpp \
+    src/grayscale.cpp \
+    src/gradientnode.cpp \
+    src/gradient.cpp \
+    src/directionalwarpnode.cpp \
+    src/directionalwarp.cpp \
+    src/directionalblurnode.cpp \
+    src/directionalblur.cpp \
+    src/slopeblurnode.cpp \
+    src/slopeblur.cpp \
+    src/bevelnode.cpp \
+    src/bevel.cpp \
+    src/polartransformnode.cpp \
+    src/polartransform.cpp \
+    src/bricksnode.cpp \
+    src/bricks.cpp \
+    src/hexagonsnode.cpp \
+    src/hexagons.cpp \
+    src/distancenode.cpp \
+    src/distance.cpp \
+    src/graphevaluator.cpp \
+    src/qmlloader.cpp \
+    src/shadercache.cpp \
+    src/texturepool.cpp \
+    src/blurengine.cpp \
+    src/textureexporter.cpp \
+    src/glworker.cpp \
+    src/workerkernel.cpp \
+    src/pointstage.cpp \
+    src/pointchain.cpp \
+    src/jumpflood.cpp \
+    src/celltable.cpp \
+    src/ramplut.cpp \
+    src/textureformat.cpp \
+    src/resampler.cpp \
+    src/spatialindex.cpp
+
+HEADERS += \
+    src/backgroundobject.h \
+    src/backgroundrenderer.h \
+    src/scene.h \
+    src/node.h \
+    src/edge.h \
+    src/socket.h \
+    src/commands.h \
+    src/clipboard.h \
+    src/mainwindow.h \
+    src/tab.h \
+    src/preview.h \
+    src/noisenode.h \
+    src/noise.h \
+    src/mixnode.h \
+    src/mix.h \
+    src/preview3d.h \
+    src/albedonode.h \
+    src/albedo.h \
+    src/metalnode.h \
+    src/onechanel.h \
+    src/roughnode.h \
+    src/normalmapnode.h \
+    src/normalmap.h \
+    src/normalnode.h \
+    src/normal.h \
+    src/voronoinode.h \
+    src/voronoi.h \
+    src/polygonnode.h \
+    src/polygon.h \
+    src/circlenode.h \
+    src/circle.h \
+    src/transformnode.h \
+    src/transform.h \
+    src/tilenode.h \
+    src/tile.h \
+    src/warpnode.h \
+    src/warp.h \
+    src/blurnode.h \
+    src/blur.h \
+    src/inversenode.h \
+    src/inverse.h \
+    src/colorrampnode.h \
+    src/colorramp.h \
+    src/colornode.h \
+    src/color.h \
+    src/coloring.h \
+    src/coloringnode.h \
+    src/mappingnode.h \
+    src/mapping.h \
+    src/mirrornode.h \
+    src/mirror.h \
+    src/brightnesscontrastnode.h \
+    src/brightnesscontrast.h \
+    src/thresholdnode.h \
+    src/threshold.h \
+    src/cubicbezier.h \
+    src/cutline.h \
+    src/frame.h \
+    src/heightnode.h \
+    src/emissionnode.h \
+    src/grayscalenode.h \
+    src/grayscale.h \
+    src/gradientnode.h \
+    src/gradient.h \
+    src/directionalwarpnode.h \
+    src/directionalwarp.h \
+    src/directionalblurnode.h \
+    src/directionalblur.h \
+    src/slopeblurnode.h \
+    src/slopeblur.h \
+    src/bevelnode.h \
+    src/bevel.h \
+    src/polartransformnode.h \
+    src/polartransform.h \
+    src/bricksnode.h \
+    src/bricks.h \
+    src/hexagonsnode.h \
+    src/hexagons.h \
+    src/distancenode.h \
+    src/distance.h \
+    src/graphevaluator.h \
+    src/qmlloader.h \
+    src/shadercache.h \
+    src/texturepool.h \
+    src/blurengine.h \
+    src/textureexporter.h \
+    src/glworker.h \
+    src/workerkernel.h \
+    src/pointstage.h \
+    src/pointchain.h \
+    src/jumpflood.h \
+    src/celltable.h \
+    src/ramplut.h \
+    src/textureformat.h \
+    src/resampler.h \
+    src/spatialindex.h
+
+RESOURCES += src/qml.qrc
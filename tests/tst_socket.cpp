@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2020 Gukova Anastasiia
+ * Copyright © 2020 Gukov Anton <fexcron@gmail.com>
+ *
+ *
+ * This file is part of Symbinode.
+ *
+ * Symbinode is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Symbinode is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Symbinode.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QGuiApplication>
+#include "scene.h"
+#include "inversenode.h"
+#include "qmlloader.h"
+
+class TestSocket: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void inputValueMarksNodeDirty();
+    void outputValueMarksConsumerDirty();
+private:
+    Scene *m_scene = nullptr;
+    Node *m_producer = nullptr;
+    Node *m_consumer = nullptr;
+};
+
+void TestSocket::init() {
+    m_scene = new Scene();
+    //nothing is evaluated, the test only looks at what the evaluator schedules
+    m_scene->evaluator()->suspend();
+    m_producer = new InverseNode(m_scene);
+    m_consumer = new InverseNode(m_scene);
+    m_scene->addNode(m_producer);
+    m_scene->addNode(m_consumer);
+    Socket *output = m_producer->getOutputSocket(0);
+    Socket *input = m_consumer->getInputSocket(0);
+    Edge *edge = new Edge(m_scene->canvas());
+    edge->setStartSocket(output);
+    edge->setEndSocket(input);
+    output->addEdge(edge);
+    input->addEdge(edge);
+    m_scene->addEdge(edge);
+    QVERIFY(Scene::sceneOf(m_consumer) == m_scene);
+    QVERIFY(!m_scene->evaluator()->isDirty(m_producer));
+    QVERIFY(!m_scene->evaluator()->isDirty(m_consumer));
+}
+
+void TestSocket::cleanup() {
+    delete m_scene;
+    m_scene = nullptr;
+}
+
+void TestSocket::inputValueMarksNodeDirty() {
+    m_consumer->getInputSocket(0)->setValue(7u);
+    QVERIFY(m_scene->evaluator()->isDirty(m_consumer));
+    QVERIFY(!m_scene->evaluator()->isDirty(m_producer));
+}
+
+void TestSocket::outputValueMarksConsumerDirty() {
+    m_producer->getOutputSocket(0)->setValue(7u);
+    QCOMPARE(m_consumer->getInputSocket(0)->value().toUInt(), 7u);
+    QVERIFY(m_scene->evaluator()->isDirty(m_consumer));
+    QVERIFY(!m_scene->evaluator()->isDirty(m_producer));
+}
+
+int main(int argc, char *argv[])
+{
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    QmlLoader::setHeadless(true);
+    TestSocket test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_socket.moc"